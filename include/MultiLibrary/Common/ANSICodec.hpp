@@ -0,0 +1,151 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <cstdint>
+#include <locale>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief Converter between an 8 bits ANSI code page and Unicode.
+
+ The mapping of the code page is resolved once when the codec is created,
+ so conversions never touch std::locale and can run concurrently from any
+ amount of threads without contention. Codecs are immutable.
+ */
+class MULTILIBRARY_COMMON_API ANSICodec
+{
+public:
+	/*!
+	 \brief Resolve the code page of a locale.
+
+	 \param loc Locale whose wchar_t ctype facet defines the code page.
+	 */
+	explicit ANSICodec( const std::locale &loc );
+
+	/*!
+	 \brief Return the codec for ISO-8859-1, where bytes map directly to
+	 codepoints U+0000 to U+00FF.
+
+	 \return Latin-1 codec.
+	 */
+	static const ANSICodec &Latin1( );
+
+	/*!
+	 \brief Return the codec for ASCII, where bytes above 0x7F are invalid.
+
+	 \return ASCII codec.
+	 */
+	static const ANSICodec &ASCII( );
+
+	/*!
+	 \brief Return the codec for the global locale.
+
+	 The global locale is resolved the first time this is called, later
+	 changes to it are not picked up.
+
+	 \return Codec of the global locale.
+	 */
+	static const ANSICodec &GetDefault( );
+
+	/*!
+	 \brief Convert a character into a Unicode codepoint.
+
+	 \param ch Character to convert.
+
+	 \return Codepoint of the character, U+FFFD if it has none.
+	 */
+	uint32_t Widen( char ch ) const;
+
+	/*!
+	 \brief Convert a Unicode codepoint into a character.
+
+	 \param codepoint Codepoint to convert.
+	 \param replace Character returned when the code page doesn't have the codepoint.
+
+	 \return Character of the codepoint.
+	 */
+	char Narrow( uint32_t codepoint, char replace ) const;
+
+	/*!
+	 \brief Tell if bytes up to 0x7F map to the same codepoints.
+
+	 Runs of ASCII characters are then copied in bulk by the conversions.
+
+	 \return true if the code page is a superset of ASCII, false otherwise.
+	 */
+	bool IsASCIICompatible( ) const;
+
+	/*!
+	 \brief Convert ANSI input to UTF-8, appending it to a string.
+
+	 \param begin Pointer to the begining of the input.
+	 \param end Pointer to the end of the input.
+	 \param output String to append the UTF-8 output to.
+	 */
+	void ToUTF8( const char *begin, const char *end, std::string &output ) const;
+
+	/*!
+	 \brief Convert UTF-8 input to ANSI, appending it to a string.
+
+	 \param begin Pointer to the begining of the input.
+	 \param end Pointer to the end of the input.
+	 \param output String to append the ANSI output to.
+	 \param replace (optional) Character for codepoints not in the code page,
+	 0 to drop them.
+	 */
+	void FromUTF8( const char *begin, const char *end, std::string &output, char replace = 0 ) const;
+
+private:
+	ANSICodec( );
+
+	void BuildNarrowTables( );
+
+	uint32_t widen_table[256];
+	int16_t narrow_table[256];
+	std::vector<std::pair<uint32_t, char>> narrow_extra;
+	bool ascii_compatible;
+};
+
+#include <MultiLibrary/Common/ANSICodec.inl>
+
+} // namespace MultiLibrary
@@ -0,0 +1,213 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <MultiLibrary/Common/InputStream.hpp>
+#include <MultiLibrary/Common/Endian.hpp>
+#include <string>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A class that deserializes binary data from an input stream.
+
+ Data is read ahead from the stream in large chunks into a local buffer.
+ Because of this, the stream position runs ahead of what was consumed
+ until Sync is called.
+
+ \sa BinaryWriter
+ */
+class MULTILIBRARY_COMMON_API BinaryReader : public NonCopyable
+{
+public:
+	/*!
+	 \brief Default size of the local buffer, in bytes.
+	 */
+	static const size_t DEFAULT_BUFFER_SIZE = 4096;
+
+	/*!
+	 \brief Constructor.
+
+	 \param stream Stream to read the data from, must outlive this object.
+	 \param endianness Byte order used to decode values.
+	 \param buffer_size Size of the local buffer.
+	 */
+	explicit BinaryReader( InputStream &stream, Endianness endianness = Endianness::Little, size_t buffer_size = DEFAULT_BUFFER_SIZE );
+
+	/*!
+	 \brief Read an arithmetic or enumeration value.
+
+	 \param value Where to store the value, untouched on failure.
+
+	 \return true if the value was read, false otherwise.
+	 */
+	template<typename Type>
+	bool Read( Type &value );
+
+	/*!
+	 \brief Read a contiguous array of trivially copyable values.
+
+	 \param values Pointer to the first value.
+	 \param count Amount of values to read.
+
+	 \return Amount of values read.
+	 */
+	template<typename Type>
+	size_t ReadArray( Type *values, size_t count );
+
+	/*!
+	 \brief Read raw bytes.
+
+	 Reads bigger than the local buffer go straight to the stream.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes.
+	 */
+	size_t ReadBytes( void *data, size_t size );
+
+	/*!
+	 \brief Read an unsigned integer with a variable length encoding.
+
+	 \param value Where to store the value, untouched on failure.
+
+	 \return true if the value was read, false otherwise.
+
+	 \sa BinaryWriter::WriteVarInt
+	 */
+	bool ReadVarInt( uint64_t &value );
+
+	/*!
+	 \brief Read a signed integer with zigzag and variable length encoding.
+
+	 \param value Where to store the value, untouched on failure.
+
+	 \return true if the value was read, false otherwise.
+
+	 \sa BinaryWriter::WriteZigZag
+	 */
+	bool ReadZigZag( int64_t &value );
+
+	/*!
+	 \brief Read a string prefixed by its variable length encoded size.
+
+	 \param value Where to store the string, untouched on failure.
+
+	 \return true if the string was read, false otherwise.
+
+	 \sa BinaryWriter::WriteString
+	 */
+	bool ReadString( std::string &value );
+
+	/*!
+	 \brief Read an arithmetic or enumeration value.
+
+	 \param value Where to store the value.
+
+	 \return This object.
+
+	 \sa Read
+	 */
+	template<typename Type>
+	BinaryReader &operator>>( Type &value );
+
+	/*!
+	 \brief Read a string prefixed by its size.
+
+	 \param value Where to store the string.
+
+	 \return This object.
+
+	 \sa ReadString
+	 */
+	BinaryReader &operator>>( std::string &value );
+
+	/*!
+	 \brief Give unconsumed buffered data back to the stream.
+
+	 Seeks the stream back by the amount of buffered bytes and discards
+	 them.
+
+	 \return true if it succeeds, false if the stream can't seek.
+	 */
+	bool Sync( );
+
+	/*!
+	 \brief Get the amount of data waiting in the local buffer.
+
+	 \return Amount of buffered bytes.
+	 */
+	size_t Buffered( ) const;
+
+	/*!
+	 \brief Tell if a read came up short at some point.
+
+	 \return true if some read failed.
+	 */
+	bool Failed( ) const;
+
+	/*!
+	 \brief Get the byte order used to decode values.
+
+	 \return Byte order.
+	 */
+	Endianness GetEndianness( ) const;
+
+private:
+	bool Fill( size_t size );
+
+	template<typename Type>
+	void ConvertElements( Type *values, size_t count, std::true_type );
+
+	template<typename Type>
+	void ConvertElements( Type *values, size_t count, std::false_type );
+
+	InputStream &input_stream;
+	Endianness byte_order;
+	std::vector<uint8_t> buffer;
+	size_t buffer_offset;
+	size_t buffer_used;
+	bool failed;
+};
+
+#include <MultiLibrary/Common/BinaryReader.inl>
+
+} // namespace MultiLibrary
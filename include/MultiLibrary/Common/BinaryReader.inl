@@ -0,0 +1,81 @@
+/*************************************************************************
+ * MultiLibrary - danielga.bitbucket.org/multilibrary
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *************************************************************************/
+
+template<typename Type>
+bool BinaryReader::Read( Type &value )
+{
+	if( buffer_used - buffer_offset < sizeof( Type ) && !Fill( sizeof( Type ) ) )
+	{
+		failed = true;
+		return false;
+	}
+
+	Type temp;
+	std::memcpy( &temp, buffer.data( ) + buffer_offset, sizeof( Type ) );
+	buffer_offset += sizeof( Type );
+	value = ConvertEndianness( temp, byte_order );
+	return true;
+}
+
+template<typename Type>
+size_t BinaryReader::ReadArray( Type *values, size_t count )
+{
+	static_assert( std::is_trivially_copyable<Type>::value, "only trivially copyable types can be read as arrays" );
+
+	size_t read = ReadBytes( values, count * sizeof( Type ) ) / sizeof( Type );
+	if( sizeof( Type ) != 1 && byte_order != Endianness::Native )
+		ConvertElements( values, read, std::integral_constant<bool, std::is_arithmetic<Type>::value || std::is_enum<Type>::value>( ) );
+
+	return read;
+}
+
+template<typename Type>
+BinaryReader &BinaryReader::operator>>( Type &value )
+{
+	Read( value );
+	return *this;
+}
+
+template<typename Type>
+void BinaryReader::ConvertElements( Type *values, size_t count, std::true_type )
+{
+	for( size_t k = 0; k < count; ++k )
+		values[k] = ConvertEndianness( values[k], byte_order );
+}
+
+template<typename Type>
+void BinaryReader::ConvertElements( Type *, size_t, std::false_type )
+{ }
@@ -0,0 +1,219 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <MultiLibrary/Common/OutputStream.hpp>
+#include <MultiLibrary/Common/Endian.hpp>
+#include <string>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A class that serializes binary data into an output stream.
+
+ Values are encoded with an explicit byte order and gathered in a local
+ buffer, which is written to the stream in large chunks. Data is only
+ guaranteed to reach the stream after Flush is called or this object is
+ destroyed.
+
+ \sa BinaryReader
+ */
+class MULTILIBRARY_COMMON_API BinaryWriter : public NonCopyable
+{
+public:
+	/*!
+	 \brief Default size of the local buffer, in bytes.
+	 */
+	static const size_t DEFAULT_BUFFER_SIZE = 4096;
+
+	/*!
+	 \brief Constructor.
+
+	 \param stream Stream to write the data to, must outlive this object.
+	 \param endianness Byte order used to encode values.
+	 \param buffer_size Size of the local buffer.
+	 */
+	explicit BinaryWriter( OutputStream &stream, Endianness endianness = Endianness::Little, size_t buffer_size = DEFAULT_BUFFER_SIZE );
+
+	/*!
+	 \brief Destructor.
+
+	 Buffered data is flushed to the stream.
+	 */
+	~BinaryWriter( );
+
+	/*!
+	 \brief Write an arithmetic or enumeration value.
+
+	 \param value Value to write.
+
+	 \return This object.
+	 */
+	template<typename Type>
+	BinaryWriter &Write( Type value );
+
+	/*!
+	 \brief Write a contiguous array of trivially copyable values.
+
+	 If no byte order conversion is needed, the whole array is copied at
+	 once. Values that are not arithmetic or enumerations are copied as
+	 they are.
+
+	 \param values Pointer to the first value.
+	 \param count Amount of values to write.
+
+	 \return This object.
+	 */
+	template<typename Type>
+	BinaryWriter &WriteArray( const Type *values, size_t count );
+
+	/*!
+	 \brief Write raw bytes.
+
+	 Writes bigger than the local buffer go straight to the stream.
+
+	 \param data Pointer to the data to write.
+	 \param size Size of the data.
+
+	 \return This object.
+	 */
+	BinaryWriter &WriteBytes( const void *data, size_t size );
+
+	/*!
+	 \brief Write an unsigned integer with a variable length encoding.
+
+	 Uses 7 bits per byte, least significant group first (LEB128).
+
+	 \param value Value to write.
+
+	 \return This object.
+	 */
+	BinaryWriter &WriteVarInt( uint64_t value );
+
+	/*!
+	 \brief Write a signed integer with zigzag and variable length encoding.
+
+	 Small negative values are encoded as small unsigned values.
+
+	 \param value Value to write.
+
+	 \return This object.
+
+	 \sa WriteVarInt
+	 */
+	BinaryWriter &WriteZigZag( int64_t value );
+
+	/*!
+	 \brief Write a string prefixed by its variable length encoded size.
+
+	 \param value String to write.
+
+	 \return This object.
+	 */
+	BinaryWriter &WriteString( const std::string &value );
+
+	/*!
+	 \brief Write an arithmetic or enumeration value.
+
+	 \param value Value to write.
+
+	 \return This object.
+
+	 \sa Write
+	 */
+	template<typename Type>
+	BinaryWriter &operator<<( const Type &value );
+
+	/*!
+	 \brief Write a string prefixed by its size.
+
+	 \param value String to write.
+
+	 \return This object.
+
+	 \sa WriteString
+	 */
+	BinaryWriter &operator<<( const std::string &value );
+
+	/*!
+	 \brief Write all the buffered data to the stream.
+
+	 \return true if all the data was written, false otherwise.
+	 */
+	bool Flush( );
+
+	/*!
+	 \brief Get the amount of data waiting in the local buffer.
+
+	 \return Amount of buffered bytes.
+	 */
+	size_t Buffered( ) const;
+
+	/*!
+	 \brief Tell if the stream refused to take data at some point.
+
+	 \return true if a write to the stream came up short.
+	 */
+	bool Failed( ) const;
+
+	/*!
+	 \brief Get the byte order used to encode values.
+
+	 \return Byte order.
+	 */
+	Endianness GetEndianness( ) const;
+
+private:
+	template<typename Type>
+	void WriteElements( const Type *values, size_t count, std::true_type );
+
+	template<typename Type>
+	void WriteElements( const Type *values, size_t count, std::false_type );
+
+	OutputStream &output_stream;
+	Endianness byte_order;
+	std::vector<uint8_t> buffer;
+	size_t buffer_used;
+	bool failed;
+};
+
+#include <MultiLibrary/Common/BinaryWriter.inl>
+
+} // namespace MultiLibrary
@@ -0,0 +1,81 @@
+/*************************************************************************
+ * MultiLibrary - danielga.bitbucket.org/multilibrary
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *************************************************************************/
+
+template<typename Type>
+BinaryWriter &BinaryWriter::Write( Type value )
+{
+	value = ConvertEndianness( value, byte_order );
+	if( buffer.size( ) - buffer_used < sizeof( Type ) )
+		Flush( );
+
+	if( buffer.size( ) - buffer_used < sizeof( Type ) )
+		return WriteBytes( &value, sizeof( Type ) );
+
+	std::memcpy( buffer.data( ) + buffer_used, &value, sizeof( Type ) );
+	buffer_used += sizeof( Type );
+	return *this;
+}
+
+template<typename Type>
+BinaryWriter &BinaryWriter::WriteArray( const Type *values, size_t count )
+{
+	static_assert( std::is_trivially_copyable<Type>::value, "only trivially copyable types can be written as arrays" );
+
+	if( sizeof( Type ) == 1 || byte_order == Endianness::Native )
+		return WriteBytes( values, count * sizeof( Type ) );
+
+	WriteElements( values, count, std::integral_constant<bool, std::is_arithmetic<Type>::value || std::is_enum<Type>::value>( ) );
+	return *this;
+}
+
+template<typename Type>
+void BinaryWriter::WriteElements( const Type *values, size_t count, std::true_type )
+{
+	for( size_t k = 0; k < count; ++k )
+		Write( values[k] );
+}
+
+template<typename Type>
+void BinaryWriter::WriteElements( const Type *values, size_t count, std::false_type )
+{
+	WriteBytes( values, count * sizeof( Type ) );
+}
+
+template<typename Type>
+BinaryWriter &BinaryWriter::operator<<( const Type &value )
+{
+	return Write( value );
+}
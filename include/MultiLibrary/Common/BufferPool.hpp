@@ -0,0 +1,151 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <vector>
+#include <memory>
+
+namespace MultiLibrary
+{
+
+class BufferPoolInternal;
+
+/*!
+ \brief A thread-safe pool of reusable byte storage.
+
+ Storage is grouped in power of two size classes. Each thread keeps a small
+ cache per size class, so most acquisitions and releases don't need to lock.
+ Storage that doesn't fit in the thread cache goes to a shared, locked
+ cache, and is freed once that cache is full too.
+
+ \sa ByteBuffer, ChainedBuffer
+ */
+class MULTILIBRARY_COMMON_API BufferPool : public NonCopyable
+{
+public:
+	/*!
+	 \brief Storage handed out by the pool.
+	 */
+	typedef std::shared_ptr<std::vector<uint8_t>> Storage;
+
+	/*!
+	 \brief Usage counters of a pool.
+	 */
+	struct Statistics
+	{
+		uint64_t hits; ///< Acquisitions served from cached storage
+		uint64_t misses; ///< Acquisitions that had to allocate
+		uint64_t releases; ///< Storage returned and kept for reuse
+		uint64_t discards; ///< Storage returned and freed
+	};
+
+	/*!
+	 \brief Smallest size class, in bytes.
+	 */
+	static const size_t MIN_CLASS_SIZE = 256;
+
+	/*!
+	 \brief Biggest size class, in bytes. Bigger requests are never cached.
+	 */
+	static const size_t MAX_CLASS_SIZE = 4 * 1024 * 1024;
+
+	/*!
+	 \brief Constructor.
+
+	 \param max_cached Maximum amount of storage kept per size class in the
+	 shared cache.
+	 */
+	explicit BufferPool( size_t max_cached = 64 );
+
+	/*!
+	 \brief Destructor.
+
+	 Storage still acquired from this pool is simply freed when released.
+	 */
+	~BufferPool( );
+
+	/*!
+	 \brief Acquire storage with at least the specified capacity.
+
+	 Recycled storage keeps the size and contents it had when it was
+	 released, callers should resize or clear it as needed.
+
+	 \param capacity Minimum capacity of the storage.
+
+	 \return Storage not shared with anyone else.
+	 */
+	Storage Acquire( size_t capacity );
+
+	/*!
+	 \brief Return storage to the pool.
+
+	 Storage still shared with other objects is left alone.
+
+	 \param storage Storage to return.
+	 */
+	void Release( Storage &&storage );
+
+	/*!
+	 \brief Free all storage kept in the shared cache.
+	 */
+	void Trim( );
+
+	/*!
+	 \brief Get the usage counters of this pool.
+
+	 \return Usage counters.
+	 */
+	Statistics GetStatistics( ) const;
+
+	/*!
+	 \brief Reset the usage counters of this pool.
+	 */
+	void ResetStatistics( );
+
+	/*!
+	 \brief Get the process-wide pool.
+
+	 \return Default pool.
+	 */
+	static BufferPool &Default( );
+
+private:
+	std::shared_ptr<BufferPoolInternal> pool_internal;
+};
+
+} // namespace MultiLibrary
@@ -0,0 +1,202 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/InputStream.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <string>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief An input stream adapter that reads ahead from another stream.
+
+ Data is pulled from the wrapped stream in chunks as big as the internal
+ buffer, which turns small reads (like the ones done by the string
+ extraction operators) into memory copies instead of one call to the
+ wrapped stream each.
+
+ The wrapped stream must outlive this object and shouldn't be read from
+ directly while this object holds buffered data.
+ */
+class MULTILIBRARY_COMMON_API BufferedInputStream : public InputStream, public NonCopyable
+{
+public:
+	/*!
+	 \brief Default size of the internal buffer, in bytes.
+	 */
+	static const size_t DEFAULT_BUFFER_SIZE = 16384;
+
+	/*!
+	 \brief Constructor.
+
+	 \param stream Stream to read the data from.
+	 \param buffer_size Size of the internal buffer.
+	 */
+	explicit BufferedInputStream( InputStream &stream, size_t buffer_size = DEFAULT_BUFFER_SIZE );
+
+	/*!
+	 \brief Tell if the wrapped stream is valid.
+
+	 \return true if the wrapped stream is valid, false otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 Buffered data is discarded.
+
+	 \param position Position to set the pointer to.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 Relative seeks take the buffered data into account.
+
+	 \param position Position to set the pointer to.
+	 \param mode Type of seeking pretended.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Return the current read position.
+
+	 \return Position of the wrapped stream minus the buffered data.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the size of the wrapped stream.
+
+	 \return Size of the wrapped stream.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the end of file was reached.
+
+	 \return true if there's no buffered data and the wrapped stream
+	 reached end of file.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Read data from the stream.
+
+	 Reads bigger than the internal buffer go straight to the wrapped
+	 stream once the buffered data is consumed.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes.
+	 */
+	size_t Read( void *data, size_t size );
+
+	/*!
+	 \brief Look at the next bytes without consuming them.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer, at most the size of the internal buffer
+	 is used.
+
+	 \return Amount of bytes copied.
+	 */
+	size_t Peek( void *data, size_t size );
+
+	/*!
+	 \brief Read data until the delimiter is found.
+
+	 The data is appended to the string and the delimiter is consumed but
+	 not appended.
+
+	 \param data String to append the data to.
+	 \param delimiter Byte to stop at.
+
+	 \return true if the delimiter was found, false if the stream ran out
+	 of data first.
+	 */
+	bool ReadUntil( std::string &data, char delimiter );
+
+	/*!
+	 \brief Read a line of text.
+
+	 The string is replaced by the line, without the line terminator
+	 ("\n" or "\r\n").
+
+	 \param data String to store the line.
+
+	 \return true if a line, even if unterminated, was read, false if the
+	 stream had no data.
+	 */
+	bool ReadLine( std::string &data );
+
+	/*!
+	 \brief Get the amount of data waiting in the internal buffer.
+
+	 \return Amount of buffered bytes.
+	 */
+	size_t Buffered( ) const;
+
+protected:
+	/*!
+	 \brief Read a '\0' or '\n' terminated string, scanning the internal
+	 buffer instead of reading byte by byte.
+
+	 \param data String to append the data to.
+	 */
+	void ExtractString( std::string &data );
+
+private:
+	size_t Fill( );
+
+	InputStream &input_stream;
+	std::vector<char> buffer;
+	size_t buffer_offset;
+	size_t buffer_used;
+};
+
+} // namespace MultiLibrary
@@ -0,0 +1,215 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/OutputStream.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief An output stream adapter that combines small writes.
+
+ Written data is gathered in an internal buffer and handed to the wrapped
+ stream when the buffer fills up, when Flush is called or when this object
+ is destroyed. In line mode, writes containing a newline are flushed right
+ away, which suits interactive pipes.
+
+ The wrapped stream must outlive this object.
+ */
+class MULTILIBRARY_COMMON_API BufferedOutputStream : public OutputStream, public NonCopyable
+{
+public:
+	/*!
+	 \brief Values that represent when buffered data is flushed.
+	 */
+	enum class FlushMode
+	{
+		Full, ///< Flush only when the buffer is full or on demand
+		Line ///< Also flush after every write containing a newline
+	};
+
+	/*!
+	 \brief Usage counters of a buffered stream.
+	 */
+	struct Statistics
+	{
+		uint64_t writes; ///< Calls to Write
+		uint64_t bytes_written; ///< Bytes handed to the wrapped stream
+		uint64_t flushes; ///< Calls made to the wrapped stream's Write
+	};
+
+	/*!
+	 \brief Default size of the internal buffer, in bytes.
+	 */
+	static const size_t DEFAULT_BUFFER_SIZE = 16384;
+
+	/*!
+	 \brief Constructor.
+
+	 \param stream Stream to write the data to.
+	 \param buffer_size Size of the internal buffer.
+	 \param mode When to flush buffered data.
+	 */
+	explicit BufferedOutputStream( OutputStream &stream, size_t buffer_size = DEFAULT_BUFFER_SIZE, FlushMode mode = FlushMode::Full );
+
+	/*!
+	 \brief Destructor.
+
+	 Buffered data is flushed to the wrapped stream.
+	 */
+	~BufferedOutputStream( );
+
+	/*!
+	 \brief Tell if the wrapped stream is valid.
+
+	 \return true if the wrapped stream is valid, false otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Set the current position of write operations.
+
+	 Buffered data is flushed first.
+
+	 \param position Position to set the pointer to.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Set the current position of write operations.
+
+	 Buffered data is flushed first.
+
+	 \param position Position to set the pointer to.
+	 \param mode Type of seeking pretended.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Return the current write position.
+
+	 \return Position of the wrapped stream plus the buffered data.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the size of the wrapped stream.
+
+	 \return Size of the wrapped stream, including buffered data past its
+	 end.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the wrapped stream reached end of file.
+
+	 \return End of file state of the wrapped stream.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Write data to the stream.
+
+	 Writes bigger than the internal buffer go straight to the wrapped
+	 stream once the buffered data is flushed.
+
+	 \param data Data to write.
+	 \param size Size of the data.
+
+	 \return Amount of bytes accepted, which is less than size only when
+	 the wrapped stream stopped taking data.
+	 */
+	size_t Write( const void *data, size_t size );
+
+	/*!
+	 \brief Write all buffered data to the wrapped stream.
+
+	 \return true if all the data was written, false otherwise.
+	 */
+	bool Flush( );
+
+	/*!
+	 \brief Get the amount of data waiting in the internal buffer.
+
+	 \return Amount of buffered bytes.
+	 */
+	size_t Buffered( ) const;
+
+	/*!
+	 \brief Set when buffered data is flushed.
+
+	 \param mode Flush mode.
+	 */
+	void SetFlushMode( FlushMode mode );
+
+	/*!
+	 \brief Get when buffered data is flushed.
+
+	 \return Flush mode.
+	 */
+	FlushMode GetFlushMode( ) const;
+
+	/*!
+	 \brief Get the usage counters of this stream.
+
+	 \return Usage counters.
+	 */
+	Statistics GetStatistics( ) const;
+
+	/*!
+	 \brief Reset the usage counters of this stream.
+	 */
+	void ResetStatistics( );
+
+private:
+	size_t WriteThrough( const uint8_t *data, size_t size );
+
+	OutputStream &output_stream;
+	std::vector<uint8_t> buffer;
+	size_t buffer_used;
+	FlushMode flush_mode;
+	Statistics statistics;
+};
+
+} // namespace MultiLibrary
@@ -37,17 +37,27 @@
 
 #include <MultiLibrary/Common/Export.hpp>
 #include <MultiLibrary/Common/IOStream.hpp>
+#include <MultiLibrary/Common/ByteBufferView.hpp>
 #include <string>
 #include <vector>
 #include <set>
+#include <memory>
 
 namespace MultiLibrary
 {
+
+class BufferPool;
+
 /*!
  \brief A class that represents a buffer composed by bytes.
 
  It provides useful functions to read and write to it. Works very much
  like a file.
+
+ The internal storage is shared with copies of this object and with any
+ ByteBufferView created through Slice, and is only duplicated when a
+ shared buffer is modified (copy-on-write). Once the mutable GetBuffer has
+ been called, copies and slices get their own storage instead.
  */
 class MULTILIBRARY_COMMON_API ByteBuffer : public IOStream
 {
@@ -78,13 +88,48 @@ public:
 	 */
 	ByteBuffer( const uint8_t *copy_buffer, size_t size );
 
+	/*!
+	 \brief Create an empty buffer whose storage comes from a pool.
+
+	 The storage is returned to the pool when this object is destroyed,
+	 unless it is still shared with copies or views. The pool must outlive
+	 this object and its copies.
+
+	 \param pool Pool to acquire the storage from.
+	 \param capacity Initial capacity of the buffer.
+
+	 \overload
+	 */
+	ByteBuffer( BufferPool &pool, size_t capacity );
+
+	/*!
+	 \brief Copy constructor.
+
+	 Shares the storage of the other buffer unless its mutable GetBuffer
+	 was called.
+
+	 \param other Buffer to copy.
+	 */
+	ByteBuffer( const ByteBuffer &other );
+
 	/*!
 	 \brief Destructor.
 
-	 Subscribers are alerted to this object destruction, if any.
+	 Pooled storage is returned to its pool.
 	 */
 	~ByteBuffer( );
 
+	/*!
+	 \brief Copy assignment operator.
+
+	 The previous storage is returned to its pool, like on destruction.
+
+	 \param other Buffer to copy.
+
+	 \return Reference to this object.
+	 */
+	ByteBuffer &operator=( const ByteBuffer &other );
+
 	/*!
 	 \brief Tell if the buffer is valid.
 
@@ -184,6 +229,11 @@ public:
 	/*!
 	 \brief Return pointer to internal buffer.
 
+	 Storage shared with copies or views is duplicated first. Since the
+	 pointer may be written through at any time, copies and slices made
+	 afterwards don't share the storage, until it's replaced by Clear,
+	 Assign or ShrinkToFit.
+
 	 \return Pointer to internal buffer.
 	 */
 	uint8_t *GetBuffer( );
@@ -197,10 +247,37 @@ public:
 	 */
 	const uint8_t *GetBuffer( ) const;
 
+	/*!
+	 \brief Create a read-only view of the whole buffer.
+
+	 The view shares ownership of the internal storage, so no data is
+	 copied and the view stays valid after this object is destroyed.
+
+	 \return View of the buffer contents.
+
+	 \sa ByteBufferView
+	 */
+	ByteBufferView Slice( ) const;
+
+	/*!
+	 \brief Create a read-only view of a sub-range of the buffer.
+
+	 The range is clamped to the size of the buffer.
+
+	 \param offset Offset of the first byte of the view.
+	 \param size Amount of bytes the view covers.
+
+	 \return View of the buffer contents.
+
+	 \overload
+	 */
+	ByteBufferView Slice( size_t offset, size_t size ) const;
+
 	/*!
 	 \brief Reset the buffer.
 
-	 All data is wiped and all flags reset.
+	 All data is wiped and all flags reset. Storage shared with views or
+	 other buffers is released instead of being copied.
 	 */
 	void Clear( );
 
@@ -257,8 +334,13 @@ public:
 	size_t Write( const void *value, size_t size );
 
 private:
+	std::vector<uint8_t> &MutableStorage( );
+	void Share( const ByteBuffer &other );
+
+	BufferPool *buffer_pool;
 	bool end_of_file;
-	std::vector<uint8_t> buffer_internal;
+	bool buffer_exposed;
+	std::shared_ptr<std::vector<uint8_t>> buffer_internal;
 	size_t buffer_offset;
 };
 
@@ -0,0 +1,199 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/InputStream.hpp>
+#include <functional>
+#include <memory>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A read-only view of a range of bytes with shared ownership.
+
+ Views never copy the bytes they refer to. The underlying memory is kept
+ alive for as long as any view (or the ByteBuffer it came from) refers to
+ it, so views can be freely handed to other objects or threads.
+
+ \sa ByteBuffer::Slice
+ */
+class MULTILIBRARY_COMMON_API ByteBufferView : public InputStream
+{
+public:
+	/*!
+	 \brief Function used to release foreign memory.
+	 */
+	typedef std::function<void( const uint8_t * )> Deleter;
+
+	/*!
+	 \brief Default constructor.
+
+	 Creates an empty view.
+	 */
+	ByteBufferView( );
+
+	/*!
+	 \brief Create a view from memory with shared ownership.
+
+	 \param data Shared pointer to the first byte of the view.
+	 \param size Amount of bytes the view covers.
+
+	 \overload
+	 */
+	ByteBufferView( const std::shared_ptr<const uint8_t> &data, size_t size );
+
+	/*!
+	 \brief Create a view that takes ownership of foreign memory.
+
+	 \param data Pointer to the first byte of the view.
+	 \param size Amount of bytes the view covers.
+	 \param deleter Function called when the last view releases the memory.
+
+	 \overload
+	 */
+	ByteBufferView( const uint8_t *data, size_t size, const Deleter &deleter );
+
+	/*!
+	 \brief Tell if the view is valid.
+
+	 Currently just checks if we reached the end of the view.
+
+	 \return If we haven't reached the end of the view, true, otherwise false.
+
+	 \sa EndOfFile
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Tell if the object is valid.
+
+	 \return A boolean type relative to IsValid.
+
+	 \sa IsValid
+	 */
+	explicit operator bool( ) const;
+
+	/*!
+	 \brief Tell if the object is not valid.
+
+	 \return Validness of this object.
+
+	 \sa IsValid
+	 */
+	bool operator!( ) const;
+
+	/*!
+	 \brief Return the current read position on the view.
+
+	 \return Current position of read operations on the view.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the size of the view.
+
+	 \return Amount of bytes covered by the view.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 \param position Position to set the pointer to.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 \param position Position to set the pointer to.
+	 \param mode Type of seeking pretended.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Tell if the end of file was reached.
+
+	 In this case, end of file means we reached the end of the view.
+
+	 \return End of view reached.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Return pointer to the first byte of the view.
+
+	 \return Pointer to the viewed memory.
+	 */
+	const uint8_t *GetBuffer( ) const;
+
+	/*!
+	 \brief Create a view of a sub-range of this view.
+
+	 The new view shares ownership with this one and the range is clamped
+	 to the size of this view.
+
+	 \param offset Offset of the first byte, relative to this view.
+	 \param size Amount of bytes the new view covers.
+
+	 \return View of the sub-range.
+	 */
+	ByteBufferView Slice( size_t offset, size_t size ) const;
+
+	/*!
+	 \brief Read data from the view.
+
+	 \param value Pointer to the buffer to write to.
+	 \param size Amount to read.
+
+	 \return Size in bytes of the read data.
+	 */
+	size_t Read( void *value, size_t size );
+
+private:
+	std::shared_ptr<const uint8_t> view_data;
+	size_t view_size;
+	size_t view_offset;
+	bool end_of_file;
+};
+
+} // namespace MultiLibrary
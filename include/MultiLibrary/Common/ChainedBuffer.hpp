@@ -0,0 +1,310 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/IOStream.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <deque>
+#include <vector>
+#include <memory>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A buffer made of a chain of fixed-size blocks.
+
+ Unlike ByteBuffer, growing this buffer never moves the bytes already
+ stored in it, new blocks are simply appended to the chain. Writes always
+ append to the end of the buffer while reads start at the current position.
+ Blocks come from a BufferPool and are returned to it when this object is
+ destroyed. Blocks released by Consume and Clear are kept and reused by
+ later writes.
+
+ The stored bytes can be exposed as a list of segments, suitable for
+ scatter/gather I/O like Socket::Send and Socket::Receive.
+ */
+class MULTILIBRARY_COMMON_API ChainedBuffer : public IOStream
+{
+public:
+	/*!
+	 \brief A contiguous range of memory inside the buffer.
+	 */
+	struct Segment
+	{
+		uint8_t *data; ///< Pointer to the first byte of the segment
+		size_t size; ///< Size of the segment in bytes
+	};
+
+	/*!
+	 \brief Default block size, in bytes.
+	 */
+	static const size_t DEFAULT_BLOCK_SIZE = 4096;
+
+	/*!
+	 \brief Create a buffer with the specified block size.
+
+	 \param block_size Size of each block in the chain.
+	 \param pool Pool to acquire the blocks from, must outlive this object.
+	 */
+	explicit ChainedBuffer( size_t block_size = DEFAULT_BLOCK_SIZE, BufferPool &pool = BufferPool::Default( ) );
+
+	/*!
+	 \brief Destructor.
+
+	 All blocks are returned to the pool.
+	 */
+	~ChainedBuffer( );
+
+	/*!
+	 \brief Move constructor.
+
+	 The other buffer is left empty.
+
+	 \param buffer Buffer to take the blocks from.
+	 */
+	ChainedBuffer( ChainedBuffer &&buffer );
+
+	/*!
+	 \brief Move assignment operator.
+
+	 The blocks of this buffer are returned to the pool, like on
+	 destruction, and the other buffer is left empty.
+
+	 \param buffer Buffer to take the blocks from.
+
+	 \return Reference to this object.
+	 */
+	ChainedBuffer &operator=( ChainedBuffer &&buffer );
+
+	/*!
+	 \brief Tell if the buffer is valid.
+
+	 Currently just checks if we reached the end of the buffer.
+
+	 \return If we haven't reached the end of the buffer, true, otherwise false.
+
+	 \sa EndOfFile
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Tell if the object is valid.
+
+	 \return A boolean type relative to IsValid.
+
+	 \sa IsValid
+	 */
+	explicit operator bool( ) const;
+
+	/*!
+	 \brief Tell if the object is not valid.
+
+	 \return Validness of this object.
+
+	 \sa IsValid
+	 */
+	bool operator!( ) const;
+
+	/*!
+	 \brief Return the current read position on the buffer.
+
+	 \return Current position of read operations on the buffer.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the amount of bytes stored in the buffer.
+
+	 \return Size of the buffer.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Return the amount of bytes the buffer can hold without
+	 allocating more blocks.
+
+	 \return Capacity of this object.
+	 */
+	size_t Capacity( ) const;
+
+	/*!
+	 \brief Return the size of each block in the chain.
+
+	 \return Block size in bytes.
+	 */
+	size_t BlockSize( ) const;
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 \param position Position to set the pointer to.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 \param position Position to set the pointer to.
+	 \param mode Type of seeking pretended.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Tell if the end of file was reached.
+
+	 \return End of buffer reached.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Reset the buffer.
+
+	 All data is wiped and the blocks are kept for reuse.
+	 */
+	void Clear( );
+
+	/*!
+	 \brief Make sure the buffer can append the specified amount of bytes
+	 without allocating.
+
+	 \param size Amount of bytes to make room for.
+	 */
+	void Reserve( size_t size );
+
+	/*!
+	 \brief Return the blocks kept for reuse to the pool.
+	 */
+	void ShrinkToFit( );
+
+	/*!
+	 \brief Remove bytes from the beginning of the buffer.
+
+	 Blocks that become empty are kept for reuse. The read position is
+	 moved back by the amount of removed bytes.
+
+	 \param size Amount of bytes to remove.
+
+	 \return Amount of bytes removed.
+	 */
+	size_t Consume( size_t size );
+
+	/*!
+	 \brief Return the amount of segments GetSegments would return.
+
+	 \return Amount of segments between the read position and the end of
+	 the buffer.
+	 */
+	size_t SegmentCount( ) const;
+
+	/*!
+	 \brief Get the segments between the read position and the end of the
+	 buffer.
+
+	 \param segments Array to store the segments in.
+	 \param count Size of the array.
+
+	 \return Amount of segments stored.
+	 */
+	size_t GetSegments( Segment *segments, size_t count ) const;
+
+	/*!
+	 \brief Get the segments of free space at the end of the buffer.
+
+	 Blocks are added until there is room for the specified amount of bytes.
+	 Data written to the segments becomes part of the buffer after calling
+	 Commit.
+
+	 \param size Amount of bytes to prepare.
+	 \param segments Array to store the segments in.
+	 \param count Size of the array.
+
+	 \return Amount of segments stored.
+
+	 \sa Commit
+	 */
+	size_t PrepareSegments( size_t size, Segment *segments, size_t count );
+
+	/*!
+	 \brief Append bytes previously written to prepared segments.
+
+	 \param size Amount of bytes written, clamped to the free capacity.
+
+	 \sa PrepareSegments
+	 */
+	void Commit( size_t size );
+
+	/*!
+	 \brief Read data from the buffer.
+
+	 \param value Pointer to the buffer to write to.
+	 \param size Amount to read.
+
+	 \return Size in bytes of the read data.
+	 */
+	size_t Read( void *value, size_t size );
+
+	/*!
+	 \brief Append data to the end of the buffer.
+
+	 \param value Pointer to the data to write.
+	 \param size Size of the provided data.
+
+	 \return Size in bytes of the written data.
+	 */
+	size_t Write( const void *value, size_t size );
+
+private:
+	typedef BufferPool::Storage Block;
+
+	void ReleaseBlock( Block &&block );
+
+	BufferPool *block_pool;
+	size_t block_size;
+	std::deque<Block> blocks;
+	std::vector<Block> spare_blocks;
+	size_t head_offset;
+	size_t data_size;
+	size_t read_offset;
+	bool end_of_file;
+};
+
+} // namespace MultiLibrary
@@ -0,0 +1,154 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief Incremental CRC-32C (Castagnoli) checksum.
+
+ Uses the SSE 4.2 CRC32 instruction when the processor supports it and a
+ table driven implementation otherwise.
+ */
+class MULTILIBRARY_COMMON_API CRC32C
+{
+public:
+	/*!
+	 \brief Default constructor.
+	 */
+	CRC32C( );
+
+	/*!
+	 \brief Add data to the checksum.
+
+	 \param data Data to add.
+	 \param size Size of the data.
+	 */
+	void Update( const void *data, size_t size );
+
+	/*!
+	 \brief Get the checksum of the data added so far.
+
+	 \return Checksum value.
+	 */
+	uint32_t Value( ) const;
+
+	/*!
+	 \brief Start over as if no data was added.
+	 */
+	void Reset( );
+
+	/*!
+	 \brief Compute the checksum of a block of data.
+
+	 \param data Data to checksum.
+	 \param size Size of the data.
+
+	 \return Checksum value.
+	 */
+	static uint32_t Compute( const void *data, size_t size );
+
+	/*!
+	 \brief Tell if the hardware accelerated implementation is in use.
+
+	 \return true if SSE 4.2 is used, false otherwise.
+	 */
+	static bool IsAccelerated( );
+
+private:
+	uint32_t state;
+};
+
+/*!
+ \brief Incremental 64 bits non-cryptographic hash (XXH64).
+
+ Meant for fast integrity checks and hash tables, not for security.
+ */
+class MULTILIBRARY_COMMON_API Hash64
+{
+public:
+	/*!
+	 \brief Constructor.
+
+	 \param seed Seed of the hash.
+	 */
+	explicit Hash64( uint64_t seed = 0 );
+
+	/*!
+	 \brief Add data to the hash.
+
+	 \param data Data to add.
+	 \param size Size of the data.
+	 */
+	void Update( const void *data, size_t size );
+
+	/*!
+	 \brief Get the hash of the data added so far.
+
+	 \return Hash value.
+	 */
+	uint64_t Value( ) const;
+
+	/*!
+	 \brief Start over as if no data was added.
+	 */
+	void Reset( );
+
+	/*!
+	 \brief Compute the hash of a block of data.
+
+	 \param data Data to hash.
+	 \param size Size of the data.
+	 \param seed Seed of the hash.
+
+	 \return Hash value.
+	 */
+	static uint64_t Compute( const void *data, size_t size, uint64_t seed = 0 );
+
+private:
+	uint64_t hash_seed;
+	uint64_t accumulators[4];
+	uint8_t pending[32];
+	size_t pending_size;
+	uint64_t total_size;
+};
+
+} // namespace MultiLibrary
@@ -0,0 +1,181 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/OutputStream.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief An output stream adapter that compresses data with the LZ codec.
+
+ Written data is split in blocks that are compressed independently, so
+ memory use is bounded by the block size no matter how much data goes
+ through. Blocks that don't compress are stored as they are. The stream is
+ terminated when Finish is called or this object is destroyed.
+
+ The wrapped stream must outlive this object.
+
+ \sa DecompressingInputStream, LZ
+ */
+class MULTILIBRARY_COMMON_API CompressingOutputStream : public OutputStream, public NonCopyable
+{
+public:
+	/*!
+	 \brief Default size of uncompressed blocks, in bytes.
+	 */
+	static const size_t DEFAULT_BLOCK_SIZE = 65536;
+
+	/*!
+	 \brief Biggest size of uncompressed blocks, in bytes.
+	 */
+	static const size_t MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+
+	/*!
+	 \brief Constructor.
+
+	 \param stream Stream to write the compressed data to.
+	 \param block_size Size of uncompressed blocks, clamped to MAX_BLOCK_SIZE.
+	 */
+	explicit CompressingOutputStream( OutputStream &stream, size_t block_size = DEFAULT_BLOCK_SIZE );
+
+	/*!
+	 \brief Destructor.
+
+	 Terminates the compressed stream.
+
+	 \sa Finish
+	 */
+	~CompressingOutputStream( );
+
+	/*!
+	 \brief Tell if data can still be written.
+
+	 \return false if the stream was finished or the wrapped stream failed,
+	 true otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Compressed streams can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Compressed streams can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Return the amount of uncompressed data written so far.
+
+	 \return Amount of uncompressed bytes.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the amount of uncompressed data written so far.
+
+	 \return Amount of uncompressed bytes.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Output streams never reach end of file.
+
+	 \return Always false.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Write data to the stream.
+
+	 \param data Data to write.
+	 \param size Size of the data.
+
+	 \return Amount of bytes accepted, 0 if the stream is no longer valid.
+	 */
+	size_t Write( const void *data, size_t size );
+
+	/*!
+	 \brief Compress and write the pending partial block.
+
+	 Flushing often hurts the compression ratio.
+
+	 \return true if it succeeds, false otherwise.
+	 */
+	bool Flush( );
+
+	/*!
+	 \brief Flush pending data and terminate the compressed stream.
+
+	 Nothing can be written afterwards.
+
+	 \return true if it succeeds, false otherwise.
+	 */
+	bool Finish( );
+
+	/*!
+	 \brief Return the amount of compressed data written so far.
+
+	 \return Amount of bytes handed to the wrapped stream.
+	 */
+	uint64_t CompressedSize( ) const;
+
+private:
+	bool WriteBlock( );
+	bool WriteThrough( const void *data, size_t size );
+
+	OutputStream &output_stream;
+	std::vector<uint8_t> input_buffer;
+	std::vector<uint8_t> output_buffer;
+	size_t input_used;
+	uint64_t total_in;
+	uint64_t total_out;
+	bool header_written;
+	bool finished;
+	bool failed;
+};
+
+} // namespace MultiLibrary
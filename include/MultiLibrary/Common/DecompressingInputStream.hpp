@@ -0,0 +1,138 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/InputStream.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief An input stream adapter that decompresses data written by
+ CompressingOutputStream.
+
+ Blocks are read and decompressed one at a time, so memory use is bounded
+ by the block size the data was compressed with. Corrupt or truncated
+ input makes the stream invalid instead of producing garbage.
+
+ The wrapped stream must outlive this object.
+
+ \sa CompressingOutputStream, LZ
+ */
+class MULTILIBRARY_COMMON_API DecompressingInputStream : public InputStream, public NonCopyable
+{
+public:
+	/*!
+	 \brief Constructor.
+
+	 \param stream Stream to read the compressed data from.
+	 */
+	explicit DecompressingInputStream( InputStream &stream );
+
+	/*!
+	 \brief Tell if the stream is valid.
+
+	 \return false if the compressed data is corrupt or truncated, true
+	 otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Compressed streams can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Compressed streams can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Return the amount of uncompressed data read so far.
+
+	 \return Amount of uncompressed bytes.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the amount of uncompressed data decoded so far.
+
+	 \return Amount of uncompressed bytes, including the ones not read yet.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the end of the compressed stream was reached.
+
+	 \return true if all data was read, false otherwise.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Read uncompressed data from the stream.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes.
+	 */
+	size_t Read( void *data, size_t size );
+
+private:
+	bool ReadHeader( );
+	bool ReadBlock( );
+	bool ReadExact( void *data, size_t size );
+
+	InputStream &input_stream;
+	std::vector<uint8_t> input_buffer;
+	std::vector<uint8_t> output_buffer;
+	size_t block_size;
+	size_t output_offset;
+	size_t output_used;
+	uint64_t total_out;
+	bool header_read;
+	bool end_of_file;
+	bool errored;
+};
+
+} // namespace MultiLibrary
@@ -0,0 +1,216 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <cstring>
+#include <type_traits>
+
+#if defined _MSC_VER
+
+	#include <stdlib.h>
+
+#endif
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief Values that represent byte orders.
+ */
+enum class Endianness
+{
+	Little, ///< Least significant byte first
+	Big, ///< Most significant byte first
+
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+
+	Native = Big ///< Byte order of the host
+
+#else
+
+	Native = Little ///< Byte order of the host
+
+#endif
+
+};
+
+/*!
+ \brief Reverse the byte order of a 16 bits value.
+
+ \param value Value to swap.
+
+ \return Swapped value.
+ */
+inline uint16_t ByteSwap( uint16_t value )
+{
+
+#if defined _MSC_VER
+
+	return _byteswap_ushort( value );
+
+#else
+
+	return __builtin_bswap16( value );
+
+#endif
+
+}
+
+/*!
+ \brief Reverse the byte order of a 32 bits value.
+
+ \param value Value to swap.
+
+ \return Swapped value.
+
+ \overload
+ */
+inline uint32_t ByteSwap( uint32_t value )
+{
+
+#if defined _MSC_VER
+
+	return _byteswap_ulong( value );
+
+#else
+
+	return __builtin_bswap32( value );
+
+#endif
+
+}
+
+/*!
+ \brief Reverse the byte order of a 64 bits value.
+
+ \param value Value to swap.
+
+ \return Swapped value.
+
+ \overload
+ */
+inline uint64_t ByteSwap( uint64_t value )
+{
+
+#if defined _MSC_VER
+
+	return _byteswap_uint64( value );
+
+#else
+
+	return __builtin_bswap64( value );
+
+#endif
+
+}
+
+namespace Internal
+{
+
+template<size_t Size> struct ByteSwapper;
+
+template<> struct ByteSwapper<1>
+{
+	typedef uint8_t Type;
+
+	static uint8_t Swap( uint8_t value )
+	{
+		return value;
+	}
+};
+
+template<> struct ByteSwapper<2>
+{
+	typedef uint16_t Type;
+
+	static uint16_t Swap( uint16_t value )
+	{
+		return ByteSwap( value );
+	}
+};
+
+template<> struct ByteSwapper<4>
+{
+	typedef uint32_t Type;
+
+	static uint32_t Swap( uint32_t value )
+	{
+		return ByteSwap( value );
+	}
+};
+
+template<> struct ByteSwapper<8>
+{
+	typedef uint64_t Type;
+
+	static uint64_t Swap( uint64_t value )
+	{
+		return ByteSwap( value );
+	}
+};
+
+}
+
+/*!
+ \brief Convert a value between the host byte order and the specified one.
+
+ The conversion is symmetric, so the same function is used to encode and
+ decode values.
+
+ \tparam Type Arithmetic or enumeration type of the value.
+ \param value Value to convert.
+ \param endianness Byte order to convert from/to.
+
+ \return Converted value.
+ */
+template<typename Type>
+inline Type ConvertEndianness( Type value, Endianness endianness )
+{
+	static_assert( std::is_arithmetic<Type>::value || std::is_enum<Type>::value, "only arithmetic and enumeration types can be converted" );
+
+	if( endianness == Endianness::Native )
+		return value;
+
+	typedef Internal::ByteSwapper<sizeof( Type )> Swapper;
+	typename Swapper::Type temp;
+	std::memcpy( &temp, &value, sizeof( temp ) );
+	temp = Swapper::Swap( temp );
+	std::memcpy( &value, &temp, sizeof( temp ) );
+	return value;
+}
+
+} // namespace MultiLibrary
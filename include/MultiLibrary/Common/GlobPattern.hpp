@@ -0,0 +1,174 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/StringView.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A wildcard pattern compiled once and matched in linear time.
+
+ The pattern is compiled into a bit-parallel automaton, so matching never
+ backtracks no matter how many wildcards it has. Patterns and names are
+ UTF-8 and matched per codepoint. Supported syntax:
+
+ - ? matches any codepoint except /
+ - * matches any sequence of codepoints without /
+ - ** matches any sequence of codepoints, including /, and when followed by
+   a / both may match nothing at all, so a/ ** /b (without spaces) matches a/b
+ - [abc], [a-z] and [!a-z] (or [^a-z]) match one codepoint of a class,
+   never /
+ - \\ makes the next codepoint literal
+
+ A [ without a matching ] is a literal. Literal text at the beginning and
+ end of the pattern is checked first to reject most names quickly.
+ */
+class MULTILIBRARY_COMMON_API GlobPattern
+{
+public:
+	/*!
+	 \brief Default constructor.
+
+	 Creates a pattern that only matches empty names.
+	 */
+	GlobPattern( );
+
+	/*!
+	 \brief Compile a pattern.
+
+	 \param pattern Wildcard pattern to compile.
+
+	 \overload
+	 */
+	explicit GlobPattern( StringView pattern );
+
+	/*!
+	 \brief Compile a pattern, replacing the current one.
+
+	 \param pattern Wildcard pattern to compile.
+	 */
+	void Compile( StringView pattern );
+
+	/*!
+	 \brief Return the pattern this object was compiled from.
+
+	 \return Source pattern.
+	 */
+	const std::string &GetPattern( ) const;
+
+	/*!
+	 \brief Tell if the pattern has any wildcards.
+
+	 \return true if the pattern is a plain string, false otherwise.
+	 */
+	bool IsLiteral( ) const;
+
+	/*!
+	 \brief Match a name against the pattern.
+
+	 \param name Name to match.
+
+	 \return true if the whole name matches, false otherwise.
+	 */
+	bool Match( StringView name ) const;
+
+	/*!
+	 \brief Match a batch of names against the pattern.
+
+	 \param names Array of names to match.
+	 \param count Amount of names.
+	 \param results Array receiving the result of each match.
+
+	 \return Amount of names that matched.
+
+	 \overload
+	 */
+	size_t Match( const StringView *names, size_t count, bool *results ) const;
+
+	/*!
+	 \brief Remove the names which don't match the pattern.
+
+	 The order of the remaining names is kept.
+
+	 \param names Names to filter.
+
+	 \return Amount of names left.
+	 */
+	size_t Filter( std::vector<std::string> &names ) const;
+
+private:
+	enum class TokenType
+	{
+		Literal,
+		Any,
+		Class,
+		Star,
+		GlobStar
+	};
+
+	struct Token
+	{
+		TokenType type;
+		uint32_t codepoint;
+		bool negated;
+		std::vector<uint32_t> ranges;
+	};
+
+	bool TokenMatches( const Token &token, uint32_t codepoint ) const;
+	void BuildMasks( uint32_t codepoint, uint64_t *accept, uint64_t *loop ) const;
+	bool MatchMiddle( const char *begin, const char *end ) const;
+
+	std::string source_pattern;
+	std::vector<Token> tokens;
+	std::string literal_prefix;
+	std::string literal_suffix;
+	size_t prefix_tokens;
+	size_t suffix_tokens;
+	bool literal;
+	size_t words;
+	std::vector<uint64_t> ascii_accept;
+	std::vector<uint64_t> ascii_loop;
+	std::vector<uint64_t> star_mask;
+	std::vector<uint64_t> skip_mask;
+};
+
+} // namespace MultiLibrary
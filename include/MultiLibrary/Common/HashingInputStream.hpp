@@ -0,0 +1,154 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/InputStream.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <MultiLibrary/Common/Checksum.hpp>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A pass-through input stream that checksums the data read from another
+ stream.
+
+ The CRC-32C and 64 bits hash are updated over the caller's buffer as data
+ goes through, without extra copies or a second pass. Seeking isn't
+ supported since it would break the running checksums.
+
+ The wrapped stream must outlive this object.
+
+ \sa CRC32C, Hash64
+ */
+class MULTILIBRARY_COMMON_API HashingInputStream : public InputStream, public NonCopyable
+{
+public:
+	/*!
+	 \brief Constructor.
+
+	 \param stream Stream to tap.
+	 \param seed Seed of the 64 bits hash.
+	 */
+	explicit HashingInputStream( InputStream &stream, uint64_t seed = 0 );
+
+	/*!
+	 \brief Tell if the wrapped stream is valid.
+
+	 \return true if the wrapped stream is valid, false otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Hashing streams can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Hashing streams can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Return the current position of the wrapped stream.
+
+	 \return Current position.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the size of the wrapped stream.
+
+	 \return Size of the wrapped stream.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the wrapped stream reached end of file.
+
+	 \return End of file state of the wrapped stream.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Read data through the wrapped stream, updating the checksums.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes.
+	 */
+	size_t Read( void *data, size_t size );
+
+	/*!
+	 \brief Get the CRC-32C of the data read so far.
+
+	 \return Checksum value.
+	 */
+	uint32_t GetCRC32C( ) const;
+
+	/*!
+	 \brief Get the 64 bits hash of the data read so far.
+
+	 \return Hash value.
+	 */
+	uint64_t GetHash64( ) const;
+
+	/*!
+	 \brief Get the amount of data read so far.
+
+	 \return Amount of checksummed bytes.
+	 */
+	uint64_t GetSize( ) const;
+
+	/*!
+	 \brief Restart the checksums from the current position.
+	 */
+	void Reset( );
+
+private:
+	InputStream &input_stream;
+	CRC32C crc32c;
+	Hash64 hash64;
+	uint64_t hashed_size;
+};
+
+} // namespace MultiLibrary
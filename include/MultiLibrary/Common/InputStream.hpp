@@ -160,6 +160,17 @@ public:
 	 \overload
 	 */
 	InputStream &operator>>( std::wstring &data );
+
+protected:
+	/*!
+	 \brief Read a '\0' or '\n' terminated string, consuming the terminator.
+
+	 Used by the string extraction operator. The default implementation
+	 reads byte by byte, buffered streams can scan their data instead.
+
+	 \param data String to append the data to.
+	 */
+	virtual void ExtractString( std::string &data );
 };
 
 } // namespace MultiLibrary
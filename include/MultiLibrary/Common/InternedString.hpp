@@ -0,0 +1,177 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/StringView.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace MultiLibrary
+{
+
+namespace Internal
+{
+
+struct InternedStringEntry
+{
+	size_t hash;
+	size_t size;
+	const char *data;
+};
+
+} // namespace Internal
+
+/*!
+ \brief An immutable string stored once in a global intern table.
+
+ Equal strings share the same storage, so copies are pointer sized,
+ equality checks are O(1) and the hash is computed only once. Interned
+ strings are never released, which makes this class suited for names that
+ are repeated a lot, like header fields or path components.
+
+ The intern table can be used concurrently from any thread.
+ */
+class MULTILIBRARY_COMMON_API InternedString
+{
+public:
+	/*!
+	 \brief Default constructor.
+
+	 Creates an empty string.
+	 */
+	InternedString( );
+
+	/*!
+	 \brief Intern a sequence of characters.
+
+	 \param str Characters to intern.
+
+	 \overload
+	 */
+	explicit InternedString( StringView str );
+
+	/*!
+	 \brief Return pointer to the characters of the string.
+
+	 \return Pointer to the null terminated characters.
+	 */
+	const char *Data( ) const;
+
+	/*!
+	 \brief Return the size of the string.
+
+	 \return Amount of characters, not counting the null terminator.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the string is empty.
+
+	 \return true if the string has no characters, false otherwise.
+	 */
+	bool Empty( ) const;
+
+	/*!
+	 \brief Return the hash of the string, computed when interned.
+
+	 \return Hash of the string.
+	 */
+	size_t GetHash( ) const;
+
+	/*!
+	 \brief Return a view of the string.
+
+	 The view is valid for the lifetime of the program.
+
+	 \return View of the characters of the string.
+	 */
+	StringView GetView( ) const;
+
+	/*!
+	 \brief Copy the string into a standard string.
+
+	 \return Copy of the characters.
+	 */
+	std::string ToString( ) const;
+
+	/*!
+	 \brief Compare with another interned string in O(1).
+
+	 \param str String to compare with.
+
+	 \return true if both strings are equal, false otherwise.
+	 */
+	bool operator==( const InternedString &str ) const;
+
+	/*!
+	 \brief Compare with another interned string in O(1).
+
+	 \param str String to compare with.
+
+	 \return true if the strings are different, false otherwise.
+	 */
+	bool operator!=( const InternedString &str ) const;
+
+	/*!
+	 \brief Return the amount of strings in the intern table.
+
+	 \return Amount of distinct strings interned so far.
+	 */
+	static size_t GetInternedCount( );
+
+private:
+	const Internal::InternedStringEntry *entry;
+};
+
+#include <MultiLibrary/Common/InternedString.inl>
+
+} // namespace MultiLibrary
+
+namespace std
+{
+
+template<>
+struct hash<MultiLibrary::InternedString>
+{
+	size_t operator()( const MultiLibrary::InternedString &str ) const
+	{
+		return str.GetHash( );
+	}
+};
+
+} // namespace std
@@ -0,0 +1,99 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief Fast LZ77 family block codec.
+
+ Blocks are encoded as sequences of literals followed by back references of
+ at least 4 bytes into the previous 64 kilobytes, favoring speed over
+ compression ratio. Each block is independent from the others.
+
+ \sa CompressingOutputStream, DecompressingInputStream
+ */
+namespace LZ
+{
+
+/*!
+ \brief Calculate the biggest possible size of a compressed block.
+
+ \param size Size of the uncompressed data.
+
+ \return Size the destination buffer needs to always fit the compressed data.
+ */
+MULTILIBRARY_COMMON_API size_t CompressBound( size_t size );
+
+/*!
+ \brief Compress a block of data.
+
+ \param source Data to compress.
+ \param source_size Size of the data to compress.
+ \param destination Buffer to store the compressed data.
+ \param destination_size Size of the destination buffer.
+
+ \return Size of the compressed data, 0 if it doesn't fit the destination.
+
+ \sa CompressBound
+ */
+MULTILIBRARY_COMMON_API size_t Compress( const void *source, size_t source_size, void *destination, size_t destination_size );
+
+/*!
+ \brief Decompress a block of data.
+
+ The compressed data is fully validated, corrupt input never reads or
+ writes out of bounds.
+
+ \param source Data to decompress.
+ \param source_size Size of the data to decompress.
+ \param destination Buffer to store the decompressed data.
+ \param destination_size Size of the destination buffer.
+ \param decompressed_size Where to store the size of the decompressed data.
+
+ \return true if the data was decompressed, false if it's corrupt or
+ doesn't fit the destination.
+ */
+MULTILIBRARY_COMMON_API bool Decompress( const void *source, size_t source_size, void *destination, size_t destination_size, size_t &decompressed_size );
+
+} // namespace LZ
+
+} // namespace MultiLibrary
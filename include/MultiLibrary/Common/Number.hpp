@@ -0,0 +1,164 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief Locale independent conversions between numbers and text.
+
+ Integers are written in decimal. Floating point numbers are written with
+ the shortest amount of digits that parses back to the same value, using
+ scientific notation (like 1.5e-7 or 1e300) only for very small or big
+ values, and as inf, -inf and nan when not finite. Nothing is allocated.
+ */
+namespace Number
+{
+
+/*!
+ \brief Size of a buffer big enough for any formatted integer.
+ */
+static const size_t max_integer_length = 20;
+
+/*!
+ \brief Size of a buffer big enough for any formatted floating point number.
+ */
+static const size_t max_float_length = 32;
+
+/*!
+ \brief Write an integer as text.
+
+ \param value Value to write.
+ \param buffer Buffer with room for at least max_integer_length characters.
+
+ \return Amount of characters written, no null terminator is written.
+ */
+MULTILIBRARY_COMMON_API size_t Format( int32_t value, char *buffer );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API size_t Format( uint32_t value, char *buffer );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API size_t Format( int64_t value, char *buffer );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API size_t Format( uint64_t value, char *buffer );
+
+/*!
+ \brief Write a floating point number as text, with the shortest amount of
+ digits that round trips.
+
+ \param value Value to write.
+ \param buffer Buffer with room for at least max_float_length characters.
+
+ \return Amount of characters written, no null terminator is written.
+
+ \overload
+ */
+MULTILIBRARY_COMMON_API size_t Format( float value, char *buffer );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API size_t Format( double value, char *buffer );
+
+/*!
+ \brief Read an integer from text.
+
+ Accepts an optional sign followed by decimal digits. Leading whitespace is
+ not skipped.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+ \param value Output value, only modified on success.
+
+ \return Pointer to one past the last character used, or nullptr if the
+ input doesn't start with a number or the number is out of range.
+ */
+MULTILIBRARY_COMMON_API const char *Parse( const char *begin, const char *end, int32_t &value );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API const char *Parse( const char *begin, const char *end, uint32_t &value );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API const char *Parse( const char *begin, const char *end, int64_t &value );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API const char *Parse( const char *begin, const char *end, uint64_t &value );
+
+/*!
+ \brief Read a floating point number from text, correctly rounded.
+
+ Accepts an optional sign, digits with an optional decimal point and an
+ optional exponent, as well as inf, infinity and nan in any case. Values
+ too big for the type become infinite.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+ \param value Output value, only modified on success.
+
+ \return Pointer to one past the last character used, or nullptr if the
+ input doesn't start with a number.
+
+ \overload
+ */
+MULTILIBRARY_COMMON_API const char *Parse( const char *begin, const char *end, float &value );
+
+/*!
+ \overload
+ */
+MULTILIBRARY_COMMON_API const char *Parse( const char *begin, const char *end, double &value );
+
+} // namespace Number
+
+} // namespace MultiLibrary
@@ -67,6 +67,16 @@ enum class Output
 class MULTILIBRARY_COMMON_API Pipe : public IOStream, public NonCopyable
 {
 public:
+	/*!
+	 \brief How reads and writes wait for the pipe to be ready.
+	 */
+	enum class Mode
+	{
+		Blocking,
+		NonBlocking,
+		Deadline
+	};
+
 	Pipe( Standard::Input in, Standard::Output out );
 
 	/*!
@@ -124,22 +134,68 @@ public:
 	/*!
 	 \brief Return whether we reached end of file or not.
 
+	 End of file is reached once a read finds the write end closed, or when
+	 there's no read handle. It tells apart the 0 returned by Read at end of
+	 file from the one returned on timeouts and errors.
+
 	 \return true if we reached end of file, false otherwise.
 	 */
 	bool EndOfFile( ) const;
 
 	/*!
-	 \brief Reads the specified amount of bytes into the provided buffer.
+	 \brief Set how reads and writes wait for the pipe to be ready.
+
+	 Pipes start in Blocking mode. NonBlocking never waits and only transfers
+	 what can be done right away. Deadline waits up to the timeout, which
+	 applies to each call of Read and Write and to the whole transfer of
+	 ReadAll and WriteAll.
+
+	 \param mode Waiting mode.
+	 \param timeout Timeout in milliseconds, only used in Deadline mode.
+	 */
+	void SetMode( Mode mode, uint32_t timeout = 0 );
+
+	/*!
+	 \brief Get the waiting mode.
+
+	 \return Waiting mode.
+	 */
+	Mode GetMode( ) const;
+
+	/*!
+	 \brief Get the timeout used in Deadline mode.
+
+	 \return Timeout in milliseconds.
+	 */
+	uint32_t GetTimeout( ) const;
+
+	/*!
+	 \brief Reads up to the specified amount of bytes into the provided buffer,
+	 waiting for data according to the mode.
 
 	 \param data Buffer to store the data.
 	 \param size Size of the buffer.
 
-	 \return Amount of read bytes.
+	 \return Amount of read bytes, 0 on timeout, error or end of file.
+
+	 \sa EndOfFile
 	 */
 	size_t Read( void *data, size_t size );
 
 	/*!
-	 \brief Writes the specified amount of bytes from the provided buffer.
+	 \brief Reads until the buffer is filled, the other end is closed or the
+	 mode stops waiting.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes.
+	 */
+	size_t ReadAll( void *data, size_t size );
+
+	/*!
+	 \brief Writes up to the specified amount of bytes from the provided
+	 buffer, waiting for room according to the mode.
 
 	 \param data Data to write.
 	 \param size Size of the data.
@@ -148,6 +204,17 @@ public:
 	 */
 	size_t Write( const void *data, size_t size );
 
+	/*!
+	 \brief Writes until all of the data is written, the other end is closed
+	 or the mode stops waiting.
+
+	 \param data Data to write.
+	 \param size Size of the data.
+
+	 \return Amount of written bytes.
+	 */
+	size_t WriteAll( const void *data, size_t size );
+
 	void CloseRead( );
 	void CloseWrite( );
 
@@ -158,6 +225,12 @@ public:
 private:
 	std::unique_ptr<Handle> read_handle;
 	std::unique_ptr<Handle> write_handle;
+	Mode mode;
+	uint32_t timeout;
+	bool end_of_file;
+
+	friend class TransferEndpoint;
+	friend class ProcessGroup;
 };
 
 } // namespace MultiLibrary
@@ -38,6 +38,7 @@
 #include <MultiLibrary/Common/Export.hpp>
 #include <MultiLibrary/Common/NonCopyable.hpp>
 #include <MultiLibrary/Common/Pipe.hpp>
+#include <MultiLibrary/Common/ProcessBuilder.hpp>
 #include <string>
 #include <vector>
 #include <memory>
@@ -59,6 +60,22 @@ public:
 		Killed
 	};
 
+	/*!
+	 \brief Resources used by a process.
+	 */
+	struct Usage
+	{
+		uint64_t user_time; ///< Microseconds spent running in user mode
+		uint64_t system_time; ///< Microseconds spent running in kernel mode
+		uint64_t max_resident_size; ///< Peak resident set size, in bytes
+		uint64_t minor_faults; ///< Page faults served without I/O
+		uint64_t major_faults; ///< Page faults that needed I/O
+		uint64_t voluntary_switches; ///< Context switches from waiting for something
+		uint64_t involuntary_switches; ///< Context switches from being preempted
+		uint64_t read_bytes; ///< Bytes read from storage
+		uint64_t written_bytes; ///< Bytes written to storage
+	};
+
 	/*!
 	 \brief Constructor.
 
@@ -67,6 +84,13 @@ public:
 	 */
 	Process( const std::string &path, const std::vector<std::string> &args = std::vector<std::string>( ) );
 
+	/*!
+	 \brief Constructor.
+
+	 \param builder Description of how to launch the process.
+	 */
+	Process( const ProcessBuilder &builder );
+
 	/*!
 	 \brief Destructor.
 
@@ -128,13 +152,35 @@ public:
 	 */
 	int32_t ExitCode( ) const;
 
+	/*!
+	 \brief Update the resource usage with the counters of the running
+	 process.
+
+	 Not every counter is available on every system, those stay at 0.
+
+	 \return true if it succeeds, false if the process isn't running or it
+	 isn't supported.
+	 */
+	bool SampleUsage( );
+
+	/*!
+	 \brief Get the resources used by the process.
+
+	 \return Counters from the last SampleUsage, or the final ones once the
+	 process is closed.
+	 */
+	const Usage &GetUsage( ) const;
+
 private:
 	class Handle;
 	std::unique_ptr<Handle> process;
 	int32_t exit_code;
+	Usage usage;
 	Pipe input_pipe;
 	Pipe output_pipe;
 	Pipe error_pipe;
+
+	friend class ProcessGroup;
 };
 
 } // namespace MultiLibrary
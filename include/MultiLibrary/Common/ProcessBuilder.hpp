@@ -0,0 +1,223 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+class SharedChannel;
+
+/*!
+ \brief Describes how to launch a Process.
+
+ On POSIX systems processes are launched with posix_spawn, which doesn't copy
+ the page tables of the parent like fork does.
+ */
+class MULTILIBRARY_COMMON_API ProcessBuilder
+{
+public:
+
+#if defined _WIN32
+
+	typedef uintptr_t Descriptor;
+
+#else
+
+	typedef int Descriptor;
+
+#endif
+
+	/*!
+	 \brief Where a standard stream of the process goes.
+	 */
+	enum class Redirection
+	{
+		Pipe, ///< To the matching pipe of the Process
+		Inherit, ///< To the same stream of the parent
+		Null ///< To the null device
+	};
+
+	/*!
+	 \brief Constructor.
+
+	 \param executable Executable path.
+	 */
+	ProcessBuilder( const std::string &executable );
+
+	/*!
+	 \brief Add an argument for the executable.
+
+	 \param argument Argument to add.
+
+	 \return This object.
+	 */
+	ProcessBuilder &AddArgument( const std::string &argument );
+
+	/*!
+	 \brief Add arguments for the executable.
+
+	 \param arguments Arguments to add.
+
+	 \return This object.
+	 */
+	ProcessBuilder &AddArguments( const std::vector<std::string> &arguments );
+
+	/*!
+	 \brief Set an environment variable for the process.
+
+	 \param name Name of the variable.
+	 \param value Value of the variable.
+
+	 \return This object.
+	 */
+	ProcessBuilder &SetEnvironment( const std::string &name, const std::string &value );
+
+	/*!
+	 \brief Remove an environment variable inherited from the parent.
+
+	 \param name Name of the variable.
+
+	 \return This object.
+	 */
+	ProcessBuilder &UnsetEnvironment( const std::string &name );
+
+	/*!
+	 \brief Stop inheriting the environment of the parent, only variables
+	 set with SetEnvironment are passed.
+
+	 \return This object.
+	 */
+	ProcessBuilder &ClearEnvironment( );
+
+	/*!
+	 \brief Set the working directory of the process.
+
+	 On Linux this needs glibc 2.29 or newer, launching the process throws
+	 std::system_error with other C libraries.
+
+	 \param path Working directory, the one of the parent if empty.
+
+	 \return This object.
+	 */
+	ProcessBuilder &SetWorkingDirectory( const std::string &path );
+
+	/*!
+	 \brief Pass a descriptor of the parent to the process.
+
+	 Descriptors aren't inherited unless mapped, besides the standard
+	 streams. On Windows the handle is only made inheritable while the
+	 process is created, and keeps its value in the process.
+
+	 \param parent Descriptor in the parent.
+	 \param child Descriptor number in the process.
+
+	 \return This object.
+	 */
+	ProcessBuilder &MapDescriptor( Descriptor parent, Descriptor child );
+
+	/*!
+	 \brief Pass a shared channel to the process.
+
+	 The descriptor keeps its number in the process and is stored in an
+	 environment variable, which the process gives to the SharedChannel
+	 constructor. The channel must exist until the process is launched, which
+	 tells the channel which process is on the other side.
+
+	 \param channel Channel to pass.
+	 \param variable Name of the environment variable.
+
+	 \return This object.
+	 */
+	ProcessBuilder &ShareChannel( const SharedChannel &channel, const std::string &variable );
+
+	/*!
+	 \brief Set where the standard input of the process comes from.
+
+	 \param redirection Where it comes from, the input pipe by default.
+
+	 \return This object.
+	 */
+	ProcessBuilder &SetInput( Redirection redirection );
+
+	/*!
+	 \brief Set where the standard output of the process goes.
+
+	 \param redirection Where it goes, the output pipe by default.
+
+	 \return This object.
+	 */
+	ProcessBuilder &SetOutput( Redirection redirection );
+
+	/*!
+	 \brief Set where the standard error output of the process goes.
+
+	 \param redirection Where it goes, the error pipe by default.
+
+	 \return This object.
+	 */
+	ProcessBuilder &SetError( Redirection redirection );
+
+	/*!
+	 \brief Get the environment the process will get, as NAME=value entries.
+
+	 \return Environment of the process.
+	 */
+	std::vector<std::string> BuildEnvironment( ) const;
+
+private:
+	std::string path;
+	std::vector<std::string> arguments;
+	std::map<std::string, std::string> environment;
+	std::set<std::string> removed_environment;
+	bool inherit_environment;
+	std::string working_directory;
+	std::vector<std::pair<Descriptor, Descriptor>> descriptors;
+	std::vector<const SharedChannel *> channels;
+	Redirection input;
+	Redirection output;
+	Redirection error;
+
+	friend class Process;
+};
+
+} // namespace MultiLibrary
@@ -0,0 +1,161 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <MultiLibrary/Common/Process.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief Waits on the output and exit of many processes from a single thread.
+
+ Uses epoll and pidfd (or SIGCHLD when pidfd isn't available) on Linux,
+ kqueue on Mac OS X and polling on Windows. Notifications are handed to the
+ callback of their process or queued until retrieved with Next.
+ */
+class MULTILIBRARY_COMMON_API ProcessGroup : public NonCopyable
+{
+public:
+	/*!
+	 \brief What a notification is about.
+	 */
+	enum class Event
+	{
+		Output, ///< Data was read from the output pipe
+		Error, ///< Data was read from the error pipe
+		Exit ///< The process exited and was closed
+	};
+
+	/*!
+	 \brief Something that happened to a process of the group.
+	 */
+	struct Notification
+	{
+		Process *process; ///< Process it happened to
+		Event event; ///< What happened
+		std::vector<uint8_t> data; ///< Data that was read, empty for Event::Exit
+		int32_t exit_code; ///< Exit code, only set for Event::Exit
+	};
+
+	typedef std::function<void( const Notification &notification )> Callback;
+
+	/*!
+	 \brief Timeout that makes Wait block until something happens.
+	 */
+	static const uint32_t WAIT_FOREVER = 0xFFFFFFFF;
+
+	/*!
+	 \brief Constructor.
+	 */
+	ProcessGroup( );
+
+	/*!
+	 \brief Destructor.
+
+	 Processes still in the group are removed, not closed.
+	 */
+	~ProcessGroup( );
+
+	/*!
+	 \brief Add a process to the group.
+
+	 The process must stay alive until it exits or is removed. It's removed
+	 automatically after its Event::Exit notification, all of its output is
+	 delivered before that.
+
+	 \param process Process to add.
+	 \param callback Function to call with its notifications, they're queued
+	 if this is empty.
+
+	 \return true if it succeeds, false if the process isn't running or is
+	 already in the group.
+	 */
+	bool Add( Process &process, const Callback &callback = Callback( ) );
+
+	/*!
+	 \brief Remove a process from the group, without closing it.
+
+	 \param process Process to remove.
+
+	 \return true if it was in the group, false otherwise.
+	 */
+	bool Remove( Process &process );
+
+	/*!
+	 \brief Get the amount of processes in the group.
+
+	 \return Amount of processes.
+	 */
+	size_t Count( ) const;
+
+	/*!
+	 \brief Wait for something to happen to the processes of the group and
+	 dispatch the notifications.
+
+	 \param timeout Milliseconds to wait at most.
+
+	 \return Amount of notifications produced.
+	 */
+	size_t Wait( uint32_t timeout = WAIT_FOREVER );
+
+	/*!
+	 \brief Take the oldest queued notification.
+
+	 \param notification Where to store the notification.
+
+	 \return true if there was one, false otherwise.
+	 */
+	bool Next( Notification &notification );
+
+	/*!
+	 \brief Get the amount of queued notifications.
+
+	 \return Amount of queued notifications.
+	 */
+	size_t Pending( ) const;
+
+private:
+	class Reactor;
+	std::unique_ptr<Reactor> reactor;
+};
+
+} // namespace MultiLibrary
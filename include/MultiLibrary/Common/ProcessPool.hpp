@@ -0,0 +1,167 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <MultiLibrary/Common/InputStream.hpp>
+#include <MultiLibrary/Common/OutputStream.hpp>
+#include <MultiLibrary/Common/Process.hpp>
+#include <MultiLibrary/Common/ProcessBuilder.hpp>
+#include <MultiLibrary/Common/ProcessGroup.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief Keeps worker processes alive and hands them requests.
+
+ Requests and responses are frames made of a 32 bits little endian length
+ followed by that many bytes, sent through the standard input and output of
+ the workers. Workers handle one request at a time, reading it whole before
+ writing the response, and should use ReadFrame and WriteFrame. Workers that
+ exit are restarted, failing the request they were handling. Workers that
+ keep exiting right after starting are restarted with a growing delay.
+
+ All the work happens on the thread calling Wait.
+ */
+class MULTILIBRARY_COMMON_API ProcessPool : public NonCopyable
+{
+public:
+	/*!
+	 \brief Usage counters of a pool.
+	 */
+	struct Statistics
+	{
+		size_t workers; ///< Workers running
+		size_t busy; ///< Workers handling a request
+		size_t queued; ///< Requests waiting for a worker
+		uint64_t completed; ///< Requests that got a response
+		uint64_t failed; ///< Requests lost to workers that exited
+		uint64_t restarts; ///< Workers started to replace others
+		double average_latency; ///< Milliseconds from Submit to response, on average
+		double max_latency; ///< Longest milliseconds from Submit to response
+		Process::Usage usage; ///< Resources used by every worker so far, max_resident_size is the largest one
+	};
+
+	/*!
+	 \brief Function called with the result of a request.
+
+	 The first argument is false if the worker exited before responding.
+	 */
+	typedef std::function<void( bool success, const std::vector<uint8_t> &response )> Callback;
+
+	/*!
+	 \brief Constructor.
+
+	 \param builder How to launch the workers, their standard input and output
+	 are always redirected to pipes.
+	 \param workers Amount of workers to keep alive.
+	 */
+	ProcessPool( const ProcessBuilder &builder, size_t workers );
+
+	/*!
+	 \brief Destructor.
+
+	 Closes the input of every worker and waits for them to exit. Requests
+	 still pending are dropped without calling their callbacks.
+	 */
+	~ProcessPool( );
+
+	/*!
+	 \brief Queue a request for the next idle worker.
+
+	 Requests bigger than 4 GiB can't be framed and fail on the next Wait.
+
+	 \param data Request data.
+	 \param size Size of the request data.
+	 \param callback Function to call with the response.
+	 */
+	void Submit( const void *data, size_t size, const Callback &callback );
+
+	/*!
+	 \brief Wait for responses and dispatch them.
+
+	 \param timeout Milliseconds to wait at most.
+
+	 \return Amount of requests that finished, successfully or not.
+	 */
+	size_t Wait( uint32_t timeout = ProcessGroup::WAIT_FOREVER );
+
+	/*!
+	 \brief Get the amount of requests queued or being handled.
+
+	 \return Amount of requests.
+	 */
+	size_t Pending( ) const;
+
+	/*!
+	 \brief Get the usage counters of this pool.
+
+	 \return Usage counters.
+	 */
+	Statistics GetStatistics( ) const;
+
+	/*!
+	 \brief Read a frame, for use by workers.
+
+	 \param input Stream to read from, usually the standard input.
+	 \param frame Where to store the frame data.
+
+	 \return true if a whole frame was read, false otherwise.
+	 */
+	static bool ReadFrame( InputStream &input, std::vector<uint8_t> &frame );
+
+	/*!
+	 \brief Write a frame, for use by workers.
+
+	 \param output Stream to write to, usually the standard output.
+	 \param data Frame data.
+	 \param size Size of the frame data.
+
+	 \return true if the whole frame was written, false otherwise.
+	 */
+	static bool WriteFrame( OutputStream &output, const void *data, size_t size );
+
+private:
+	class Workers;
+	std::unique_ptr<Workers> workers;
+};
+
+} // namespace MultiLibrary
@@ -0,0 +1,197 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/IOStream.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <atomic>
+#include <memory>
+
+namespace MultiLibrary
+{
+
+class RingBufferInternal;
+
+/*!
+ \brief A lock-free byte queue between one producer and one consumer thread.
+
+ The capacity is rounded up to a power of two and allocated once. Write
+ must only be called from the producer thread and Read from the consumer
+ thread, both never block and transfer as much as they can. Threads that
+ need to block use WaitForData and WaitForSpace, which sleep on a futex
+ (or a condition variable where futexes aren't available) and cost nothing
+ to the other side while nobody waits.
+ */
+class MULTILIBRARY_COMMON_API RingBuffer : public IOStream, public NonCopyable
+{
+public:
+	/*!
+	 \brief Constructor.
+
+	 \param capacity Minimum capacity, rounded up to a power of two.
+	 */
+	explicit RingBuffer( size_t capacity );
+
+	/*!
+	 \brief Destructor.
+	 */
+	~RingBuffer( );
+
+	/*!
+	 \brief Tell if data can still be read or written.
+
+	 \return false if the buffer was closed and drained, true otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Ring buffers can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Ring buffers can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Return the total amount of data read so far.
+
+	 \return Amount of read bytes.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the amount of data waiting to be read.
+
+	 \return Amount of readable bytes.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the buffer was closed and all data was read.
+
+	 \return true if no more data will ever be readable.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Read data from the buffer, consumer thread only.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes, which may be less than size.
+	 */
+	size_t Read( void *data, size_t size );
+
+	/*!
+	 \brief Write data to the buffer, producer thread only.
+
+	 \param data Data to write.
+	 \param size Size of the data.
+
+	 \return Amount of written bytes, which may be less than size.
+	 */
+	size_t Write( const void *data, size_t size );
+
+	/*!
+	 \brief Wait until some amount of data can be read, consumer thread only.
+
+	 \param size Amount of bytes to wait for, clamped to the capacity.
+	 \param timeout Maximum time to wait, in milliseconds, negative to wait
+	 forever.
+
+	 \return true if the data is readable, false on timeout or if the buffer
+	 was closed first.
+	 */
+	bool WaitForData( size_t size, int32_t timeout = -1 );
+
+	/*!
+	 \brief Wait until some amount of data can be written, producer thread
+	 only.
+
+	 \param size Amount of bytes to wait for, clamped to the capacity.
+	 \param timeout Maximum time to wait, in milliseconds, negative to wait
+	 forever.
+
+	 \return true if there's enough space, false on timeout or if the
+	 buffer was closed first.
+	 */
+	bool WaitForSpace( size_t size, int32_t timeout = -1 );
+
+	/*!
+	 \brief Stop accepting data and wake up every waiting thread.
+
+	 Data already in the buffer can still be read.
+	 */
+	void Close( );
+
+	/*!
+	 \brief Tell if the buffer was closed.
+
+	 \return true if Close was called, false otherwise.
+	 */
+	bool IsClosed( ) const;
+
+	/*!
+	 \brief Get the capacity of the buffer.
+
+	 \return Capacity in bytes.
+	 */
+	size_t Capacity( ) const;
+
+private:
+	// Each side owns a cache line, with a cached copy of the other side's
+	// index so the shared one is only touched when the cache runs out
+	alignas( 64 ) std::atomic<size_t> write_index;
+	size_t cached_read_index;
+
+	alignas( 64 ) std::atomic<size_t> read_index;
+	size_t cached_write_index;
+
+	alignas( 64 ) std::atomic<bool> closed;
+	size_t buffer_mask;
+	std::unique_ptr<uint8_t[]> buffer;
+	std::unique_ptr<RingBufferInternal> ring_internal;
+};
+
+} // namespace MultiLibrary
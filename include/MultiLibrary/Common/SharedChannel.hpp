@@ -0,0 +1,260 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/IOStream.hpp>
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace MultiLibrary
+{
+
+namespace Internal
+{
+
+class SharedMemory;
+
+}
+
+struct SharedChannelRing;
+
+/*!
+ \brief A pair of lock-free byte queues in memory shared between a parent
+ process and a child process.
+
+ The parent creates the channel and passes it to the child with
+ ProcessBuilder::ShareChannel, the child opens it from the environment
+ variable named there. Each side writes to one queue and reads from the
+ other, both never block and transfer as much as they can, like RingBuffer.
+ Data is copied once into the shared memory and can be read in place with
+ Peek and Consume, no system calls are made unless a side waits.
+
+ Waiting sleeps on a futex on Linux. Other systems have no doorbell shared
+ between processes, so waiting polls with short sleeps there. Sides that
+ wait check every 100 milliseconds that the other side is still running, and
+ stop waiting when it's gone. The parent knows the child once it's launched
+ by Process.
+ */
+class MULTILIBRARY_COMMON_API SharedChannel : public IOStream, public NonCopyable
+{
+public:
+
+#if defined _WIN32
+
+	typedef uintptr_t Descriptor;
+
+#else
+
+	typedef int Descriptor;
+
+#endif
+
+	/*!
+	 \brief Constructor, creates a channel.
+
+	 \param capacity Minimum capacity of each queue, rounded up to a power of
+	 two.
+	 */
+	explicit SharedChannel( size_t capacity );
+
+	/*!
+	 \brief Constructor, opens the channel passed by the parent process.
+
+	 \param variable Name of the environment variable given to
+	 ProcessBuilder::ShareChannel.
+	 */
+	explicit SharedChannel( const std::string &variable );
+
+	/*!
+	 \brief Destructor.
+
+	 Closes the channel, so the other side sees the end of the data.
+	 */
+	~SharedChannel( );
+
+	/*!
+	 \brief Tell if data can still be read.
+
+	 \return false if the other side closed the channel and all data was
+	 read, true otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Channels can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Channels can't seek.
+
+	 \return Always false.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Return the total amount of data read so far.
+
+	 \return Amount of read bytes.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the amount of data waiting to be read.
+
+	 \return Amount of readable bytes.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the other side closed the channel and all data was read.
+
+	 \return true if no more data will ever be readable.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Read data sent by the other side.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes, which may be less than size.
+	 */
+	size_t Read( void *data, size_t size );
+
+	/*!
+	 \brief Get the readable data in place, without copying it.
+
+	 The data might wrap around the end of the queue, in which case only the
+	 first part is returned and the rest is available after Consume.
+
+	 \param data Receives the address of the readable data.
+
+	 \return Amount of contiguous readable bytes.
+	 */
+	size_t Peek( const void *&data );
+
+	/*!
+	 \brief Release data obtained with Peek, so its space can be reused.
+
+	 \param size Amount of bytes to release, at most what Peek returned.
+	 */
+	void Consume( size_t size );
+
+	/*!
+	 \brief Send data to the other side.
+
+	 \param data Data to write.
+	 \param size Size of the data.
+
+	 \return Amount of written bytes, which may be less than size.
+	 */
+	size_t Write( const void *data, size_t size );
+
+	/*!
+	 \brief Wait until some amount of data can be read.
+
+	 \param size Amount of bytes to wait for, clamped to the capacity.
+	 \param timeout Maximum time to wait, in milliseconds, negative to wait
+	 forever.
+
+	 \return true if the data is readable, false on timeout or if the other
+	 side closed the channel or exited first.
+	 */
+	bool WaitForData( size_t size, int32_t timeout = -1 );
+
+	/*!
+	 \brief Wait until some amount of data can be written.
+
+	 \param size Amount of bytes to wait for, clamped to the capacity.
+	 \param timeout Maximum time to wait, in milliseconds, negative to wait
+	 forever.
+
+	 \return true if there's enough space, false on timeout or if the
+	 channel was closed or the other side exited first.
+	 */
+	bool WaitForSpace( size_t size, int32_t timeout = -1 );
+
+	/*!
+	 \brief Stop sending data and wake up the other side.
+
+	 Data sent by the other side can still be read.
+	 */
+	void Close( );
+
+	/*!
+	 \brief Get the capacity of each queue.
+
+	 \return Capacity in bytes.
+	 */
+	size_t Capacity( ) const;
+
+	/*!
+	 \brief Get the descriptor of the shared memory.
+
+	 \return Descriptor of the shared memory.
+	 */
+	Descriptor GetDescriptor( ) const;
+
+private:
+	void Attach( bool parent );
+	void SetPeer( uint32_t identifier ) const;
+	bool IsPeerRunning( );
+
+	std::unique_ptr<Internal::SharedMemory> memory;
+	std::atomic<uint32_t> *peer;
+	SharedChannelRing *input;
+	SharedChannelRing *output;
+	uint8_t *input_buffer;
+	uint8_t *output_buffer;
+	size_t buffer_mask;
+
+	// Local copies of the other side's indices, so the shared ones are only
+	// touched when the copies run out
+	uint64_t cached_write_index;
+	uint64_t cached_read_index;
+	bool peer_gone;
+
+	friend class Process;
+};
+
+} // namespace MultiLibrary
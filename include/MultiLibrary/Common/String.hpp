@@ -36,12 +36,17 @@
 #pragma once
 
 #include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/ANSICodec.hpp>
+#include <MultiLibrary/Common/StringView.hpp>
 #include <MultiLibrary/Common/Unicode.hpp>
+#include <memory>
 #include <string>
 
 namespace MultiLibrary
 {
 
+class StringCache;
+
 class MULTILIBRARY_COMMON_API String
 {
 public:
@@ -50,11 +55,13 @@ public:
 	explicit String( const wchar_t *str );
 	explicit String( const std::string &str );
 	explicit String( const std::wstring &str );
-	String( const String &str ) = default;
-	String( String &&str ) = default;
+	String( StringView str, const ANSICodec &codec );
+	String( const String &str );
+	String( String &&str );
+	~String( );
 
-	String &operator=( const String &str ) = default;
-	String &operator=( String &&str ) = default;
+	String &operator=( const String &str );
+	String &operator=( String &&str );
 
 	String &operator+=( const String &str );
 
@@ -70,15 +77,71 @@ public:
 	std::u16string ToUTF16( ) const;
 	std::u32string ToUTF32( ) const;
 
+	// ANSI conversions without a codec use ANSICodec::GetDefault
+	std::string ToANSI( const ANSICodec &codec ) const;
+
+	// These reuse the capacity of the provided string instead of allocating
+	void ToANSI( std::string &str ) const;
+	void ToANSI( std::string &str, const ANSICodec &codec ) const;
+	void ToWideString( std::wstring &str ) const;
+	void ToUTF16( std::u16string &str ) const;
+	void ToUTF32( std::u32string &str ) const;
+
+	StringView GetView( ) const;
+
+	// Amount of codepoints, memoized when caching is enabled
+	size_t Length( ) const;
+
+	// Caching memoizes the length and the last wide, UTF-16 or UTF-32
+	// conversion until the string is modified; a cached String must not be
+	// converted from several threads at once
+	void SetCaching( bool enable );
+	bool IsCaching( ) const;
+
 	operator std::string( ) const;
 	operator std::wstring( ) const;
 
 	// Written by Jack Handy - jakkhandy@hotmail.com
 	// Adapted for C++ (MultiLibrary)
+	// Prefer GlobPattern, which compiles the pattern once and never backtracks
 	static bool WildcardCompare( const std::string &str, const std::string &wildcard );
 
+	// ASCII only case folding, bytes outside of 'A' to 'Z' are copied as they
+	// are; output may be the same buffer as input
+	static void ToLowerASCII( const char *input, size_t size, char *output );
+
+	// ASCII case insensitive comparison and hashing, for names like HTTP
+	// header fields that don't need full Unicode case folding
+	static int CompareCaseInsensitive( StringView left, StringView right );
+	static bool EqualsCaseInsensitive( StringView left, StringView right );
+	static size_t HashCaseInsensitive( StringView str );
+
 private:
 	std::string utf8_string;
+	std::unique_ptr<StringCache> cache;
+};
+
+// Comparators for containers keyed by ASCII case insensitive names, which
+// also accept anything convertible to StringView without building keys
+struct CaseInsensitiveLess
+{
+	typedef void is_transparent;
+
+	bool operator()( StringView left, StringView right ) const;
+};
+
+struct CaseInsensitiveEqual
+{
+	typedef void is_transparent;
+
+	bool operator()( StringView left, StringView right ) const;
+};
+
+struct CaseInsensitiveHash
+{
+	typedef void is_transparent;
+
+	size_t operator()( StringView str ) const;
 };
 
 #include <MultiLibrary/Common/String.inl>
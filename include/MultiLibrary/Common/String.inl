@@ -73,3 +73,18 @@ String String::FromUTF32( Input begin, Input end )
 	UTF8::FromUTF32( begin, end, std::back_inserter( str.utf8_string ) );
 	return str;
 }
+
+inline bool CaseInsensitiveLess::operator()( StringView left, StringView right ) const
+{
+	return String::CompareCaseInsensitive( left, right ) < 0;
+}
+
+inline bool CaseInsensitiveEqual::operator()( StringView left, StringView right ) const
+{
+	return String::EqualsCaseInsensitive( left, right );
+}
+
+inline size_t CaseInsensitiveHash::operator()( StringView str ) const
+{
+	return String::HashCaseInsensitive( str );
+}
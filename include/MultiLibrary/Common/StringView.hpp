@@ -0,0 +1,209 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A non-owning view of a sequence of characters.
+
+ Views never copy the characters they refer to, so the memory must outlive
+ the view. Useful to pass strings around without allocating.
+ */
+class StringView
+{
+public:
+	/*!
+	 \brief Value returned by Find when nothing was found.
+	 */
+	static const size_t npos = static_cast<size_t>( -1 );
+
+	/*!
+	 \brief Default constructor.
+
+	 Creates an empty view.
+	 */
+	StringView( );
+
+	/*!
+	 \brief Create a view of a null terminated string.
+
+	 \param str Null terminated string.
+
+	 \overload
+	 */
+	StringView( const char *str );
+
+	/*!
+	 \brief Create a view of a sequence of characters.
+
+	 \param str Pointer to the first character.
+	 \param size Amount of characters.
+
+	 \overload
+	 */
+	StringView( const char *str, size_t size );
+
+	/*!
+	 \brief Create a view of a standard string.
+
+	 \param str String to view.
+
+	 \overload
+	 */
+	StringView( const std::string &str );
+
+	/*!
+	 \brief Return pointer to the first character of the view.
+
+	 The characters are not necessarily null terminated.
+
+	 \return Pointer to the viewed characters.
+	 */
+	const char *Data( ) const;
+
+	/*!
+	 \brief Return the size of the view.
+
+	 \return Amount of characters covered by the view.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Tell if the view is empty.
+
+	 \return true if the view covers no characters, false otherwise.
+	 */
+	bool Empty( ) const;
+
+	/*!
+	 \brief Return iterator to the first character.
+
+	 \return Pointer to the first character.
+	 */
+	const char *begin( ) const;
+
+	/*!
+	 \brief Return iterator to one past the last character.
+
+	 \return Pointer to one past the last character.
+	 */
+	const char *end( ) const;
+
+	/*!
+	 \brief Access a character of the view.
+
+	 \param index Index of the character, which must be in range.
+
+	 \return Character at the index.
+	 */
+	char operator[]( size_t index ) const;
+
+	/*!
+	 \brief Create a view of a sub-range of this view.
+
+	 The range is clamped to the size of this view.
+
+	 \param offset Offset of the first character.
+	 \param size (optional) Amount of characters the new view covers.
+
+	 \return View of the sub-range.
+	 */
+	StringView Substring( size_t offset, size_t size = npos ) const;
+
+	/*!
+	 \brief Find the first occurrence of a character.
+
+	 \param ch Character to look for.
+	 \param offset (optional) Offset to start looking from.
+
+	 \return Offset of the character or npos if not found.
+	 */
+	size_t Find( char ch, size_t offset = 0 ) const;
+
+	/*!
+	 \brief Tell if the view starts with another sequence.
+
+	 \param str Sequence to compare with.
+
+	 \return true if the view starts with the sequence, false otherwise.
+	 */
+	bool StartsWith( StringView str ) const;
+
+	/*!
+	 \brief Tell if the view ends with another sequence.
+
+	 \param str Sequence to compare with.
+
+	 \return true if the view ends with the sequence, false otherwise.
+	 */
+	bool EndsWith( StringView str ) const;
+
+	/*!
+	 \brief Compare lexicographically with another view.
+
+	 \param str View to compare with.
+
+	 \return Negative, zero or positive if this view is respectively lesser,
+	 equal or greater than the other.
+	 */
+	int Compare( StringView str ) const;
+
+	/*!
+	 \brief Copy the viewed characters into a standard string.
+
+	 \return Copy of the viewed characters.
+	 */
+	std::string ToString( ) const;
+
+	bool operator==( StringView str ) const;
+	bool operator!=( StringView str ) const;
+	bool operator<( StringView str ) const;
+
+private:
+	const char *view_data;
+	size_t view_size;
+};
+
+#include <MultiLibrary/Common/StringView.inl>
+
+} // namespace MultiLibrary
@@ -0,0 +1,139 @@
+/*************************************************************************
+ * MultiLibrary - danielga.bitbucket.org/multilibrary
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *************************************************************************/
+
+inline StringView::StringView( ) :
+	view_data( "" ),
+	view_size( 0 )
+{ }
+
+inline StringView::StringView( const char *str ) :
+	view_data( str ),
+	view_size( std::strlen( str ) )
+{ }
+
+inline StringView::StringView( const char *str, size_t size ) :
+	view_data( str ),
+	view_size( size )
+{ }
+
+inline StringView::StringView( const std::string &str ) :
+	view_data( str.data( ) ),
+	view_size( str.size( ) )
+{ }
+
+inline const char *StringView::Data( ) const
+{
+	return view_data;
+}
+
+inline size_t StringView::Size( ) const
+{
+	return view_size;
+}
+
+inline bool StringView::Empty( ) const
+{
+	return view_size == 0;
+}
+
+inline const char *StringView::begin( ) const
+{
+	return view_data;
+}
+
+inline const char *StringView::end( ) const
+{
+	return view_data + view_size;
+}
+
+inline char StringView::operator[]( size_t index ) const
+{
+	return view_data[index];
+}
+
+inline StringView StringView::Substring( size_t offset, size_t size ) const
+{
+	offset = std::min( offset, view_size );
+	return StringView( view_data + offset, std::min( size, view_size - offset ) );
+}
+
+inline size_t StringView::Find( char ch, size_t offset ) const
+{
+	if( offset >= view_size )
+		return npos;
+
+	const void *found = std::memchr( view_data + offset, ch, view_size - offset );
+	return found != nullptr ? static_cast<size_t>( static_cast<const char *>( found ) - view_data ) : npos;
+}
+
+inline bool StringView::StartsWith( StringView str ) const
+{
+	return str.view_size <= view_size && std::memcmp( view_data, str.view_data, str.view_size ) == 0;
+}
+
+inline bool StringView::EndsWith( StringView str ) const
+{
+	return str.view_size <= view_size && std::memcmp( view_data + view_size - str.view_size, str.view_data, str.view_size ) == 0;
+}
+
+inline int StringView::Compare( StringView str ) const
+{
+	int result = std::memcmp( view_data, str.view_data, std::min( view_size, str.view_size ) );
+	if( result != 0 )
+		return result;
+
+	return view_size < str.view_size ? -1 : ( view_size > str.view_size ? 1 : 0 );
+}
+
+inline std::string StringView::ToString( ) const
+{
+	return std::string( view_data, view_size );
+}
+
+inline bool StringView::operator==( StringView str ) const
+{
+	return view_size == str.view_size && std::memcmp( view_data, str.view_data, view_size ) == 0;
+}
+
+inline bool StringView::operator!=( StringView str ) const
+{
+	return !( *this == str );
+}
+
+inline bool StringView::operator<( StringView str ) const
+{
+	return Compare( str ) < 0;
+}
@@ -0,0 +1,191 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/IOStream.hpp>
+#include <limits>
+
+namespace MultiLibrary
+{
+
+class Pipe;
+
+/*!
+ \brief One end of a Transfer.
+
+ Endpoints made from kernel objects (pipes, files and sockets) let Transfer
+ move data inside the kernel, endpoints made from any other stream are
+ copied through a pooled buffer.
+ */
+class MULTILIBRARY_COMMON_API TransferEndpoint
+{
+public:
+
+#if defined _WIN32
+
+	typedef uintptr_t Descriptor;
+
+#else
+
+	typedef int Descriptor;
+
+#endif
+
+	/*!
+	 \brief Kind of object behind an endpoint.
+	 */
+	enum class Type
+	{
+		Stream,
+		Pipe,
+		File,
+		Socket
+	};
+
+	/*!
+	 \brief Endpoint that reads from a stream.
+
+	 \param stream Stream to read from.
+	 */
+	TransferEndpoint( InputStream &stream );
+
+	/*!
+	 \brief Endpoint that writes to a stream.
+
+	 \param stream Stream to write to.
+	 */
+	TransferEndpoint( OutputStream &stream );
+
+	/*!
+	 \brief Endpoint that reads from or writes to a stream.
+
+	 \param stream Stream to use.
+	 */
+	TransferEndpoint( IOStream &stream );
+
+	/*!
+	 \brief Endpoint that reads from the read end of a pipe when used as a
+	 source and writes to its write end when used as a sink.
+
+	 Kernel transfers always wait like Pipe::Mode::Blocking.
+
+	 \param pipe Pipe to use.
+	 */
+	TransferEndpoint( Pipe &pipe );
+
+	/*!
+	 \brief Endpoint for a regular file.
+
+	 Data is transferred from the current position of the stream, which is
+	 moved past it afterwards.
+
+	 \param file Descriptor of the file.
+	 \param stream Stream that owns the descriptor and tracks its position.
+
+	 \return The endpoint.
+	 */
+	static TransferEndpoint FromFile( Descriptor file, IOStream &stream );
+
+	/*!
+	 \brief Endpoint for a connected stream socket.
+
+	 \param socket Descriptor of the socket.
+
+	 \return The endpoint.
+	 */
+	static TransferEndpoint FromSocket( Descriptor socket );
+
+	/*!
+	 \brief Get the kind of object behind this endpoint.
+
+	 \return Kind of object.
+	 */
+	Type GetType( ) const;
+
+private:
+	TransferEndpoint( Type endpoint_type, Descriptor read, Descriptor write, InputStream *in, OutputStream *out, Stream *positioned );
+
+	Type type;
+	Descriptor read_descriptor;
+	Descriptor write_descriptor;
+	InputStream *input;
+	OutputStream *output;
+	Stream *position;
+
+	friend MULTILIBRARY_COMMON_API size_t Transfer( const TransferEndpoint &source, const TransferEndpoint &sink, size_t size );
+	friend MULTILIBRARY_COMMON_API size_t Tee( Pipe &source, Pipe &sink, size_t size );
+};
+
+/*!
+ \brief Move data from one endpoint to another.
+
+ When both ends are kernel objects the data doesn't go through user space on
+ systems that support it, using splice, sendfile and copy_file_range on
+ Linux. Otherwise it's copied through a buffer from BufferPool::Default.
+
+ A sink whose other end was closed stops the transfer, without raising
+ SIGPIPE.
+
+ Relaying between sockets on Linux consumes data from the source before the
+ sink accepts it. If the sink fails with some of it still in flight, a
+ std::system_error is thrown whose message has the amount of bytes delivered
+ and lost, instead of returning a short count.
+
+ \param source Endpoint to read from.
+ \param sink Endpoint to write to.
+ \param size Maximum amount of bytes to move, everything until the end of
+ the source by default.
+
+ \return Amount of bytes moved.
+ */
+MULTILIBRARY_COMMON_API size_t Transfer( const TransferEndpoint &source, const TransferEndpoint &sink, size_t size = std::numeric_limits<size_t>::max( ) );
+
+/*!
+ \brief Copy data waiting in a pipe into another pipe without consuming it.
+
+ Waits for data like Pipe::Mode::Blocking. Only supported on Linux, where it
+ uses tee, other systems always return 0.
+
+ \param source Pipe to copy from, its data is left in place.
+ \param sink Pipe to copy to.
+ \param size Maximum amount of bytes to copy.
+
+ \return Amount of bytes copied.
+ */
+MULTILIBRARY_COMMON_API size_t Tee( Pipe &source, Pipe &sink, size_t size );
+
+} // namespace MultiLibrary
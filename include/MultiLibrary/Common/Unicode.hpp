@@ -36,7 +36,9 @@
 #pragma once
 
 #include <MultiLibrary/Common/Export.hpp>
+#include <MultiLibrary/Common/ANSICodec.hpp>
 #include <locale>
+#include <string>
 
 namespace MultiLibrary
 {
@@ -50,6 +52,11 @@ namespace UTF8
 /*!
  \brief Decode a single UTF-8 codepoint.
 
+ Overlong encodings, surrogates, codepoints above U+10FFFF and truncated
+ sequences yield the replacement value. Only the maximal ill-formed part of a
+ sequence is consumed, so decoding resumes at the first byte which could start
+ a new one.
+
  \param begin Iterator to the begining of the input.
  \param end Iterator to the end of the input.
  \param output Output Unicode codepoint.
@@ -107,6 +114,23 @@ static size_t Length( Input begin, Input end );
 template<typename Input, typename Output>
 static Output FromANSI( Input begin, Input end, Output out, const std::locale &loc = std::locale( ) );
 
+/*!
+ \brief Decode ANSI input into UTF-8 with a pre-resolved codec.
+
+ Unlike the locale overload, this never touches std::locale.
+
+ \param begin Iterator to the begining of the input.
+ \param end Iterator to the end of the input.
+ \param out Iterator to the begining of the output.
+ \param codec Codec of the input sequence.
+
+ \return Iterator to the end of the output sequence which was written.
+
+ \overload
+ */
+template<typename Input, typename Output>
+static Output FromANSI( Input begin, Input end, Output out, const ANSICodec &codec );
+
 /*!
  \brief Decode wide string input into UTF-8.
 
@@ -157,6 +181,24 @@ static Output FromUTF32( Input begin, Input end, Output out );
 template<typename Input, typename Output>
 static Output ToANSI( Input begin, Input end, Output out, char replace = 0, const std::locale &loc = std::locale( ) );
 
+/*!
+ \brief Encode UTF-8 input into ANSI with a pre-resolved codec.
+
+ Unlike the locale overload, this never touches std::locale.
+
+ \param begin Iterator to the begining of the input.
+ \param end Iterator to the end of the input.
+ \param out Iterator to the begining of the output.
+ \param codec Codec of the output sequence.
+ \param replace (optional) Replacement for codepoints not convertible to ANSI.
+
+ \return Iterator to the end of the output sequence which was written.
+
+ \overload
+ */
+template<typename Input, typename Output>
+static Output ToANSI( Input begin, Input end, Output out, const ANSICodec &codec, char replace = 0 );
+
 /*!
  \brief Encode UTF-8 input into wide string.
 
@@ -194,6 +236,100 @@ static Output ToUTF16( Input begin, Input end, Output out );
 template<typename Input, typename Output>
 static Output ToUTF32( Input begin, Input end, Output out );
 
+/*!
+ \brief Policy for handling invalid UTF-8 sequences.
+ */
+enum class ErrorPolicy
+{
+	Replace,
+	Fail
+};
+
+/*!
+ \brief Find the end of the run of ASCII characters at the begining of the
+ input.
+
+ Vectorized with SSE2 or AVX2, whichever is the best the processor supports.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+
+ \return Pointer to the first non-ASCII byte, or end.
+ */
+MULTILIBRARY_COMMON_API const char *SkipASCII( const char *begin, const char *end );
+
+/*!
+ \brief Check if the input is well formed UTF-8.
+
+ Overlong encodings, surrogates, code points above U+10FFFF and truncated
+ sequences are rejected.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+
+ \return true if the input is valid, false otherwise.
+ */
+MULTILIBRARY_COMMON_API bool Validate( const char *begin, const char *end );
+
+/*!
+ \brief Find the first invalid UTF-8 sequence of the input.
+
+ Runs a DFA over the input in a single pass, skipping runs of ASCII characters
+ with vector instructions.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+
+ \return Pointer to the first byte of the first invalid sequence, or end if the
+ input is valid.
+ */
+MULTILIBRARY_COMMON_API const char *FindInvalid( const char *begin, const char *end );
+
+/*!
+ \brief Append UTF-8 input to a string, validating it on the way.
+
+ With ErrorPolicy::Replace, each maximal ill-formed part of a sequence is
+ appended as U+FFFD. With ErrorPolicy::Fail, nothing is appended if the input
+ is invalid.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+ \param output String to append the input to.
+ \param policy (optional) Policy for invalid sequences.
+ \param error_offset (optional) Receives the offset of the first invalid sequence.
+
+ \return true if the input is valid, false otherwise.
+ */
+MULTILIBRARY_COMMON_API bool Sanitize( const char *begin, const char *end, std::string &output, ErrorPolicy policy = ErrorPolicy::Replace, size_t *error_offset = nullptr );
+
+/*!
+ \brief Convert contiguous UTF-8 input into UTF-16.
+
+ Each maximal ill-formed part of a sequence is replaced by U+FFFD. Runs of
+ ASCII characters are widened with vector instructions.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+ \param out Pointer to the output, with room for at least end - begin units.
+
+ \return Pointer to the end of the output which was written.
+ */
+MULTILIBRARY_COMMON_API char16_t *ConvertToUTF16( const char *begin, const char *end, char16_t *out );
+
+/*!
+ \brief Convert contiguous UTF-8 input into UTF-32.
+
+ Each maximal ill-formed part of a sequence is replaced by U+FFFD. Runs of
+ ASCII characters are widened with vector instructions.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+ \param out Pointer to the output, with room for at least end - begin units.
+
+ \return Pointer to the end of the output which was written.
+ */
+MULTILIBRARY_COMMON_API char32_t *ConvertToUTF32( const char *begin, const char *end, char32_t *out );
+
 } // namespace UTF8
 
 /*!
@@ -349,6 +485,21 @@ static Output ToUTF8( Input begin, Input end, Output out );
 template<typename Input, typename Output>
 static Output ToUTF32( Input begin, Input end, Output out );
 
+/*!
+ \brief Convert contiguous UTF-16 input into UTF-8.
+
+ Unpaired surrogates are replaced by U+FFFD. Runs of ASCII characters are
+ narrowed with vector instructions.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+ \param out Pointer to the output, with room for at least 3 * ( end - begin )
+ bytes.
+
+ \return Pointer to the end of the output which was written.
+ */
+MULTILIBRARY_COMMON_API char *ConvertToUTF8( const char16_t *begin, const char16_t *end, char *out );
+
 } // namespace UTF16
 
 /*!
@@ -504,6 +655,21 @@ static Output ToUTF8( Input begin, Input end, Output out );
 template<typename Input, typename Output>
 static Output ToUTF16( Input begin, Input end, Output out );
 
+/*!
+ \brief Convert contiguous UTF-32 input into UTF-8.
+
+ Surrogates and values above U+10FFFF are replaced by U+FFFD. Runs of ASCII
+ characters are narrowed with vector instructions.
+
+ \param begin Pointer to the begining of the input.
+ \param end Pointer to the end of the input.
+ \param out Pointer to the output, with room for at least 4 * ( end - begin )
+ bytes.
+
+ \return Pointer to the end of the output which was written.
+ */
+MULTILIBRARY_COMMON_API char *ConvertToUTF8( const char32_t *begin, const char32_t *end, char *out );
+
 } // namespace UTF32
 
 #include <MultiLibrary/Common/Unicode.inl>
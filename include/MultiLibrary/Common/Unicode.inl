@@ -40,69 +40,65 @@ namespace UTF8
 template<typename Input>
 static Input Decode( Input begin, Input end, uint32_t &output, uint32_t replace )
 {
-	static const uint32_t offsets[6] = { 0x00000000, 0x00003080, 0x000E2080, 0x03C82080, 0xFA082080, 0x82082080 };
-
 	uint8_t ch = static_cast<uint8_t>( *begin );
+	++begin;
+
 	int trailingBytes = 0;
-	if( ch < 192 )
-		/* do nothing and break if chain */;
-	else if( ch < 224 )
+	uint8_t lower = 0x80, upper = 0xBF;
+	if( ch < 0x80 )
+	{
+		output = ch;
+		return begin;
+	}
+	else if( ch < 0xC2 )
+	{
+		output = replace;
+		return begin;
+	}
+	else if( ch < 0xE0 )
+	{
 		trailingBytes = 1;
-	else if( ch < 240 )
+		output = ch & 0x1Fu;
+	}
+	else if( ch < 0xF0 )
+	{
 		trailingBytes = 2;
-	else if( ch < 248 )
+		output = ch & 0x0Fu;
+		if( ch == 0xE0 )
+			lower = 0xA0;
+		else if( ch == 0xED )
+			upper = 0x9F;
+	}
+	else if( ch < 0xF5 )
+	{
 		trailingBytes = 3;
-	else if( ch < 252 )
-		trailingBytes = 4;
+		output = ch & 0x07u;
+		if( ch == 0xF0 )
+			lower = 0x90;
+		else if( ch == 0xF4 )
+			upper = 0x8F;
+	}
 	else
-		trailingBytes = 5;
+	{
+		output = replace;
+		return begin;
+	}
 
-	if( begin + trailingBytes < end )
+	// Only the second byte has a narrower range, which rules out overlongs,
+	// surrogates and codepoints above U+10FFFF
+	for( ; trailingBytes > 0; --trailingBytes )
 	{
-		output = 0;
-		switch( trailingBytes )
+		uint8_t next = begin != end ? static_cast<uint8_t>( *begin ) : 0;
+		if( next < lower || next > upper )
 		{
-		case 5:
-			output += static_cast<uint8_t>( *begin );
-			++begin;
-			output <<= 6;
-			// fall through
-
-		case 4:
-			output += static_cast<uint8_t>( *begin );
-			++begin;
-			output <<= 6;
-			// fall through
-
-		case 3:
-			output += static_cast<uint8_t>( *begin );
-			++begin;
-			output <<= 6;
-			// fall through
-
-		case 2:
-			output += static_cast<uint8_t>( *begin );
-			++begin;
-			output <<= 6;
-			// fall through
-
-		case 1:
-			output += static_cast<uint8_t>( *begin );
-			++begin;
-			output <<= 6;
-			// fall through
-
-		case 0:
-			output += static_cast<uint8_t>( *begin );
-			++begin;
+			output = replace;
+			return begin;
 		}
 
-		output -= offsets[trailingBytes];
-	}
-	else
-	{
-		begin = end;
-		output = replace;
+		output = output << 6 | ( next & 0x3Fu );
+		lower = 0x80;
+		upper = 0xBF;
+		++begin;
 	}
 
 	return begin;
@@ -113,7 +109,7 @@ static Output Encode( uint32_t input, Output output, uint8_t replace )
 {
 	static const uint8_t firstBytes[7] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC };
 
-	if( input > 0x0010FFFF || ( input >= 0xD800 && input <= 0xDBFF ) )
+	if( input > 0x0010FFFF || ( input >= 0xD800 && input <= 0xDFFF ) )
 	{
 		if( replace )
 		{
@@ -196,6 +192,18 @@ static Output FromANSI( Input begin, Input end, Output out, const std::locale &l
 	return out;
 }
 
+template<typename Input, typename Output>
+static Output FromANSI( Input begin, Input end, Output out, const ANSICodec &codec )
+{
+	while( begin != end )
+	{
+		out = Encode( codec.Widen( *begin ), out );
+		++begin;
+	}
+
+	return out;
+}
+
 template<typename Input, typename Output>
 static Output FromWideString( Input begin, Input end, Output out )
 {
@@ -264,6 +272,27 @@ static Output ToANSI( Input begin, Input end, Output out, char replace, const st
 	return out;
 }
 
+template<typename Input, typename Output>
+static Output ToANSI( Input begin, Input end, Output out, const ANSICodec &codec, char replace )
+{
+	uint32_t codepoint;
+	while( begin != end )
+	{
+		begin = Decode( begin, end, codepoint );
+
+		// Unmappable codepoints are dropped without a replacement, like
+		// ANSICodec::FromUTF8 does
+		char ch = codec.Narrow( codepoint, replace );
+		if( ch == 0 && codepoint != 0 )
+			continue;
+
+		*out = ch;
+		++out;
+	}
+
+	return out;
+}
+
 template<typename Input, typename Output>
 static Output ToWideString( Input begin, Input end, Output out, wchar_t replace )
 {
@@ -37,6 +37,7 @@
 
 #include <MultiLibrary/Filesystem/Export.hpp>
 #include <MultiLibrary/Common/IOStream.hpp>
+#include <MultiLibrary/Common/Transfer.hpp>
 #include <string>
 #include <set>
 #include <memory>
@@ -74,6 +75,13 @@ public:
 	bool Errored( ) const;
 	bool EndOfFile( ) const;
 
+	/*!
+	 \brief Get an endpoint to use this file with Transfer.
+
+	 \return Endpoint for this file.
+	 */
+	TransferEndpoint GetTransferEndpoint( );
+
 	/*!
 	 \brief Reads the specified amount of bytes into the provided buffer.
 
@@ -0,0 +1,222 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Filesystem/Export.hpp>
+#include <MultiLibrary/Common/IOStream.hpp>
+#include <MultiLibrary/Common/ByteBufferView.hpp>
+#include <string>
+#include <memory>
+
+namespace MultiLibrary
+{
+
+/*!
+ \brief A read-only file mapped into memory.
+
+ The file contents are paged in by the operating system as they are
+ accessed, so big files can be read and seeked without copying them into
+ heap memory. The mapping is shared by every copy of this object and by
+ every view created through Slice, and is released with the last of them.
+ */
+class MULTILIBRARY_FILESYSTEM_API MappedFile : public IOStream
+{
+public:
+	/*!
+	 \brief Values that represent how the mapped data is expected to be
+	 accessed.
+	 */
+	enum class AccessHint
+	{
+		Normal, ///< No particular access pattern
+		Sequential, ///< Data is accessed in order, read ahead aggressively
+		Random ///< Data is accessed in random order, don't read ahead
+	};
+
+	/*!
+	 \brief Default constructor.
+
+	 Creates an invalid mapping.
+	 */
+	MappedFile( );
+
+	/*!
+	 \brief Map a file into memory.
+
+	 \param path Path of the file to map.
+	 \param hint Expected access pattern.
+	 \param populate Fault in the whole file right away, where supported.
+
+	 \sa Open
+	 */
+	explicit MappedFile( const std::string &path, AccessHint hint = AccessHint::Normal, bool populate = false );
+
+	/*!
+	 \brief Map a file into memory, releasing any previous mapping.
+
+	 \param path Path of the file to map.
+	 \param hint Expected access pattern.
+	 \param populate Fault in the whole file right away, where supported.
+
+	 \return true if the file was mapped, false otherwise.
+	 */
+	bool Open( const std::string &path, AccessHint hint = AccessHint::Normal, bool populate = false );
+
+	/*!
+	 \brief Release this object's reference to the mapping.
+	 */
+	void Close( );
+
+	/*!
+	 \brief Tell if a file is mapped.
+
+	 \return true if a file is mapped, false otherwise.
+	 */
+	bool IsValid( ) const;
+
+	/*!
+	 \brief Get the path of the mapped file.
+
+	 \return Path of the mapped file.
+	 */
+	const std::string &GetPath( ) const;
+
+	/*!
+	 \brief Change the expected access pattern of the mapped data.
+
+	 \param hint Expected access pattern.
+
+	 \return true if the operating system accepted the hint, false otherwise.
+	 */
+	bool Advise( AccessHint hint );
+
+	/*!
+	 \brief Return the current read position.
+
+	 \return Current position of read operations.
+	 */
+	size_t Tell( ) const;
+
+	/*!
+	 \brief Return the size of the mapped file.
+
+	 \return Size of the mapped file.
+	 */
+	size_t Size( ) const;
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 \param position Position to set the pointer to.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( size_t position );
+
+	/*!
+	 \brief Set the current position of read operations.
+
+	 \param position Position to set the pointer to.
+	 \param mode Type of seeking pretended.
+
+	 \return Success of this operation.
+	 */
+	bool Seek( int64_t position, SeekMode mode );
+
+	/*!
+	 \brief Tell if the end of file was reached.
+
+	 \return End of file reached.
+	 */
+	bool EndOfFile( ) const;
+
+	/*!
+	 \brief Return pointer to the mapped data.
+
+	 \return Pointer to the first byte of the file, nullptr if nothing is
+	 mapped or the file is empty.
+	 */
+	const uint8_t *GetBuffer( ) const;
+
+	/*!
+	 \brief Create a view of the whole mapped file.
+
+	 \return View of the whole file.
+
+	 \sa ByteBufferView
+	 */
+	ByteBufferView Slice( ) const;
+
+	/*!
+	 \brief Create a view of a range of the mapped file.
+
+	 The range is clamped to the size of the file.
+
+	 \param offset Offset of the first byte.
+	 \param size Amount of bytes the view covers.
+
+	 \return View of the range.
+
+	 \overload
+	 */
+	ByteBufferView Slice( size_t offset, size_t size ) const;
+
+	/*!
+	 \brief Read data from the mapped file.
+
+	 \param data Buffer to store the data.
+	 \param size Size of the buffer.
+
+	 \return Amount of read bytes.
+	 */
+	size_t Read( void *data, size_t size );
+
+	/*!
+	 \brief Mapped files are read-only, nothing is written.
+
+	 \return Always 0.
+	 */
+	size_t Write( const void *data, size_t size );
+
+private:
+	std::shared_ptr<const uint8_t> mapped_data;
+	size_t mapped_size;
+	size_t read_offset;
+	bool end_of_file;
+	std::string file_path;
+};
+
+} // namespace MultiLibrary
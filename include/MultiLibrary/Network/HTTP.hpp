@@ -37,6 +37,7 @@
 
 #include <MultiLibrary/Network/Export.hpp>
 #include <MultiLibrary/Network/IPAddress.hpp>
+#include <MultiLibrary/Common/String.hpp>
 #include <string>
 #include <map>
 
@@ -46,6 +47,9 @@ namespace MultiLibrary
 class MULTILIBRARY_NETWORK_API HTTP
 {
 public:
+	// Field names are case insensitive
+	typedef std::map<std::string, std::string, CaseInsensitiveLess> FieldMap;
+
 	class MULTILIBRARY_NETWORK_API Request
 	{
 	public:
@@ -69,7 +73,7 @@ public:
 		std::string BuildRequest( ) const;
 
 	private:
-		std::map<std::string, std::string> fields;
+		FieldMap fields;
 		std::string uri;
 		std::string body;
 		Method method;
@@ -124,7 +128,7 @@ public:
 		void ParseResponse( const std::string &data );
 
 	private:
-		std::map<std::string, std::string> fields;
+		FieldMap fields;
 		Status status;
 		std::string body;
 		uint32_t minorVersion;
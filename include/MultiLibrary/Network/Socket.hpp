@@ -43,6 +43,7 @@ namespace MultiLibrary
 {
 
 class ByteBuffer;
+class ChainedBuffer;
 
 #if defined _WIN32
 
@@ -91,6 +92,7 @@ public:
 
 	virtual SocketError Receive( void *buffer, int32_t size, int32_t flags, int32_t *received_bytes = nullptr );
 	virtual SocketError Receive( ByteBuffer &buffer, int32_t flags );
+	virtual SocketError Receive( ChainedBuffer &buffer, int32_t size, int32_t flags, int32_t *received_bytes = nullptr );
 
 	virtual SocketError ReceiveFrom( void *buffer, int32_t size, int32_t flags, IPAddress &address, int32_t *received_bytes = nullptr );
 	virtual SocketError ReceiveFrom( ByteBuffer &buffer, int32_t flags, IPAddress &address );
@@ -101,6 +103,7 @@ public:
 
 	virtual SocketError Send( const void *buffer, int32_t size, int32_t flags, int32_t *sent_bytes = nullptr );
 	virtual SocketError Send( const ByteBuffer &buffer, int32_t flags, int32_t *sent_bytes = nullptr );
+	virtual SocketError Send( const ChainedBuffer &buffer, int32_t flags, int32_t *sent_bytes = nullptr );
 
 	virtual SocketError SendTo( const void *buffer, int32_t size, int32_t flags, const IPAddress &address, int32_t *sent_bytes = nullptr );
 	virtual SocketError SendTo( const ByteBuffer &buffer, int32_t flags, const IPAddress &address, int32_t *sent_bytes = nullptr );
@@ -37,6 +37,7 @@
 
 #include <MultiLibrary/Network/Export.hpp>
 #include <MultiLibrary/Network/Socket.hpp>
+#include <MultiLibrary/Common/Transfer.hpp>
 
 namespace MultiLibrary
 {
@@ -49,6 +50,13 @@ public:
 	virtual bool Open( );
 
 	virtual SocketType Type( ) const;
+
+	/*!
+	 \brief Get an endpoint to use this connected socket with Transfer.
+
+	 \return Endpoint for this socket.
+	 */
+	TransferEndpoint GetTransferEndpoint( ) const;
 };
 
 } // namespace MultiLibrary
@@ -145,6 +145,21 @@ solution("MultiLibrary")
 		files(SOURCE_DIRECTORY .. "/Testing/child.cpp")
 		links({"Filesystem", "Common"})
 
+	project("Benchmark")
+		uuid("5E0C4B7A-2F6D-4C1B-9A3E-8D7F1B2C4E60")
+		kind("ConsoleApp")
+		targetname("benchmark")
+		includedirs(INCLUDE_DIRECTORY)
+		vpaths({["Source files"] = SOURCE_DIRECTORY .. "/Testing/**.cpp"})
+		files(SOURCE_DIRECTORY .. "/Testing/benchmark.cpp")
+		links({"Filesystem", "Network", "Common"})
+
+		filter("system:windows")
+			links("ws2_32")
+
+		filter("system:linux or macosx")
+			links("pthread")
+
 	group("MultiLibrary")
 		project("Common")
 			uuid("B172660C-0AB8-B24F-8BED-F729A0DE3CBB")
@@ -0,0 +1,213 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ANSICodec.hpp>
+#include <MultiLibrary/Common/Unicode.hpp>
+#include <algorithm>
+
+namespace MultiLibrary
+{
+
+static const uint32_t replacement_character = 0xFFFD;
+
+static void AppendUTF8( uint32_t codepoint, std::string &output )
+{
+	char bytes[4];
+	char *end = bytes;
+	if( codepoint < 0x80 )
+	{
+		*end++ = static_cast<char>( codepoint );
+	}
+	else if( codepoint < 0x800 )
+	{
+		*end++ = static_cast<char>( 0xC0 | codepoint >> 6 );
+		*end++ = static_cast<char>( 0x80 | ( codepoint & 0x3F ) );
+	}
+	else if( codepoint < 0x10000 )
+	{
+		*end++ = static_cast<char>( 0xE0 | codepoint >> 12 );
+		*end++ = static_cast<char>( 0x80 | ( codepoint >> 6 & 0x3F ) );
+		*end++ = static_cast<char>( 0x80 | ( codepoint & 0x3F ) );
+	}
+	else
+	{
+		*end++ = static_cast<char>( 0xF0 | codepoint >> 18 );
+		*end++ = static_cast<char>( 0x80 | ( codepoint >> 12 & 0x3F ) );
+		*end++ = static_cast<char>( 0x80 | ( codepoint >> 6 & 0x3F ) );
+		*end++ = static_cast<char>( 0x80 | ( codepoint & 0x3F ) );
+	}
+
+	output.append( bytes, end );
+}
+
+ANSICodec::ANSICodec( ) :
+	ascii_compatible( true )
+{ }
+
+ANSICodec::ANSICodec( const std::locale &loc ) :
+	ascii_compatible( true )
+{
+	const std::ctype<wchar_t> &facet = std::use_facet<std::ctype<wchar_t>>( loc );
+	for( size_t k = 0; k < 256; ++k )
+	{
+		// Bytes without a wide character come back as WEOF or garbage
+		uint32_t codepoint = static_cast<uint32_t>( facet.widen( static_cast<char>( k ) ) );
+		if( codepoint > 0x10FFFF || ( codepoint >= 0xD800 && codepoint <= 0xDFFF ) || ( codepoint == 0 && k != 0 ) )
+			codepoint = replacement_character;
+
+		widen_table[k] = codepoint;
+		if( k < 0x80 && codepoint != k )
+			ascii_compatible = false;
+	}
+
+	BuildNarrowTables( );
+}
+
+const ANSICodec &ANSICodec::Latin1( )
+{
+	static const ANSICodec codec = [] ( )
+	{
+		ANSICodec latin1;
+		for( uint32_t k = 0; k < 256; ++k )
+			latin1.widen_table[k] = k;
+
+		latin1.BuildNarrowTables( );
+		return latin1;
+	}( );
+	return codec;
+}
+
+const ANSICodec &ANSICodec::ASCII( )
+{
+	static const ANSICodec codec = [] ( )
+	{
+		ANSICodec ascii;
+		for( uint32_t k = 0; k < 256; ++k )
+			ascii.widen_table[k] = k < 0x80 ? k : replacement_character;
+
+		ascii.BuildNarrowTables( );
+		return ascii;
+	}( );
+	return codec;
+}
+
+const ANSICodec &ANSICodec::GetDefault( )
+{
+	static const ANSICodec codec( ( std::locale( ) ) );
+	return codec;
+}
+
+void ANSICodec::BuildNarrowTables( )
+{
+	std::fill( narrow_table, narrow_table + 256, static_cast<int16_t>( -1 ) );
+	narrow_extra.clear( );
+	for( size_t k = 0; k < 256; ++k )
+	{
+		uint32_t codepoint = widen_table[k];
+		if( codepoint == replacement_character )
+			continue;
+
+		if( codepoint < 256 )
+		{
+			if( narrow_table[codepoint] < 0 )
+				narrow_table[codepoint] = static_cast<int16_t>( k );
+		}
+		else
+		{
+			narrow_extra.push_back( std::make_pair( codepoint, static_cast<char>( k ) ) );
+		}
+	}
+
+	std::sort( narrow_extra.begin( ), narrow_extra.end( ) );
+}
+
+char ANSICodec::Narrow( uint32_t codepoint, char replace ) const
+{
+	if( codepoint < 256 )
+		return narrow_table[codepoint] >= 0 ? static_cast<char>( narrow_table[codepoint] ) : replace;
+
+	std::vector<std::pair<uint32_t, char>>::const_iterator it = std::lower_bound( narrow_extra.begin( ), narrow_extra.end( ), std::make_pair( codepoint, '\0' ) );
+	return it != narrow_extra.end( ) && it->first == codepoint ? it->second : replace;
+}
+
+bool ANSICodec::IsASCIICompatible( ) const
+{
+	return ascii_compatible;
+}
+
+void ANSICodec::ToUTF8( const char *begin, const char *end, std::string &output ) const
+{
+	output.reserve( output.size( ) + static_cast<size_t>( end - begin ) );
+	while( begin != end )
+	{
+		if( ascii_compatible )
+		{
+			const char *ascii_end = UTF8::SkipASCII( begin, end );
+			output.append( begin, ascii_end );
+			if( ascii_end == end )
+				break;
+
+			begin = ascii_end;
+		}
+
+		AppendUTF8( Widen( *begin ), output );
+		++begin;
+	}
+}
+
+void ANSICodec::FromUTF8( const char *begin, const char *end, std::string &output, char replace ) const
+{
+	output.reserve( output.size( ) + static_cast<size_t>( end - begin ) );
+	while( begin != end )
+	{
+		if( ascii_compatible )
+		{
+			const char *ascii_end = UTF8::SkipASCII( begin, end );
+			output.append( begin, ascii_end );
+			if( ascii_end == end )
+				break;
+
+			begin = ascii_end;
+		}
+
+		uint32_t codepoint;
+		begin = UTF8::Decode( begin, end, codepoint, replacement_character );
+		char ch = Narrow( codepoint, replace );
+		if( ch != 0 || codepoint == 0 )
+			output.push_back( ch );
+	}
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,200 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/BinaryReader.hpp>
+#include <algorithm>
+
+namespace MultiLibrary
+{
+
+// Big enough for any fixed size value plus a variable length integer
+static const size_t minimum_buffer_size = 16;
+
+BinaryReader::BinaryReader( InputStream &stream, Endianness endianness, size_t buffer_size ) :
+	input_stream( stream ),
+	byte_order( endianness ),
+	buffer( std::max( buffer_size, minimum_buffer_size ) ),
+	buffer_offset( 0 ),
+	buffer_used( 0 ),
+	failed( false )
+{ }
+
+size_t BinaryReader::ReadBytes( void *data, size_t size )
+{
+	uint8_t *bytes = reinterpret_cast<uint8_t *>( data );
+	size_t total = 0;
+
+	size_t buffered = std::min( size, buffer_used - buffer_offset );
+	std::memcpy( bytes, buffer.data( ) + buffer_offset, buffered );
+	buffer_offset += buffered;
+	total += buffered;
+
+	if( size - total >= buffer.size( ) )
+	{
+		while( total < size )
+		{
+			size_t read = input_stream.Read( bytes + total, size - total );
+			if( read == 0 )
+				break;
+
+			total += read;
+		}
+	}
+	else if( total < size )
+	{
+		Fill( size - total );
+		buffered = std::min( size - total, buffer_used - buffer_offset );
+		std::memcpy( bytes + total, buffer.data( ) + buffer_offset, buffered );
+		buffer_offset += buffered;
+		total += buffered;
+	}
+
+	if( total != size )
+		failed = true;
+
+	return total;
+}
+
+bool BinaryReader::ReadVarInt( uint64_t &value )
+{
+	uint64_t result = 0;
+	for( size_t shift = 0; shift < 64; shift += 7 )
+	{
+		if( buffer_offset == buffer_used && !Fill( 1 ) )
+		{
+			failed = true;
+			return false;
+		}
+
+		uint8_t byte = buffer[buffer_offset++];
+		result |= static_cast<uint64_t>( byte & 0x7F ) << shift;
+		if( ( byte & 0x80 ) == 0 )
+		{
+			value = result;
+			return true;
+		}
+	}
+
+	// More than 10 bytes, not something BinaryWriter produces
+	failed = true;
+	return false;
+}
+
+bool BinaryReader::ReadZigZag( int64_t &value )
+{
+	uint64_t encoded = 0;
+	if( !ReadVarInt( encoded ) )
+		return false;
+
+	value = static_cast<int64_t>( encoded >> 1 ) ^ -static_cast<int64_t>( encoded & 1 );
+	return true;
+}
+
+bool BinaryReader::ReadString( std::string &value )
+{
+	uint64_t size = 0;
+	if( !ReadVarInt( size ) )
+		return false;
+
+	// Grow as data arrives so a corrupt size can't trigger a huge allocation
+	std::string result;
+	while( result.size( ) < size )
+	{
+		size_t offset = result.size( );
+		size_t chunk = static_cast<size_t>( std::min<uint64_t>( size - offset, buffer.size( ) ) );
+		result.resize( offset + chunk );
+		if( ReadBytes( &result[offset], chunk ) != chunk )
+			return false;
+	}
+
+	value.swap( result );
+	return true;
+}
+
+BinaryReader &BinaryReader::operator>>( std::string &value )
+{
+	ReadString( value );
+	return *this;
+}
+
+bool BinaryReader::Sync( )
+{
+	size_t unread = buffer_used - buffer_offset;
+	if( unread != 0 && !input_stream.Seek( -static_cast<int64_t>( unread ), SeekMode::Cur ) )
+		return false;
+
+	buffer_offset = 0;
+	buffer_used = 0;
+	return true;
+}
+
+size_t BinaryReader::Buffered( ) const
+{
+	return buffer_used - buffer_offset;
+}
+
+bool BinaryReader::Failed( ) const
+{
+	return failed;
+}
+
+Endianness BinaryReader::GetEndianness( ) const
+{
+	return byte_order;
+}
+
+bool BinaryReader::Fill( size_t size )
+{
+	size_t unread = buffer_used - buffer_offset;
+	if( buffer_offset != 0 )
+	{
+		std::memmove( buffer.data( ), buffer.data( ) + buffer_offset, unread );
+		buffer_offset = 0;
+		buffer_used = unread;
+	}
+
+	while( buffer_used < size && buffer_used < buffer.size( ) )
+	{
+		size_t read = input_stream.Read( buffer.data( ) + buffer_used, buffer.size( ) - buffer_used );
+		if( read == 0 )
+			return false;
+
+		buffer_used += read;
+	}
+
+	return buffer_used >= size;
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,156 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/BinaryWriter.hpp>
+
+namespace MultiLibrary
+{
+
+BinaryWriter::BinaryWriter( OutputStream &stream, Endianness endianness, size_t buffer_size ) :
+	output_stream( stream ),
+	byte_order( endianness ),
+	buffer( buffer_size != 0 ? buffer_size : DEFAULT_BUFFER_SIZE ),
+	buffer_used( 0 ),
+	failed( false )
+{ }
+
+BinaryWriter::~BinaryWriter( )
+{
+	Flush( );
+}
+
+BinaryWriter &BinaryWriter::WriteBytes( const void *data, size_t size )
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>( data );
+	if( size <= buffer.size( ) - buffer_used )
+	{
+		std::memcpy( buffer.data( ) + buffer_used, bytes, size );
+		buffer_used += size;
+		return *this;
+	}
+
+	if( !Flush( ) )
+		return *this;
+
+	if( size >= buffer.size( ) )
+	{
+		while( size != 0 )
+		{
+			size_t written = output_stream.Write( bytes, size );
+			if( written == 0 )
+			{
+				failed = true;
+				break;
+			}
+
+			bytes += written;
+			size -= written;
+		}
+
+		return *this;
+	}
+
+	std::memcpy( buffer.data( ), bytes, size );
+	buffer_used = size;
+	return *this;
+}
+
+BinaryWriter &BinaryWriter::WriteVarInt( uint64_t value )
+{
+	uint8_t encoded[10];
+	size_t size = 0;
+	while( value >= 0x80 )
+	{
+		encoded[size++] = static_cast<uint8_t>( value | 0x80 );
+		value >>= 7;
+	}
+
+	encoded[size++] = static_cast<uint8_t>( value );
+	return WriteBytes( encoded, size );
+}
+
+BinaryWriter &BinaryWriter::WriteZigZag( int64_t value )
+{
+	return WriteVarInt( ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 ) );
+}
+
+BinaryWriter &BinaryWriter::WriteString( const std::string &value )
+{
+	WriteVarInt( value.size( ) );
+	return WriteBytes( value.data( ), value.size( ) );
+}
+
+BinaryWriter &BinaryWriter::operator<<( const std::string &value )
+{
+	return WriteString( value );
+}
+
+bool BinaryWriter::Flush( )
+{
+	size_t offset = 0;
+	while( offset < buffer_used )
+	{
+		size_t written = output_stream.Write( buffer.data( ) + offset, buffer_used - offset );
+		if( written == 0 )
+		{
+			std::memmove( buffer.data( ), buffer.data( ) + offset, buffer_used - offset );
+			buffer_used -= offset;
+			failed = true;
+			return false;
+		}
+
+		offset += written;
+	}
+
+	buffer_used = 0;
+	return true;
+}
+
+size_t BinaryWriter::Buffered( ) const
+{
+	return buffer_used;
+}
+
+bool BinaryWriter::Failed( ) const
+{
+	return failed;
+}
+
+Endianness BinaryWriter::GetEndianness( ) const
+{
+	return byte_order;
+}
+
+} // namespace MultiLibrary
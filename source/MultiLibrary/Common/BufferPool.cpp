@@ -0,0 +1,271 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <atomic>
+#include <mutex>
+
+namespace MultiLibrary
+{
+
+static const size_t class_count = 15; // 256 bytes to 4 megabytes
+static const size_t thread_cache_size = 8;
+
+static size_t ClassSize( size_t index )
+{
+	return BufferPool::MIN_CLASS_SIZE << index;
+}
+
+// Smallest class that can hold the requested capacity
+static size_t ClassForAcquire( size_t capacity )
+{
+	size_t index = 0;
+	while( ClassSize( index ) < capacity )
+		++index;
+
+	return index;
+}
+
+// Biggest class whose size the provided capacity satisfies
+static size_t ClassForRelease( size_t capacity )
+{
+	size_t index = 0;
+	while( index + 1 < class_count && ClassSize( index + 1 ) <= capacity )
+		++index;
+
+	return index;
+}
+
+class BufferPoolInternal
+{
+public:
+	BufferPoolInternal( size_t max ) :
+		max_cached( max ),
+		hits( 0 ),
+		misses( 0 ),
+		releases( 0 ),
+		discards( 0 )
+	{ }
+
+	std::mutex lock;
+	std::vector<BufferPool::Storage> classes[class_count];
+	size_t max_cached;
+
+	std::atomic<uint64_t> hits;
+	std::atomic<uint64_t> misses;
+	std::atomic<uint64_t> releases;
+	std::atomic<uint64_t> discards;
+};
+
+namespace
+{
+
+class ThreadCache
+{
+public:
+	struct Entry
+	{
+		std::weak_ptr<BufferPoolInternal> pool;
+		std::vector<BufferPool::Storage> classes[class_count];
+	};
+
+	~ThreadCache( )
+	{
+		for( Entry &entry : entries )
+			Flush( entry );
+	}
+
+	Entry &Find( const std::shared_ptr<BufferPoolInternal> &pool )
+	{
+		for( size_t k = 0; k < entries.size( ); )
+		{
+			Entry &entry = entries[k];
+			if( entry.pool.expired( ) )
+			{
+				entries.erase( entries.begin( ) + static_cast<std::ptrdiff_t>( k ) );
+				continue;
+			}
+
+			if( !entry.pool.owner_before( pool ) && !pool.owner_before( entry.pool ) )
+				return entry;
+
+			++k;
+		}
+
+		entries.emplace_back( );
+		Entry &entry = entries.back( );
+		entry.pool = pool;
+		for( std::vector<BufferPool::Storage> &cache : entry.classes )
+			cache.reserve( thread_cache_size );
+
+		return entry;
+	}
+
+private:
+	static void Flush( Entry &entry )
+	{
+		std::shared_ptr<BufferPoolInternal> pool = entry.pool.lock( );
+		if( !pool )
+			return;
+
+		std::lock_guard<std::mutex> guard( pool->lock );
+		for( size_t k = 0; k < class_count; ++k )
+			for( BufferPool::Storage &storage : entry.classes[k] )
+				if( pool->classes[k].size( ) < pool->max_cached )
+					pool->classes[k].push_back( std::move( storage ) );
+	}
+
+	std::vector<Entry> entries;
+};
+
+static thread_local ThreadCache thread_cache;
+
+}
+
+BufferPool::BufferPool( size_t max_cached ) :
+	pool_internal( std::make_shared<BufferPoolInternal>( max_cached ) )
+{ }
+
+BufferPool::~BufferPool( )
+{ }
+
+BufferPool::Storage BufferPool::Acquire( size_t capacity )
+{
+	if( capacity > MAX_CLASS_SIZE )
+	{
+		++pool_internal->misses;
+		Storage storage = std::make_shared<std::vector<uint8_t>>( );
+		storage->reserve( capacity );
+		return storage;
+	}
+
+	size_t index = ClassForAcquire( capacity );
+	std::vector<Storage> &local = thread_cache.Find( pool_internal ).classes[index];
+	if( !local.empty( ) )
+	{
+		++pool_internal->hits;
+		Storage storage = std::move( local.back( ) );
+		local.pop_back( );
+		return storage;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard( pool_internal->lock );
+		std::vector<Storage> &shared = pool_internal->classes[index];
+		if( !shared.empty( ) )
+		{
+			++pool_internal->hits;
+			Storage storage = std::move( shared.back( ) );
+			shared.pop_back( );
+			return storage;
+		}
+	}
+
+	++pool_internal->misses;
+	Storage storage = std::make_shared<std::vector<uint8_t>>( );
+	storage->reserve( ClassSize( index ) );
+	return storage;
+}
+
+void BufferPool::Release( Storage &&storage )
+{
+	Storage released( std::move( storage ) );
+	if( !released || released.use_count( ) != 1 )
+		return;
+
+	size_t capacity = released->capacity( );
+	if( capacity < MIN_CLASS_SIZE || capacity > MAX_CLASS_SIZE )
+	{
+		++pool_internal->discards;
+		return;
+	}
+
+	size_t index = ClassForRelease( capacity );
+	std::vector<Storage> &local = thread_cache.Find( pool_internal ).classes[index];
+	if( local.size( ) < thread_cache_size )
+	{
+		++pool_internal->releases;
+		local.push_back( std::move( released ) );
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard( pool_internal->lock );
+	std::vector<Storage> &shared = pool_internal->classes[index];
+	if( shared.size( ) < pool_internal->max_cached )
+	{
+		++pool_internal->releases;
+		shared.push_back( std::move( released ) );
+	}
+	else
+	{
+		++pool_internal->discards;
+	}
+}
+
+void BufferPool::Trim( )
+{
+	std::lock_guard<std::mutex> guard( pool_internal->lock );
+	for( std::vector<Storage> &shared : pool_internal->classes )
+	{
+		shared.clear( );
+		shared.shrink_to_fit( );
+	}
+}
+
+BufferPool::Statistics BufferPool::GetStatistics( ) const
+{
+	Statistics stats;
+	stats.hits = pool_internal->hits;
+	stats.misses = pool_internal->misses;
+	stats.releases = pool_internal->releases;
+	stats.discards = pool_internal->discards;
+	return stats;
+}
+
+void BufferPool::ResetStatistics( )
+{
+	pool_internal->hits = 0;
+	pool_internal->misses = 0;
+	pool_internal->releases = 0;
+	pool_internal->discards = 0;
+}
+
+BufferPool &BufferPool::Default( )
+{
+	static BufferPool pool;
+	return pool;
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,232 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/BufferedInputStream.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+BufferedInputStream::BufferedInputStream( InputStream &stream, size_t buffer_size ) :
+	input_stream( stream ),
+	buffer( buffer_size != 0 ? buffer_size : DEFAULT_BUFFER_SIZE ),
+	buffer_offset( 0 ),
+	buffer_used( 0 )
+{ }
+
+bool BufferedInputStream::IsValid( ) const
+{
+	return input_stream.IsValid( );
+}
+
+bool BufferedInputStream::Seek( size_t position )
+{
+	buffer_offset = 0;
+	buffer_used = 0;
+	return input_stream.Seek( position );
+}
+
+bool BufferedInputStream::Seek( int64_t position, SeekMode mode )
+{
+	if( mode == SeekMode::Cur )
+	{
+		int64_t unread = static_cast<int64_t>( buffer_used - buffer_offset );
+		if( position >= 0 && position <= unread )
+		{
+			buffer_offset += static_cast<size_t>( position );
+			return true;
+		}
+
+		position -= unread;
+	}
+
+	if( !input_stream.Seek( position, mode ) )
+		return false;
+
+	buffer_offset = 0;
+	buffer_used = 0;
+	return true;
+}
+
+size_t BufferedInputStream::Tell( ) const
+{
+	return input_stream.Tell( ) - ( buffer_used - buffer_offset );
+}
+
+size_t BufferedInputStream::Size( ) const
+{
+	return input_stream.Size( );
+}
+
+bool BufferedInputStream::EndOfFile( ) const
+{
+	return buffer_offset == buffer_used && input_stream.EndOfFile( );
+}
+
+size_t BufferedInputStream::Read( void *data, size_t size )
+{
+	char *bytes = reinterpret_cast<char *>( data );
+	size_t total = std::min( size, buffer_used - buffer_offset );
+	std::memcpy( bytes, buffer.data( ) + buffer_offset, total );
+	buffer_offset += total;
+
+	while( total < size )
+	{
+		size_t read = 0;
+		if( size - total >= buffer.size( ) )
+		{
+			read = input_stream.Read( bytes + total, size - total );
+		}
+		else if( Fill( ) != 0 )
+		{
+			read = std::min( size - total, buffer_used );
+			std::memcpy( bytes + total, buffer.data( ), read );
+			buffer_offset = read;
+		}
+
+		if( read == 0 )
+			break;
+
+		total += read;
+	}
+
+	return total;
+}
+
+size_t BufferedInputStream::Peek( void *data, size_t size )
+{
+	size = std::min( size, buffer.size( ) );
+	if( buffer_used - buffer_offset < size )
+	{
+		if( buffer_offset != 0 )
+		{
+			std::memmove( buffer.data( ), buffer.data( ) + buffer_offset, buffer_used - buffer_offset );
+			buffer_used -= buffer_offset;
+			buffer_offset = 0;
+		}
+
+		while( buffer_used < size )
+		{
+			size_t read = input_stream.Read( buffer.data( ) + buffer_used, buffer.size( ) - buffer_used );
+			if( read == 0 )
+				break;
+
+			buffer_used += read;
+		}
+	}
+
+	size = std::min( size, buffer_used - buffer_offset );
+	std::memcpy( data, buffer.data( ) + buffer_offset, size );
+	return size;
+}
+
+bool BufferedInputStream::ReadUntil( std::string &data, char delimiter )
+{
+	while( buffer_offset != buffer_used || Fill( ) != 0 )
+	{
+		const char *start = buffer.data( ) + buffer_offset;
+		size_t available = buffer_used - buffer_offset;
+		const char *found = static_cast<const char *>( std::memchr( start, delimiter, available ) );
+		if( found != nullptr )
+		{
+			data.append( start, found );
+			buffer_offset += found - start + 1;
+			return true;
+		}
+
+		data.append( start, available );
+		buffer_offset = buffer_used;
+	}
+
+	return false;
+}
+
+bool BufferedInputStream::ReadLine( std::string &data )
+{
+	data.clear( );
+	if( !ReadUntil( data, '\n' ) && data.empty( ) )
+		return false;
+
+	if( !data.empty( ) && data.back( ) == '\r' )
+		data.pop_back( );
+
+	return true;
+}
+
+size_t BufferedInputStream::Buffered( ) const
+{
+	return buffer_used - buffer_offset;
+}
+
+void BufferedInputStream::ExtractString( std::string &data )
+{
+	while( buffer_offset != buffer_used || Fill( ) != 0 )
+	{
+		const char *start = buffer.data( ) + buffer_offset;
+		size_t available = buffer_used - buffer_offset;
+		const char *found = static_cast<const char *>( std::memchr( start, '\n', available ) );
+		const char *null = static_cast<const char *>( std::memchr( start, '\0', found != nullptr ? found - start : available ) );
+		if( null != nullptr )
+			found = null;
+
+		if( found != nullptr )
+		{
+			data.append( start, found );
+			buffer_offset += found - start + 1;
+			break;
+		}
+
+		data.append( start, available );
+		buffer_offset = buffer_used;
+	}
+
+#ifdef _WIN32
+
+	if( !data.empty( ) && data.back( ) == '\r' )
+		data.pop_back( );
+
+#endif
+
+}
+
+size_t BufferedInputStream::Fill( )
+{
+	buffer_offset = 0;
+	buffer_used = input_stream.Read( buffer.data( ), buffer.size( ) );
+	return buffer_used;
+}
+
+} // namespace MultiLibrary
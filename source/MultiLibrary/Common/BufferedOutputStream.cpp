@@ -0,0 +1,166 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/BufferedOutputStream.hpp>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+BufferedOutputStream::BufferedOutputStream( OutputStream &stream, size_t buffer_size, FlushMode mode ) :
+	output_stream( stream ),
+	buffer( buffer_size != 0 ? buffer_size : DEFAULT_BUFFER_SIZE ),
+	buffer_used( 0 ),
+	flush_mode( mode ),
+	statistics( )
+{ }
+
+BufferedOutputStream::~BufferedOutputStream( )
+{
+	Flush( );
+}
+
+bool BufferedOutputStream::IsValid( ) const
+{
+	return output_stream.IsValid( );
+}
+
+bool BufferedOutputStream::Seek( size_t position )
+{
+	return Flush( ) && output_stream.Seek( position );
+}
+
+bool BufferedOutputStream::Seek( int64_t position, SeekMode mode )
+{
+	return Flush( ) && output_stream.Seek( position, mode );
+}
+
+size_t BufferedOutputStream::Tell( ) const
+{
+	return output_stream.Tell( ) + buffer_used;
+}
+
+size_t BufferedOutputStream::Size( ) const
+{
+	size_t size = output_stream.Size( );
+	size_t end = Tell( );
+	return end > size ? end : size;
+}
+
+bool BufferedOutputStream::EndOfFile( ) const
+{
+	return output_stream.EndOfFile( );
+}
+
+size_t BufferedOutputStream::Write( const void *data, size_t size )
+{
+	++statistics.writes;
+
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>( data );
+	bool flush = flush_mode == FlushMode::Line && std::memchr( bytes, '\n', size ) != nullptr;
+	if( size > buffer.size( ) - buffer_used )
+	{
+		if( !Flush( ) )
+			return 0;
+
+		if( size >= buffer.size( ) )
+			return WriteThrough( bytes, size );
+	}
+
+	std::memcpy( buffer.data( ) + buffer_used, bytes, size );
+	buffer_used += size;
+	if( flush || buffer_used == buffer.size( ) )
+		Flush( );
+
+	return size;
+}
+
+bool BufferedOutputStream::Flush( )
+{
+	size_t written = WriteThrough( buffer.data( ), buffer_used );
+	if( written != buffer_used )
+	{
+		std::memmove( buffer.data( ), buffer.data( ) + written, buffer_used - written );
+		buffer_used -= written;
+		return false;
+	}
+
+	buffer_used = 0;
+	return true;
+}
+
+size_t BufferedOutputStream::Buffered( ) const
+{
+	return buffer_used;
+}
+
+void BufferedOutputStream::SetFlushMode( FlushMode mode )
+{
+	flush_mode = mode;
+}
+
+BufferedOutputStream::FlushMode BufferedOutputStream::GetFlushMode( ) const
+{
+	return flush_mode;
+}
+
+BufferedOutputStream::Statistics BufferedOutputStream::GetStatistics( ) const
+{
+	return statistics;
+}
+
+void BufferedOutputStream::ResetStatistics( )
+{
+	statistics = Statistics( );
+}
+
+size_t BufferedOutputStream::WriteThrough( const uint8_t *data, size_t size )
+{
+	size_t total = 0;
+	while( total < size )
+	{
+		size_t written = output_stream.Write( data + total, size - total );
+		++statistics.flushes;
+		if( written == 0 )
+			break;
+
+		total += written;
+		statistics.bytes_written += written;
+	}
+
+	return total;
+}
+
+} // namespace MultiLibrary
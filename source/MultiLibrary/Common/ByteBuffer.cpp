@@ -34,6 +34,7 @@
  *************************************************************************/
 
 #include <MultiLibrary/Common/ByteBuffer.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
 #include <stdexcept>
 #include <cassert>
 #include <cstring>
@@ -42,26 +43,70 @@ namespace MultiLibrary
 {
 
 ByteBuffer::ByteBuffer( ) :
+	buffer_pool( nullptr ),
 	end_of_file( true ),
+	buffer_exposed( false ),
 	buffer_offset( 0 )
 { }
 
 ByteBuffer::ByteBuffer( size_t size ) :
+	buffer_pool( nullptr ),
 	end_of_file( true ),
+	buffer_exposed( false ),
 	buffer_offset( 0 )
 {
 	Resize( size );
 }
 
 ByteBuffer::ByteBuffer( const uint8_t *copy_buffer, size_t size ) :
+	buffer_pool( nullptr ),
 	end_of_file( true ),
+	buffer_exposed( false ),
 	buffer_offset( 0 )
 {
 	Assign( copy_buffer, size );
 }
 
+ByteBuffer::ByteBuffer( BufferPool &pool, size_t capacity ) :
+	buffer_pool( &pool ),
+	end_of_file( true ),
+	buffer_exposed( false ),
+	buffer_internal( pool.Acquire( capacity ) ),
+	buffer_offset( 0 )
+{
+	buffer_internal->clear( );
+}
+
+ByteBuffer::ByteBuffer( const ByteBuffer &other ) :
+	IOStream( other ),
+	buffer_pool( other.buffer_pool ),
+	end_of_file( other.end_of_file ),
+	buffer_exposed( false ),
+	buffer_offset( other.buffer_offset )
+{
+	Share( other );
+}
+
 ByteBuffer::~ByteBuffer( )
-{ }
+{
+	if( buffer_pool != nullptr )
+		buffer_pool->Release( std::move( buffer_internal ) );
+}
+
+ByteBuffer &ByteBuffer::operator=( const ByteBuffer &other )
+{
+	if( this == &other )
+		return *this;
+
+	if( buffer_pool != nullptr )
+		buffer_pool->Release( std::move( buffer_internal ) );
+
+	buffer_pool = other.buffer_pool;
+	end_of_file = other.end_of_file;
+	buffer_offset = other.buffer_offset;
+	Share( other );
+	return *this;
+}
 
 bool ByteBuffer::IsValid( ) const
 {
@@ -85,12 +130,12 @@ size_t ByteBuffer::Tell( ) const
 
 size_t ByteBuffer::Size( ) const
 {
-	return buffer_internal.size( );
+	return buffer_internal ? buffer_internal->size( ) : 0;
 }
 
 size_t ByteBuffer::Capacity( ) const
 {
-	return buffer_internal.capacity( );
+	return buffer_internal ? buffer_internal->capacity( ) : 0;
 }
 
 bool ByteBuffer::Seek( size_t position )
@@ -132,29 +177,65 @@ bool ByteBuffer::EndOfFile( ) const
 
 uint8_t *ByteBuffer::GetBuffer( )
 {
-	return &buffer_internal[0];
+	uint8_t *data = MutableStorage( ).data( );
+	buffer_exposed = true;
+	return data;
 }
 
 const uint8_t *ByteBuffer::GetBuffer( ) const
 {
-	return &buffer_internal[0];
+	return buffer_internal ? buffer_internal->data( ) : nullptr;
+}
+
+ByteBufferView ByteBuffer::Slice( ) const
+{
+	return Slice( 0, Size( ) );
+}
+
+ByteBufferView ByteBuffer::Slice( size_t offset, size_t size ) const
+{
+	size_t total = Size( );
+	if( offset > total )
+		offset = total;
+
+	if( size > total - offset )
+		size = total - offset;
+
+	if( size == 0 )
+		return ByteBufferView( );
+
+	if( buffer_exposed )
+	{
+		// Writes through GetBuffer can't be allowed to reach the view
+		const uint8_t *begin = buffer_internal->data( ) + offset;
+		std::shared_ptr<std::vector<uint8_t>> copy = std::make_shared<std::vector<uint8_t>>( begin, begin + size );
+		return ByteBufferView( std::shared_ptr<const uint8_t>( copy, copy->data( ) ), size );
+	}
+
+	std::shared_ptr<const uint8_t> data( buffer_internal, buffer_internal->data( ) + offset );
+	return ByteBufferView( data, size );
 }
 
 void ByteBuffer::Clear( )
 {
-	buffer_internal.clear( );
+	if( buffer_internal && buffer_internal.use_count( ) == 1 )
+		buffer_internal->clear( );
+	else
+		buffer_internal.reset( );
+
+	buffer_exposed = false;
 	buffer_offset = 0;
 	end_of_file = false;
 }
 
 void ByteBuffer::Reserve( size_t capacity )
 {
-	buffer_internal.reserve( capacity );
+	MutableStorage( ).reserve( capacity );
 }
 
 void ByteBuffer::Resize( size_t size )
 {
-	buffer_internal.resize( size );
+	MutableStorage( ).resize( size );
 
 	if( size < buffer_offset )
 		end_of_file = true;
@@ -162,14 +243,24 @@ void ByteBuffer::Resize( size_t size )
 
 void ByteBuffer::ShrinkToFit( )
 {
-	std::vector<uint8_t>( buffer_internal ).swap( buffer_internal );
+	if( buffer_internal )
+		buffer_internal = std::make_shared<std::vector<uint8_t>>( *buffer_internal );
+
+	buffer_exposed = false;
 }
 
 void ByteBuffer::Assign( const uint8_t *copy_buffer, size_t size )
 {
 	assert( copy_buffer != nullptr && size != 0 );
 
-	buffer_internal.assign( copy_buffer, copy_buffer + size );
+	if( !buffer_internal || buffer_internal.use_count( ) != 1 )
+	{
+		buffer_internal = buffer_pool != nullptr ? buffer_pool->Acquire( size ) : std::make_shared<std::vector<uint8_t>>( );
+		buffer_exposed = false;
+	}
+
+	buffer_internal->assign( copy_buffer, copy_buffer + size );
+
 	buffer_offset = 0;
 	end_of_file = false;
 }
@@ -178,16 +269,16 @@ size_t ByteBuffer::Read( void *value, size_t size )
 {
 	assert( value != nullptr && size != 0 );
 
-	if( buffer_offset >= buffer_internal.size( ) )
+	if( buffer_offset >= Size( ) )
 	{
 		end_of_file = true;
 		return 0;
 	}
 
-	size_t clamped = buffer_internal.size( ) - buffer_offset;
+	size_t clamped = Size( ) - buffer_offset;
 	if( clamped > size )
 		clamped = size;
-	std::memcpy( value, &buffer_internal[buffer_offset], clamped );
+	std::memcpy( value, buffer_internal->data( ) + buffer_offset, clamped );
 	buffer_offset += clamped;
 	if( clamped < size )
 		end_of_file = true;
@@ -199,13 +290,47 @@ size_t ByteBuffer::Write( const void *value, size_t size )
 {
 	assert( value != nullptr && size != 0 );
 
-	if( buffer_internal.size( ) < buffer_offset + size )
+	if( Size( ) < buffer_offset + size )
 		Resize( buffer_offset + size );
 
-	std::memcpy( &buffer_internal[buffer_offset], value, size );
+	std::memcpy( MutableStorage( ).data( ) + buffer_offset, value, size );
 	buffer_offset += size;
 	end_of_file = false;
 	return size;
 }
 
+std::vector<uint8_t> &ByteBuffer::MutableStorage( )
+{
+	if( buffer_internal && buffer_internal.use_count( ) == 1 )
+		return *buffer_internal;
+
+	BufferPool::Storage storage;
+	if( buffer_pool != nullptr )
+	{
+		storage = buffer_pool->Acquire( Size( ) );
+		storage->clear( );
+	}
+	else
+	{
+		storage = std::make_shared<std::vector<uint8_t>>( );
+	}
+
+	if( buffer_internal )
+		storage->assign( buffer_internal->begin( ), buffer_internal->end( ) );
+
+	buffer_internal = std::move( storage );
+	buffer_exposed = false;
+	return *buffer_internal;
+}
+
+void ByteBuffer::Share( const ByteBuffer &other )
+{
+	buffer_internal = other.buffer_internal;
+	buffer_exposed = false;
+
+	// The other buffer's pointer may still be written through
+	if( other.buffer_exposed && buffer_internal )
+		MutableStorage( );
+}
+
 } // namespace MultiLibrary
@@ -0,0 +1,162 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ByteBufferView.hpp>
+#include <cassert>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+ByteBufferView::ByteBufferView( ) :
+	view_size( 0 ),
+	view_offset( 0 ),
+	end_of_file( true )
+{ }
+
+ByteBufferView::ByteBufferView( const std::shared_ptr<const uint8_t> &data, size_t size ) :
+	view_data( data ),
+	view_size( data ? size : 0 ),
+	view_offset( 0 ),
+	end_of_file( view_size == 0 )
+{ }
+
+ByteBufferView::ByteBufferView( const uint8_t *data, size_t size, const Deleter &deleter ) :
+	view_data( data, deleter ),
+	view_size( data != nullptr ? size : 0 ),
+	view_offset( 0 ),
+	end_of_file( view_size == 0 )
+{ }
+
+bool ByteBufferView::IsValid( ) const
+{
+	return !EndOfFile( );
+}
+
+ByteBufferView::operator bool( ) const
+{
+	return IsValid( );
+}
+
+bool ByteBufferView::operator!( ) const
+{
+	return !IsValid( );
+}
+
+size_t ByteBufferView::Tell( ) const
+{
+	return view_offset;
+}
+
+size_t ByteBufferView::Size( ) const
+{
+	return view_size;
+}
+
+bool ByteBufferView::Seek( size_t position )
+{
+	view_offset = position < view_size ? position : view_size;
+	end_of_file = view_offset >= view_size;
+	return true;
+}
+
+bool ByteBufferView::Seek( int64_t position, SeekMode mode )
+{
+	int64_t temp;
+	switch( mode )
+	{
+	case SeekMode::Set:
+		return Seek( static_cast<size_t>( position > 0 ? position : 0 ) );
+
+	case SeekMode::Cur:
+		temp = static_cast<int64_t>( Tell( ) ) + position;
+		return Seek( static_cast<size_t>( temp > 0 ? temp : 0 ) );
+
+	case SeekMode::End:
+		temp = static_cast<int64_t>( Size( ) ) + position;
+		return Seek( static_cast<size_t>( temp > 0 ? temp : 0 ) );
+
+	default:
+		return false;
+	}
+}
+
+bool ByteBufferView::EndOfFile( ) const
+{
+	return end_of_file;
+}
+
+const uint8_t *ByteBufferView::GetBuffer( ) const
+{
+	return view_data.get( );
+}
+
+ByteBufferView ByteBufferView::Slice( size_t offset, size_t size ) const
+{
+	if( offset > view_size )
+		offset = view_size;
+
+	if( size > view_size - offset )
+		size = view_size - offset;
+
+	if( size == 0 )
+		return ByteBufferView( );
+
+	return ByteBufferView( std::shared_ptr<const uint8_t>( view_data, view_data.get( ) + offset ), size );
+}
+
+size_t ByteBufferView::Read( void *value, size_t size )
+{
+	assert( value != nullptr && size != 0 );
+
+	if( view_offset >= view_size )
+	{
+		end_of_file = true;
+		return 0;
+	}
+
+	size_t clamped = view_size - view_offset;
+	if( clamped > size )
+		clamped = size;
+
+	std::memcpy( value, view_data.get( ) + view_offset, clamped );
+	view_offset += clamped;
+	if( clamped < size )
+		end_of_file = true;
+
+	return clamped;
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,109 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#if ( defined __x86_64__ || defined __i386__ ) && defined __GNUC__
+
+	#define MULTILIBRARY_X86
+	#define MULTILIBRARY_TARGET( features ) __attribute__( ( target( features ) ) )
+
+#elif defined _MSC_VER && ( defined _M_X64 || defined _M_IX86 )
+
+	#define MULTILIBRARY_X86
+	#define MULTILIBRARY_TARGET( features )
+	#include <intrin.h>
+
+#endif
+
+namespace MultiLibrary
+{
+
+namespace Internal
+{
+
+#if defined MULTILIBRARY_X86
+
+struct CPUFeatures
+{
+	bool sse42;
+	bool avx2;
+
+	CPUFeatures( ) :
+		sse42( false ),
+		avx2( false )
+	{
+
+#if defined _MSC_VER
+
+		int info[4];
+		__cpuid( info, 0 );
+		int max_leaf = info[0];
+
+		__cpuid( info, 1 );
+		sse42 = ( info[2] & ( 1 << 20 ) ) != 0;
+
+		// AVX state must also be enabled by the operating system
+		bool os_avx = ( info[2] & ( 1 << 27 ) ) != 0 && ( info[2] & ( 1 << 28 ) ) != 0 && ( _xgetbv( 0 ) & 6 ) == 6;
+		if( max_leaf >= 7 && os_avx )
+		{
+			__cpuidex( info, 7, 0 );
+			avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+		}
+
+#else
+
+		__builtin_cpu_init( );
+		sse42 = __builtin_cpu_supports( "sse4.2" ) != 0;
+		avx2 = __builtin_cpu_supports( "avx2" ) != 0;
+
+#endif
+
+	}
+};
+
+inline const CPUFeatures &GetCPUFeatures( )
+{
+	static const CPUFeatures features;
+	return features;
+}
+
+#endif
+
+} // namespace Internal
+
+} // namespace MultiLibrary
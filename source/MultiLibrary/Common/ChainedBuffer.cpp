@@ -0,0 +1,349 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ChainedBuffer.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+ChainedBuffer::ChainedBuffer( size_t size, BufferPool &pool ) :
+	block_pool( &pool ),
+	block_size( size != 0 ? size : DEFAULT_BLOCK_SIZE ),
+	head_offset( 0 ),
+	data_size( 0 ),
+	read_offset( 0 ),
+	end_of_file( true )
+{ }
+
+ChainedBuffer::ChainedBuffer( ChainedBuffer &&buffer ) :
+	block_pool( buffer.block_pool ),
+	block_size( buffer.block_size ),
+	blocks( std::move( buffer.blocks ) ),
+	spare_blocks( std::move( buffer.spare_blocks ) ),
+	head_offset( buffer.head_offset ),
+	data_size( buffer.data_size ),
+	read_offset( buffer.read_offset ),
+	end_of_file( buffer.end_of_file )
+{
+	buffer.blocks.clear( );
+	buffer.spare_blocks.clear( );
+	buffer.Clear( );
+}
+
+ChainedBuffer::~ChainedBuffer( )
+{
+	Clear( );
+	ShrinkToFit( );
+}
+
+ChainedBuffer &ChainedBuffer::operator=( ChainedBuffer &&buffer )
+{
+	if( this == &buffer )
+		return *this;
+
+	Clear( );
+	ShrinkToFit( );
+
+	block_pool = buffer.block_pool;
+	block_size = buffer.block_size;
+	blocks = std::move( buffer.blocks );
+	spare_blocks = std::move( buffer.spare_blocks );
+	head_offset = buffer.head_offset;
+	data_size = buffer.data_size;
+	read_offset = buffer.read_offset;
+	end_of_file = buffer.end_of_file;
+
+	buffer.blocks.clear( );
+	buffer.spare_blocks.clear( );
+	buffer.Clear( );
+	return *this;
+}
+
+bool ChainedBuffer::IsValid( ) const
+{
+	return !EndOfFile( );
+}
+
+ChainedBuffer::operator bool( ) const
+{
+	return IsValid( );
+}
+
+bool ChainedBuffer::operator!( ) const
+{
+	return !IsValid( );
+}
+
+size_t ChainedBuffer::Tell( ) const
+{
+	return read_offset;
+}
+
+size_t ChainedBuffer::Size( ) const
+{
+	return data_size;
+}
+
+size_t ChainedBuffer::Capacity( ) const
+{
+	return blocks.size( ) * block_size - head_offset;
+}
+
+size_t ChainedBuffer::BlockSize( ) const
+{
+	return block_size;
+}
+
+bool ChainedBuffer::Seek( size_t position )
+{
+	read_offset = position < data_size ? position : data_size;
+	end_of_file = read_offset >= data_size;
+	return true;
+}
+
+bool ChainedBuffer::Seek( int64_t position, SeekMode mode )
+{
+	int64_t temp;
+	switch( mode )
+	{
+	case SeekMode::Set:
+		return Seek( static_cast<size_t>( position > 0 ? position : 0 ) );
+
+	case SeekMode::Cur:
+		temp = static_cast<int64_t>( Tell( ) ) + position;
+		return Seek( static_cast<size_t>( temp > 0 ? temp : 0 ) );
+
+	case SeekMode::End:
+		temp = static_cast<int64_t>( Size( ) ) + position;
+		return Seek( static_cast<size_t>( temp > 0 ? temp : 0 ) );
+
+	default:
+		return false;
+	}
+}
+
+bool ChainedBuffer::EndOfFile( ) const
+{
+	return end_of_file;
+}
+
+void ChainedBuffer::Clear( )
+{
+	while( !blocks.empty( ) )
+	{
+		ReleaseBlock( std::move( blocks.back( ) ) );
+		blocks.pop_back( );
+	}
+
+	head_offset = 0;
+	data_size = 0;
+	read_offset = 0;
+	end_of_file = false;
+}
+
+void ChainedBuffer::Reserve( size_t size )
+{
+	while( Capacity( ) - data_size < size )
+	{
+		if( spare_blocks.empty( ) )
+		{
+			blocks.push_back( block_pool->Acquire( block_size ) );
+			blocks.back( )->resize( block_size );
+		}
+		else
+		{
+			blocks.push_back( std::move( spare_blocks.back( ) ) );
+			spare_blocks.pop_back( );
+		}
+	}
+}
+
+void ChainedBuffer::ShrinkToFit( )
+{
+	for( Block &block : spare_blocks )
+		block_pool->Release( std::move( block ) );
+
+	spare_blocks.clear( );
+}
+
+size_t ChainedBuffer::Consume( size_t size )
+{
+	if( size > data_size )
+		size = data_size;
+
+	head_offset += size;
+	data_size -= size;
+	read_offset = read_offset > size ? read_offset - size : 0;
+
+	while( head_offset >= block_size )
+	{
+		ReleaseBlock( std::move( blocks.front( ) ) );
+		blocks.pop_front( );
+		head_offset -= block_size;
+	}
+
+	if( data_size == 0 )
+		head_offset = 0;
+
+	return size;
+}
+
+size_t ChainedBuffer::SegmentCount( ) const
+{
+	if( read_offset >= data_size )
+		return 0;
+
+	size_t first = ( head_offset + read_offset ) / block_size;
+	size_t last = ( head_offset + data_size - 1 ) / block_size;
+	return last - first + 1;
+}
+
+size_t ChainedBuffer::GetSegments( Segment *segments, size_t count ) const
+{
+	assert( segments != nullptr || count == 0 );
+
+	size_t position = head_offset + read_offset;
+	size_t end = head_offset + data_size;
+	size_t stored = 0;
+	while( position < end && stored < count )
+	{
+		size_t offset = position % block_size;
+		size_t length = std::min( block_size - offset, end - position );
+		segments[stored].data = blocks[position / block_size]->data( ) + offset;
+		segments[stored].size = length;
+		position += length;
+		++stored;
+	}
+
+	return stored;
+}
+
+size_t ChainedBuffer::PrepareSegments( size_t size, Segment *segments, size_t count )
+{
+	assert( segments != nullptr || count == 0 );
+
+	Reserve( size );
+
+	size_t position = head_offset + data_size;
+	size_t end = position + size;
+	size_t stored = 0;
+	while( position < end && stored < count )
+	{
+		size_t offset = position % block_size;
+		size_t length = std::min( block_size - offset, end - position );
+		segments[stored].data = blocks[position / block_size]->data( ) + offset;
+		segments[stored].size = length;
+		position += length;
+		++stored;
+	}
+
+	return stored;
+}
+
+void ChainedBuffer::Commit( size_t size )
+{
+	size_t available = Capacity( ) - data_size;
+	data_size += size < available ? size : available;
+	if( size != 0 )
+		end_of_file = read_offset >= data_size;
+}
+
+size_t ChainedBuffer::Read( void *value, size_t size )
+{
+	assert( value != nullptr && size != 0 );
+
+	if( read_offset >= data_size )
+	{
+		end_of_file = true;
+		return 0;
+	}
+
+	size_t clamped = data_size - read_offset;
+	if( clamped > size )
+		clamped = size;
+
+	uint8_t *output = static_cast<uint8_t *>( value );
+	size_t position = head_offset + read_offset;
+	size_t remaining = clamped;
+	while( remaining != 0 )
+	{
+		size_t offset = position % block_size;
+		size_t length = std::min( block_size - offset, remaining );
+		std::memcpy( output, blocks[position / block_size]->data( ) + offset, length );
+		output += length;
+		position += length;
+		remaining -= length;
+	}
+
+	read_offset += clamped;
+	if( clamped < size )
+		end_of_file = true;
+
+	return clamped;
+}
+
+size_t ChainedBuffer::Write( const void *value, size_t size )
+{
+	assert( value != nullptr && size != 0 );
+
+	Reserve( size );
+
+	const uint8_t *input = static_cast<const uint8_t *>( value );
+	size_t position = head_offset + data_size;
+	size_t remaining = size;
+	while( remaining != 0 )
+	{
+		size_t offset = position % block_size;
+		size_t length = std::min( block_size - offset, remaining );
+		std::memcpy( blocks[position / block_size]->data( ) + offset, input, length );
+		input += length;
+		position += length;
+		remaining -= length;
+	}
+
+	data_size += size;
+	end_of_file = false;
+	return size;
+}
+
+void ChainedBuffer::ReleaseBlock( Block &&block )
+{
+	spare_blocks.push_back( std::move( block ) );
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,338 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/Checksum.hpp>
+#include <MultiLibrary/Common/CPUFeatures.hpp>
+#include <MultiLibrary/Common/Endian.hpp>
+#include <cstring>
+
+#if defined MULTILIBRARY_X86
+
+	#include <nmmintrin.h>
+
+#endif
+
+namespace MultiLibrary
+{
+
+typedef uint32_t ( *CRC32CFunction )( uint32_t crc, const uint8_t *data, size_t size );
+
+static uint64_t Load64( const uint8_t *data )
+{
+	uint64_t value;
+	std::memcpy( &value, data, sizeof( value ) );
+	return ConvertEndianness( value, Endianness::Little );
+}
+
+static uint32_t Load32( const uint8_t *data )
+{
+	uint32_t value;
+	std::memcpy( &value, data, sizeof( value ) );
+	return ConvertEndianness( value, Endianness::Little );
+}
+
+// Slicing by 8 tables for the reflected Castagnoli polynomial
+struct CRC32CTables
+{
+	uint32_t table[8][256];
+
+	CRC32CTables( )
+	{
+		for( uint32_t k = 0; k < 256; ++k )
+		{
+			uint32_t crc = k;
+			for( int32_t bit = 0; bit < 8; ++bit )
+				crc = crc & 1 ? ( crc >> 1 ) ^ 0x82F63B78U : crc >> 1;
+
+			table[0][k] = crc;
+		}
+
+		for( uint32_t k = 0; k < 256; ++k )
+			for( size_t slice = 1; slice < 8; ++slice )
+				table[slice][k] = ( table[slice - 1][k] >> 8 ) ^ table[0][table[slice - 1][k] & 0xFF];
+	}
+};
+
+static uint32_t UpdateSoftware( uint32_t crc, const uint8_t *data, size_t size )
+{
+	static const CRC32CTables tables;
+	const uint32_t ( &table )[8][256] = tables.table;
+
+	while( size >= 8 )
+	{
+		uint32_t low = Load32( data ) ^ crc;
+		uint32_t high = Load32( data + 4 );
+		crc = table[7][low & 0xFF] ^ table[6][( low >> 8 ) & 0xFF] ^ table[5][( low >> 16 ) & 0xFF] ^ table[4][low >> 24] ^
+			table[3][high & 0xFF] ^ table[2][( high >> 8 ) & 0xFF] ^ table[1][( high >> 16 ) & 0xFF] ^ table[0][high >> 24];
+		data += 8;
+		size -= 8;
+	}
+
+	while( size-- != 0 )
+		crc = ( crc >> 8 ) ^ table[0][( crc ^ *data++ ) & 0xFF];
+
+	return crc;
+}
+
+#if defined MULTILIBRARY_X86
+
+MULTILIBRARY_TARGET( "sse4.2" ) static uint32_t UpdateHardware( uint32_t crc, const uint8_t *data, size_t size )
+{
+
+#if defined __x86_64__ || defined _M_X64
+
+	uint64_t crc64 = crc;
+	while( size >= 8 )
+	{
+		uint64_t value;
+		std::memcpy( &value, data, sizeof( value ) );
+		crc64 = _mm_crc32_u64( crc64, value );
+		data += 8;
+		size -= 8;
+	}
+
+	crc = static_cast<uint32_t>( crc64 );
+
+#endif
+
+	while( size >= 4 )
+	{
+		uint32_t value;
+		std::memcpy( &value, data, sizeof( value ) );
+		crc = _mm_crc32_u32( crc, value );
+		data += 4;
+		size -= 4;
+	}
+
+	while( size-- != 0 )
+		crc = _mm_crc32_u8( crc, *data++ );
+
+	return crc;
+}
+
+#endif
+
+static CRC32CFunction SelectCRC32C( )
+{
+
+#if defined MULTILIBRARY_X86
+
+	if( Internal::GetCPUFeatures( ).sse42 )
+		return UpdateHardware;
+
+#endif
+
+	return UpdateSoftware;
+}
+
+static CRC32CFunction GetCRC32C( )
+{
+	static const CRC32CFunction function = SelectCRC32C( );
+	return function;
+}
+
+CRC32C::CRC32C( ) :
+	state( 0xFFFFFFFFU )
+{ }
+
+void CRC32C::Update( const void *data, size_t size )
+{
+	state = GetCRC32C( )( state, static_cast<const uint8_t *>( data ), size );
+}
+
+uint32_t CRC32C::Value( ) const
+{
+	return ~state;
+}
+
+void CRC32C::Reset( )
+{
+	state = 0xFFFFFFFFU;
+}
+
+uint32_t CRC32C::Compute( const void *data, size_t size )
+{
+	return ~GetCRC32C( )( 0xFFFFFFFFU, static_cast<const uint8_t *>( data ), size );
+}
+
+bool CRC32C::IsAccelerated( )
+{
+	return GetCRC32C( ) != UpdateSoftware;
+}
+
+static const uint64_t prime1 = 11400714785074694791ULL;
+static const uint64_t prime2 = 14029467366897019727ULL;
+static const uint64_t prime3 = 1609587929392839161ULL;
+static const uint64_t prime4 = 9650029242287828579ULL;
+static const uint64_t prime5 = 2870177450012600261ULL;
+
+static uint64_t RotateLeft( uint64_t value, int32_t bits )
+{
+	return ( value << bits ) | ( value >> ( 64 - bits ) );
+}
+
+static uint64_t Round( uint64_t accumulator, uint64_t input )
+{
+	accumulator += input * prime2;
+	accumulator = RotateLeft( accumulator, 31 );
+	return accumulator * prime1;
+}
+
+static uint64_t MergeRound( uint64_t hash, uint64_t accumulator )
+{
+	hash ^= Round( 0, accumulator );
+	return hash * prime1 + prime4;
+}
+
+Hash64::Hash64( uint64_t seed ) :
+	hash_seed( seed )
+{
+	Reset( );
+}
+
+void Hash64::Update( const void *data, size_t size )
+{
+	const uint8_t *bytes = static_cast<const uint8_t *>( data );
+	total_size += size;
+
+	if( pending_size + size < sizeof( pending ) )
+	{
+		if( size != 0 )
+			std::memcpy( pending + pending_size, bytes, size );
+
+		pending_size += size;
+		return;
+	}
+
+	if( pending_size != 0 )
+	{
+		size_t fill = sizeof( pending ) - pending_size;
+		std::memcpy( pending + pending_size, bytes, fill );
+		for( size_t k = 0; k < 4; ++k )
+			accumulators[k] = Round( accumulators[k], Load64( pending + k * 8 ) );
+
+		bytes += fill;
+		size -= fill;
+		pending_size = 0;
+	}
+
+	uint64_t v1 = accumulators[0], v2 = accumulators[1], v3 = accumulators[2], v4 = accumulators[3];
+	while( size >= 32 )
+	{
+		v1 = Round( v1, Load64( bytes ) );
+		v2 = Round( v2, Load64( bytes + 8 ) );
+		v3 = Round( v3, Load64( bytes + 16 ) );
+		v4 = Round( v4, Load64( bytes + 24 ) );
+		bytes += 32;
+		size -= 32;
+	}
+
+	accumulators[0] = v1;
+	accumulators[1] = v2;
+	accumulators[2] = v3;
+	accumulators[3] = v4;
+
+	if( size != 0 )
+		std::memcpy( pending, bytes, size );
+
+	pending_size = size;
+}
+
+uint64_t Hash64::Value( ) const
+{
+	uint64_t hash;
+	if( total_size >= 32 )
+	{
+		hash = RotateLeft( accumulators[0], 1 ) + RotateLeft( accumulators[1], 7 ) + RotateLeft( accumulators[2], 12 ) + RotateLeft( accumulators[3], 18 );
+		for( size_t k = 0; k < 4; ++k )
+			hash = MergeRound( hash, accumulators[k] );
+	}
+	else
+	{
+		hash = hash_seed + prime5;
+	}
+
+	hash += total_size;
+
+	const uint8_t *bytes = pending;
+	size_t size = pending_size;
+	while( size >= 8 )
+	{
+		hash ^= Round( 0, Load64( bytes ) );
+		hash = RotateLeft( hash, 27 ) * prime1 + prime4;
+		bytes += 8;
+		size -= 8;
+	}
+
+	if( size >= 4 )
+	{
+		hash ^= Load32( bytes ) * prime1;
+		hash = RotateLeft( hash, 23 ) * prime2 + prime3;
+		bytes += 4;
+		size -= 4;
+	}
+
+	while( size-- != 0 )
+	{
+		hash ^= *bytes++ * prime5;
+		hash = RotateLeft( hash, 11 ) * prime1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+void Hash64::Reset( )
+{
+	accumulators[0] = hash_seed + prime1 + prime2;
+	accumulators[1] = hash_seed + prime2;
+	accumulators[2] = hash_seed;
+	accumulators[3] = hash_seed - prime1;
+	pending_size = 0;
+	total_size = 0;
+}
+
+uint64_t Hash64::Compute( const void *data, size_t size, uint64_t seed )
+{
+	Hash64 hash( seed );
+	hash.Update( data, size );
+	return hash.Value( );
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,208 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/CompressingOutputStream.hpp>
+#include <MultiLibrary/Common/Endian.hpp>
+#include <MultiLibrary/Common/LZ.hpp>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+// Stream layout, all integers little endian:
+//  header: "MLZ", version byte, uint32 block size
+//  blocks: uint32 stored size (bit 31 set if stored uncompressed), data
+//  end: uint32 zero
+static const uint8_t stream_magic[4] = { 'M', 'L', 'Z', 1 };
+static const uint32_t stored_flag = 0x80000000U;
+
+CompressingOutputStream::CompressingOutputStream( OutputStream &stream, size_t block_size ) :
+	output_stream( stream ),
+	input_buffer( block_size == 0 ? DEFAULT_BLOCK_SIZE : block_size > MAX_BLOCK_SIZE ? MAX_BLOCK_SIZE : block_size ),
+	output_buffer( LZ::CompressBound( input_buffer.size( ) ) ),
+	input_used( 0 ),
+	total_in( 0 ),
+	total_out( 0 ),
+	header_written( false ),
+	finished( false ),
+	failed( false )
+{ }
+
+CompressingOutputStream::~CompressingOutputStream( )
+{
+	Finish( );
+}
+
+bool CompressingOutputStream::IsValid( ) const
+{
+	return !finished && !failed && output_stream.IsValid( );
+}
+
+bool CompressingOutputStream::Seek( size_t )
+{
+	return false;
+}
+
+bool CompressingOutputStream::Seek( int64_t, SeekMode )
+{
+	return false;
+}
+
+size_t CompressingOutputStream::Tell( ) const
+{
+	return static_cast<size_t>( total_in );
+}
+
+size_t CompressingOutputStream::Size( ) const
+{
+	return static_cast<size_t>( total_in );
+}
+
+bool CompressingOutputStream::EndOfFile( ) const
+{
+	return false;
+}
+
+size_t CompressingOutputStream::Write( const void *data, size_t size )
+{
+	if( finished || failed )
+		return 0;
+
+	const uint8_t *bytes = static_cast<const uint8_t *>( data );
+	size_t remaining = size;
+	while( remaining != 0 )
+	{
+		size_t chunk = input_buffer.size( ) - input_used;
+		if( chunk > remaining )
+			chunk = remaining;
+
+		std::memcpy( input_buffer.data( ) + input_used, bytes, chunk );
+		input_used += chunk;
+		bytes += chunk;
+		remaining -= chunk;
+
+		if( input_used == input_buffer.size( ) && !WriteBlock( ) )
+		{
+			total_in += size - remaining;
+			return size - remaining;
+		}
+	}
+
+	total_in += size;
+	return size;
+}
+
+bool CompressingOutputStream::Flush( )
+{
+	if( finished || failed )
+		return false;
+
+	return input_used == 0 || WriteBlock( );
+}
+
+bool CompressingOutputStream::Finish( )
+{
+	if( finished )
+		return !failed;
+
+	// Also writes the header of streams with no data
+	bool success = !failed && WriteBlock( );
+	finished = true;
+	if( !success )
+		return false;
+
+	uint32_t end = 0;
+	return WriteThrough( &end, sizeof( end ) );
+}
+
+uint64_t CompressingOutputStream::CompressedSize( ) const
+{
+	return total_out;
+}
+
+bool CompressingOutputStream::WriteBlock( )
+{
+	if( !header_written )
+	{
+		uint32_t block_size = ConvertEndianness( static_cast<uint32_t>( input_buffer.size( ) ), Endianness::Little );
+		if( !WriteThrough( stream_magic, sizeof( stream_magic ) ) || !WriteThrough( &block_size, sizeof( block_size ) ) )
+			return false;
+
+		header_written = true;
+	}
+
+	if( input_used == 0 )
+		return true;
+
+	// Blocks that don't shrink are cheaper to store as they are
+	size_t compressed = LZ::Compress( input_buffer.data( ), input_used, output_buffer.data( ), input_used - 1 );
+	const uint8_t *block = output_buffer.data( );
+	uint32_t frame = static_cast<uint32_t>( compressed );
+	if( compressed == 0 )
+	{
+		block = input_buffer.data( );
+		compressed = input_used;
+		frame = static_cast<uint32_t>( input_used ) | stored_flag;
+	}
+
+	frame = ConvertEndianness( frame, Endianness::Little );
+	if( !WriteThrough( &frame, sizeof( frame ) ) || !WriteThrough( block, compressed ) )
+		return false;
+
+	input_used = 0;
+	return true;
+}
+
+bool CompressingOutputStream::WriteThrough( const void *data, size_t size )
+{
+	const uint8_t *bytes = static_cast<const uint8_t *>( data );
+	while( size != 0 )
+	{
+		size_t written = output_stream.Write( bytes, size );
+		if( written == 0 )
+		{
+			failed = true;
+			return false;
+		}
+
+		bytes += written;
+		size -= written;
+		total_out += written;
+	}
+
+	return true;
+}
+
+} // namespace MultiLibrary
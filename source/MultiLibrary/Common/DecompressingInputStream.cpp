@@ -0,0 +1,197 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/DecompressingInputStream.hpp>
+#include <MultiLibrary/Common/CompressingOutputStream.hpp>
+#include <MultiLibrary/Common/Endian.hpp>
+#include <MultiLibrary/Common/LZ.hpp>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+static const uint8_t stream_magic[4] = { 'M', 'L', 'Z', 1 };
+static const uint32_t stored_flag = 0x80000000U;
+
+DecompressingInputStream::DecompressingInputStream( InputStream &stream ) :
+	input_stream( stream ),
+	block_size( 0 ),
+	output_offset( 0 ),
+	output_used( 0 ),
+	total_out( 0 ),
+	header_read( false ),
+	end_of_file( false ),
+	errored( false )
+{ }
+
+bool DecompressingInputStream::IsValid( ) const
+{
+	return !errored;
+}
+
+bool DecompressingInputStream::Seek( size_t )
+{
+	return false;
+}
+
+bool DecompressingInputStream::Seek( int64_t, SeekMode )
+{
+	return false;
+}
+
+size_t DecompressingInputStream::Tell( ) const
+{
+	return static_cast<size_t>( total_out - ( output_used - output_offset ) );
+}
+
+size_t DecompressingInputStream::Size( ) const
+{
+	return static_cast<size_t>( total_out );
+}
+
+bool DecompressingInputStream::EndOfFile( ) const
+{
+	return end_of_file && output_offset == output_used;
+}
+
+size_t DecompressingInputStream::Read( void *data, size_t size )
+{
+	uint8_t *bytes = static_cast<uint8_t *>( data );
+	size_t total = 0;
+	while( total < size )
+	{
+		if( output_offset == output_used && !ReadBlock( ) )
+			break;
+
+		size_t chunk = output_used - output_offset;
+		if( chunk > size - total )
+			chunk = size - total;
+
+		std::memcpy( bytes + total, output_buffer.data( ) + output_offset, chunk );
+		output_offset += chunk;
+		total += chunk;
+	}
+
+	return total;
+}
+
+bool DecompressingInputStream::ReadHeader( )
+{
+	uint8_t magic[sizeof( stream_magic )];
+	uint32_t size = 0;
+	if( !ReadExact( magic, sizeof( magic ) ) || std::memcmp( magic, stream_magic, sizeof( magic ) ) != 0 || !ReadExact( &size, sizeof( size ) ) )
+	{
+		errored = true;
+		return false;
+	}
+
+	// Reject sizes the compressor can't produce, so memory stays bounded
+	block_size = ConvertEndianness( size, Endianness::Little );
+	if( block_size == 0 || block_size > CompressingOutputStream::MAX_BLOCK_SIZE )
+	{
+		errored = true;
+		return false;
+	}
+
+	input_buffer.resize( block_size );
+	output_buffer.resize( block_size );
+	header_read = true;
+	return true;
+}
+
+bool DecompressingInputStream::ReadBlock( )
+{
+	if( end_of_file || errored || ( !header_read && !ReadHeader( ) ) )
+		return false;
+
+	uint32_t frame = 0;
+	if( !ReadExact( &frame, sizeof( frame ) ) )
+	{
+		errored = true;
+		return false;
+	}
+
+	frame = ConvertEndianness( frame, Endianness::Little );
+	if( frame == 0 )
+	{
+		end_of_file = true;
+		return false;
+	}
+
+	size_t stored_size = frame & ~stored_flag;
+	if( stored_size > block_size )
+	{
+		errored = true;
+		return false;
+	}
+
+	size_t decompressed = stored_size;
+	if( ( frame & stored_flag ) != 0 )
+	{
+		if( !ReadExact( output_buffer.data( ), stored_size ) )
+		{
+			errored = true;
+			return false;
+		}
+	}
+	else if( !ReadExact( input_buffer.data( ), stored_size ) || !LZ::Decompress( input_buffer.data( ), stored_size, output_buffer.data( ), block_size, decompressed ) )
+	{
+		errored = true;
+		return false;
+	}
+
+	output_offset = 0;
+	output_used = decompressed;
+	total_out += decompressed;
+	return true;
+}
+
+bool DecompressingInputStream::ReadExact( void *data, size_t size )
+{
+	uint8_t *bytes = static_cast<uint8_t *>( data );
+	while( size != 0 )
+	{
+		size_t read = input_stream.Read( bytes, size );
+		if( read == 0 )
+			return false;
+
+		bytes += read;
+		size -= read;
+	}
+
+	return true;
+}
+
+} // namespace MultiLibrary
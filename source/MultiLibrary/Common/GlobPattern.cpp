@@ -0,0 +1,370 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/GlobPattern.hpp>
+#include <MultiLibrary/Common/Unicode.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace MultiLibrary
+{
+
+static const uint32_t invalid_codepoint = 0xFFFD;
+static const size_t inline_words = 4;
+
+GlobPattern::GlobPattern( ) :
+	prefix_tokens( 0 ),
+	suffix_tokens( 0 ),
+	literal( true ),
+	words( 1 )
+{ }
+
+GlobPattern::GlobPattern( StringView pattern ) :
+	prefix_tokens( 0 ),
+	suffix_tokens( 0 ),
+	literal( true ),
+	words( 1 )
+{
+	Compile( pattern );
+}
+
+// Parses a class whose opening bracket was already consumed, returns nullptr
+// if there is no closing bracket
+static const char *ParseClass( const char *it, const char *end, bool &negated, std::vector<uint32_t> &ranges )
+{
+	negated = false;
+	if( it != end && ( *it == '!' || *it == '^' ) )
+	{
+		negated = true;
+		++it;
+	}
+
+	bool first = true;
+	while( it != end )
+	{
+		if( *it == ']' && !first )
+			return it + 1;
+
+		first = false;
+		if( *it == '\\' && it + 1 != end )
+			++it;
+
+		uint32_t low;
+		it = UTF8::Decode( it, end, low, invalid_codepoint );
+		uint32_t high = low;
+		if( it != end && *it == '-' && it + 1 != end && it[1] != ']' )
+		{
+			++it;
+			if( *it == '\\' && it + 1 != end )
+				++it;
+
+			it = UTF8::Decode( it, end, high, invalid_codepoint );
+		}
+
+		ranges.push_back( std::min( low, high ) );
+		ranges.push_back( std::max( low, high ) );
+	}
+
+	return nullptr;
+}
+
+void GlobPattern::Compile( StringView pattern )
+{
+	source_pattern = pattern.ToString( );
+	tokens.clear( );
+
+	const char *it = pattern.begin( ), *end = pattern.end( );
+	while( it != end )
+	{
+		Token token;
+		token.type = TokenType::Literal;
+		token.negated = false;
+		it = UTF8::Decode( it, end, token.codepoint, invalid_codepoint );
+		if( token.codepoint == '*' )
+		{
+			token.type = TokenType::Star;
+			while( it != end && *it == '*' )
+			{
+				token.type = TokenType::GlobStar;
+				++it;
+			}
+
+			// Consecutive stars are merged, the automaton relies on it
+			if( !tokens.empty( ) && ( tokens.back( ).type == TokenType::Star || tokens.back( ).type == TokenType::GlobStar ) )
+			{
+				if( token.type == TokenType::GlobStar )
+					tokens.back( ).type = TokenType::GlobStar;
+
+				continue;
+			}
+		}
+		else if( token.codepoint == '?' )
+		{
+			token.type = TokenType::Any;
+		}
+		else if( token.codepoint == '[' )
+		{
+			const char *class_end = ParseClass( it, end, token.negated, token.ranges );
+			if( class_end != nullptr )
+			{
+				token.type = TokenType::Class;
+				it = class_end;
+			}
+		}
+		else if( token.codepoint == '\\' && it != end )
+		{
+			it = UTF8::Decode( it, end, token.codepoint, invalid_codepoint );
+		}
+
+		tokens.push_back( token );
+	}
+
+	prefix_tokens = 0;
+	literal_prefix.clear( );
+	while( prefix_tokens < tokens.size( ) && tokens[prefix_tokens].type == TokenType::Literal )
+		UTF8::Encode( tokens[prefix_tokens++].codepoint, std::back_inserter( literal_prefix ) );
+
+	suffix_tokens = 0;
+	while( prefix_tokens + suffix_tokens < tokens.size( ) )
+	{
+		// The slash of **/ can be skipped, so it can't be part of the suffix
+		size_t index = tokens.size( ) - suffix_tokens - 1;
+		if( tokens[index].type != TokenType::Literal || ( tokens[index].codepoint == '/' && tokens[index - 1].type == TokenType::GlobStar ) )
+			break;
+
+		++suffix_tokens;
+	}
+
+	literal_suffix.clear( );
+	for( size_t k = tokens.size( ) - suffix_tokens; k < tokens.size( ); ++k )
+		UTF8::Encode( tokens[k].codepoint, std::back_inserter( literal_suffix ) );
+
+	literal = prefix_tokens == tokens.size( );
+	words = ( tokens.size( ) + 1 + 63 ) / 64;
+
+	star_mask.assign( words, 0 );
+	skip_mask.assign( words, 0 );
+	for( size_t k = 0; k < tokens.size( ); ++k )
+	{
+		TokenType type = tokens[k].type;
+		if( type == TokenType::Star || type == TokenType::GlobStar )
+			star_mask[k / 64] |= uint64_t( 1 ) << ( k % 64 );
+
+		if( type == TokenType::GlobStar && k + 1 < tokens.size( ) && tokens[k + 1].type == TokenType::Literal && tokens[k + 1].codepoint == '/' )
+			skip_mask[k / 64] |= uint64_t( 1 ) << ( k % 64 );
+	}
+
+	ascii_accept.assign( 128 * words, 0 );
+	ascii_loop.assign( 128 * words, 0 );
+	for( uint32_t ch = 0; ch < 128; ++ch )
+		BuildMasks( ch, &ascii_accept[ch * words], &ascii_loop[ch * words] );
+}
+
+const std::string &GlobPattern::GetPattern( ) const
+{
+	return source_pattern;
+}
+
+bool GlobPattern::IsLiteral( ) const
+{
+	return literal;
+}
+
+bool GlobPattern::Match( StringView name ) const
+{
+	if( literal )
+		return name == StringView( literal_prefix );
+
+	if( name.Size( ) < literal_prefix.size( ) + literal_suffix.size( ) || !name.StartsWith( literal_prefix ) || !name.EndsWith( literal_suffix ) )
+		return false;
+
+	return MatchMiddle( name.begin( ) + literal_prefix.size( ), name.end( ) - literal_suffix.size( ) );
+}
+
+size_t GlobPattern::Match( const StringView *names, size_t count, bool *results ) const
+{
+	size_t matches = 0;
+	for( size_t k = 0; k < count; ++k )
+	{
+		results[k] = Match( names[k] );
+		matches += results[k] ? 1 : 0;
+	}
+
+	return matches;
+}
+
+size_t GlobPattern::Filter( std::vector<std::string> &names ) const
+{
+	size_t kept = 0;
+	for( size_t k = 0; k < names.size( ); ++k )
+		if( Match( names[k] ) )
+		{
+			if( kept != k )
+				names[kept].swap( names[k] );
+
+			++kept;
+		}
+
+	names.resize( kept );
+	return kept;
+}
+
+bool GlobPattern::TokenMatches( const Token &token, uint32_t codepoint ) const
+{
+	switch( token.type )
+	{
+	case TokenType::Literal:
+		return codepoint == token.codepoint;
+
+	case TokenType::Class:
+	{
+		if( codepoint == '/' )
+			return false;
+
+		bool found = false;
+		for( size_t k = 0; k < token.ranges.size( ) && !found; k += 2 )
+			found = codepoint >= token.ranges[k] && codepoint <= token.ranges[k + 1];
+
+		return found != token.negated;
+	}
+
+	case TokenType::GlobStar:
+		return true;
+
+	default:
+		return codepoint != '/';
+	}
+}
+
+void GlobPattern::BuildMasks( uint32_t codepoint, uint64_t *accept, uint64_t *loop ) const
+{
+	std::fill( accept, accept + words, 0 );
+	std::fill( loop, loop + words, 0 );
+	for( size_t k = 0; k < tokens.size( ); ++k )
+	{
+		const Token &token = tokens[k];
+		if( !TokenMatches( token, codepoint ) )
+			continue;
+
+		if( token.type == TokenType::Star || token.type == TokenType::GlobStar )
+			loop[k / 64] |= uint64_t( 1 ) << ( k % 64 );
+		else
+			accept[k / 64] |= uint64_t( 1 ) << ( k % 64 );
+	}
+}
+
+// Follows the empty transitions of newly entered states: stars may match
+// nothing and **/ may be skipped entirely, but only before ** consumed anything
+static void Closure( uint64_t *state, const uint64_t *star_mask, const uint64_t *skip_mask, size_t words )
+{
+	bool changed = true;
+	while( changed )
+	{
+		changed = false;
+		uint64_t star_carry = 0, skip_carry = 0;
+		for( size_t w = 0; w < words; ++w )
+		{
+			uint64_t stars = state[w] & star_mask[w], skips = state[w] & skip_mask[w];
+			uint64_t added = ( stars << 1 | star_carry | skips << 2 | skip_carry ) & ~state[w];
+			star_carry = stars >> 63;
+			skip_carry = skips >> 62;
+			if( added != 0 )
+			{
+				state[w] |= added;
+				changed = true;
+			}
+		}
+	}
+}
+
+bool GlobPattern::MatchMiddle( const char *begin, const char *end ) const
+{
+	// Bit k of the state is set when the first k tokens matched
+	uint64_t inline_buffer[4 * inline_words];
+	std::vector<uint64_t> heap_buffer;
+	uint64_t *buffer = inline_buffer;
+	if( words > inline_words )
+	{
+		heap_buffer.resize( 4 * words );
+		buffer = heap_buffer.data( );
+	}
+
+	uint64_t *state = buffer, *next = buffer + words, *accept = buffer + 2 * words, *loop = buffer + 3 * words;
+	std::fill( state, state + words, 0 );
+	state[prefix_tokens / 64] = uint64_t( 1 ) << ( prefix_tokens % 64 );
+	Closure( state, star_mask.data( ), skip_mask.data( ), words );
+
+	while( begin != end )
+	{
+		const uint64_t *accept_mask = accept, *loop_mask = loop;
+		uint8_t byte = static_cast<uint8_t>( *begin );
+		if( byte < 0x80 )
+		{
+			accept_mask = &ascii_accept[byte * words];
+			loop_mask = &ascii_loop[byte * words];
+			++begin;
+		}
+		else
+		{
+			uint32_t codepoint;
+			begin = UTF8::Decode( begin, end, codepoint, invalid_codepoint );
+			BuildMasks( codepoint, accept, loop );
+		}
+
+		// Stars which keep looping may still stop matching, but never skip
+		uint64_t carry = 0, alive = 0;
+		for( size_t w = 0; w < words; ++w )
+		{
+			uint64_t advanced = state[w] & ( accept_mask[w] | loop_mask[w] );
+			next[w] = advanced << 1 | carry;
+			carry = advanced >> 63;
+			alive |= advanced;
+		}
+
+		if( alive == 0 )
+			return false;
+
+		Closure( next, star_mask.data( ), skip_mask.data( ), words );
+		for( size_t w = 0; w < words; ++w )
+			next[w] |= state[w] & loop_mask[w];
+
+		std::swap( state, next );
+	}
+
+	size_t final_state = tokens.size( ) - suffix_tokens;
+	return ( state[final_state / 64] >> ( final_state % 64 ) & 1 ) != 0;
+}
+
+} // namespace MultiLibrary
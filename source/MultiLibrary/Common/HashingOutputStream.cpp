@@ -0,0 +1,108 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/HashingOutputStream.hpp>
+
+namespace MultiLibrary
+{
+
+HashingOutputStream::HashingOutputStream( OutputStream &stream, uint64_t seed ) :
+	output_stream( stream ),
+	hash64( seed ),
+	hashed_size( 0 )
+{ }
+
+bool HashingOutputStream::IsValid( ) const
+{
+	return output_stream.IsValid( );
+}
+
+bool HashingOutputStream::Seek( size_t )
+{
+	return false;
+}
+
+bool HashingOutputStream::Seek( int64_t, SeekMode )
+{
+	return false;
+}
+
+size_t HashingOutputStream::Tell( ) const
+{
+	return output_stream.Tell( );
+}
+
+size_t HashingOutputStream::Size( ) const
+{
+	return output_stream.Size( );
+}
+
+bool HashingOutputStream::EndOfFile( ) const
+{
+	return output_stream.EndOfFile( );
+}
+
+size_t HashingOutputStream::Write( const void *data, size_t size )
+{
+	size_t written = output_stream.Write( data, size );
+	crc32c.Update( data, written );
+	hash64.Update( data, written );
+	hashed_size += written;
+	return written;
+}
+
+uint32_t HashingOutputStream::GetCRC32C( ) const
+{
+	return crc32c.Value( );
+}
+
+uint64_t HashingOutputStream::GetHash64( ) const
+{
+	return hash64.Value( );
+}
+
+uint64_t HashingOutputStream::GetSize( ) const
+{
+	return hashed_size;
+}
+
+void HashingOutputStream::Reset( )
+{
+	crc32c.Reset( );
+	hash64.Reset( );
+	hashed_size = 0;
+}
+
+} // namespace MultiLibrary
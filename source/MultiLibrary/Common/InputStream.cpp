@@ -40,18 +40,24 @@ namespace MultiLibrary
 
 InputStream &InputStream::operator>>( std::string &data )
 {
-	char ch = '\0', nch = '\0';
-	if( Read( &ch, sizeof( ch ) ) != sizeof( ch ) || ch == '\0' || ch == '\n' )
+	ExtractString( data );
+	return *this;
+}
+
+InputStream &InputStream::operator>>( std::wstring &data )
+{
+	wchar_t ch = L'\0', nch = L'\0';
+	if( Read( &ch, sizeof( ch ) ) != sizeof( ch ) || ch == L'\0' || ch == L'\n' )
 		return *this;
 
 	do
 	{
-		if( Read( &nch, sizeof( nch ) ) != sizeof( nch ) || nch == '\0' || nch == '\n' )
+		if( Read( &nch, sizeof( nch ) ) != sizeof( nch ) || nch == L'\0' || nch == L'\n' )
 		{
 
 #ifdef _WIN32
 
-			if( ch == '\r' )
+			if( ch == L'\r' )
 				break;
 
 #endif
@@ -64,25 +70,25 @@ InputStream &InputStream::operator>>( std::string &data )
 
 		ch = nch;
 	}
-	while( ch != '\0' && ch != '\n' );
+	while( ch != L'\0' && ch != L'\n' );
 
 	return *this;
 }
 
-InputStream &InputStream::operator>>( std::wstring &data )
+void InputStream::ExtractString( std::string &data )
 {
-	wchar_t ch = L'\0', nch = L'\0';
-	if( Read( &ch, sizeof( ch ) ) != sizeof( ch ) || ch == L'\0' || ch == L'\n' )
-		return *this;
+	char ch = '\0', nch = '\0';
+	if( Read( &ch, sizeof( ch ) ) != sizeof( ch ) || ch == '\0' || ch == '\n' )
+		return;
 
 	do
 	{
-		if( Read( &nch, sizeof( nch ) ) != sizeof( nch ) || nch == L'\0' || nch == L'\n' )
+		if( Read( &nch, sizeof( nch ) ) != sizeof( nch ) || nch == '\0' || nch == '\n' )
 		{
 
 #ifdef _WIN32
 
-			if( ch == L'\r' )
+			if( ch == '\r' )
 				break;
 
 #endif
@@ -95,9 +101,7 @@ InputStream &InputStream::operator>>( std::wstring &data )
 
 		ch = nch;
 	}
-	while( ch != L'\0' && ch != L'\n' );
-
-	return *this;
+	while( ch != '\0' && ch != '\n' );
 }
 
 } // namespace MultiLibrary
@@ -0,0 +1,198 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/InternedString.hpp>
+#include <MultiLibrary/Common/Checksum.hpp>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace MultiLibrary
+{
+
+using Internal::InternedStringEntry;
+
+static const size_t intern_shard_bits = 5;
+static const size_t intern_shard_count = 1 << intern_shard_bits;
+static const size_t intern_block_size = 64 * 1024;
+
+// Constant initialized, so default constructed strings work during static initialization
+static const InternedStringEntry empty_entry = { 0, 0, "" };
+
+// Each shard is an open addressing table guarded by its own mutex, with the
+// entries and their characters carved out of large blocks
+struct InternTableShard
+{
+	InternTableShard( ) :
+		slots( 64, nullptr ),
+		used( 0 ),
+		block_cursor( nullptr ),
+		block_left( 0 )
+	{ }
+
+	const InternedStringEntry *Find( StringView str, size_t hash ) const
+	{
+		size_t mask = slots.size( ) - 1;
+		for( size_t index = hash & mask; slots[index] != nullptr; index = ( index + 1 ) & mask )
+		{
+			const InternedStringEntry *entry = slots[index];
+			if( entry->hash == hash && StringView( entry->data, entry->size ) == str )
+				return entry;
+		}
+
+		return nullptr;
+	}
+
+	void Insert( const InternedStringEntry *entry )
+	{
+		size_t mask = slots.size( ) - 1;
+		size_t index = entry->hash & mask;
+		while( slots[index] != nullptr )
+			index = ( index + 1 ) & mask;
+
+		slots[index] = entry;
+	}
+
+	void Grow( )
+	{
+		std::vector<const InternedStringEntry *> old_slots( slots.size( ) * 2, nullptr );
+		old_slots.swap( slots );
+		for( const InternedStringEntry *entry : old_slots )
+			if( entry != nullptr )
+				Insert( entry );
+	}
+
+	void *Allocate( size_t size )
+	{
+		const size_t alignment = alignof( InternedStringEntry );
+		size = ( size + alignment - 1 ) & ~( alignment - 1 );
+		if( size > block_left )
+		{
+			size_t block_size = size > intern_block_size / 4 ? size : intern_block_size;
+			blocks.emplace_back( new char[block_size] );
+			if( block_size != intern_block_size )
+				return blocks.back( ).get( );
+
+			block_cursor = blocks.back( ).get( );
+			block_left = block_size;
+		}
+
+		void *memory = block_cursor;
+		block_cursor += size;
+		block_left -= size;
+		return memory;
+	}
+
+	const InternedStringEntry *Intern( StringView str, size_t hash )
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		const InternedStringEntry *entry = Find( str, hash );
+		if( entry != nullptr )
+			return entry;
+
+		if( ( used + 1 ) * 4 > slots.size( ) * 3 )
+			Grow( );
+
+		char *memory = static_cast<char *>( Allocate( sizeof( InternedStringEntry ) + str.Size( ) + 1 ) );
+		char *data = memory + sizeof( InternedStringEntry );
+		std::memcpy( data, str.Data( ), str.Size( ) );
+		data[str.Size( )] = '\0';
+
+		InternedStringEntry *new_entry = new( memory ) InternedStringEntry;
+		new_entry->hash = hash;
+		new_entry->size = str.Size( );
+		new_entry->data = data;
+		Insert( new_entry );
+		++used;
+		return new_entry;
+	}
+
+	std::mutex mutex;
+	std::vector<const InternedStringEntry *> slots;
+	size_t used;
+	std::vector<std::unique_ptr<char[]>> blocks;
+	char *block_cursor;
+	size_t block_left;
+};
+
+struct InternTable
+{
+	InternTableShard shards[intern_shard_count];
+};
+
+static InternTable &GetInternTable( )
+{
+	// Never destroyed, interned strings may be used by other static objects
+	static InternTable *table = new InternTable;
+	return *table;
+}
+
+InternedString::InternedString( ) :
+	entry( &empty_entry )
+{ }
+
+InternedString::InternedString( StringView str ) :
+	entry( &empty_entry )
+{
+	if( str.Empty( ) )
+		return;
+
+	size_t hash = static_cast<size_t>( Hash64::Compute( str.Data( ), str.Size( ) ) );
+	// Low bits pick the slot, so shards are picked from the high bits
+	size_t shard = hash >> ( sizeof( size_t ) * 8 - intern_shard_bits );
+	entry = GetInternTable( ).shards[shard].Intern( str, hash );
+}
+
+std::string InternedString::ToString( ) const
+{
+	return std::string( entry->data, entry->size );
+}
+
+size_t InternedString::GetInternedCount( )
+{
+	InternTable &table = GetInternTable( );
+	size_t count = 0;
+	for( InternTableShard &shard : table.shards )
+	{
+		std::lock_guard<std::mutex> lock( shard.mutex );
+		count += shard.used;
+	}
+
+	return count;
+}
+
+} // namespace MultiLibrary
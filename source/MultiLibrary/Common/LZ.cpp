@@ -0,0 +1,255 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/LZ.hpp>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+namespace LZ
+{
+
+static const size_t min_match = 4;
+static const size_t max_offset = 65535;
+static const size_t hash_bits = 12;
+
+// The last bytes of a block are always literals, which keeps the match
+// search from reading past the end of the input
+static const size_t last_literals = 5;
+static const size_t match_limit = 12;
+
+static uint32_t Load32( const uint8_t *data )
+{
+	uint32_t value;
+	std::memcpy( &value, data, sizeof( value ) );
+	return value;
+}
+
+static uint32_t Hash( uint32_t sequence )
+{
+	return ( sequence * 2654435761U ) >> ( 32 - hash_bits );
+}
+
+static uint8_t *WriteLength( uint8_t *output, size_t length )
+{
+	while( length >= 255 )
+	{
+		*output++ = 255;
+		length -= 255;
+	}
+
+	*output++ = static_cast<uint8_t>( length );
+	return output;
+}
+
+static bool ReadLength( const uint8_t *&input, const uint8_t *input_end, size_t &length )
+{
+	uint8_t byte = 255;
+	while( byte == 255 )
+	{
+		if( input == input_end )
+			return false;
+
+		byte = *input++;
+		length += byte;
+	}
+
+	return true;
+}
+
+static size_t LengthBytes( size_t length )
+{
+	return length >= 15 ? ( length - 15 ) / 255 + 1 : 0;
+}
+
+size_t CompressBound( size_t size )
+{
+	return size + size / 255 + 16;
+}
+
+size_t Compress( const void *source, size_t source_size, void *destination, size_t destination_size )
+{
+	const uint8_t *input = static_cast<const uint8_t *>( source );
+	const uint8_t *input_end = input + source_size;
+	uint8_t *output = static_cast<uint8_t *>( destination );
+	uint8_t *output_end = output + destination_size;
+
+	const uint8_t *anchor = input;
+	if( source_size >= match_limit )
+	{
+		uint32_t table[1 << hash_bits];
+		std::memset( table, 0, sizeof( table ) );
+
+		const uint8_t *match_end = input_end - match_limit;
+		const uint8_t *ip = input + 1;
+		while( ip < match_end )
+		{
+			uint32_t sequence = Load32( ip );
+			uint32_t hash = Hash( sequence );
+			const uint8_t *reference = input + table[hash];
+			table[hash] = static_cast<uint32_t>( ip - input );
+			if( static_cast<size_t>( ip - reference ) > max_offset || Load32( reference ) != sequence )
+			{
+				++ip;
+				continue;
+			}
+
+			// Extend the match backwards over pending literals
+			while( ip > anchor && reference > input && ip[-1] == reference[-1] )
+			{
+				--ip;
+				--reference;
+			}
+
+			const uint8_t *limit = input_end - last_literals;
+			const uint8_t *match = ip + min_match;
+			const uint8_t *match_reference = reference + min_match;
+			while( match < limit && *match == *match_reference )
+			{
+				++match;
+				++match_reference;
+			}
+
+			size_t literal_length = static_cast<size_t>( ip - anchor );
+			size_t match_length = static_cast<size_t>( match - ip ) - min_match;
+			size_t required = 1 + LengthBytes( literal_length ) + literal_length + 2 + LengthBytes( match_length );
+			if( static_cast<size_t>( output_end - output ) < required )
+				return 0;
+
+			uint8_t *token = output++;
+			*token = static_cast<uint8_t>( ( literal_length >= 15 ? 15 : literal_length ) << 4 );
+			if( literal_length >= 15 )
+				output = WriteLength( output, literal_length - 15 );
+
+			std::memcpy( output, anchor, literal_length );
+			output += literal_length;
+
+			size_t offset = static_cast<size_t>( ip - reference );
+			*output++ = static_cast<uint8_t>( offset );
+			*output++ = static_cast<uint8_t>( offset >> 8 );
+
+			*token |= static_cast<uint8_t>( match_length >= 15 ? 15 : match_length );
+			if( match_length >= 15 )
+				output = WriteLength( output, match_length - 15 );
+
+			ip = match;
+			anchor = ip;
+
+			// Keep the table fresh with a position from inside the match
+			if( ip < match_end )
+				table[Hash( Load32( ip - 2 ) )] = static_cast<uint32_t>( ip - 2 - input );
+		}
+	}
+
+	size_t literal_length = static_cast<size_t>( input_end - anchor );
+	if( static_cast<size_t>( output_end - output ) < 1 + LengthBytes( literal_length ) + literal_length )
+		return 0;
+
+	*output++ = static_cast<uint8_t>( ( literal_length >= 15 ? 15 : literal_length ) << 4 );
+	if( literal_length >= 15 )
+		output = WriteLength( output, literal_length - 15 );
+
+	if( literal_length != 0 )
+		std::memcpy( output, anchor, literal_length );
+
+	output += literal_length;
+	return static_cast<size_t>( output - static_cast<uint8_t *>( destination ) );
+}
+
+bool Decompress( const void *source, size_t source_size, void *destination, size_t destination_size, size_t &decompressed_size )
+{
+	const uint8_t *input = static_cast<const uint8_t *>( source );
+	const uint8_t *input_end = input + source_size;
+	uint8_t *output = static_cast<uint8_t *>( destination );
+	uint8_t *output_start = output;
+	uint8_t *output_end = output + destination_size;
+
+	while( input < input_end )
+	{
+		uint8_t token = *input++;
+
+		size_t literal_length = token >> 4;
+		if( literal_length == 15 && !ReadLength( input, input_end, literal_length ) )
+			return false;
+
+		if( static_cast<size_t>( input_end - input ) < literal_length || static_cast<size_t>( output_end - output ) < literal_length )
+			return false;
+
+		std::memcpy( output, input, literal_length );
+		input += literal_length;
+		output += literal_length;
+
+		// The last sequence has no match
+		if( input == input_end )
+			break;
+
+		if( input_end - input < 2 )
+			return false;
+
+		size_t offset = static_cast<size_t>( input[0] ) | static_cast<size_t>( input[1] ) << 8;
+		input += 2;
+		if( offset == 0 || offset > static_cast<size_t>( output - output_start ) )
+			return false;
+
+		size_t match_length = token & 15;
+		if( match_length == 15 && !ReadLength( input, input_end, match_length ) )
+			return false;
+
+		match_length += min_match;
+		if( static_cast<size_t>( output_end - output ) < match_length )
+			return false;
+
+		const uint8_t *reference = output - offset;
+		if( offset >= match_length )
+		{
+			std::memcpy( output, reference, match_length );
+			output += match_length;
+		}
+		else
+		{
+			// Overlapping copy, repeats the last offset bytes
+			for( size_t k = 0; k < match_length; ++k )
+				*output++ = *reference++;
+		}
+	}
+
+	decompressed_size = static_cast<size_t>( output - output_start );
+	return true;
+}
+
+} // namespace LZ
+
+} // namespace MultiLibrary
@@ -36,6 +36,9 @@
 #pragma once
 
 #include <MultiLibrary/Common/Pipe.hpp>
+#include <pthread.h>
+#include <signal.h>
+#include <errno.h>
 
 namespace MultiLibrary
 {
@@ -53,4 +56,36 @@ private:
 	int internal;
 };
 
+namespace Internal
+{
+
+// Writing to a pipe or socket without readers raises SIGPIPE, which kills the
+// process by default. The signal is blocked during the call and discarded if
+// the call raised it, so the call only fails with EPIPE.
+template<typename Call>
+ssize_t WithoutPipeSignal( Call call )
+{
+	sigset_t pipe_signal, previous;
+	sigemptyset( &pipe_signal );
+	sigaddset( &pipe_signal, SIGPIPE );
+	pthread_sigmask( SIG_BLOCK, &pipe_signal, &previous );
+
+	ssize_t result = call( );
+	int error = errno;
+	if( result == -1 && error == EPIPE && !sigismember( &previous, SIGPIPE ) )
+	{
+		timespec immediately = { 0, 0 };
+		int waited = -1;
+		do
+			waited = sigtimedwait( &pipe_signal, nullptr, &immediately );
+		while( waited == -1 && errno == EINTR );
+	}
+
+	pthread_sigmask( SIG_SETMASK, &previous, nullptr );
+	errno = error;
+	return result;
+}
+
+} // namespace Internal
+
 } // namespace MultiLibrary
@@ -33,63 +33,281 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *************************************************************************/
 
-#include <MultiLibrary/Common/Process.hpp>
+#include <MultiLibrary/Common/Linux/Process.hpp>
+#include <MultiLibrary/Common/Linux/Pipe.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <MultiLibrary/Common/Number.hpp>
+#include <algorithm>
+#include <cstring>
 #include <system_error>
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
 namespace MultiLibrary
 {
 
-class Process::Handle
+Process::Handle::Handle( pid_t proc ) :
+	internal( proc )
+{ }
+
+Process::Handle::operator pid_t( ) const
+{
+	return internal;
+}
+
+// Actions for posix_spawn and the descriptors duplicated for them
+struct SpawnActions
 {
-public:
-	Handle( pid_t proc ) :
-		internal( proc )
-	{ }
+	SpawnActions( )
+	{
+		posix_spawn_file_actions_init( &actions );
+		posix_spawnattr_init( &attributes );
+	}
+
+	~SpawnActions( )
+	{
+		posix_spawn_file_actions_destroy( &actions );
+		posix_spawnattr_destroy( &attributes );
+		for( int descriptor : duplicates )
+			close( descriptor );
+	}
+
+	// Sources are duplicated above every descriptor the process gets, so
+	// the duplications done in the process can't overwrite each other
+	void Map( int source, int target, int minimum )
+	{
+		int duplicate = fcntl( source, F_DUPFD_CLOEXEC, minimum );
+		if( duplicate == -1 )
+			throw std::system_error( errno, std::system_category( ), "unable to duplicate descriptor" );
+
+		duplicates.push_back( duplicate );
+		posix_spawn_file_actions_adddup2( &actions, duplicate, target );
+	}
+
+	void Redirect( ProcessBuilder::Redirection redirection, const Pipe::Handle &pipe, int target, int flags, int minimum )
+	{
+		if( redirection == ProcessBuilder::Redirection::Pipe )
+			Map( pipe, target, minimum );
+		else if( redirection == ProcessBuilder::Redirection::Null )
+			posix_spawn_file_actions_addopen( &actions, target, "/dev/null", flags, 0 );
+	}
+
+	// Descriptors opened without O_CLOEXEC would be inherited too, so every
+	// descriptor besides the standard streams and the targets is closed.
+	// Must come after the duplications, which read descriptors above minimum.
+	void CloseOthers( const std::vector<int> &targets, int minimum )
+	{
+		for( int descriptor = STDERR_FILENO + 1; descriptor < minimum; ++descriptor )
+			if( std::find( targets.begin( ), targets.end( ), descriptor ) == targets.end( ) && IsInherited( descriptor ) )
+				posix_spawn_file_actions_addclose( &actions, descriptor );
+
+#if defined __GLIBC__ && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 34 ) )
+
+		posix_spawn_file_actions_addclosefrom_np( &actions, minimum );
+
+#else
+
+		// Without closefrom the open descriptors are listed, which misses
+		// the ones other threads open in the meantime
+		DIR *directory = opendir( "/proc/self/fd" );
+		if( directory == nullptr )
+		{
+			long limit = sysconf( _SC_OPEN_MAX );
+			for( int descriptor = minimum; descriptor < limit; ++descriptor )
+				if( IsInherited( descriptor ) )
+					posix_spawn_file_actions_addclose( &actions, descriptor );
+
+			return;
+		}
+
+		struct dirent *entry = nullptr;
+		while( ( entry = readdir( directory ) ) != nullptr )
+		{
+			int descriptor = 0;
+			const char *end = entry->d_name + std::strlen( entry->d_name );
+			if( Number::Parse( entry->d_name, end, descriptor ) == end && descriptor >= minimum && descriptor != dirfd( directory ) && IsInherited( descriptor ) )
+				posix_spawn_file_actions_addclose( &actions, descriptor );
+		}
+
+		closedir( directory );
+
+#endif
+
+	}
 
-	operator pid_t( ) const
+	static bool IsInherited( int descriptor )
 	{
-		return internal;
+		int flags = fcntl( descriptor, F_GETFD );
+		return flags != -1 && ( flags & FD_CLOEXEC ) == 0;
 	}
 
-private:
-	pid_t internal;
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_t attributes;
+	std::vector<int> duplicates;
 };
 
+// Reads a whole file from /proc, which reports a size of 0 for them
+static bool ReadProcFile( const std::string &path, std::string &contents )
+{
+	int descriptor = open( path.c_str( ), O_RDONLY | O_CLOEXEC );
+	if( descriptor == -1 )
+		return false;
+
+	char buffer[4096];
+	ssize_t result = 0;
+	contents.clear( );
+	while( ( result = read( descriptor, buffer, sizeof( buffer ) ) ) > 0 )
+		contents.append( buffer, static_cast<size_t>( result ) );
+
+	close( descriptor );
+	return result == 0;
+}
+
+// Finds the value of a "name: value" line
+static bool ReadField( const std::string &contents, const char *name, uint64_t &value )
+{
+	const std::string key = std::string( name ) + ":";
+	size_t position = 0;
+	while( contents.compare( position, key.size( ), key ) != 0 )
+	{
+		position = contents.find( '\n', position );
+		if( position == std::string::npos )
+			return false;
+
+		++position;
+	}
+
+	const char *begin = contents.data( ) + position + key.size( ), *end = contents.data( ) + contents.size( );
+	while( begin != end && ( *begin == ' ' || *begin == '\t' ) )
+		++begin;
+
+	return Number::Parse( begin, end, value ) != nullptr;
+}
+
+static uint64_t ToMicroseconds( const timeval &time )
+{
+	return static_cast<uint64_t>( time.tv_sec ) * 1000000 + static_cast<uint64_t>( time.tv_usec );
+}
+
+static void ReadResourceUsage( const struct rusage &resources, Process::Usage &usage )
+{
+	usage.user_time = ToMicroseconds( resources.ru_utime );
+	usage.system_time = ToMicroseconds( resources.ru_stime );
+	usage.max_resident_size = static_cast<uint64_t>( resources.ru_maxrss ) * 1024;
+	usage.minor_faults = static_cast<uint64_t>( resources.ru_minflt );
+	usage.major_faults = static_cast<uint64_t>( resources.ru_majflt );
+	usage.voluntary_switches = static_cast<uint64_t>( resources.ru_nvcsw );
+	usage.involuntary_switches = static_cast<uint64_t>( resources.ru_nivcsw );
+
+	// Counted in blocks of 512 bytes, the same accounting /proc/<pid>/io uses
+	usage.read_bytes = static_cast<uint64_t>( resources.ru_inblock ) * 512;
+	usage.written_bytes = static_cast<uint64_t>( resources.ru_oublock ) * 512;
+}
+
 Process::Process( const std::string &path, const std::vector<std::string> &args ) :
+	Process( ProcessBuilder( path ).AddArguments( args ) )
+{ }
+
+Process::Process( const ProcessBuilder &builder ) :
 	exit_code( 0 ),
+	usage( ),
 	input_pipe( true, false ),
 	output_pipe( false, true ),
 	error_pipe( false, true )
 {
-	char **argv = nullptr;
-	if( !args.empty( ) )
-	{
-		argv = new char *[args.size( ) + 2];
-		argv[0] = const_cast<char *>( path.c_str( ) );
-		for( size_t i = 1; i < args.size( ) + 1; ++i )
-			argv[i] = const_cast<char *>( args[i].c_str( ) );
+	std::vector<char *> argv;
+	argv.push_back( const_cast<char *>( builder.path.c_str( ) ) );
+	for( const std::string &argument : builder.arguments )
+		argv.push_back( const_cast<char *>( argument.c_str( ) ) );
+
+	argv.push_back( nullptr );
+
+	std::vector<std::string> environment = builder.BuildEnvironment( );
+	std::vector<char *> envp;
+	for( std::string &entry : environment )
+		envp.push_back( &entry[0] );
+
+	envp.push_back( nullptr );
 
-		argv[args.size( )] = nullptr;
+	int minimum = STDERR_FILENO + 1;
+	for( const std::pair<int, int> &mapping : builder.descriptors )
+		minimum = std::max( minimum, mapping.second + 1 );
+
+	SpawnActions spawn;
+	spawn.Redirect( builder.input, input_pipe.ReadHandle( ), STDIN_FILENO, O_RDONLY, minimum );
+	spawn.Redirect( builder.output, output_pipe.WriteHandle( ), STDOUT_FILENO, O_WRONLY, minimum );
+	spawn.Redirect( builder.error, error_pipe.WriteHandle( ), STDERR_FILENO, O_WRONLY, minimum );
+	std::vector<int> targets;
+	for( const std::pair<int, int> &mapping : builder.descriptors )
+	{
+		spawn.Map( mapping.first, mapping.second, minimum );
+		targets.push_back( mapping.second );
 	}
 
-	pid_t pid = fork( );
-	if( pid == 0 && execv( path.c_str( ), argv ) )
+	spawn.CloseOthers( targets, minimum );
+
+	if( !builder.working_directory.empty( ) )
 	{
-		delete [] argv;
-		exit( EXIT_FAILURE );
+
+#if defined __GLIBC__ && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 29 ) )
+
+		posix_spawn_file_actions_addchdir_np( &spawn.actions, builder.working_directory.c_str( ) );
+
+#else
+
+		throw std::system_error( ENOSYS, std::system_category( ), "unable to set working directory of process" );
+
+#endif
+
 	}
 
-	delete [] argv;
+	// Servers often ignore SIGPIPE, which the process would inherit
+	sigset_t signals;
+	sigemptyset( &signals );
+	posix_spawnattr_setsigmask( &spawn.attributes, &signals );
+	sigaddset( &signals, SIGPIPE );
+	posix_spawnattr_setsigdefault( &spawn.attributes, &signals );
+
+	short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+
+#if defined POSIX_SPAWN_USEVFORK
+
+	// Older glibc versions only avoid fork with this
+	flags |= POSIX_SPAWN_USEVFORK;
+
+#endif
+
+	posix_spawnattr_setflags( &spawn.attributes, flags );
 
-	if( pid == -1 )
-		throw std::system_error( errno, std::system_category( ), "failed to fork process" );
+	pid_t pid = -1;
+	int result = posix_spawn( &pid, builder.path.c_str( ), &spawn.actions, &spawn.attributes, argv.data( ), envp.data( ) );
+	if( result != 0 )
+		throw std::system_error( result, std::system_category( ), "failed to spawn process" );
 
 	process.reset( new Handle( pid ) );
+	for( const SharedChannel *channel : builder.channels )
+		channel->SetPeer( static_cast<uint32_t>( pid ) );
+
+	// Only the process uses these ends
+	input_pipe.CloseRead( );
+	output_pipe.CloseWrite( );
+	error_pipe.CloseWrite( );
+	if( builder.input != ProcessBuilder::Redirection::Pipe )
+		input_pipe.CloseWrite( );
+
+	if( builder.output != ProcessBuilder::Redirection::Pipe )
+		output_pipe.CloseRead( );
+
+	if( builder.error != ProcessBuilder::Redirection::Pipe )
+		error_pipe.CloseRead( );
 }
 
 Process::~Process( )
@@ -102,11 +320,16 @@ Process::Status Process::GetStatus( ) const
 	if( !process )
 		return Status::Unknown;
 
-	int status = 0;
-	if( waitpid( *process, &status, WNOHANG ) )
-		return WIFEXITED( status ) ? Status::Terminated : Status::Running;
+	// The child is left waitable so Close can still reap it
+	siginfo_t info;
+	info.si_pid = 0;
+	if( waitid( P_PID, *process, &info, WEXITED | WNOHANG | WNOWAIT ) != 0 )
+		return Status::Unknown;
+
+	if( info.si_pid == 0 )
+		return Status::Running;
 
-	return Status::Unknown;
+	return info.si_code == CLD_EXITED ? Status::Terminated : Status::Killed;
 }
 
 bool Process::Close( )
@@ -115,14 +338,19 @@ bool Process::Close( )
 		return false;
 
 	int status = 0;
-	if( waitpid( *process, &status, 0 ) > 0 )
-	{
-		process.reset( );
-		return WIFEXITED( status );
-	}
+	struct rusage resources;
+	pid_t result = -1;
+	do
+		result = wait4( *process, &status, 0, &resources );
+	while( result == -1 && errno == EINTR );
 
 	process.reset( );
-	return false;
+	if( result <= 0 )
+		return false;
+
+	ReadResourceUsage( resources, usage );
+	exit_code = WIFEXITED( status ) ? WEXITSTATUS( status ) : -WTERMSIG( status );
+	return WIFEXITED( status );
 }
 
 void Process::Kill( )
@@ -160,4 +388,74 @@ int32_t Process::ExitCode( ) const
 	return exit_code;
 }
 
+bool Process::SampleUsage( )
+{
+	if( !process )
+		return false;
+
+	const std::string directory = "/proc/" + std::to_string( *process ) + "/";
+	std::string contents;
+	if( !ReadProcFile( directory + "stat", contents ) )
+		return false;
+
+	// The executable name might contain spaces, the fields after it don't
+	size_t name_end = contents.rfind( ')' );
+	if( name_end == std::string::npos )
+		return false;
+
+	// Fields from the state on, as listed in proc(5)
+	std::vector<uint64_t> fields;
+	const char *current = contents.data( ) + name_end + 1, *end = contents.data( ) + contents.size( );
+	while( current != end && fields.size( ) < 13 )
+	{
+		while( current != end && *current == ' ' )
+			++current;
+
+		uint64_t value = 0;
+		const char *next = Number::Parse( current, end, value );
+		fields.push_back( next != nullptr ? value : 0 );
+		while( current != end && *current != ' ' )
+			++current;
+	}
+
+	if( fields.size( ) < 13 )
+		return false;
+
+	const uint64_t ticks = static_cast<uint64_t>( sysconf( _SC_CLK_TCK ) );
+	usage.minor_faults = fields[7];
+	usage.major_faults = fields[9];
+	usage.user_time = fields[11] * 1000000 / ticks;
+	usage.system_time = fields[12] * 1000000 / ticks;
+
+	uint64_t value = 0;
+	if( ReadProcFile( directory + "status", contents ) )
+	{
+		if( ReadField( contents, "VmHWM", value ) )
+			usage.max_resident_size = value * 1024;
+
+		if( ReadField( contents, "voluntary_ctxt_switches", value ) )
+			usage.voluntary_switches = value;
+
+		if( ReadField( contents, "nonvoluntary_ctxt_switches", value ) )
+			usage.involuntary_switches = value;
+	}
+
+	// Only readable by the owner of the process
+	if( ReadProcFile( directory + "io", contents ) )
+	{
+		if( ReadField( contents, "read_bytes", value ) )
+			usage.read_bytes = value;
+
+		if( ReadField( contents, "write_bytes", value ) )
+			usage.written_bytes = value;
+	}
+
+	return true;
+}
+
+const Process::Usage &Process::GetUsage( ) const
+{
+	return usage;
+}
+
 } // namespace MultiLibrary
@@ -0,0 +1,499 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ProcessGroup.hpp>
+#include <MultiLibrary/Common/Linux/Pipe.hpp>
+#include <MultiLibrary/Common/Linux/Process.hpp>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+namespace MultiLibrary
+{
+
+// Size of the chunks read from the process pipes
+static const size_t chunk_size = 64 * 1024;
+
+// Events taken from epoll per call
+static const int max_events = 64;
+
+// Groups that can wait on SIGCHLD at the same time
+static const size_t max_signal_slots = 64;
+
+// When pidfd_open isn't available every group gets a self-pipe that the
+// SIGCHLD handler writes to. The handler might run at any time, so the pipes
+// are never closed and groups recycle them instead.
+static std::atomic<int> signal_pipes[max_signal_slots];
+static int signal_reads[max_signal_slots];
+static bool signal_used[max_signal_slots];
+static std::mutex signal_mutex;
+static bool signal_installed = false;
+static struct sigaction previous_action;
+
+static void SignalHandler( int signal, siginfo_t *info, void *context )
+{
+	int saved_errno = errno;
+	for( size_t k = 0; k < max_signal_slots; ++k )
+	{
+		// Stored plus one, since zero is what the slots start with
+		int descriptor = signal_pipes[k].load( std::memory_order_acquire ) - 1;
+		if( descriptor >= 0 )
+		{
+			char byte = 0;
+			ssize_t result = write( descriptor, &byte, 1 );
+			(void)result;
+		}
+	}
+
+	if( ( previous_action.sa_flags & SA_SIGINFO ) != 0 )
+	{
+		if( previous_action.sa_sigaction != nullptr )
+			previous_action.sa_sigaction( signal, info, context );
+	}
+	else if( previous_action.sa_handler != SIG_DFL && previous_action.sa_handler != SIG_IGN )
+	{
+		previous_action.sa_handler( signal );
+	}
+
+	errno = saved_errno;
+}
+
+static int AcquireSignalSlot( )
+{
+	std::lock_guard<std::mutex> lock( signal_mutex );
+	if( !signal_installed )
+	{
+		struct sigaction action;
+		sigemptyset( &action.sa_mask );
+		action.sa_sigaction = SignalHandler;
+		action.sa_flags = SA_SIGINFO | SA_RESTART | SA_NOCLDSTOP;
+		if( sigaction( SIGCHLD, &action, &previous_action ) != 0 )
+			return -1;
+
+		signal_installed = true;
+	}
+
+	for( size_t k = 0; k < max_signal_slots; ++k )
+	{
+		if( signal_used[k] )
+			continue;
+
+		if( signal_pipes[k].load( std::memory_order_relaxed ) == 0 )
+		{
+			int handles[2] = { -1, -1 };
+			if( pipe2( handles, O_NONBLOCK | O_CLOEXEC ) != 0 )
+				return -1;
+
+			signal_reads[k] = handles[0];
+			signal_pipes[k].store( handles[1] + 1, std::memory_order_release );
+		}
+
+		// Drop wake ups meant for the previous owner
+		char bytes[64];
+		while( read( signal_reads[k], bytes, sizeof( bytes ) ) > 0 );
+
+		signal_used[k] = true;
+		return static_cast<int>( k );
+	}
+
+	return -1;
+}
+
+static void ReleaseSignalSlot( int slot )
+{
+	std::lock_guard<std::mutex> lock( signal_mutex );
+	signal_used[slot] = false;
+}
+
+static int OpenProcessDescriptor( pid_t pid )
+{
+
+#if defined SYS_pidfd_open
+
+	return static_cast<int>( syscall( SYS_pidfd_open, pid, 0 ) );
+
+#else
+
+	(void)pid;
+	errno = ENOSYS;
+	return -1;
+
+#endif
+
+}
+
+// Checks whether a process exited, leaving it waitable
+static bool HasExited( pid_t pid )
+{
+	siginfo_t info;
+	info.si_pid = 0;
+	return waitid( P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT ) != 0 || info.si_pid != 0;
+}
+
+class ProcessGroup::Reactor
+{
+public:
+	struct Entry;
+
+	// Something epoll watches for an entry
+	struct Source
+	{
+		Entry *entry;
+		Event event;
+		int descriptor;
+	};
+
+	struct Entry
+	{
+		Process *process;
+		Callback callback;
+		Source sources[3];
+		bool removed;
+	};
+
+	Reactor( ) :
+		epoll( epoll_create1( EPOLL_CLOEXEC ) ),
+		signal_slot( -1 ),
+		buffer( chunk_size )
+	{
+		if( epoll == -1 )
+			throw std::system_error( errno, std::system_category( ), "unable to create epoll instance" );
+	}
+
+	~Reactor( )
+	{
+		for( std::unique_ptr<Entry> &entry : entries )
+			Detach( *entry );
+
+		if( signal_slot != -1 )
+			ReleaseSignalSlot( signal_slot );
+
+		close( epoll );
+	}
+
+	bool Add( Process &process, const Callback &callback )
+	{
+		if( !process.process || Find( process ) != nullptr )
+			return false;
+
+		std::unique_ptr<Entry> entry( new Entry );
+		entry->process = &process;
+		entry->callback = callback;
+		entry->removed = false;
+		entry->sources[0] = { entry.get( ), Event::Output, process.output_pipe.read_handle ? static_cast<int>( *process.output_pipe.read_handle ) : -1 };
+		entry->sources[1] = { entry.get( ), Event::Error, process.error_pipe.read_handle ? static_cast<int>( *process.error_pipe.read_handle ) : -1 };
+		entry->sources[2] = { entry.get( ), Event::Exit, OpenProcessDescriptor( *process.process ) };
+
+		if( entry->sources[2].descriptor == -1 )
+		{
+			if( errno != ENOSYS )
+				return false;
+
+			if( signal_slot == -1 )
+			{
+				if( ( signal_slot = AcquireSignalSlot( ) ) == -1 )
+					return false;
+
+				epoll_event event = { };
+				event.events = EPOLLIN;
+				event.data.ptr = nullptr;
+				epoll_ctl( epoll, EPOLL_CTL_ADD, signal_reads[signal_slot], &event );
+			}
+
+			// The process might have exited before the handler was installed
+			char byte = 0;
+			ssize_t result = write( signal_pipes[signal_slot].load( std::memory_order_relaxed ) - 1, &byte, 1 );
+			(void)result;
+		}
+
+		for( Source &source : entry->sources )
+		{
+			if( source.descriptor == -1 )
+				continue;
+
+			epoll_event event = { };
+			event.events = EPOLLIN;
+			event.data.ptr = &source;
+			if( epoll_ctl( epoll, EPOLL_CTL_ADD, source.descriptor, &event ) != 0 )
+			{
+				Detach( *entry );
+				return false;
+			}
+		}
+
+		entries.push_back( std::move( entry ) );
+		return true;
+	}
+
+	bool Remove( Process &process )
+	{
+		Entry *entry = Find( process );
+		if( entry == nullptr )
+			return false;
+
+		Detach( *entry );
+		return true;
+	}
+
+	size_t Count( ) const
+	{
+		size_t count = 0;
+		for( const std::unique_ptr<Entry> &entry : entries )
+			if( !entry->removed )
+				++count;
+
+		return count;
+	}
+
+	size_t Wait( uint32_t timeout )
+	{
+		int wait = timeout == WAIT_FOREVER ? -1 : static_cast<int>( std::min<uint32_t>( timeout, INT_MAX ) );
+		epoll_event events[max_events];
+		int count = epoll_wait( epoll, events, max_events, wait );
+		if( count < 0 && errno != EINTR )
+			throw std::system_error( errno, std::system_category( ), "unable to wait on epoll instance" );
+
+		size_t produced = 0;
+		for( int k = 0; k < count; ++k )
+		{
+			Source *source = static_cast<Source *>( events[k].data.ptr );
+			if( source == nullptr )
+				produced += CheckExits( );
+			else if( source->entry->removed || source->descriptor == -1 )
+				continue;
+			else if( source->event == Event::Exit )
+				produced += Finish( *source->entry );
+			else
+				produced += ReadChunk( *source );
+		}
+
+		Purge( );
+		return produced;
+	}
+
+	bool Next( Notification &notification )
+	{
+		if( queue.empty( ) )
+			return false;
+
+		notification = std::move( queue.front( ) );
+		queue.pop_front( );
+		return true;
+	}
+
+	size_t Pending( ) const
+	{
+		return queue.size( );
+	}
+
+private:
+	Entry *Find( Process &process )
+	{
+		for( std::unique_ptr<Entry> &entry : entries )
+			if( entry->process == &process && !entry->removed )
+				return entry.get( );
+
+		return nullptr;
+	}
+
+	void Detach( Entry &entry )
+	{
+		if( entry.removed )
+			return;
+
+		for( Source &source : entry.sources )
+		{
+			if( source.descriptor == -1 )
+				continue;
+
+			epoll_ctl( epoll, EPOLL_CTL_DEL, source.descriptor, nullptr );
+			if( source.event == Event::Exit )
+				close( source.descriptor );
+
+			source.descriptor = -1;
+		}
+
+		entry.removed = true;
+	}
+
+	// Entries are only freed here, so events already taken from epoll never
+	// point to freed memory
+	void Purge( )
+	{
+		size_t kept = 0;
+		for( size_t k = 0; k < entries.size( ); ++k )
+			if( !entries[k]->removed )
+				entries[kept++] = std::move( entries[k] );
+
+		entries.resize( kept );
+	}
+
+	void Deliver( Entry &entry, Event event, const uint8_t *data, size_t size, int32_t exit_code )
+	{
+		Notification *notification = &scratch;
+		if( !entry.callback )
+		{
+			queue.emplace_back( );
+			notification = &queue.back( );
+		}
+
+		notification->process = entry.process;
+		notification->event = event;
+		notification->data.assign( data, data + size );
+		notification->exit_code = exit_code;
+		if( entry.callback )
+		{
+			// The callback might remove the entry, it's only freed on Purge
+			Callback callback = entry.callback;
+			callback( *notification );
+		}
+	}
+
+	size_t ReadChunk( Source &source )
+	{
+		ssize_t result;
+		do
+			result = read( source.descriptor, buffer.data( ), buffer.size( ) );
+		while( result < 0 && errno == EINTR );
+
+		if( result > 0 )
+		{
+			Deliver( *source.entry, source.event, buffer.data( ), static_cast<size_t>( result ), 0 );
+			return 1;
+		}
+
+		if( result < 0 && errno == EAGAIN )
+			return 0;
+
+		// The other end was closed, nothing else will come from it
+		epoll_ctl( epoll, EPOLL_CTL_DEL, source.descriptor, nullptr );
+		source.descriptor = -1;
+		return 0;
+	}
+
+	size_t Finish( Entry &entry )
+	{
+		size_t produced = 0;
+		for( size_t k = 0; k < 2 && !entry.removed; ++k )
+		{
+			int available = 0;
+			Source &source = entry.sources[k];
+			while( source.descriptor != -1 && ioctl( source.descriptor, FIONREAD, &available ) == 0 && available > 0 )
+				produced += ReadChunk( source );
+		}
+
+		if( entry.removed )
+			return produced;
+
+		Process &process = *entry.process;
+		Detach( entry );
+		process.Close( );
+		Deliver( entry, Event::Exit, nullptr, 0, process.ExitCode( ) );
+		return produced + 1;
+	}
+
+	size_t CheckExits( )
+	{
+		char bytes[64];
+		while( read( signal_reads[signal_slot], bytes, sizeof( bytes ) ) > 0 );
+
+		size_t produced = 0;
+		for( size_t k = 0; k < entries.size( ); ++k )
+		{
+			Entry &entry = *entries[k];
+			if( !entry.removed && entry.sources[2].descriptor == -1 && HasExited( *entry.process->process ) )
+				produced += Finish( entry );
+		}
+
+		return produced;
+	}
+
+	int epoll;
+	int signal_slot;
+	std::vector<std::unique_ptr<Entry>> entries;
+	std::deque<Notification> queue;
+	std::vector<uint8_t> buffer;
+	Notification scratch;
+};
+
+ProcessGroup::ProcessGroup( ) :
+	reactor( new Reactor( ) )
+{ }
+
+ProcessGroup::~ProcessGroup( )
+{ }
+
+bool ProcessGroup::Add( Process &process, const Callback &callback )
+{
+	return reactor->Add( process, callback );
+}
+
+bool ProcessGroup::Remove( Process &process )
+{
+	return reactor->Remove( process );
+}
+
+size_t ProcessGroup::Count( ) const
+{
+	return reactor->Count( );
+}
+
+size_t ProcessGroup::Wait( uint32_t timeout )
+{
+	return reactor->Wait( timeout );
+}
+
+bool ProcessGroup::Next( Notification &notification )
+{
+	return reactor->Next( notification );
+}
+
+size_t ProcessGroup::Pending( ) const
+{
+	return reactor->Pending( );
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,196 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/SharedMemory.hpp>
+#include <climits>
+#include <system_error>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+namespace MultiLibrary
+{
+
+namespace Internal
+{
+
+static int CreateDescriptor( )
+{
+
+#if defined SYS_memfd_create && defined MFD_CLOEXEC
+
+	int descriptor = static_cast<int>( syscall( SYS_memfd_create, "MultiLibrary", MFD_CLOEXEC | MFD_ALLOW_SEALING ) );
+	if( descriptor != -1 || errno != ENOSYS )
+		return descriptor;
+
+#endif
+
+	// Kernels older than 3.17 have no memfd, an unnamed file in the shared
+	// memory filesystem is the same thing without sealing
+	return open( "/dev/shm", O_TMPFILE | O_RDWR | O_CLOEXEC, 0600 );
+}
+
+static void *Map( int descriptor, size_t size )
+{
+	void *address = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0 );
+	if( address == MAP_FAILED )
+	{
+		int error = errno;
+		close( descriptor );
+		throw std::system_error( error, std::system_category( ), "failed to map shared memory" );
+	}
+
+	return address;
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Create( size_t size )
+{
+	int descriptor = CreateDescriptor( );
+	if( descriptor == -1 )
+		throw std::system_error( errno, std::system_category( ), "failed to create shared memory" );
+
+	if( ftruncate( descriptor, static_cast<off_t>( size ) ) != 0 )
+	{
+		int error = errno;
+		close( descriptor );
+		throw std::system_error( error, std::system_category( ), "failed to resize shared memory" );
+	}
+
+#if defined F_ADD_SEALS
+
+	// A child shrinking the memory would crash the parent with SIGBUS
+	fcntl( descriptor, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL );
+
+#endif
+
+	return std::unique_ptr<SharedMemory>( new SharedMemory( descriptor, Map( descriptor, size ), size ) );
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open( Descriptor descriptor )
+{
+	struct stat information;
+	if( fstat( descriptor, &information ) != 0 )
+		throw std::system_error( errno, std::system_category( ), "failed to open shared memory" );
+
+	// Processes spawned by this one only get it if mapped again
+	fcntl( descriptor, F_SETFD, FD_CLOEXEC );
+
+	size_t size = static_cast<size_t>( information.st_size );
+	return std::unique_ptr<SharedMemory>( new SharedMemory( descriptor, Map( descriptor, size ), size ) );
+}
+
+SharedMemory::SharedMemory( Descriptor memory_descriptor, void *memory_address, size_t memory_size ) :
+	descriptor( memory_descriptor ),
+	address( memory_address ),
+	size( memory_size )
+{ }
+
+SharedMemory::~SharedMemory( )
+{
+	munmap( address, size );
+	close( descriptor );
+}
+
+void *SharedMemory::Address( ) const
+{
+	return address;
+}
+
+size_t SharedMemory::Size( ) const
+{
+	return size;
+}
+
+SharedMemory::Descriptor SharedMemory::GetDescriptor( ) const
+{
+	return descriptor;
+}
+
+// The memory is shared, so the futexes can't be private to this process
+void SharedMemory::Wait( std::atomic<uint32_t> &signal, uint32_t value, int64_t timeout )
+{
+	timespec time;
+	time.tv_sec = static_cast<time_t>( timeout / 1000000000 );
+	time.tv_nsec = static_cast<long>( timeout % 1000000000 );
+	syscall( SYS_futex, reinterpret_cast<uint32_t *>( &signal ), FUTEX_WAIT, value, timeout >= 0 ? &time : nullptr, nullptr, 0 );
+}
+
+void SharedMemory::Wake( std::atomic<uint32_t> &signal )
+{
+	syscall( SYS_futex, reinterpret_cast<uint32_t *>( &signal ), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0 );
+}
+
+uint32_t SharedMemory::GetProcessIdentifier( )
+{
+	return static_cast<uint32_t>( getpid( ) );
+}
+
+// A process descriptor tells exited processes apart from running ones even
+// before they're waited for, which kill can't
+bool SharedMemory::IsRunning( uint32_t identifier )
+{
+
+#if defined SYS_pidfd_open
+
+	int process = static_cast<int>( syscall( SYS_pidfd_open, static_cast<pid_t>( identifier ), 0 ) );
+	if( process != -1 )
+	{
+		pollfd ready;
+		ready.fd = process;
+		ready.events = POLLIN;
+		ready.revents = 0;
+		bool running = poll( &ready, 1, 0 ) == 0;
+		close( process );
+		return running;
+	}
+
+	if( errno != ENOSYS )
+		return errno != ESRCH;
+
+#endif
+
+	return kill( static_cast<pid_t>( identifier ), 0 ) == 0 || errno != ESRCH;
+}
+
+} // namespace Internal
+
+} // namespace MultiLibrary
@@ -0,0 +1,427 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/Transfer.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <MultiLibrary/Common/Linux/Pipe.hpp>
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/sendfile.h>
+#include <errno.h>
+
+namespace MultiLibrary
+{
+
+// Biggest amount of bytes the kernel moves in a single call
+static const size_t max_chunk_size = 0x7FFFF000;
+
+// Size of the buffer used when data has to go through user space
+static const size_t copy_buffer_size = 128 * 1024;
+
+// Capacity requested for the pipe that relays data between sockets and files
+static const int relay_pipe_size = 1024 * 1024;
+
+enum class Method
+{
+	CopyRange,
+	SendFile,
+	Splice,
+	Relay,
+	Buffered
+};
+
+// One end of a transfer, files being accessed at an explicit offset
+struct End
+{
+	int descriptor;
+	InputStream *input;
+	OutputStream *output;
+	bool is_file;
+	bool is_pipe;
+	loff_t offset;
+};
+
+TransferEndpoint::TransferEndpoint( Pipe &pipe ) :
+	TransferEndpoint(
+		Type::Pipe,
+		pipe.read_handle ? static_cast<int>( *pipe.read_handle ) : -1,
+		pipe.write_handle ? static_cast<int>( *pipe.write_handle ) : -1,
+		&pipe,
+		&pipe,
+		nullptr
+	)
+{ }
+
+// Waits until a nonblocking descriptor is ready for the requested events
+static bool WaitReady( int descriptor, short events )
+{
+	pollfd request = { descriptor, events, 0 };
+	int result;
+	do
+		result = poll( &request, 1, -1 );
+	while( result < 0 && errno == EINTR );
+
+	return result > 0;
+}
+
+static ssize_t ReadSome( End &end, void *data, size_t size )
+{
+	if( end.is_file )
+	{
+		ssize_t result;
+		do
+			result = pread64( end.descriptor, data, size, end.offset );
+		while( result < 0 && errno == EINTR );
+
+		if( result > 0 )
+			end.offset += result;
+
+		return result;
+	}
+
+	if( end.input != nullptr )
+		return static_cast<ssize_t>( end.input->Read( data, size ) );
+
+	while( true )
+	{
+		ssize_t result = read( end.descriptor, data, size );
+		if( result >= 0 )
+			return result;
+
+		if( errno == EAGAIN || errno == EWOULDBLOCK )
+		{
+			if( !WaitReady( end.descriptor, POLLIN ) )
+				return -1;
+		}
+		else if( errno != EINTR )
+		{
+			return -1;
+		}
+	}
+}
+
+static size_t WriteAll( End &end, const uint8_t *data, size_t size )
+{
+	size_t total = 0;
+	while( total < size )
+	{
+		ssize_t result;
+		if( end.is_file )
+		{
+			result = pwrite64( end.descriptor, data + total, size - total, end.offset );
+			if( result > 0 )
+				end.offset += result;
+		}
+		else if( end.output != nullptr )
+		{
+			result = static_cast<ssize_t>( end.output->Write( data + total, size - total ) );
+		}
+		else
+		{
+			result = Internal::WithoutPipeSignal( [&]( ) { return write( end.descriptor, data + total, size - total ); } );
+		}
+
+		if( result > 0 )
+		{
+			total += static_cast<size_t>( result );
+		}
+		else if( result == 0 )
+		{
+			break;
+		}
+		else if( errno == EAGAIN || errno == EWOULDBLOCK )
+		{
+			if( !WaitReady( end.descriptor, POLLOUT ) )
+				break;
+		}
+		else if( errno != EINTR )
+		{
+			break;
+		}
+	}
+
+	return total;
+}
+
+static size_t CopyBuffered( End &source, End &sink, size_t size )
+{
+	BufferPool &pool = BufferPool::Default( );
+	BufferPool::Storage storage = pool.Acquire( copy_buffer_size );
+	storage->resize( copy_buffer_size );
+
+	size_t total = 0;
+	while( total < size )
+	{
+		ssize_t result = ReadSome( source, storage->data( ), std::min( size - total, copy_buffer_size ) );
+		if( result <= 0 )
+			break;
+
+		size_t written = WriteAll( sink, storage->data( ), static_cast<size_t>( result ) );
+		total += written;
+		if( written != static_cast<size_t>( result ) )
+			break;
+	}
+
+	pool.Release( std::move( storage ) );
+	return total;
+}
+
+// Errors that mean the method isn't supported for these descriptors
+static bool IsUnsupported( int error )
+{
+	return error == EINVAL || error == ENOSYS || error == EXDEV || error == EOPNOTSUPP || error == EBADF;
+}
+
+// Moves everything in the relay pipe into the sink
+static size_t DrainRelay( int relay, End &sink, size_t size )
+{
+	size_t total = 0;
+	while( total < size )
+	{
+		ssize_t result = Internal::WithoutPipeSignal( [&]( ) { return splice( relay, nullptr, sink.descriptor, sink.is_file ? &sink.offset : nullptr, size - total, SPLICE_F_MOVE ); } );
+		if( result > 0 )
+		{
+			total += static_cast<size_t>( result );
+		}
+		else if( result == 0 )
+		{
+			break;
+		}
+		else if( errno == EAGAIN )
+		{
+			if( !WaitReady( sink.descriptor, POLLOUT ) )
+				break;
+		}
+		else if( errno != EINTR )
+		{
+			break;
+		}
+	}
+
+	return total;
+}
+
+// Copies what's left in the relay pipe through user space, for sinks that
+// stopped accepting splice
+static size_t DrainRelayBuffered( int relay, End &sink, size_t size )
+{
+	End from = { relay, nullptr, nullptr, false, true, 0 };
+	return CopyBuffered( from, sink, size );
+}
+
+static End MakeEnd( int descriptor, InputStream *input, OutputStream *output, Stream *position, TransferEndpoint::Type type )
+{
+	End end = { descriptor, input, output, position != nullptr, type == TransferEndpoint::Type::Pipe, 0 };
+	if( position != nullptr )
+	{
+		// Seeking to the current position flushes whatever the stream buffered
+		end.offset = static_cast<loff_t>( position->Tell( ) );
+		position->Seek( static_cast<size_t>( end.offset ) );
+	}
+
+	return end;
+}
+
+size_t Transfer( const TransferEndpoint &source, const TransferEndpoint &sink, size_t size )
+{
+	End from = MakeEnd( source.read_descriptor, source.input, nullptr, source.position, source.type );
+	End to = MakeEnd( sink.write_descriptor, nullptr, sink.output, sink.position, sink.type );
+
+	Method method = Method::Buffered;
+	if( from.descriptor != -1 && to.descriptor != -1 )
+	{
+		if( from.is_file && to.is_file )
+			method = Method::CopyRange;
+		else if( from.is_pipe || to.is_pipe )
+			method = Method::Splice;
+		else if( from.is_file )
+			method = Method::SendFile;
+		else
+			method = Method::Relay;
+	}
+
+	int relay[2] = { -1, -1 };
+	size_t lost = 0;
+	int lost_error = 0;
+	size_t total = 0;
+	while( total < size && method != Method::Buffered )
+	{
+		size_t chunk = std::min( size - total, max_chunk_size );
+		ssize_t result = -1;
+		int wait_descriptor = -1;
+		short wait_events = 0;
+		switch( method )
+		{
+			case Method::CopyRange:
+				result = copy_file_range( from.descriptor, &from.offset, to.descriptor, &to.offset, chunk, 0 );
+				if( result < 0 && IsUnsupported( errno ) )
+				{
+					method = Method::SendFile;
+					continue;
+				}
+
+				break;
+
+			case Method::SendFile:
+				// sendfile writes at the position of the sink
+				if( to.is_file && lseek64( to.descriptor, to.offset, SEEK_SET ) < 0 )
+				{
+					method = Method::Buffered;
+					continue;
+				}
+
+				result = Internal::WithoutPipeSignal( [&]( ) { return sendfile64( to.descriptor, from.descriptor, from.is_file ? &from.offset : nullptr, chunk ); } );
+				if( result > 0 && to.is_file )
+					to.offset += result;
+
+				wait_descriptor = to.descriptor;
+				wait_events = POLLOUT;
+				break;
+
+			case Method::Splice:
+				result = Internal::WithoutPipeSignal( [&]( ) { return splice( from.descriptor, from.is_file ? &from.offset : nullptr, to.descriptor, to.is_file ? &to.offset : nullptr, chunk, SPLICE_F_MOVE ); } );
+				wait_descriptor = from.is_pipe ? to.descriptor : from.descriptor;
+				wait_events = from.is_pipe ? POLLOUT : POLLIN;
+				break;
+
+			case Method::Relay:
+				if( relay[0] == -1 )
+				{
+					if( pipe2( relay, O_CLOEXEC ) != 0 )
+					{
+						method = Method::Buffered;
+						continue;
+					}
+
+					fcntl( relay[1], F_SETPIPE_SZ, relay_pipe_size );
+				}
+
+				result = splice( from.descriptor, from.is_file ? &from.offset : nullptr, relay[1], nullptr, chunk, SPLICE_F_MOVE );
+				if( result > 0 )
+				{
+					size_t relayed = static_cast<size_t>( result );
+					size_t moved = DrainRelay( relay[0], to, relayed );
+					if( moved != relayed )
+					{
+						lost_error = errno;
+						moved += DrainRelayBuffered( relay[0], to, relayed - moved );
+					}
+
+					total += moved;
+					if( moved != relayed )
+					{
+						// The source already gave these up, so they can't be left unread
+						lost = relayed - moved;
+						size = total;
+					}
+
+					continue;
+				}
+
+				wait_descriptor = from.descriptor;
+				wait_events = POLLIN;
+				break;
+
+			case Method::Buffered:
+				break;
+		}
+
+		if( result > 0 )
+		{
+			total += static_cast<size_t>( result );
+		}
+		else if( result == 0 )
+		{
+			break;
+		}
+		else if( errno == EAGAIN && wait_descriptor != -1 )
+		{
+			if( !WaitReady( wait_descriptor, wait_events ) )
+				break;
+		}
+		else if( IsUnsupported( errno ) )
+		{
+			method = Method::Buffered;
+		}
+		else if( errno != EINTR )
+		{
+			break;
+		}
+	}
+
+	if( relay[0] != -1 )
+	{
+		close( relay[0] );
+		close( relay[1] );
+	}
+
+	if( method == Method::Buffered && total < size )
+		total += CopyBuffered( from, to, size - total );
+
+	if( from.is_file )
+		source.position->Seek( static_cast<size_t>( from.offset ) );
+
+	if( to.is_file )
+		sink.position->Seek( static_cast<size_t>( to.offset ) );
+
+	if( lost != 0 )
+		throw std::system_error(
+			lost_error != 0 ? lost_error : EPIPE,
+			std::generic_category( ),
+			"transfer delivered " + std::to_string( total ) + " bytes but lost " + std::to_string( lost ) + " bytes read from the source"
+		);
+
+	return total;
+}
+
+size_t Tee( Pipe &source, Pipe &sink, size_t size )
+{
+	TransferEndpoint from( source ), to( sink );
+	if( from.read_descriptor == -1 || to.write_descriptor == -1 )
+		return 0;
+
+	ssize_t result;
+	do
+		result = Internal::WithoutPipeSignal( [&]( ) { return tee( from.read_descriptor, to.write_descriptor, std::min( size, max_chunk_size ), 0 ); } );
+	while( result < 0 && errno == EINTR );
+
+	return result > 0 ? static_cast<size_t>( result ) : 0;
+}
+
+} // namespace MultiLibrary
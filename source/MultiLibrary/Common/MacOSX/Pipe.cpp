@@ -34,10 +34,12 @@
  *************************************************************************/
 
 #include <MultiLibrary/Common/MacOSX/Pipe.hpp>
+#include <chrono>
 #include <system_error>
 #include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
 #include <unistd.h>
-#include <sys/select.h>
 #include <sys/ioctl.h>
 #include <errno.h>
 
@@ -59,7 +61,100 @@ Pipe::Handle::operator int( ) const
 	return internal;
 }
 
-Pipe::Pipe( Standard::Input in, Standard::Output out )
+typedef std::chrono::steady_clock Clock;
+
+// Milliseconds for poll to wait in the given mode, -1 being forever
+static int GetWait( Pipe::Mode mode, Clock::time_point deadline )
+{
+	switch( mode )
+	{
+		case Pipe::Mode::Blocking:
+			return -1;
+
+		case Pipe::Mode::Deadline:
+		{
+			Clock::duration remaining = deadline - Clock::now( );
+			if( remaining <= Clock::duration::zero( ) )
+				return 0;
+
+			// Rounded up so the wait doesn't end right before the deadline
+			std::chrono::milliseconds::rep wait = std::chrono::duration_cast<std::chrono::milliseconds>( remaining + std::chrono::milliseconds( 1 ) - Clock::duration( 1 ) ).count( );
+			return wait < INT_MAX ? static_cast<int>( wait ) : INT_MAX;
+		}
+
+		default:
+			return 0;
+	}
+}
+
+static bool WaitReady( int handle, short events, Pipe::Mode mode, Clock::time_point deadline )
+{
+	pollfd descriptor = { handle, events, 0 };
+	for( ; ; )
+	{
+		int result = poll( &descriptor, 1, GetWait( mode, deadline ) );
+		if( result > 0 )
+			return true;
+
+		if( result == 0 || errno != EINTR )
+			return false;
+	}
+}
+
+// Returns 0 on timeout or error and sets closed at end of file
+static size_t ReadUntil( int handle, void *data, size_t size, Pipe::Mode mode, Clock::time_point deadline, bool &closed )
+{
+	for( ; ; )
+	{
+		if( mode != Pipe::Mode::Blocking && !WaitReady( handle, POLLIN, mode, deadline ) )
+			return 0;
+
+		ssize_t result = read( handle, data, size );
+		if( result > 0 )
+			return static_cast<size_t>( result );
+
+		if( result == 0 )
+		{
+			closed = true;
+			return 0;
+		}
+
+		if( errno != EINTR && errno != EAGAIN )
+			return 0;
+	}
+}
+
+// Outside of Blocking mode, writes are split in PIPE_BUF chunks, which never
+// block once poll reports the pipe as writable
+static size_t WriteUntil( int handle, const void *data, size_t size, Pipe::Mode mode, Clock::time_point deadline )
+{
+	const char *bytes = static_cast<const char *>( data );
+	size_t written = 0;
+	while( written < size )
+	{
+		size_t chunk = size - written;
+		if( mode != Pipe::Mode::Blocking )
+		{
+			if( !WaitReady( handle, POLLOUT, written == 0 ? mode : Pipe::Mode::NonBlocking, deadline ) )
+				break;
+
+			chunk = chunk < PIPE_BUF ? chunk : PIPE_BUF;
+		}
+
+		ssize_t result = write( handle, bytes + written, chunk );
+		if( result > 0 )
+			written += static_cast<size_t>( result );
+		else if( result == 0 || ( errno != EINTR && errno != EAGAIN ) )
+			break;
+	}
+
+	return written;
+}
+
+Pipe::Pipe( Standard::Input in, Standard::Output out ) :
+	mode( Mode::Blocking ),
+	timeout( 0 ),
+	end_of_file( false )
 {
 	int std_handle = -1;
 
@@ -71,12 +166,15 @@ Pipe::Pipe( Standard::Input in, Standard::Output out )
 		read_handle.reset( new Handle( std_handle ) );
 	}
 
+	// Writes without readers fail with EPIPE instead of raising SIGPIPE,
+	// which kills the process by default
 	switch( out )
 	{
 		case Standard::Output::Normal:
 			if( ( std_handle = dup( 1 ) ) == -1 )
 				throw std::system_error( errno, std::system_category( ), "unable to duplicate standard output handle" );
 
+			fcntl( std_handle, F_SETNOSIGPIPE, 1 );
 			write_handle.reset( new Handle( std_handle ) );
 			break;
 
@@ -84,6 +182,7 @@ Pipe::Pipe( Standard::Input in, Standard::Output out )
 			if( ( std_handle = dup( 2 ) ) == -1 )
 				throw std::system_error( errno, std::system_category( ), "unable to duplicate standard error handle" );
 
+			fcntl( std_handle, F_SETNOSIGPIPE, 1 );
 			write_handle.reset( new Handle( std_handle ) );
 			break;
 
@@ -92,7 +191,10 @@ Pipe::Pipe( Standard::Input in, Standard::Output out )
 	}
 }
 
-Pipe::Pipe( bool, bool )
+Pipe::Pipe( bool, bool ) :
+	mode( Mode::Blocking ),
+	timeout( 0 ),
+	end_of_file( false )
 {
 	int handles[2] = { -1, -1 };
 	if( pipe( handles ) != 0 )
@@ -100,13 +202,17 @@ Pipe::Pipe( bool, bool )
 
 	fcntl( handles[0], F_SETFD, FD_CLOEXEC );
 	fcntl( handles[1], F_SETFD, FD_CLOEXEC );
+	fcntl( handles[1], F_SETNOSIGPIPE, 1 );
 	read_handle.reset( new Handle( handles[0] ) );
 	write_handle.reset( new Handle( handles[1] ) );
 }
 
 Pipe::Pipe( Pipe &&pipe ) noexcept :
 	read_handle( std::move( pipe.read_handle ) ),
-	write_handle( std::move( pipe.write_handle ) )
+	write_handle( std::move( pipe.write_handle ) ),
+	mode( pipe.mode ),
+	timeout( pipe.timeout ),
+	end_of_file( pipe.end_of_file )
 { }
 
 Pipe::~Pipe( )
@@ -141,53 +247,96 @@ size_t Pipe::Size( ) const
 		return 0;
 
 	int size = 0;
-	if( ioctl( *read_handle, FIONREAD, &size ) == 0 )
-		return 0;
+	if( ioctl( *read_handle, FIONREAD, &size ) == 0 && size > 0 )
+		return static_cast<size_t>( size );
 
 	return 0;
 }
 
 bool Pipe::EndOfFile( ) const
 {
-	return static_cast<bool>( read_handle );
+	return end_of_file || !read_handle;
+}
+
+void Pipe::SetMode( Mode m, uint32_t t )
+{
+	mode = m;
+	timeout = t;
+}
+
+Pipe::Mode Pipe::GetMode( ) const
+{
+	return mode;
+}
+
+uint32_t Pipe::GetTimeout( ) const
+{
+	return timeout;
 }
 
 size_t Pipe::Read( void *data, size_t size )
+{
+	if( !read_handle || size == 0 )
+		return 0;
+
+	bool closed = false;
+	size_t result = ReadUntil( *read_handle, data, size, mode, Clock::now( ) + std::chrono::milliseconds( timeout ), closed );
+	if( closed )
+		end_of_file = true;
+
+	return result;
+}
+
+size_t Pipe::ReadAll( void *data, size_t size )
 {
 	if( !read_handle )
 		return 0;
 
-	fd_set rfds;
-	FD_ZERO( &rfds );
-	FD_SET( *read_handle, &rfds );
-	timeval time = { 0, 0 };
-	if( select( 1, &rfds, nullptr, nullptr, &time ) == 1 )
+	Clock::time_point deadline = Clock::now( ) + std::chrono::milliseconds( timeout );
+	char *bytes = static_cast<char *>( data );
+	size_t total = 0;
+	bool closed = false;
+	while( total < size && !closed )
 	{
-		ssize_t res = read( *read_handle, data, size );
-		if( res >= 0 )
-			return res;
+		size_t result = ReadUntil( *read_handle, bytes + total, size - total, mode, deadline, closed );
+		if( result == 0 )
+			break;
+
+		total += result;
 	}
 
-	return 0;
+	if( closed )
+		end_of_file = true;
+
+	return total;
 }
 
 size_t Pipe::Write( const void *data, size_t size )
+{
+	if( !write_handle || size == 0 )
+		return 0;
+
+	return WriteUntil( *write_handle, data, size, mode, Clock::now( ) + std::chrono::milliseconds( timeout ) );
+}
+
+size_t Pipe::WriteAll( const void *data, size_t size )
 {
 	if( !write_handle )
 		return 0;
 
-	fd_set rfds;
-	FD_ZERO( &rfds );
-	FD_SET( *write_handle, &rfds );
-	timeval time = { 0, 0 };
-	if( select( 1, nullptr, &rfds, nullptr, &time ) == 1 )
+	Clock::time_point deadline = Clock::now( ) + std::chrono::milliseconds( timeout );
+	const char *bytes = static_cast<const char *>( data );
+	size_t total = 0;
+	while( total < size )
 	{
-		ssize_t res = write( *write_handle, data, size );
-		if( res >= 0 )
-			return res;
+		size_t result = WriteUntil( *write_handle, bytes + total, size - total, mode, deadline );
+		if( result == 0 )
+			break;
+
+		total += result;
 	}
 
-	return 0;
+	return total;
 }
 
 void Pipe::CloseRead( )
@@ -33,64 +33,154 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *************************************************************************/
 
-#include <MultiLibrary/Common/Process.hpp>
+#include <MultiLibrary/Common/MacOSX/Process.hpp>
+#include <MultiLibrary/Common/MacOSX/Pipe.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <algorithm>
 #include <system_error>
 #include <errno.h>
+#include <libproc.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <signal.h>
+#include <mach/mach_time.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
 namespace MultiLibrary
 {
 
-class Process::Handle
+Process::Handle::Handle( pid_t proc ) :
+	internal( proc )
+{ }
+
+Process::Handle::operator pid_t( ) const
+{
+	return internal;
+}
+
+// Actions for posix_spawn and the descriptors duplicated for them
+struct SpawnActions
 {
-public:
-	Handle( pid_t proc ) :
-		internal( proc )
-	{ }
+	SpawnActions( )
+	{
+		posix_spawn_file_actions_init( &actions );
+		posix_spawnattr_init( &attributes );
+	}
+
+	~SpawnActions( )
+	{
+		posix_spawn_file_actions_destroy( &actions );
+		posix_spawnattr_destroy( &attributes );
+		for( int descriptor : duplicates )
+			close( descriptor );
+	}
+
+	// Sources are duplicated above every descriptor the process gets, so
+	// the duplications done in the process can't overwrite each other
+	void Map( int source, int target, int minimum )
+	{
+		int duplicate = fcntl( source, F_DUPFD_CLOEXEC, minimum );
+		if( duplicate == -1 )
+			throw std::system_error( errno, std::system_category( ), "unable to duplicate descriptor" );
+
+		duplicates.push_back( duplicate );
+		posix_spawn_file_actions_adddup2( &actions, duplicate, target );
+	}
 
-	operator pid_t( ) const
+	void Redirect( ProcessBuilder::Redirection redirection, const Pipe::Handle &pipe, int target, int flags, int minimum )
 	{
-		return internal;
+		if( redirection == ProcessBuilder::Redirection::Pipe )
+			Map( pipe, target, minimum );
+		else if( redirection == ProcessBuilder::Redirection::Null )
+			posix_spawn_file_actions_addopen( &actions, target, "/dev/null", flags, 0 );
 	}
 
-private:
-	pid_t internal;
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_t attributes;
+	std::vector<int> duplicates;
 };
 
+static uint64_t ToMicroseconds( const timeval &time )
+{
+	return static_cast<uint64_t>( time.tv_sec ) * 1000000 + static_cast<uint64_t>( time.tv_usec );
+}
+
 Process::Process( const std::string &path, const std::vector<std::string> &args ) :
+	Process( ProcessBuilder( path ).AddArguments( args ) )
+{ }
+
+Process::Process( const ProcessBuilder &builder ) :
 	exit_code( 0 ),
+	usage( ),
 	input_pipe( true, false ),
 	output_pipe( false, true ),
 	error_pipe( false, true )
 {
-	char **argv = nullptr;
-	if( !args.empty( ) )
-	{
-		argv = new char *[args.size( ) + 2];
-		argv[0] = const_cast<char *>( path.c_str( ) );
-		for( size_t i = 1; i < args.size( ) + 1; ++i )
-			argv[i] = const_cast<char *>( args[i].c_str( ) );
+	std::vector<char *> argv;
+	argv.push_back( const_cast<char *>( builder.path.c_str( ) ) );
+	for( const std::string &argument : builder.arguments )
+		argv.push_back( const_cast<char *>( argument.c_str( ) ) );
 
-		argv[args.size( )] = nullptr;
-	}
+	argv.push_back( nullptr );
 
-	pid_t pid = fork( );
-	if( pid == 0 && execv( path.c_str( ), argv ) )
-	{
-		delete [] argv;
-		exit( EXIT_FAILURE );
-	}
+	std::vector<std::string> environment = builder.BuildEnvironment( );
+	std::vector<char *> envp;
+	for( std::string &entry : environment )
+		envp.push_back( &entry[0] );
+
+	envp.push_back( nullptr );
+
+	int minimum = STDERR_FILENO + 1;
+	for( const std::pair<int, int> &mapping : builder.descriptors )
+		minimum = std::max( minimum, mapping.second + 1 );
+
+	SpawnActions spawn;
+	spawn.Redirect( builder.input, input_pipe.ReadHandle( ), STDIN_FILENO, O_RDONLY, minimum );
+	spawn.Redirect( builder.output, output_pipe.WriteHandle( ), STDOUT_FILENO, O_WRONLY, minimum );
+	spawn.Redirect( builder.error, error_pipe.WriteHandle( ), STDERR_FILENO, O_WRONLY, minimum );
+	for( const std::pair<int, int> &mapping : builder.descriptors )
+		spawn.Map( mapping.first, mapping.second, minimum );
+
+	if( !builder.working_directory.empty( ) )
+		posix_spawn_file_actions_addchdir_np( &spawn.actions, builder.working_directory.c_str( ) );
+
+	// Servers often ignore SIGPIPE, which the process would inherit
+	sigset_t signals;
+	sigemptyset( &signals );
+	posix_spawnattr_setsigmask( &spawn.attributes, &signals );
+	sigaddset( &signals, SIGPIPE );
+	posix_spawnattr_setsigdefault( &spawn.attributes, &signals );
+
+	// Descriptors that weren't mapped are closed in the process
+	short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_CLOEXEC_DEFAULT;
 
-	delete [] argv;
+	posix_spawnattr_setflags( &spawn.attributes, flags );
 
-	if( pid == -1 )
-		throw std::system_error( errno, std::system_category( ), "failed to fork process" );
+	pid_t pid = -1;
+	int result = posix_spawn( &pid, builder.path.c_str( ), &spawn.actions, &spawn.attributes, argv.data( ), envp.data( ) );
+	if( result != 0 )
+		throw std::system_error( result, std::system_category( ), "failed to spawn process" );
 
 	process.reset( new Handle( pid ) );
+	for( const SharedChannel *channel : builder.channels )
+		channel->SetPeer( static_cast<uint32_t>( pid ) );
+
+	// Only the process uses these ends
+	input_pipe.CloseRead( );
+	output_pipe.CloseWrite( );
+	error_pipe.CloseWrite( );
+	if( builder.input != ProcessBuilder::Redirection::Pipe )
+		input_pipe.CloseWrite( );
+
+	if( builder.output != ProcessBuilder::Redirection::Pipe )
+		output_pipe.CloseRead( );
+
+	if( builder.error != ProcessBuilder::Redirection::Pipe )
+		error_pipe.CloseRead( );
 }
 
 Process::~Process( )
@@ -103,11 +193,16 @@ Process::Status Process::GetStatus( ) const
 	if( !process )
 		return Status::Unknown;
 
-	int status = 0;
-	if( waitpid( *process, &status, WNOHANG ) )
-		return WIFEXITED( status ) ? Status::Terminated : Status::Running;
+	// The child is left waitable so Close can still reap it
+	siginfo_t info;
+	info.si_pid = 0;
+	if( waitid( P_PID, *process, &info, WEXITED | WNOHANG | WNOWAIT ) != 0 )
+		return Status::Unknown;
+
+	if( info.si_pid == 0 )
+		return Status::Running;
 
-	return Status::Unknown;
+	return info.si_code == CLD_EXITED ? Status::Terminated : Status::Killed;
 }
 
 bool Process::Close( )
@@ -115,15 +210,40 @@ bool Process::Close( )
 	if( !process )
 		return false;
 
-	int status = 0;
-	if( waitpid( *process, &status, 0 ) > 0 )
+	// Wait without reaping, the disk counters are gone once the child is
+	siginfo_t info;
+	int result = -1;
+	do
+		result = waitid( P_PID, *process, &info, WEXITED | WNOWAIT );
+	while( result == -1 && errno == EINTR );
+
+	rusage_info_v2 information;
+	if( result == 0 && proc_pid_rusage( *process, RUSAGE_INFO_V2, reinterpret_cast<rusage_info_t *>( &information ) ) == 0 )
 	{
-		process.reset( );
-		return WIFEXITED( status );
+		usage.read_bytes = information.ri_diskio_bytesread;
+		usage.written_bytes = information.ri_diskio_byteswritten;
 	}
 
+	int status = 0;
+	struct rusage resources;
+	pid_t reaped = -1;
+	do
+		reaped = wait4( *process, &status, 0, &resources );
+	while( reaped == -1 && errno == EINTR );
+
 	process.reset( );
-	return false;
+	if( reaped <= 0 )
+		return false;
+
+	usage.user_time = ToMicroseconds( resources.ru_utime );
+	usage.system_time = ToMicroseconds( resources.ru_stime );
+	usage.max_resident_size = static_cast<uint64_t>( resources.ru_maxrss );
+	usage.minor_faults = static_cast<uint64_t>( resources.ru_minflt );
+	usage.major_faults = static_cast<uint64_t>( resources.ru_majflt );
+	usage.voluntary_switches = static_cast<uint64_t>( resources.ru_nvcsw );
+	usage.involuntary_switches = static_cast<uint64_t>( resources.ru_nivcsw );
+	exit_code = WIFEXITED( status ) ? WEXITSTATUS( status ) : -WTERMSIG( status );
+	return WIFEXITED( status );
 }
 
 void Process::Kill( )
@@ -161,4 +281,40 @@ int32_t Process::ExitCode( ) const
 	return exit_code;
 }
 
+bool Process::SampleUsage( )
+{
+	if( !process )
+		return false;
+
+	rusage_info_v2 information;
+	if( proc_pid_rusage( *process, RUSAGE_INFO_V2, reinterpret_cast<rusage_info_t *>( &information ) ) != 0 )
+		return false;
+
+	// Times are in Mach absolute units, which are only nanoseconds on Intel
+	mach_timebase_info_data_t timebase;
+	mach_timebase_info( &timebase );
+	usage.user_time = information.ri_user_time * timebase.numer / timebase.denom / 1000;
+	usage.system_time = information.ri_system_time * timebase.numer / timebase.denom / 1000;
+	usage.max_resident_size = std::max( usage.max_resident_size, static_cast<uint64_t>( information.ri_resident_size ) );
+	usage.major_faults = information.ri_pageins;
+	usage.read_bytes = information.ri_diskio_bytesread;
+	usage.written_bytes = information.ri_diskio_byteswritten;
+
+	proc_taskinfo task;
+	if( proc_pidinfo( *process, PROC_PIDTASKINFO, 0, &task, sizeof( task ) ) == sizeof( task ) )
+	{
+		usage.minor_faults = static_cast<uint64_t>( task.pti_faults - task.pti_pageins );
+
+		// Mach doesn't tell the two kinds of context switches apart
+		usage.voluntary_switches = static_cast<uint64_t>( task.pti_csw );
+	}
+
+	return true;
+}
+
+const Process::Usage &Process::GetUsage( ) const
+{
+	return usage;
+}
+
 } // namespace MultiLibrary
@@ -0,0 +1,359 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ProcessGroup.hpp>
+#include <MultiLibrary/Common/MacOSX/Pipe.hpp>
+#include <MultiLibrary/Common/MacOSX/Process.hpp>
+#include <deque>
+#include <system_error>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/event.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+
+namespace MultiLibrary
+{
+
+// Size of the chunks read from the process pipes
+static const size_t chunk_size = 64 * 1024;
+
+// Events taken from kqueue per call
+static const int max_events = 64;
+
+class ProcessGroup::Reactor
+{
+public:
+	struct Entry;
+
+	// Something kqueue watches for an entry, the descriptor being the
+	// process identifier for Event::Exit
+	struct Source
+	{
+		Entry *entry;
+		Event event;
+		int descriptor;
+	};
+
+	struct Entry
+	{
+		Process *process;
+		Callback callback;
+		Source sources[3];
+		bool exited;
+		bool removed;
+	};
+
+	Reactor( ) :
+		queue_descriptor( kqueue( ) ),
+		buffer( chunk_size )
+	{
+		if( queue_descriptor == -1 )
+			throw std::system_error( errno, std::system_category( ), "unable to create kqueue instance" );
+
+		fcntl( queue_descriptor, F_SETFD, FD_CLOEXEC );
+	}
+
+	~Reactor( )
+	{
+		for( std::unique_ptr<Entry> &entry : entries )
+			Detach( *entry );
+
+		close( queue_descriptor );
+	}
+
+	bool Add( Process &process, const Callback &callback )
+	{
+		if( !process.process || Find( process ) != nullptr )
+			return false;
+
+		std::unique_ptr<Entry> entry( new Entry );
+		entry->process = &process;
+		entry->callback = callback;
+		entry->exited = false;
+		entry->removed = false;
+		entry->sources[0] = { entry.get( ), Event::Output, process.output_pipe.read_handle ? static_cast<int>( *process.output_pipe.read_handle ) : -1 };
+		entry->sources[1] = { entry.get( ), Event::Error, process.error_pipe.read_handle ? static_cast<int>( *process.error_pipe.read_handle ) : -1 };
+		entry->sources[2] = { entry.get( ), Event::Exit, static_cast<int>( *process.process ) };
+
+		for( Source &source : entry->sources )
+		{
+			if( source.descriptor == -1 )
+				continue;
+
+			struct kevent change;
+			if( source.event == Event::Exit )
+				EV_SET( &change, source.descriptor, EVFILT_PROC, EV_ADD | EV_ONESHOT, NOTE_EXIT, 0, &source );
+			else
+				EV_SET( &change, source.descriptor, EVFILT_READ, EV_ADD, 0, 0, &source );
+
+			if( kevent( queue_descriptor, &change, 1, nullptr, 0, nullptr ) == 0 )
+				continue;
+
+			// Exited before it could be watched, it's finished on the next Wait
+			if( source.event == Event::Exit && errno == ESRCH )
+			{
+				entry->exited = true;
+				continue;
+			}
+
+			Detach( *entry );
+			return false;
+		}
+
+		entries.push_back( std::move( entry ) );
+		return true;
+	}
+
+	bool Remove( Process &process )
+	{
+		Entry *entry = Find( process );
+		if( entry == nullptr )
+			return false;
+
+		Detach( *entry );
+		return true;
+	}
+
+	size_t Count( ) const
+	{
+		size_t count = 0;
+		for( const std::unique_ptr<Entry> &entry : entries )
+			if( !entry->removed )
+				++count;
+
+		return count;
+	}
+
+	size_t Wait( uint32_t timeout )
+	{
+		size_t produced = 0;
+		for( size_t k = 0; k < entries.size( ); ++k )
+			if( !entries[k]->removed && entries[k]->exited )
+				produced += Finish( *entries[k] );
+
+		timespec wait;
+		wait.tv_sec = produced != 0 ? 0 : timeout / 1000;
+		wait.tv_nsec = produced != 0 ? 0 : static_cast<long>( timeout % 1000 ) * 1000000;
+
+		struct kevent events[max_events];
+		int count = kevent( queue_descriptor, nullptr, 0, events, max_events, timeout == WAIT_FOREVER && produced == 0 ? nullptr : &wait );
+		if( count < 0 && errno != EINTR )
+			throw std::system_error( errno, std::system_category( ), "unable to wait on kqueue instance" );
+
+		for( int k = 0; k < count; ++k )
+		{
+			Source *source = static_cast<Source *>( events[k].udata );
+			if( source->entry->removed || source->descriptor == -1 )
+				continue;
+			else if( source->event == Event::Exit )
+				produced += Finish( *source->entry );
+			else
+				produced += ReadChunk( *source );
+		}
+
+		Purge( );
+		return produced;
+	}
+
+	bool Next( Notification &notification )
+	{
+		if( queue.empty( ) )
+			return false;
+
+		notification = std::move( queue.front( ) );
+		queue.pop_front( );
+		return true;
+	}
+
+	size_t Pending( ) const
+	{
+		return queue.size( );
+	}
+
+private:
+	Entry *Find( Process &process )
+	{
+		for( std::unique_ptr<Entry> &entry : entries )
+			if( entry->process == &process && !entry->removed )
+				return entry.get( );
+
+		return nullptr;
+	}
+
+	void Detach( Entry &entry )
+	{
+		if( entry.removed )
+			return;
+
+		for( Source &source : entry.sources )
+		{
+			if( source.descriptor == -1 )
+				continue;
+
+			// Fails harmlessly for exit watches that already fired
+			struct kevent change;
+			EV_SET( &change, source.descriptor, source.event == Event::Exit ? EVFILT_PROC : EVFILT_READ, EV_DELETE, 0, 0, nullptr );
+			kevent( queue_descriptor, &change, 1, nullptr, 0, nullptr );
+			source.descriptor = -1;
+		}
+
+		entry.removed = true;
+	}
+
+	// Entries are only freed here, so events already taken from kqueue never
+	// point to freed memory
+	void Purge( )
+	{
+		size_t kept = 0;
+		for( size_t k = 0; k < entries.size( ); ++k )
+			if( !entries[k]->removed )
+				entries[kept++] = std::move( entries[k] );
+
+		entries.resize( kept );
+	}
+
+	void Deliver( Entry &entry, Event event, const uint8_t *data, size_t size, int32_t exit_code )
+	{
+		Notification *notification = &scratch;
+		if( !entry.callback )
+		{
+			queue.emplace_back( );
+			notification = &queue.back( );
+		}
+
+		notification->process = entry.process;
+		notification->event = event;
+		notification->data.assign( data, data + size );
+		notification->exit_code = exit_code;
+		if( entry.callback )
+		{
+			// The callback might remove the entry, it's only freed on Purge
+			Callback callback = entry.callback;
+			callback( *notification );
+		}
+	}
+
+	size_t ReadChunk( Source &source )
+	{
+		ssize_t result;
+		do
+			result = read( source.descriptor, buffer.data( ), buffer.size( ) );
+		while( result < 0 && errno == EINTR );
+
+		if( result > 0 )
+		{
+			Deliver( *source.entry, source.event, buffer.data( ), static_cast<size_t>( result ), 0 );
+			return 1;
+		}
+
+		if( result < 0 && errno == EAGAIN )
+			return 0;
+
+		// The other end was closed, nothing else will come from it
+		struct kevent change;
+		EV_SET( &change, source.descriptor, EVFILT_READ, EV_DELETE, 0, 0, nullptr );
+		kevent( queue_descriptor, &change, 1, nullptr, 0, nullptr );
+		source.descriptor = -1;
+		return 0;
+	}
+
+	size_t Finish( Entry &entry )
+	{
+		size_t produced = 0;
+		for( size_t k = 0; k < 2 && !entry.removed; ++k )
+		{
+			int available = 0;
+			Source &source = entry.sources[k];
+			while( source.descriptor != -1 && ioctl( source.descriptor, FIONREAD, &available ) == 0 && available > 0 )
+				produced += ReadChunk( source );
+		}
+
+		if( entry.removed )
+			return produced;
+
+		Process &process = *entry.process;
+		Detach( entry );
+		process.Close( );
+		Deliver( entry, Event::Exit, nullptr, 0, process.ExitCode( ) );
+		return produced + 1;
+	}
+
+	int queue_descriptor;
+	std::vector<std::unique_ptr<Entry>> entries;
+	std::deque<Notification> queue;
+	std::vector<uint8_t> buffer;
+	Notification scratch;
+};
+
+ProcessGroup::ProcessGroup( ) :
+	reactor( new Reactor( ) )
+{ }
+
+ProcessGroup::~ProcessGroup( )
+{ }
+
+bool ProcessGroup::Add( Process &process, const Callback &callback )
+{
+	return reactor->Add( process, callback );
+}
+
+bool ProcessGroup::Remove( Process &process )
+{
+	return reactor->Remove( process );
+}
+
+size_t ProcessGroup::Count( ) const
+{
+	return reactor->Count( );
+}
+
+size_t ProcessGroup::Wait( uint32_t timeout )
+{
+	return reactor->Wait( timeout );
+}
+
+bool ProcessGroup::Next( Notification &notification )
+{
+	return reactor->Next( notification );
+}
+
+size_t ProcessGroup::Pending( ) const
+{
+	return reactor->Pending( );
+}
+
+} // namespace MultiLibrary
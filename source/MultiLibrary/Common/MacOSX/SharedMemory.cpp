@@ -0,0 +1,163 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/SharedMemory.hpp>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <errno.h>
+#include <fcntl.h>
+#include <libproc.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/proc.h>
+#include <sys/stat.h>
+
+namespace MultiLibrary
+{
+
+namespace Internal
+{
+
+// Longest sleep between checks of a signal, there's no futex shared between
+// processes to wait on
+static const int64_t poll_interval = 200000;
+
+static void *Map( int descriptor, size_t size )
+{
+	void *address = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0 );
+	if( address == MAP_FAILED )
+	{
+		int error = errno;
+		close( descriptor );
+		throw std::system_error( error, std::system_category( ), "failed to map shared memory" );
+	}
+
+	return address;
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Create( size_t size )
+{
+	// The name is removed right away, only the descriptor keeps the memory
+	static std::atomic<uint32_t> counter( 0 );
+	const std::string name = "/ml." + std::to_string( getpid( ) ) + "." + std::to_string( counter.fetch_add( 1 ) );
+	int descriptor = shm_open( name.c_str( ), O_RDWR | O_CREAT | O_EXCL, 0600 );
+	if( descriptor == -1 )
+		throw std::system_error( errno, std::system_category( ), "failed to create shared memory" );
+
+	shm_unlink( name.c_str( ) );
+	fcntl( descriptor, F_SETFD, FD_CLOEXEC );
+	if( ftruncate( descriptor, static_cast<off_t>( size ) ) != 0 )
+	{
+		int error = errno;
+		close( descriptor );
+		throw std::system_error( error, std::system_category( ), "failed to resize shared memory" );
+	}
+
+	return std::unique_ptr<SharedMemory>( new SharedMemory( descriptor, Map( descriptor, size ), size ) );
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open( Descriptor descriptor )
+{
+	struct stat information;
+	if( fstat( descriptor, &information ) != 0 )
+		throw std::system_error( errno, std::system_category( ), "failed to open shared memory" );
+
+	// Processes spawned by this one only get it if mapped again
+	fcntl( descriptor, F_SETFD, FD_CLOEXEC );
+
+	size_t size = static_cast<size_t>( information.st_size );
+	return std::unique_ptr<SharedMemory>( new SharedMemory( descriptor, Map( descriptor, size ), size ) );
+}
+
+SharedMemory::SharedMemory( Descriptor memory_descriptor, void *memory_address, size_t memory_size ) :
+	descriptor( memory_descriptor ),
+	address( memory_address ),
+	size( memory_size )
+{ }
+
+SharedMemory::~SharedMemory( )
+{
+	munmap( address, size );
+	close( descriptor );
+}
+
+void *SharedMemory::Address( ) const
+{
+	return address;
+}
+
+size_t SharedMemory::Size( ) const
+{
+	return size;
+}
+
+SharedMemory::Descriptor SharedMemory::GetDescriptor( ) const
+{
+	return descriptor;
+}
+
+void SharedMemory::Wait( std::atomic<uint32_t> &signal, uint32_t value, int64_t timeout )
+{
+	if( signal.load( std::memory_order_acquire ) != value )
+		return;
+
+	std::this_thread::sleep_for( std::chrono::nanoseconds( timeout >= 0 && timeout < poll_interval ? timeout : poll_interval ) );
+}
+
+void SharedMemory::Wake( std::atomic<uint32_t> & )
+{ }
+
+uint32_t SharedMemory::GetProcessIdentifier( )
+{
+	return static_cast<uint32_t>( getpid( ) );
+}
+
+bool SharedMemory::IsRunning( uint32_t identifier )
+{
+	// Exited processes stay around as zombies until they're waited for
+	proc_bsdinfo information;
+	if( proc_pidinfo( static_cast<pid_t>( identifier ), PROC_PIDTBSDINFO, 0, &information, sizeof( information ) ) == sizeof( information ) )
+		return information.pbi_status != SZOMB;
+
+	return kill( static_cast<pid_t>( identifier ), 0 ) == 0 || errno != ESRCH;
+}
+
+} // namespace Internal
+
+} // namespace MultiLibrary
@@ -0,0 +1,228 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/Transfer.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <MultiLibrary/Common/MacOSX/Pipe.hpp>
+#include <algorithm>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace MultiLibrary
+{
+
+// Size of the buffer used when data has to go through user space
+static const size_t copy_buffer_size = 128 * 1024;
+
+// One end of a transfer, files being accessed at an explicit offset
+struct End
+{
+	int descriptor;
+	InputStream *input;
+	OutputStream *output;
+	bool is_file;
+	bool is_pipe;
+	off_t offset;
+};
+
+TransferEndpoint::TransferEndpoint( Pipe &pipe ) :
+	TransferEndpoint(
+		Type::Pipe,
+		pipe.read_handle ? static_cast<int>( *pipe.read_handle ) : -1,
+		pipe.write_handle ? static_cast<int>( *pipe.write_handle ) : -1,
+		&pipe,
+		&pipe,
+		nullptr
+	)
+{ }
+
+// Waits until a nonblocking descriptor is ready for the requested events
+static bool WaitReady( int descriptor, short events )
+{
+	pollfd request = { descriptor, events, 0 };
+	int result;
+	do
+		result = poll( &request, 1, -1 );
+	while( result < 0 && errno == EINTR );
+
+	return result > 0;
+}
+
+static ssize_t ReadSome( End &end, void *data, size_t size )
+{
+	if( end.is_file )
+	{
+		ssize_t result;
+		do
+			result = pread( end.descriptor, data, size, end.offset );
+		while( result < 0 && errno == EINTR );
+
+		if( result > 0 )
+			end.offset += result;
+
+		return result;
+	}
+
+	if( end.input != nullptr )
+		return static_cast<ssize_t>( end.input->Read( data, size ) );
+
+	while( true )
+	{
+		ssize_t result = read( end.descriptor, data, size );
+		if( result >= 0 )
+			return result;
+
+		if( errno == EAGAIN || errno == EWOULDBLOCK )
+		{
+			if( !WaitReady( end.descriptor, POLLIN ) )
+				return -1;
+		}
+		else if( errno != EINTR )
+		{
+			return -1;
+		}
+	}
+}
+
+static size_t WriteAll( End &end, const uint8_t *data, size_t size )
+{
+	size_t total = 0;
+	while( total < size )
+	{
+		ssize_t result;
+		if( end.is_file )
+		{
+			result = pwrite( end.descriptor, data + total, size - total, end.offset );
+			if( result > 0 )
+				end.offset += result;
+		}
+		else if( end.output != nullptr )
+		{
+			result = static_cast<ssize_t>( end.output->Write( data + total, size - total ) );
+		}
+		else
+		{
+			result = write( end.descriptor, data + total, size - total );
+		}
+
+		if( result > 0 )
+		{
+			total += static_cast<size_t>( result );
+		}
+		else if( result == 0 )
+		{
+			break;
+		}
+		else if( errno == EAGAIN || errno == EWOULDBLOCK )
+		{
+			if( !WaitReady( end.descriptor, POLLOUT ) )
+				break;
+		}
+		else if( errno != EINTR )
+		{
+			break;
+		}
+	}
+
+	return total;
+}
+
+static size_t CopyBuffered( End &source, End &sink, size_t size )
+{
+	BufferPool &pool = BufferPool::Default( );
+	BufferPool::Storage storage = pool.Acquire( copy_buffer_size );
+	storage->resize( copy_buffer_size );
+
+	size_t total = 0;
+	while( total < size )
+	{
+		ssize_t result = ReadSome( source, storage->data( ), std::min( size - total, copy_buffer_size ) );
+		if( result <= 0 )
+			break;
+
+		size_t written = WriteAll( sink, storage->data( ), static_cast<size_t>( result ) );
+		total += written;
+		if( written != static_cast<size_t>( result ) )
+			break;
+	}
+
+	pool.Release( std::move( storage ) );
+	return total;
+}
+
+static End MakeEnd( int descriptor, InputStream *input, OutputStream *output, Stream *position, TransferEndpoint::Type type )
+{
+	End end = { descriptor, input, output, position != nullptr, type == TransferEndpoint::Type::Pipe, 0 };
+	if( position != nullptr )
+	{
+		// Seeking to the current position flushes whatever the stream buffered
+		end.offset = static_cast<off_t>( position->Tell( ) );
+		position->Seek( static_cast<size_t>( end.offset ) );
+	}
+
+	return end;
+}
+
+size_t Transfer( const TransferEndpoint &source, const TransferEndpoint &sink, size_t size )
+{
+	End from = MakeEnd( source.read_descriptor, source.input, nullptr, source.position, source.type );
+	End to = MakeEnd( sink.write_descriptor, nullptr, sink.output, sink.position, sink.type );
+
+	// Writing to a socket or pipe without readers raises SIGPIPE, which kills
+	// the process by default, so it's turned off while the sink is written to
+	bool restore_signal = to.descriptor != -1 && fcntl( to.descriptor, F_GETNOSIGPIPE ) == 0 && fcntl( to.descriptor, F_SETNOSIGPIPE, 1 ) == 0;
+
+	size_t total = CopyBuffered( from, to, size );
+
+	if( restore_signal )
+		fcntl( to.descriptor, F_SETNOSIGPIPE, 0 );
+
+	if( from.is_file )
+		source.position->Seek( static_cast<size_t>( from.offset ) );
+
+	if( to.is_file )
+		sink.position->Seek( static_cast<size_t>( to.offset ) );
+
+	return total;
+}
+
+size_t Tee( Pipe &, Pipe &, size_t )
+{
+	return 0;
+}
+
+} // namespace MultiLibrary
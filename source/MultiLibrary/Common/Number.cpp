@@ -0,0 +1,1194 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/Number.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace MultiLibrary
+{
+
+namespace Number
+{
+
+static const char digit_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static size_t CountDigits( uint64_t value )
+{
+	size_t count = 1;
+	for( ; ; value /= 10000, count += 4 )
+	{
+		if( value < 10 )
+			return count;
+
+		if( value < 100 )
+			return count + 1;
+
+		if( value < 1000 )
+			return count + 2;
+
+		if( value < 10000 )
+			return count + 3;
+	}
+}
+
+// Digits are written from the end, two at a time
+static size_t FormatUnsigned( uint64_t value, char *buffer )
+{
+	size_t length = CountDigits( value );
+	char *out = buffer + length;
+	while( value >= 100 )
+	{
+		size_t pair = static_cast<size_t>( value % 100 ) * 2;
+		value /= 100;
+		*--out = digit_pairs[pair + 1];
+		*--out = digit_pairs[pair];
+	}
+
+	if( value >= 10 )
+	{
+		size_t pair = static_cast<size_t>( value ) * 2;
+		*--out = digit_pairs[pair + 1];
+		*--out = digit_pairs[pair];
+	}
+	else
+	{
+		*--out = static_cast<char>( '0' + value );
+	}
+
+	return length;
+}
+
+static size_t FormatSigned( int64_t value, char *buffer )
+{
+	if( value >= 0 )
+		return FormatUnsigned( static_cast<uint64_t>( value ), buffer );
+
+	*buffer = '-';
+	return FormatUnsigned( 0 - static_cast<uint64_t>( value ), buffer + 1 ) + 1;
+}
+
+static inline bool IsDigit( char c )
+{
+	return static_cast<unsigned char>( c - '0' ) < 10;
+}
+
+// Up to 19 digits always fit in 64 bits, only the 20th one needs checking
+static const char *ParseDigits( const char *it, const char *end, uint64_t limit, uint64_t &value )
+{
+	if( it == end || !IsDigit( *it ) )
+		return nullptr;
+
+	while( it != end && *it == '0' )
+		++it;
+
+	const char *start = it;
+	uint64_t result = 0;
+	for( ; it != end && IsDigit( *it ) && it - start < 19; ++it )
+		result = result * 10 + static_cast<uint64_t>( *it - '0' );
+
+	if( it != end && IsDigit( *it ) )
+	{
+		uint64_t digit = static_cast<uint64_t>( *it - '0' );
+		if( result > ( std::numeric_limits<uint64_t>::max( ) - digit ) / 10 )
+			return nullptr;
+
+		result = result * 10 + digit;
+		++it;
+		if( it != end && IsDigit( *it ) )
+			return nullptr;
+	}
+
+	if( result > limit )
+		return nullptr;
+
+	value = result;
+	return it;
+}
+
+static const char *ParseUnsigned( const char *begin, const char *end, uint64_t limit, uint64_t &value )
+{
+	if( begin != end && *begin == '+' )
+		++begin;
+
+	return ParseDigits( begin, end, limit, value );
+}
+
+static const char *ParseSigned( const char *begin, const char *end, uint64_t limit, int64_t &value )
+{
+	bool negative = false;
+	if( begin != end && ( *begin == '-' || *begin == '+' ) )
+	{
+		negative = *begin == '-';
+		++begin;
+	}
+
+	uint64_t magnitude = 0;
+	const char *it = ParseDigits( begin, end, negative ? limit + 1 : limit, magnitude );
+	if( it == nullptr )
+		return nullptr;
+
+	if( negative )
+		value = magnitude == 0 ? 0 : -static_cast<int64_t>( magnitude - 1 ) - 1;
+	else
+		value = static_cast<int64_t>( magnitude );
+
+	return it;
+}
+
+// Just enough of an arbitrary precision unsigned integer for exact float
+// conversions, the biggest values needed are around 2^3900
+class BigInteger
+{
+public:
+	BigInteger( ) :
+		size( 0 )
+	{ }
+
+	void Set( uint64_t value )
+	{
+		size = 0;
+		for( ; value != 0; value >>= 32 )
+			limbs[size++] = static_cast<uint32_t>( value );
+	}
+
+	bool IsZero( ) const
+	{
+		return size == 0;
+	}
+
+	size_t BitLength( ) const
+	{
+		if( size == 0 )
+			return 0;
+
+		size_t bits = ( size - 1 ) * 32;
+		for( uint32_t top = limbs[size - 1]; top != 0; top >>= 1 )
+			++bits;
+
+		return bits;
+	}
+
+	void MultiplyAdd( uint32_t factor, uint32_t addend )
+	{
+		uint64_t carry = addend;
+		for( size_t k = 0; k < size; ++k )
+		{
+			uint64_t product = static_cast<uint64_t>( limbs[k] ) * factor + carry;
+			limbs[k] = static_cast<uint32_t>( product );
+			carry = product >> 32;
+		}
+
+		if( carry != 0 )
+			limbs[size++] = static_cast<uint32_t>( carry );
+	}
+
+	void MultiplyPow10( size_t exponent )
+	{
+		static const uint32_t powers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+		for( ; exponent >= 9; exponent -= 9 )
+			MultiplyAdd( powers[9], 0 );
+
+		if( exponent != 0 )
+			MultiplyAdd( powers[exponent], 0 );
+	}
+
+	void ShiftLeft( size_t bits )
+	{
+		if( size == 0 || bits == 0 )
+			return;
+
+		size_t words = bits / 32;
+		size_t rest = bits % 32;
+		if( rest != 0 )
+		{
+			uint32_t carry = limbs[size - 1] >> ( 32 - rest );
+			for( size_t k = size - 1; k > 0; --k )
+				limbs[k] = ( limbs[k] << rest ) | ( limbs[k - 1] >> ( 32 - rest ) );
+
+			limbs[0] <<= rest;
+			if( carry != 0 )
+				limbs[size++] = carry;
+		}
+
+		if( words != 0 )
+		{
+			std::memmove( limbs + words, limbs, size * sizeof( uint32_t ) );
+			std::memset( limbs, 0, words * sizeof( uint32_t ) );
+			size += words;
+		}
+	}
+
+	void ShiftRightOne( )
+	{
+		for( size_t k = 0; k + 1 < size; ++k )
+			limbs[k] = ( limbs[k] >> 1 ) | ( limbs[k + 1] << 31 );
+
+		if( size != 0 && ( limbs[size - 1] >>= 1 ) == 0 )
+			--size;
+	}
+
+	void Add( const BigInteger &other )
+	{
+		size_t count = size > other.size ? size : other.size;
+		uint64_t carry = 0;
+		for( size_t k = 0; k < count; ++k )
+		{
+			uint64_t sum = carry;
+			if( k < size )
+				sum += limbs[k];
+
+			if( k < other.size )
+				sum += other.limbs[k];
+
+			limbs[k] = static_cast<uint32_t>( sum );
+			carry = sum >> 32;
+		}
+
+		size = count;
+		if( carry != 0 )
+			limbs[size++] = static_cast<uint32_t>( carry );
+	}
+
+	// Requires other <= *this
+	void Subtract( const BigInteger &other )
+	{
+		int64_t borrow = 0;
+		for( size_t k = 0; k < size; ++k )
+		{
+			int64_t difference = static_cast<int64_t>( limbs[k] ) - borrow;
+			if( k < other.size )
+				difference -= other.limbs[k];
+
+			borrow = difference < 0 ? 1 : 0;
+			limbs[k] = static_cast<uint32_t>( difference + ( borrow << 32 ) );
+		}
+
+		while( size != 0 && limbs[size - 1] == 0 )
+			--size;
+	}
+
+	static int Compare( const BigInteger &left, const BigInteger &right )
+	{
+		if( left.size != right.size )
+			return left.size < right.size ? -1 : 1;
+
+		for( size_t k = left.size; k > 0; --k )
+			if( left.limbs[k - 1] != right.limbs[k - 1] )
+				return left.limbs[k - 1] < right.limbs[k - 1] ? -1 : 1;
+
+		return 0;
+	}
+
+	// Compares left + right against other
+	static int CompareSum( const BigInteger &left, const BigInteger &right, const BigInteger &other )
+	{
+		BigInteger sum = left;
+		sum.Add( right );
+		return Compare( sum, other );
+	}
+
+	// Requires *this < 10 * divisor, leaves the remainder behind
+	uint32_t DivideSmall( const BigInteger &divisor )
+	{
+		uint32_t quotient = 0;
+		while( Compare( *this, divisor ) >= 0 )
+		{
+			Subtract( divisor );
+			++quotient;
+		}
+
+		return quotient;
+	}
+
+private:
+	static const size_t max_limbs = 160;
+
+	size_t size;
+	uint32_t limbs[max_limbs];
+};
+
+template<typename Float>
+struct FloatTraits;
+
+template<>
+struct FloatTraits<float>
+{
+	typedef uint32_t Bits;
+	static const int mantissa_bits = 23;
+	static const int exponent_mask = 0xFF;
+	static const int exponent_bias = 150;
+	static const int max_digits = 9;
+	static const int max_exact_pow10 = 10;
+	static const int max_decimal_exponent = 40;
+	static const int min_decimal_exponent = -48;
+};
+
+template<>
+struct FloatTraits<double>
+{
+	typedef uint64_t Bits;
+	static const int mantissa_bits = 52;
+	static const int exponent_mask = 0x7FF;
+	static const int exponent_bias = 1075;
+	static const int max_digits = 17;
+	static const int max_exact_pow10 = 22;
+	static const int max_decimal_exponent = 310;
+	static const int min_decimal_exponent = -326;
+};
+
+// A 64 bit significand with a binary exponent, the base for the fast paths
+// of both conversions, which fall back to exact arithmetic when they can't
+// prove their result is right
+struct DiyFp
+{
+	uint64_t significand;
+	int exponent;
+};
+
+static DiyFp Normalize( DiyFp value )
+{
+	while( ( value.significand & 0xFFC0000000000000ULL ) == 0 )
+	{
+		value.significand <<= 10;
+		value.exponent -= 10;
+	}
+
+	while( ( value.significand & 0x8000000000000000ULL ) == 0 )
+	{
+		value.significand <<= 1;
+		value.exponent -= 1;
+	}
+
+	return value;
+}
+
+// Upper 64 bits of the 128 bits product, rounded
+static DiyFp Multiply( DiyFp left, DiyFp right )
+{
+	const uint64_t low_mask = 0xFFFFFFFFULL;
+	uint64_t a = left.significand >> 32;
+	uint64_t b = left.significand & low_mask;
+	uint64_t c = right.significand >> 32;
+	uint64_t d = right.significand & low_mask;
+	uint64_t ac = a * c;
+	uint64_t bc = b * c;
+	uint64_t ad = a * d;
+	uint64_t bd = b * d;
+	uint64_t middle = ( bd >> 32 ) + ( ad & low_mask ) + ( bc & low_mask ) + ( 1ULL << 31 );
+	DiyFp product = { ac + ( ad >> 32 ) + ( bc >> 32 ) + ( middle >> 32 ), left.exponent + right.exponent + 64 };
+	return product;
+}
+
+struct CachedPower
+{
+	uint64_t significand;
+	int16_t binary_exponent;
+	int16_t decimal_exponent;
+};
+
+// Normalized and rounded powers of ten, from 10^-348 to 10^340 in steps of 8
+static const int cached_powers_offset = 348;
+static const int cached_powers_step = 8;
+static const CachedPower cached_powers[] = {
+	{ 0xfa8fd5a0081c0288ULL, -1220, -348 }, { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+	{ 0x8b16fb203055ac76ULL, -1166, -332 }, { 0xcf42894a5dce35eaULL, -1140, -324 },
+	{ 0x9a6bb0aa55653b2dULL, -1113, -316 }, { 0xe61acf033d1a45dfULL, -1087, -308 },
+	{ 0xab70fe17c79ac6caULL, -1060, -300 }, { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+	{ 0xbe5691ef416bd60cULL, -1007, -284 }, { 0x8dd01fad907ffc3cULL, -980, -276 },
+	{ 0xd3515c2831559a83ULL, -954, -268 }, { 0x9d71ac8fada6c9b5ULL, -927, -260 },
+	{ 0xea9c227723ee8bcbULL, -901, -252 }, { 0xaecc49914078536dULL, -874, -244 },
+	{ 0x823c12795db6ce57ULL, -847, -236 }, { 0xc21094364dfb5637ULL, -821, -228 },
+	{ 0x9096ea6f3848984fULL, -794, -220 }, { 0xd77485cb25823ac7ULL, -768, -212 },
+	{ 0xa086cfcd97bf97f4ULL, -741, -204 }, { 0xef340a98172aace5ULL, -715, -196 },
+	{ 0xb23867fb2a35b28eULL, -688, -188 }, { 0x84c8d4dfd2c63f3bULL, -661, -180 },
+	{ 0xc5dd44271ad3cdbaULL, -635, -172 }, { 0x936b9fcebb25c996ULL, -608, -164 },
+	{ 0xdbac6c247d62a584ULL, -582, -156 }, { 0xa3ab66580d5fdaf6ULL, -555, -148 },
+	{ 0xf3e2f893dec3f126ULL, -529, -140 }, { 0xb5b5ada8aaff80b8ULL, -502, -132 },
+	{ 0x87625f056c7c4a8bULL, -475, -124 }, { 0xc9bcff6034c13053ULL, -449, -116 },
+	{ 0x964e858c91ba2655ULL, -422, -108 }, { 0xdff9772470297ebdULL, -396, -100 },
+	{ 0xa6dfbd9fb8e5b88fULL, -369, -92 }, { 0xf8a95fcf88747d94ULL, -343, -84 },
+	{ 0xb94470938fa89bcfULL, -316, -76 }, { 0x8a08f0f8bf0f156bULL, -289, -68 },
+	{ 0xcdb02555653131b6ULL, -263, -60 }, { 0x993fe2c6d07b7facULL, -236, -52 },
+	{ 0xe45c10c42a2b3b06ULL, -210, -44 }, { 0xaa242499697392d3ULL, -183, -36 },
+	{ 0xfd87b5f28300ca0eULL, -157, -28 }, { 0xbce5086492111aebULL, -130, -20 },
+	{ 0x8cbccc096f5088ccULL, -103, -12 }, { 0xd1b71758e219652cULL, -77, -4 },
+	{ 0x9c40000000000000ULL, -50, 4 }, { 0xe8d4a51000000000ULL, -24, 12 },
+	{ 0xad78ebc5ac620000ULL, 3, 20 }, { 0x813f3978f8940984ULL, 30, 28 },
+	{ 0xc097ce7bc90715b3ULL, 56, 36 }, { 0x8f7e32ce7bea5c70ULL, 83, 44 },
+	{ 0xd5d238a4abe98068ULL, 109, 52 }, { 0x9f4f2726179a2245ULL, 136, 60 },
+	{ 0xed63a231d4c4fb27ULL, 162, 68 }, { 0xb0de65388cc8ada8ULL, 189, 76 },
+	{ 0x83c7088e1aab65dbULL, 216, 84 }, { 0xc45d1df942711d9aULL, 242, 92 },
+	{ 0x924d692ca61be758ULL, 269, 100 }, { 0xda01ee641a708deaULL, 295, 108 },
+	{ 0xa26da3999aef774aULL, 322, 116 }, { 0xf209787bb47d6b85ULL, 348, 124 },
+	{ 0xb454e4a179dd1877ULL, 375, 132 }, { 0x865b86925b9bc5c2ULL, 402, 140 },
+	{ 0xc83553c5c8965d3dULL, 428, 148 }, { 0x952ab45cfa97a0b3ULL, 455, 156 },
+	{ 0xde469fbd99a05fe3ULL, 481, 164 }, { 0xa59bc234db398c25ULL, 508, 172 },
+	{ 0xf6c69a72a3989f5cULL, 534, 180 }, { 0xb7dcbf5354e9beceULL, 561, 188 },
+	{ 0x88fcf317f22241e2ULL, 588, 196 }, { 0xcc20ce9bd35c78a5ULL, 614, 204 },
+	{ 0x98165af37b2153dfULL, 641, 212 }, { 0xe2a0b5dc971f303aULL, 667, 220 },
+	{ 0xa8d9d1535ce3b396ULL, 694, 228 }, { 0xfb9b7cd9a4a7443cULL, 720, 236 },
+	{ 0xbb764c4ca7a44410ULL, 747, 244 }, { 0x8bab8eefb6409c1aULL, 774, 252 },
+	{ 0xd01fef10a657842cULL, 800, 260 }, { 0x9b10a4e5e9913129ULL, 827, 268 },
+	{ 0xe7109bfba19c0c9dULL, 853, 276 }, { 0xac2820d9623bf429ULL, 880, 284 },
+	{ 0x80444b5e7aa7cf85ULL, 907, 292 }, { 0xbf21e44003acdd2dULL, 933, 300 },
+	{ 0x8e679c2f5e44ff8fULL, 960, 308 }, { 0xd433179d9c8cb841ULL, 986, 316 },
+	{ 0x9e19db92b4e31ba9ULL, 1013, 324 }, { 0xeb96bf6ebadf77d9ULL, 1039, 332 },
+	{ 0xaf87023b9bf0ee6bULL, 1066, 340 }
+};
+
+static DiyFp GetCachedPower( size_t index, int &decimal_exponent )
+{
+	decimal_exponent = cached_powers[index].decimal_exponent;
+	DiyFp power = { cached_powers[index].significand, cached_powers[index].binary_exponent };
+	return power;
+}
+
+template<typename Float>
+static uint64_t Decompose( Float value, int &binary_exponent, bool &unequal_gaps )
+{
+	typedef FloatTraits<Float> Traits;
+	typename Traits::Bits bits;
+	std::memcpy( &bits, &value, sizeof( bits ) );
+
+	const uint64_t hidden_bit = static_cast<uint64_t>( 1 ) << Traits::mantissa_bits;
+	uint64_t mantissa = static_cast<uint64_t>( bits ) & ( hidden_bit - 1 );
+	int biased = static_cast<int>( static_cast<uint64_t>( bits ) >> Traits::mantissa_bits ) & Traits::exponent_mask;
+	binary_exponent = 1 - Traits::exponent_bias;
+	if( biased != 0 )
+	{
+		mantissa |= hidden_bit;
+		binary_exponent = biased - Traits::exponent_bias;
+	}
+
+	// The gap to the previous value is half as big on powers of two
+	unequal_gaps = mantissa == hidden_bit && biased > 1;
+	return mantissa;
+}
+
+// Removes one from the last digit while that gets closer to the real value,
+// then checks the result is safely inside the boundaries
+static bool RoundWeed( char *digits, size_t count, uint64_t distance_high_w, uint64_t unsafe_interval, uint64_t rest, uint64_t ten_kappa, uint64_t unit )
+{
+	uint64_t small_distance = distance_high_w - unit;
+	uint64_t big_distance = distance_high_w + unit;
+	while( rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+		( rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance ) )
+	{
+		--digits[count - 1];
+		rest += ten_kappa;
+	}
+
+	if( rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+		( rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance ) )
+		return false;
+
+	return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+// Loitsch's Grisu3, generates the shortest digits of the scaled value or
+// fails in the rare cases it can't be sure they are
+static bool GenerateDigits( DiyFp low, DiyFp w, DiyFp high, char *digits, size_t &count, int &kappa )
+{
+	uint64_t unit = 1;
+	DiyFp too_low = { low.significand - unit, low.exponent };
+	DiyFp too_high = { high.significand + unit, high.exponent };
+	uint64_t unsafe_interval = too_high.significand - too_low.significand;
+	int shift = -w.exponent;
+	uint64_t one = static_cast<uint64_t>( 1 ) << shift;
+	uint32_t integrals = static_cast<uint32_t>( too_high.significand >> shift );
+	uint64_t fractionals = too_high.significand & ( one - 1 );
+
+	uint32_t divisor = 1;
+	kappa = 1;
+	while( integrals / divisor >= 10 )
+	{
+		divisor *= 10;
+		++kappa;
+	}
+
+	count = 0;
+	while( kappa > 0 )
+	{
+		digits[count++] = static_cast<char>( '0' + integrals / divisor );
+		integrals %= divisor;
+		--kappa;
+		uint64_t rest = ( static_cast<uint64_t>( integrals ) << shift ) + fractionals;
+		if( rest < unsafe_interval )
+			return RoundWeed( digits, count, too_high.significand - w.significand, unsafe_interval, rest, static_cast<uint64_t>( divisor ) << shift, unit );
+
+		divisor /= 10;
+	}
+
+	for( ; ; )
+	{
+		fractionals *= 10;
+		unit *= 10;
+		unsafe_interval *= 10;
+		digits[count++] = static_cast<char>( '0' + ( fractionals >> shift ) );
+		fractionals &= one - 1;
+		--kappa;
+		if( fractionals < unsafe_interval )
+			return RoundWeed( digits, count, ( too_high.significand - w.significand ) * unit, unsafe_interval, fractionals, one, unit );
+	}
+}
+
+template<typename Float>
+static bool FastShortestDigits( Float value, char *digits, size_t &count, int &exponent )
+{
+	int binary_exponent = 0;
+	bool unequal_gaps = false;
+	uint64_t mantissa = Decompose( value, binary_exponent, unequal_gaps );
+
+	DiyFp exact = { mantissa, binary_exponent };
+	DiyFp w = Normalize( exact );
+	DiyFp upper = { ( mantissa << 1 ) + 1, binary_exponent - 1 };
+	DiyFp high = Normalize( upper );
+	DiyFp low = { ( mantissa << 1 ) - 1, binary_exponent - 1 };
+	if( unequal_gaps )
+	{
+		low.significand = ( mantissa << 2 ) - 1;
+		low.exponent = binary_exponent - 2;
+	}
+
+	low.significand <<= low.exponent - high.exponent;
+	low.exponent = high.exponent;
+
+	// Scale so the binary exponent ends up between -60 and -32
+	int min_exponent = -60 - ( w.exponent + 64 );
+	int estimate = static_cast<int>( std::ceil( ( min_exponent + 63 ) * 0.30102999566398114 ) );
+	size_t index = static_cast<size_t>( ( cached_powers_offset + estimate - 1 ) / cached_powers_step + 1 );
+	int decimal_exponent = 0;
+	DiyFp power = GetCachedPower( index, decimal_exponent );
+
+	int kappa = 0;
+	if( !GenerateDigits( Multiply( low, power ), Multiply( w, power ), Multiply( high, power ), digits, count, kappa ) )
+		return false;
+
+	exponent = kappa - decimal_exponent + static_cast<int>( count );
+	return true;
+}
+
+// Burger and Dybvig's free format algorithm, generates the shortest digits
+// that read back as the same value and returns their count, the value is
+// 0.digits times 10^exponent
+template<typename Float>
+static size_t ExactShortestDigits( Float value, char *digits, int &exponent )
+{
+	int binary_exponent = 0;
+	bool unequal_gaps = false;
+	uint64_t mantissa = Decompose( value, binary_exponent, unequal_gaps );
+	bool even = ( mantissa & 1 ) == 0;
+
+	BigInteger remainder, scale, high, low;
+	remainder.Set( mantissa );
+	scale.Set( 1 );
+	high.Set( 1 );
+	low.Set( 1 );
+	if( binary_exponent >= 0 )
+	{
+		remainder.ShiftLeft( static_cast<size_t>( binary_exponent ) + ( unequal_gaps ? 2 : 1 ) );
+		scale.ShiftLeft( unequal_gaps ? 2 : 1 );
+		high.ShiftLeft( static_cast<size_t>( binary_exponent ) + ( unequal_gaps ? 1 : 0 ) );
+		low.ShiftLeft( static_cast<size_t>( binary_exponent ) );
+	}
+	else
+	{
+		remainder.ShiftLeft( unequal_gaps ? 2 : 1 );
+		scale.ShiftLeft( static_cast<size_t>( -binary_exponent ) + ( unequal_gaps ? 2 : 1 ) );
+		high.ShiftLeft( unequal_gaps ? 1 : 0 );
+	}
+
+	int estimate = static_cast<int>( std::ceil( std::log10( static_cast<double>( value ) ) - 1e-10 ) );
+	if( estimate >= 0 )
+	{
+		scale.MultiplyPow10( static_cast<size_t>( estimate ) );
+	}
+	else
+	{
+		remainder.MultiplyPow10( static_cast<size_t>( -estimate ) );
+		high.MultiplyPow10( static_cast<size_t>( -estimate ) );
+		low.MultiplyPow10( static_cast<size_t>( -estimate ) );
+	}
+
+	int too_low = BigInteger::CompareSum( remainder, high, scale );
+	if( even ? too_low >= 0 : too_low > 0 )
+	{
+		exponent = estimate + 1;
+	}
+	else
+	{
+		exponent = estimate;
+		remainder.MultiplyAdd( 10, 0 );
+		high.MultiplyAdd( 10, 0 );
+		low.MultiplyAdd( 10, 0 );
+	}
+
+	size_t count = 0;
+	for( ; ; )
+	{
+		uint32_t digit = remainder.DivideSmall( scale );
+		int low_compare = BigInteger::Compare( remainder, low );
+		int high_compare = BigInteger::CompareSum( remainder, high, scale );
+		bool round_down = even ? low_compare <= 0 : low_compare < 0;
+		bool round_up = even ? high_compare >= 0 : high_compare > 0;
+		if( round_down && round_up )
+		{
+			BigInteger twice = remainder;
+			twice.ShiftLeft( 1 );
+			int half = BigInteger::Compare( twice, scale );
+			if( half > 0 || ( half == 0 && ( digit & 1 ) != 0 ) )
+				++digit;
+		}
+		else if( round_up )
+		{
+			++digit;
+		}
+
+		digits[count++] = static_cast<char>( '0' + digit );
+		if( round_down || round_up )
+			break;
+
+		remainder.MultiplyAdd( 10, 0 );
+		high.MultiplyAdd( 10, 0 );
+		low.MultiplyAdd( 10, 0 );
+	}
+
+	return count;
+}
+
+template<typename Float>
+static size_t ShortestDigits( Float value, char *digits, int &exponent )
+{
+	size_t count = 0;
+	if( FastShortestDigits( value, digits, count, exponent ) )
+		return count;
+
+	return ExactShortestDigits( value, digits, exponent );
+}
+
+template<typename Float>
+static size_t FormatFloat( Float value, char *buffer )
+{
+	char *out = buffer;
+	if( std::isnan( value ) )
+	{
+		std::memcpy( out, "nan", 3 );
+		return 3;
+	}
+
+	if( std::signbit( value ) )
+	{
+		*out++ = '-';
+		value = -value;
+	}
+
+	if( std::isinf( value ) )
+	{
+		std::memcpy( out, "inf", 3 );
+		return static_cast<size_t>( out - buffer ) + 3;
+	}
+
+	if( value == 0 )
+	{
+		*out++ = '0';
+		return static_cast<size_t>( out - buffer );
+	}
+
+	// Integers below 2^(mantissa bits + 1) need all of their digits anyway
+	const Float integer_limit = static_cast<Float>( static_cast<uint64_t>( 1 ) << ( FloatTraits<Float>::mantissa_bits + 1 ) );
+	if( value < integer_limit && value == std::floor( value ) )
+		return static_cast<size_t>( out - buffer ) + FormatUnsigned( static_cast<uint64_t>( value ), out );
+
+	char digits[FloatTraits<Float>::max_digits + 8];
+	int exponent = 0;
+	int count = static_cast<int>( ShortestDigits( value, digits, exponent ) );
+	int scientific = exponent - 1;
+	if( scientific >= -5 && scientific < FloatTraits<Float>::max_digits )
+	{
+		if( exponent <= 0 )
+		{
+			*out++ = '0';
+			*out++ = '.';
+			for( int k = exponent; k < 0; ++k )
+				*out++ = '0';
+
+			std::memcpy( out, digits, static_cast<size_t>( count ) );
+			out += count;
+		}
+		else if( exponent >= count )
+		{
+			std::memcpy( out, digits, static_cast<size_t>( count ) );
+			out += count;
+			for( int k = count; k < exponent; ++k )
+				*out++ = '0';
+		}
+		else
+		{
+			std::memcpy( out, digits, static_cast<size_t>( exponent ) );
+			out += exponent;
+			*out++ = '.';
+			std::memcpy( out, digits + exponent, static_cast<size_t>( count - exponent ) );
+			out += count - exponent;
+		}
+
+		return static_cast<size_t>( out - buffer );
+	}
+
+	*out++ = digits[0];
+	if( count > 1 )
+	{
+		*out++ = '.';
+		std::memcpy( out, digits + 1, static_cast<size_t>( count - 1 ) );
+		out += count - 1;
+	}
+
+	*out++ = 'e';
+	if( scientific < 0 )
+	{
+		*out++ = '-';
+		scientific = -scientific;
+	}
+
+	out += FormatUnsigned( static_cast<uint64_t>( scientific ), out );
+	return static_cast<size_t>( out - buffer );
+}
+
+static const char *MatchWord( const char *it, const char *end, const char *word )
+{
+	for( ; *word != '\0'; ++it, ++word )
+		if( it == end || ( *it | 0x20 ) != *word )
+			return nullptr;
+
+	return it;
+}
+
+template<typename Float>
+static Float Pow10( int exponent )
+{
+	static const Float powers[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	return powers[exponent];
+}
+
+// Multiplies the first 19 digits by a cached power of ten while keeping
+// track of the error, in eighths of the last bit, and fails when the error
+// could change how the result rounds
+template<typename Float>
+static bool FastConvert( const char *digits, size_t count, int exponent, Float &value )
+{
+	typedef FloatTraits<Float> Traits;
+	const int error_scale_bits = 3;
+	const uint64_t error_scale = 1 << error_scale_bits;
+
+	uint64_t significand = 0;
+	size_t used = count < 19 ? count : 19;
+	for( size_t k = 0; k < used; ++k )
+		significand = significand * 10 + static_cast<uint64_t>( digits[k] - '0' );
+
+	uint64_t error = 0;
+	if( used < count )
+	{
+		if( digits[used] >= '5' )
+			++significand;
+
+		exponent += static_cast<int>( count - used );
+		error = error_scale / 2;
+	}
+
+	DiyFp exact = { significand, 0 };
+	DiyFp input = Normalize( exact );
+	error <<= -input.exponent;
+
+	size_t index = static_cast<size_t>( ( exponent + cached_powers_offset ) / cached_powers_step );
+	int decimal_exponent = 0;
+	DiyFp power = GetCachedPower( index, decimal_exponent );
+	if( exponent != decimal_exponent )
+	{
+		static const uint64_t adjustments[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+		DiyFp adjustment = { adjustments[exponent - decimal_exponent], 0 };
+		input = Multiply( input, Normalize( adjustment ) );
+		error += error_scale / 2;
+	}
+
+	input = Multiply( input, power );
+	error += error_scale / 2 + ( error != 0 ? 1 : 0 ) + error_scale / 2;
+
+	int unnormalized_exponent = input.exponent;
+	input = Normalize( input );
+	error <<= unnormalized_exponent - input.exponent;
+
+	// Subnormals have less bits of precision
+	const int min_exponent = 1 - Traits::exponent_bias;
+	int magnitude = input.exponent + 64;
+	int precision = Traits::mantissa_bits + 1;
+	if( magnitude <= min_exponent )
+		precision = 0;
+	else if( magnitude < min_exponent + precision )
+		precision = magnitude - min_exponent;
+
+	int dropped = 64 - precision;
+	if( dropped + error_scale_bits >= 64 )
+	{
+		int shift = dropped + error_scale_bits - 63;
+		input.significand >>= shift;
+		input.exponent += shift;
+		error = ( error >> shift ) + 1 + error_scale;
+		dropped -= shift;
+	}
+
+	uint64_t rest = ( input.significand & ( ( static_cast<uint64_t>( 1 ) << dropped ) - 1 ) ) * error_scale;
+	uint64_t half = ( static_cast<uint64_t>( 1 ) << ( dropped - 1 ) ) * error_scale;
+	if( half - error < rest && rest < half + error )
+		return false;
+
+	uint64_t mantissa = input.significand >> dropped;
+	if( rest >= half + error )
+		++mantissa;
+
+	value = std::ldexp( static_cast<Float>( mantissa ), input.exponent + dropped );
+	return true;
+}
+
+// Exact division of the decimal value by a power of two big enough to get
+// 64 significant bits, then a single rounding to the precision of Float
+template<typename Float>
+static Float SlowConvert( const char *digits, size_t count, int exponent )
+{
+	typedef FloatTraits<Float> Traits;
+
+	BigInteger numerator, denominator;
+	for( size_t k = 0; k < count; k += 9 )
+	{
+		uint32_t chunk = 0;
+		uint32_t factor = 1;
+		for( size_t i = k; i < count && i < k + 9; ++i )
+		{
+			chunk = chunk * 10 + static_cast<uint32_t>( digits[i] - '0' );
+			factor *= 10;
+		}
+
+		numerator.MultiplyAdd( factor, chunk );
+	}
+
+	denominator.Set( 1 );
+	if( exponent >= 0 )
+		numerator.MultiplyPow10( static_cast<size_t>( exponent ) );
+	else
+		denominator.MultiplyPow10( static_cast<size_t>( -exponent ) );
+
+	int shift = 63 - ( static_cast<int>( numerator.BitLength( ) ) - static_cast<int>( denominator.BitLength( ) ) );
+	if( shift > 0 )
+		numerator.ShiftLeft( static_cast<size_t>( shift ) );
+	else
+		denominator.ShiftLeft( static_cast<size_t>( -shift ) );
+
+	denominator.ShiftLeft( 63 );
+	if( BigInteger::Compare( numerator, denominator ) < 0 )
+	{
+		numerator.ShiftLeft( 1 );
+		++shift;
+	}
+
+	uint64_t quotient = 0;
+	for( int bit = 63; bit >= 0; --bit )
+	{
+		if( BigInteger::Compare( numerator, denominator ) >= 0 )
+		{
+			numerator.Subtract( denominator );
+			quotient |= static_cast<uint64_t>( 1 ) << bit;
+		}
+
+		denominator.ShiftRightOne( );
+	}
+
+	bool sticky = !numerator.IsZero( );
+
+	// The value is quotient * 2^-shift, keep mantissa_bits + 1 of it or less
+	// for subnormals
+	int drop = 63 - Traits::mantissa_bits;
+	int min_drop = 1 - Traits::exponent_bias + shift;
+	if( min_drop > drop )
+		drop = min_drop;
+
+	uint64_t mantissa = 0;
+	bool round_up = false;
+	if( drop < 64 )
+	{
+		uint64_t half = static_cast<uint64_t>( 1 ) << ( drop - 1 );
+		uint64_t rest = quotient & ( ( half << 1 ) - 1 );
+		mantissa = quotient >> drop;
+		round_up = rest > half || ( rest == half && ( sticky || ( mantissa & 1 ) != 0 ) );
+	}
+	else if( drop == 64 )
+	{
+		const uint64_t half = static_cast<uint64_t>( 1 ) << 63;
+		round_up = quotient > half || ( quotient == half && sticky );
+	}
+
+	if( round_up )
+		++mantissa;
+
+	return std::ldexp( static_cast<Float>( mantissa ), drop - shift );
+}
+
+template<typename Float>
+static const char *ParseFloat( const char *begin, const char *end, Float &value )
+{
+	typedef FloatTraits<Float> Traits;
+	static const size_t max_digits = 800;
+
+	const char *it = begin;
+	bool negative = false;
+	if( it != end && ( *it == '-' || *it == '+' ) )
+	{
+		negative = *it == '-';
+		++it;
+	}
+
+	if( it != end && ( *it | 0x20 ) == 'i' )
+	{
+		const char *word_end = MatchWord( it, end, "inf" );
+		if( word_end == nullptr )
+			return nullptr;
+
+		const char *long_end = MatchWord( word_end, end, "inity" );
+		value = negative ? -std::numeric_limits<Float>::infinity( ) : std::numeric_limits<Float>::infinity( );
+		return long_end != nullptr ? long_end : word_end;
+	}
+
+	if( it != end && ( *it | 0x20 ) == 'n' )
+	{
+		const char *word_end = MatchWord( it, end, "nan" );
+		if( word_end == nullptr )
+			return nullptr;
+
+		value = negative ? -std::numeric_limits<Float>::quiet_NaN( ) : std::numeric_limits<Float>::quiet_NaN( );
+		return word_end;
+	}
+
+	// Significant digits are kept without leading zeros, the value being
+	// digits * 10^exponent, anything past max_digits only matters for ties
+	char digits[max_digits + 1];
+	size_t count = 0;
+	int64_t exponent = 0;
+	bool any_digits = false;
+	bool truncated = false;
+	for( ; it != end && IsDigit( *it ); ++it )
+	{
+		any_digits = true;
+		if( count == 0 && *it == '0' )
+			continue;
+
+		if( count < max_digits )
+			digits[count++] = *it;
+		else
+		{
+			truncated = truncated || *it != '0';
+			++exponent;
+		}
+	}
+
+	if( it != end && *it == '.' )
+	{
+		for( ++it; it != end && IsDigit( *it ); ++it )
+		{
+			any_digits = true;
+			if( count == 0 && *it == '0' )
+			{
+				--exponent;
+				continue;
+			}
+
+			if( count < max_digits )
+			{
+				digits[count++] = *it;
+				--exponent;
+			}
+			else
+			{
+				truncated = truncated || *it != '0';
+			}
+		}
+	}
+
+	if( !any_digits )
+		return nullptr;
+
+	if( it != end && ( *it == 'e' || *it == 'E' ) )
+	{
+		const char *exponent_it = it + 1;
+		bool exponent_negative = false;
+		if( exponent_it != end && ( *exponent_it == '-' || *exponent_it == '+' ) )
+		{
+			exponent_negative = *exponent_it == '-';
+			++exponent_it;
+		}
+
+		if( exponent_it != end && IsDigit( *exponent_it ) )
+		{
+			int64_t written = 0;
+			for( ; exponent_it != end && IsDigit( *exponent_it ); ++exponent_it )
+				if( written < 100000 )
+					written = written * 10 + ( *exponent_it - '0' );
+
+			exponent += exponent_negative ? -written : written;
+			it = exponent_it;
+		}
+	}
+
+	Float result = 0;
+	if( count == 0 || static_cast<int64_t>( count ) + exponent < Traits::min_decimal_exponent )
+	{
+		result = 0;
+	}
+	else if( static_cast<int64_t>( count ) + exponent > Traits::max_decimal_exponent )
+	{
+		result = std::numeric_limits<Float>::infinity( );
+	}
+	else
+	{
+		if( truncated )
+		{
+			digits[count++] = '1';
+			--exponent;
+		}
+
+		uint64_t mantissa = 0;
+		if( count <= 19 )
+			for( size_t k = 0; k < count; ++k )
+				mantissa = mantissa * 10 + static_cast<uint64_t>( digits[k] - '0' );
+
+		if( count <= 19 && mantissa <= ( static_cast<uint64_t>( 1 ) << ( Traits::mantissa_bits + 1 ) ) &&
+			exponent >= -Traits::max_exact_pow10 && exponent <= Traits::max_exact_pow10 )
+		{
+			// Both operands are exact, so the single operation rounds correctly
+			result = static_cast<Float>( mantissa );
+			if( exponent < 0 )
+				result /= Pow10<Float>( static_cast<int>( -exponent ) );
+			else
+				result *= Pow10<Float>( static_cast<int>( exponent ) );
+		}
+		else if( !FastConvert( digits, count, static_cast<int>( exponent ), result ) )
+		{
+			result = SlowConvert<Float>( digits, count, static_cast<int>( exponent ) );
+		}
+	}
+
+	value = negative ? -result : result;
+	return it;
+}
+
+size_t Format( int32_t value, char *buffer )
+{
+	return FormatSigned( value, buffer );
+}
+
+size_t Format( uint32_t value, char *buffer )
+{
+	return FormatUnsigned( value, buffer );
+}
+
+size_t Format( int64_t value, char *buffer )
+{
+	return FormatSigned( value, buffer );
+}
+
+size_t Format( uint64_t value, char *buffer )
+{
+	return FormatUnsigned( value, buffer );
+}
+
+size_t Format( float value, char *buffer )
+{
+	return FormatFloat( value, buffer );
+}
+
+size_t Format( double value, char *buffer )
+{
+	return FormatFloat( value, buffer );
+}
+
+const char *Parse( const char *begin, const char *end, int32_t &value )
+{
+	int64_t result = 0;
+	const char *it = ParseSigned( begin, end, std::numeric_limits<int32_t>::max( ), result );
+	if( it != nullptr )
+		value = static_cast<int32_t>( result );
+
+	return it;
+}
+
+const char *Parse( const char *begin, const char *end, uint32_t &value )
+{
+	uint64_t result = 0;
+	const char *it = ParseUnsigned( begin, end, std::numeric_limits<uint32_t>::max( ), result );
+	if( it != nullptr )
+		value = static_cast<uint32_t>( result );
+
+	return it;
+}
+
+const char *Parse( const char *begin, const char *end, int64_t &value )
+{
+	return ParseSigned( begin, end, std::numeric_limits<int64_t>::max( ), value );
+}
+
+const char *Parse( const char *begin, const char *end, uint64_t &value )
+{
+	return ParseUnsigned( begin, end, std::numeric_limits<uint64_t>::max( ), value );
+}
+
+const char *Parse( const char *begin, const char *end, float &value )
+{
+	return ParseFloat( begin, end, value );
+}
+
+const char *Parse( const char *begin, const char *end, double &value )
+{
+	return ParseFloat( begin, end, value );
+}
+
+} // namespace Number
+
+} // namespace MultiLibrary
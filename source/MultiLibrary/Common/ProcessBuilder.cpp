@@ -0,0 +1,222 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ProcessBuilder.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <MultiLibrary/Common/String.hpp>
+#include <algorithm>
+
+#if defined _WIN32
+
+	#include <MultiLibrary/Common/Unicode.hpp>
+	#include <iterator>
+	#include <windows.h>
+
+#elif defined __APPLE__
+
+	#include <crt_externs.h>
+
+#else
+
+	#include <unistd.h>
+
+#endif
+
+namespace MultiLibrary
+{
+
+static void ReadEnvironment( std::vector<std::string> &entries )
+{
+
+#if defined _WIN32
+
+	wchar_t *block = GetEnvironmentStringsW( );
+	if( block == nullptr )
+		return;
+
+	for( const wchar_t *entry = block; *entry != L'\0'; entry += wcslen( entry ) + 1 )
+	{
+		entries.emplace_back( );
+		UTF8::FromUTF16( entry, entry + wcslen( entry ), std::back_inserter( entries.back( ) ) );
+	}
+
+	FreeEnvironmentStringsW( block );
+
+#else
+
+#if defined __APPLE__
+
+	char **entry = *_NSGetEnviron( );
+
+#else
+
+	char **entry = environ;
+
+#endif
+
+	for( ; entry != nullptr && *entry != nullptr; ++entry )
+		entries.emplace_back( *entry );
+
+#endif
+
+}
+
+static std::string GetName( const std::string &entry )
+{
+	// Windows has entries like "=C:=C:\" that start with the separator
+	return entry.substr( 0, entry.find( '=', 1 ) );
+}
+
+// Variable names are case insensitive on Windows
+static bool IsSameName( const std::string &left, const std::string &right )
+{
+
+#if defined _WIN32
+
+	return String::EqualsCaseInsensitive( left, right );
+
+#else
+
+	return left == right;
+
+#endif
+
+}
+
+ProcessBuilder::ProcessBuilder( const std::string &executable ) :
+	path( executable ),
+	inherit_environment( true ),
+	input( Redirection::Pipe ),
+	output( Redirection::Pipe ),
+	error( Redirection::Pipe )
+{ }
+
+ProcessBuilder &ProcessBuilder::AddArgument( const std::string &argument )
+{
+	arguments.push_back( argument );
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::AddArguments( const std::vector<std::string> &args )
+{
+	arguments.insert( arguments.end( ), args.begin( ), args.end( ) );
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::SetEnvironment( const std::string &name, const std::string &value )
+{
+	removed_environment.erase( name );
+	environment[name] = value;
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::UnsetEnvironment( const std::string &name )
+{
+	environment.erase( name );
+	removed_environment.insert( name );
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::ClearEnvironment( )
+{
+	inherit_environment = false;
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::SetWorkingDirectory( const std::string &directory )
+{
+	working_directory = directory;
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::MapDescriptor( Descriptor parent, Descriptor child )
+{
+	descriptors.push_back( std::make_pair( parent, child ) );
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::ShareChannel( const SharedChannel &channel, const std::string &variable )
+{
+	Descriptor descriptor = channel.GetDescriptor( );
+	MapDescriptor( descriptor, descriptor );
+	channels.push_back( &channel );
+	return SetEnvironment( variable, std::to_string( descriptor ) );
+}
+
+ProcessBuilder &ProcessBuilder::SetInput( Redirection redirection )
+{
+	input = redirection;
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::SetOutput( Redirection redirection )
+{
+	output = redirection;
+	return *this;
+}
+
+ProcessBuilder &ProcessBuilder::SetError( Redirection redirection )
+{
+	error = redirection;
+	return *this;
+}
+
+std::vector<std::string> ProcessBuilder::BuildEnvironment( ) const
+{
+	std::vector<std::string> entries;
+	if( inherit_environment )
+		ReadEnvironment( entries );
+
+	entries.erase( std::remove_if( entries.begin( ), entries.end( ), [this]( const std::string &entry )
+	{
+		std::string name = GetName( entry );
+		for( const std::pair<const std::string, std::string> &variable : environment )
+			if( IsSameName( name, variable.first ) )
+				return true;
+
+		for( const std::string &removed : removed_environment )
+			if( IsSameName( name, removed ) )
+				return true;
+
+		return false;
+	} ), entries.end( ) );
+
+	for( const std::pair<const std::string, std::string> &variable : environment )
+		entries.push_back( variable.first + '=' + variable.second );
+
+	return entries;
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,464 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ProcessPool.hpp>
+#include <MultiLibrary/Common/Endian.hpp>
+#include <MultiLibrary/Common/Process.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <limits>
+
+namespace MultiLibrary
+{
+
+typedef std::chrono::steady_clock Clock;
+
+// Size of the length that starts every frame
+static const size_t header_size = sizeof( uint32_t );
+
+// Workers that exit this soon after starting are restarted with a growing
+// delay, so a worker that can't start doesn't keep the pool spinning
+static const std::chrono::milliseconds minimum_uptime( 100 );
+static const std::chrono::milliseconds first_backoff( 10 );
+static const std::chrono::milliseconds max_backoff( 1000 );
+
+static Clock::duration GrowBackoff( Clock::duration backoff )
+{
+	return std::min<Clock::duration>( std::max<Clock::duration>( backoff * 2, first_backoff ), max_backoff );
+}
+
+static bool ReadExactly( InputStream &input, void *data, size_t size )
+{
+	uint8_t *bytes = static_cast<uint8_t *>( data );
+	size_t total = 0;
+	while( total < size )
+	{
+		size_t read = input.Read( bytes + total, size - total );
+		if( read == 0 )
+			return false;
+
+		total += read;
+	}
+
+	return true;
+}
+
+static bool WriteExactly( OutputStream &output, const void *data, size_t size )
+{
+	const uint8_t *bytes = static_cast<const uint8_t *>( data );
+	size_t total = 0;
+	while( total < size )
+	{
+		size_t written = output.Write( bytes + total, size - total );
+		if( written == 0 )
+			return false;
+
+		total += written;
+	}
+
+	return true;
+}
+
+class ProcessPool::Workers
+{
+public:
+	struct Job
+	{
+		std::vector<uint8_t> request;
+		Callback callback;
+		Clock::time_point submitted;
+	};
+
+	struct Worker
+	{
+		std::unique_ptr<Process> process;
+		std::vector<uint8_t> received;
+		bool busy;
+		Job job;
+		Clock::time_point started;
+		Clock::time_point restart_time;
+		Clock::duration backoff;
+	};
+
+	Workers( const ProcessBuilder &worker_builder, size_t count ) :
+		builder( worker_builder ),
+		next_worker( 0 ),
+		finished( 0 ),
+		completed( 0 ),
+		failed( 0 ),
+		restarts( 0 ),
+		total_latency( 0.0 ),
+		max_latency( 0.0 ),
+		exited_usage( )
+	{
+		this->builder.SetInput( ProcessBuilder::Redirection::Pipe ).SetOutput( ProcessBuilder::Redirection::Pipe );
+		for( size_t k = 0; k < count; ++k )
+		{
+			workers.emplace_back( new Worker );
+			workers.back( )->backoff = Clock::duration::zero( );
+			Start( *workers.back( ) );
+		}
+	}
+
+	~Workers( )
+	{
+		// Workers exit once their input is closed, the processes wait for
+		// that when destroyed. Their output is closed too, so a worker
+		// blocked writing a response fails instead of waiting for a reader.
+		for( std::unique_ptr<Worker> &worker : workers )
+		{
+			if( !worker->process )
+				continue;
+
+			group.Remove( *worker->process );
+			worker->process->CloseInput( );
+			worker->process->Output( ).CloseRead( );
+			worker->process->Error( ).CloseRead( );
+		}
+	}
+
+	void Submit( const void *data, size_t size, const Callback &callback )
+	{
+		// Lengths are 32 bits, bigger requests fail on the next Wait
+		std::deque<Job> &jobs = size > std::numeric_limits<uint32_t>::max( ) ? rejected : queue;
+		jobs.emplace_back( );
+		Job &job = jobs.back( );
+		job.callback = callback;
+		job.submitted = Clock::now( );
+		if( &jobs == &rejected )
+			return;
+
+		const uint8_t *bytes = static_cast<const uint8_t *>( data );
+		job.request.assign( bytes, bytes + size );
+		Dispatch( );
+	}
+
+	size_t Wait( uint32_t timeout )
+	{
+		finished = 0;
+		while( !rejected.empty( ) )
+		{
+			Job job = std::move( rejected.front( ) );
+			rejected.pop_front( );
+			++failed;
+			++finished;
+			if( job.callback )
+				job.callback( false, std::vector<uint8_t>( ) );
+		}
+
+		// Don't sleep past the next delayed restart
+		StartDelayed( );
+		Clock::time_point now = Clock::now( );
+		for( const std::unique_ptr<Worker> &worker : workers )
+		{
+			if( worker->process )
+				continue;
+
+			int64_t delay = std::chrono::duration_cast<std::chrono::milliseconds>( worker->restart_time - now ).count( ) + 1;
+			timeout = static_cast<uint32_t>( std::min<int64_t>( timeout, std::max<int64_t>( delay, 0 ) ) );
+		}
+
+		group.Wait( timeout );
+		StartDelayed( );
+		return finished;
+	}
+
+	size_t Pending( ) const
+	{
+		return queue.size( ) + rejected.size( ) + CountBusy( );
+	}
+
+	Statistics GetStatistics( ) const
+	{
+		Statistics statistics;
+		statistics.workers = 0;
+		for( const std::unique_ptr<Worker> &worker : workers )
+			if( worker->process )
+				++statistics.workers;
+
+		statistics.busy = CountBusy( );
+		statistics.queued = queue.size( );
+		statistics.completed = completed;
+		statistics.failed = failed;
+		statistics.restarts = restarts;
+		statistics.average_latency = completed != 0 ? total_latency / completed : 0.0;
+		statistics.max_latency = max_latency;
+
+		// Counters of running workers are sampled on the spot
+		statistics.usage = exited_usage;
+		for( const std::unique_ptr<Worker> &worker : workers )
+			if( worker->process && worker->process->SampleUsage( ) )
+				AddUsage( statistics.usage, worker->process->GetUsage( ) );
+
+		return statistics;
+	}
+
+private:
+	size_t CountBusy( ) const
+	{
+		size_t busy = 0;
+		for( const std::unique_ptr<Worker> &worker : workers )
+			if( worker->busy )
+				++busy;
+
+		return busy;
+	}
+
+	void Start( Worker &worker )
+	{
+		worker.process.reset( new Process( builder ) );
+		worker.received.clear( );
+		worker.busy = false;
+		worker.started = Clock::now( );
+
+		Worker *target = &worker;
+		group.Add( *worker.process, [this, target]( const ProcessGroup::Notification &notification )
+		{
+			if( notification.event == ProcessGroup::Event::Output )
+				Receive( *target, notification.data );
+			else if( notification.event == ProcessGroup::Event::Exit )
+				Restart( *target );
+		} );
+	}
+
+	static void AddUsage( Process::Usage &total, const Process::Usage &usage )
+	{
+		total.user_time += usage.user_time;
+		total.system_time += usage.system_time;
+		total.max_resident_size = std::max( total.max_resident_size, usage.max_resident_size );
+		total.minor_faults += usage.minor_faults;
+		total.major_faults += usage.major_faults;
+		total.voluntary_switches += usage.voluntary_switches;
+		total.involuntary_switches += usage.involuntary_switches;
+		total.read_bytes += usage.read_bytes;
+		total.written_bytes += usage.written_bytes;
+	}
+
+	void Restart( Worker &worker )
+	{
+		// The group already closed the process and removed it, which
+		// collected its final usage
+		AddUsage( exited_usage, worker.process->GetUsage( ) );
+		worker.process.reset( );
+		if( worker.busy )
+			Finish( worker, false, std::vector<uint8_t>( ) );
+
+		// The first quick exit restarts right away, the next ones wait longer
+		// and longer until a worker stays up
+		Clock::time_point now = Clock::now( );
+		Clock::duration delay = Clock::duration::zero( );
+		if( now - worker.started < minimum_uptime )
+		{
+			delay = worker.backoff;
+			worker.backoff = GrowBackoff( worker.backoff );
+		}
+		else
+		{
+			worker.backoff = Clock::duration::zero( );
+		}
+
+		++restarts;
+		worker.restart_time = now + delay;
+		if( delay == Clock::duration::zero( ) )
+			Relaunch( worker );
+
+		Dispatch( );
+	}
+
+	// Failing to launch a worker is handled like a worker exiting right away
+	void Relaunch( Worker &worker )
+	{
+		try
+		{
+			Start( worker );
+		}
+		catch( const std::exception & )
+		{
+			worker.backoff = GrowBackoff( worker.backoff );
+			worker.restart_time = Clock::now( ) + worker.backoff;
+		}
+	}
+
+	void StartDelayed( )
+	{
+		Clock::time_point now = Clock::now( );
+		bool started = false;
+		for( std::unique_ptr<Worker> &worker : workers )
+		{
+			if( worker->process || worker->restart_time > now )
+				continue;
+
+			Relaunch( *worker );
+			started = started || worker->process != nullptr;
+		}
+
+		if( started )
+			Dispatch( );
+	}
+
+	void Receive( Worker &worker, const std::vector<uint8_t> &data )
+	{
+		// Workers shouldn't write anything while idle
+		if( !worker.busy )
+			return;
+
+		worker.received.insert( worker.received.end( ), data.begin( ), data.end( ) );
+		if( worker.received.size( ) < header_size )
+			return;
+
+		uint32_t length = 0;
+		std::memcpy( &length, worker.received.data( ), header_size );
+		length = ConvertEndianness( length, Endianness::Little );
+		if( worker.received.size( ) - header_size < length )
+			return;
+
+		std::vector<uint8_t> response( worker.received.begin( ) + header_size, worker.received.begin( ) + header_size + length );
+		worker.received.clear( );
+		Finish( worker, true, response );
+		Dispatch( );
+	}
+
+	void Finish( Worker &worker, bool success, const std::vector<uint8_t> &response )
+	{
+		Job job = std::move( worker.job );
+		worker.busy = false;
+		++finished;
+		if( success )
+		{
+			double latency = std::chrono::duration<double, std::milli>( Clock::now( ) - job.submitted ).count( );
+			total_latency += latency;
+			max_latency = std::max( max_latency, latency );
+			++completed;
+		}
+		else
+		{
+			++failed;
+		}
+
+		if( job.callback )
+			job.callback( success, response );
+	}
+
+	// Hands queued jobs to idle workers, going around the workers so the
+	// load is spread between them
+	void Dispatch( )
+	{
+		for( size_t k = 0; k < workers.size( ) && !queue.empty( ); ++k )
+		{
+			Worker &worker = *workers[next_worker];
+			next_worker = ( next_worker + 1 ) % workers.size( );
+			if( worker.busy || !worker.process )
+				continue;
+
+			worker.job = std::move( queue.front( ) );
+			queue.pop_front( );
+			worker.busy = true;
+
+			// Submit keeps bigger requests out of the queue
+			uint32_t length = ConvertEndianness( static_cast<uint32_t>( worker.job.request.size( ) ), Endianness::Little );
+
+			// A worker that can't take the request, usually because it already
+			// exited, gets its input closed. Its exit then fails the job and
+			// restarts it.
+			Pipe &input = worker.process->Input( );
+			if( !WriteExactly( input, &length, header_size ) || !WriteExactly( input, worker.job.request.data( ), worker.job.request.size( ) ) )
+				worker.process->CloseInput( );
+		}
+	}
+
+	ProcessBuilder builder;
+	ProcessGroup group;
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::deque<Job> queue;
+	std::deque<Job> rejected;
+	size_t next_worker;
+	size_t finished;
+	uint64_t completed;
+	uint64_t failed;
+	uint64_t restarts;
+	double total_latency;
+	double max_latency;
+	Process::Usage exited_usage;
+};
+
+ProcessPool::ProcessPool( const ProcessBuilder &builder, size_t count ) :
+	workers( new Workers( builder, count ) )
+{ }
+
+ProcessPool::~ProcessPool( )
+{ }
+
+void ProcessPool::Submit( const void *data, size_t size, const Callback &callback )
+{
+	workers->Submit( data, size, callback );
+}
+
+size_t ProcessPool::Wait( uint32_t timeout )
+{
+	return workers->Wait( timeout );
+}
+
+size_t ProcessPool::Pending( ) const
+{
+	return workers->Pending( );
+}
+
+ProcessPool::Statistics ProcessPool::GetStatistics( ) const
+{
+	return workers->GetStatistics( );
+}
+
+bool ProcessPool::ReadFrame( InputStream &input, std::vector<uint8_t> &frame )
+{
+	uint32_t length = 0;
+	if( !ReadExactly( input, &length, header_size ) )
+		return false;
+
+	frame.resize( ConvertEndianness( length, Endianness::Little ) );
+	return ReadExactly( input, frame.data( ), frame.size( ) );
+}
+
+bool ProcessPool::WriteFrame( OutputStream &output, const void *data, size_t size )
+{
+	if( size > std::numeric_limits<uint32_t>::max( ) )
+		return false;
+
+	uint32_t length = ConvertEndianness( static_cast<uint32_t>( size ), Endianness::Little );
+	return WriteExactly( output, &length, header_size ) && WriteExactly( output, data, size );
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,323 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/RingBuffer.hpp>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if defined __linux__
+
+	#include <climits>
+	#include <time.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#include <linux/futex.h>
+
+#else
+
+	#include <condition_variable>
+	#include <mutex>
+
+#endif
+
+namespace MultiLibrary
+{
+
+class RingBufferInternal
+{
+public:
+	RingBufferInternal( ) :
+		data_signal( 0 ),
+		space_signal( 0 ),
+		reader_waiting( false ),
+		writer_waiting( false )
+	{ }
+
+	std::atomic<uint32_t> data_signal;
+	std::atomic<uint32_t> space_signal;
+	std::atomic<bool> reader_waiting;
+	std::atomic<bool> writer_waiting;
+
+#if !defined __linux__
+
+	std::mutex lock;
+	std::condition_variable condition;
+
+#endif
+
+};
+
+// The fence pairs with the one in Wait, so either the waiter sees the new
+// indices or the notifier sees the waiter and wakes it up
+static void Notify( RingBufferInternal &internal, std::atomic<uint32_t> &signal, std::atomic<bool> &waiting )
+{
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	if( !waiting.load( std::memory_order_relaxed ) )
+		return;
+
+#if defined __linux__
+
+	(void)internal;
+	signal.fetch_add( 1, std::memory_order_release );
+	syscall( SYS_futex, reinterpret_cast<uint32_t *>( &signal ), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0 );
+
+#else
+
+	{
+		std::lock_guard<std::mutex> guard( internal.lock );
+		signal.fetch_add( 1, std::memory_order_release );
+	}
+
+	internal.condition.notify_all( );
+
+#endif
+
+}
+
+static const size_t spin_count = 64;
+
+// Sleeps until the predicate holds or the timeout expires
+template<typename Predicate>
+static void Wait( RingBufferInternal &internal, std::atomic<uint32_t> &signal, std::atomic<bool> &waiting, int32_t timeout, Predicate predicate )
+{
+	if( predicate( ) || timeout == 0 )
+		return;
+
+	// The other side is usually about to make progress, so spin a little
+	// before paying for a system call
+	for( size_t spin = 0; spin < spin_count; ++spin )
+	{
+		std::this_thread::yield( );
+		if( predicate( ) )
+			return;
+	}
+
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now( ) + std::chrono::milliseconds( timeout );
+	while( true )
+	{
+		uint32_t sequence = signal.load( std::memory_order_acquire );
+		waiting.store( true, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if( predicate( ) )
+			break;
+
+		std::chrono::nanoseconds remaining = deadline - std::chrono::steady_clock::now( );
+		if( timeout > 0 && remaining.count( ) <= 0 )
+			break;
+
+#if defined __linux__
+
+		(void)internal;
+		timespec time;
+		time.tv_sec = static_cast<time_t>( remaining.count( ) / 1000000000 );
+		time.tv_nsec = static_cast<long>( remaining.count( ) % 1000000000 );
+		syscall( SYS_futex, reinterpret_cast<uint32_t *>( &signal ), FUTEX_WAIT_PRIVATE, sequence, timeout > 0 ? &time : nullptr, nullptr, 0 );
+
+#else
+
+		std::unique_lock<std::mutex> guard( internal.lock );
+		if( signal.load( std::memory_order_relaxed ) == sequence )
+		{
+			if( timeout > 0 )
+				internal.condition.wait_until( guard, deadline );
+			else
+				internal.condition.wait( guard );
+		}
+
+#endif
+
+	}
+
+	waiting.store( false, std::memory_order_relaxed );
+}
+
+static size_t RoundCapacity( size_t capacity )
+{
+	size_t rounded = 1;
+	while( rounded < capacity )
+		rounded <<= 1;
+
+	return rounded;
+}
+
+RingBuffer::RingBuffer( size_t capacity ) :
+	write_index( 0 ),
+	cached_read_index( 0 ),
+	read_index( 0 ),
+	cached_write_index( 0 ),
+	closed( false ),
+	buffer_mask( RoundCapacity( capacity ) - 1 ),
+	buffer( new uint8_t[buffer_mask + 1] ),
+	ring_internal( new RingBufferInternal )
+{ }
+
+RingBuffer::~RingBuffer( )
+{ }
+
+bool RingBuffer::IsValid( ) const
+{
+	return !EndOfFile( );
+}
+
+bool RingBuffer::Seek( size_t )
+{
+	return false;
+}
+
+bool RingBuffer::Seek( int64_t, SeekMode )
+{
+	return false;
+}
+
+size_t RingBuffer::Tell( ) const
+{
+	return read_index.load( std::memory_order_acquire );
+}
+
+size_t RingBuffer::Size( ) const
+{
+	size_t read = read_index.load( std::memory_order_acquire );
+	return write_index.load( std::memory_order_acquire ) - read;
+}
+
+bool RingBuffer::EndOfFile( ) const
+{
+	return closed.load( std::memory_order_acquire ) && Size( ) == 0;
+}
+
+size_t RingBuffer::Read( void *data, size_t size )
+{
+	size_t read = read_index.load( std::memory_order_relaxed );
+	size_t available = cached_write_index - read;
+	if( available < size )
+	{
+		cached_write_index = write_index.load( std::memory_order_acquire );
+		available = cached_write_index - read;
+	}
+
+	if( size > available )
+		size = available;
+
+	if( size == 0 )
+		return 0;
+
+	size_t offset = read & buffer_mask;
+	size_t first = buffer_mask + 1 - offset;
+	if( first > size )
+		first = size;
+
+	std::memcpy( data, buffer.get( ) + offset, first );
+	std::memcpy( static_cast<uint8_t *>( data ) + first, buffer.get( ), size - first );
+	read_index.store( read + size, std::memory_order_release );
+	Notify( *ring_internal, ring_internal->space_signal, ring_internal->writer_waiting );
+	return size;
+}
+
+size_t RingBuffer::Write( const void *data, size_t size )
+{
+	if( closed.load( std::memory_order_relaxed ) )
+		return 0;
+
+	size_t write = write_index.load( std::memory_order_relaxed );
+	size_t space = buffer_mask + 1 - ( write - cached_read_index );
+	if( space < size )
+	{
+		cached_read_index = read_index.load( std::memory_order_acquire );
+		space = buffer_mask + 1 - ( write - cached_read_index );
+	}
+
+	if( size > space )
+		size = space;
+
+	if( size == 0 )
+		return 0;
+
+	size_t offset = write & buffer_mask;
+	size_t first = buffer_mask + 1 - offset;
+	if( first > size )
+		first = size;
+
+	std::memcpy( buffer.get( ) + offset, data, first );
+	std::memcpy( buffer.get( ), static_cast<const uint8_t *>( data ) + first, size - first );
+	write_index.store( write + size, std::memory_order_release );
+	Notify( *ring_internal, ring_internal->data_signal, ring_internal->reader_waiting );
+	return size;
+}
+
+bool RingBuffer::WaitForData( size_t size, int32_t timeout )
+{
+	if( size > buffer_mask + 1 )
+		size = buffer_mask + 1;
+
+	Wait( *ring_internal, ring_internal->data_signal, ring_internal->reader_waiting, timeout, [this, size]( )
+	{
+		return Size( ) >= size || closed.load( std::memory_order_acquire );
+	} );
+
+	return Size( ) >= size;
+}
+
+bool RingBuffer::WaitForSpace( size_t size, int32_t timeout )
+{
+	if( size > buffer_mask + 1 )
+		size = buffer_mask + 1;
+
+	Wait( *ring_internal, ring_internal->space_signal, ring_internal->writer_waiting, timeout, [this, size]( )
+	{
+		return buffer_mask + 1 - Size( ) >= size || closed.load( std::memory_order_acquire );
+	} );
+
+	return !closed.load( std::memory_order_acquire ) && buffer_mask + 1 - Size( ) >= size;
+}
+
+void RingBuffer::Close( )
+{
+	closed.store( true, std::memory_order_release );
+	Notify( *ring_internal, ring_internal->data_signal, ring_internal->reader_waiting );
+	Notify( *ring_internal, ring_internal->space_signal, ring_internal->writer_waiting );
+}
+
+bool RingBuffer::IsClosed( ) const
+{
+	return closed.load( std::memory_order_acquire );
+}
+
+size_t RingBuffer::Capacity( ) const
+{
+	return buffer_mask + 1;
+}
+
+} // namespace MultiLibrary
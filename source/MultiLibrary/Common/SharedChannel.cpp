@@ -0,0 +1,405 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <MultiLibrary/Common/Number.hpp>
+#include <MultiLibrary/Common/SharedMemory.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
+
+namespace MultiLibrary
+{
+
+// Each queue keeps the indices of each side in their own cache line, the
+// signals and waiting flags are the doorbell of the side that sleeps on them
+struct SharedChannelRing
+{
+	alignas( 64 ) std::atomic<uint64_t> write_index;
+	std::atomic<uint32_t> data_signal;
+	std::atomic<uint32_t> reader_waiting;
+
+	alignas( 64 ) std::atomic<uint64_t> read_index;
+	std::atomic<uint32_t> space_signal;
+	std::atomic<uint32_t> writer_waiting;
+
+	alignas( 64 ) std::atomic<uint32_t> closed;
+};
+
+// Start of the shared memory, followed by the buffer of each queue. Each side
+// stores its process identifier, so the other one can tell when it's gone.
+struct SharedChannelHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t capacity;
+	std::atomic<uint32_t> processes[2];
+	SharedChannelRing rings[2];
+};
+
+static const uint32_t channel_magic = 0x4C4D4843; // "CHML"
+static const uint32_t channel_version = 1;
+
+// The fence pairs with the one in Wait, so either the waiter sees the new
+// indices or the notifier sees the waiter and wakes it up
+static void Notify( std::atomic<uint32_t> &signal, std::atomic<uint32_t> &waiting )
+{
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	if( waiting.load( std::memory_order_relaxed ) == 0 )
+		return;
+
+	signal.fetch_add( 1, std::memory_order_release );
+	Internal::SharedMemory::Wake( signal );
+}
+
+static const size_t spin_count = 64;
+
+// How often sleeping sides check that the other one is still running
+static const std::chrono::milliseconds liveness_interval( 100 );
+
+// Sleeps until the predicate holds, the timeout expires or the other side is
+// gone, which only a crash or a kill can do without closing the channel
+template<typename Predicate, typename Liveness>
+static void Wait( std::atomic<uint32_t> &signal, std::atomic<uint32_t> &waiting, int32_t timeout, Predicate predicate, Liveness alive )
+{
+	if( predicate( ) || timeout == 0 )
+		return;
+
+	// The other side is usually about to make progress, so spin a little
+	// before paying for a system call
+	for( size_t spin = 0; spin < spin_count; ++spin )
+	{
+		std::this_thread::yield( );
+		if( predicate( ) )
+			return;
+	}
+
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now( ) + std::chrono::milliseconds( timeout );
+	std::chrono::steady_clock::time_point next_check = std::chrono::steady_clock::now( ) + liveness_interval;
+	while( true )
+	{
+		uint32_t sequence = signal.load( std::memory_order_acquire );
+		waiting.store( 1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if( predicate( ) )
+			break;
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now( );
+		if( timeout > 0 && now >= deadline )
+			break;
+
+		if( now >= next_check )
+		{
+			if( !alive( ) )
+				break;
+
+			next_check = now + liveness_interval;
+		}
+
+		std::chrono::nanoseconds remaining = next_check - now;
+		if( timeout > 0 && deadline < next_check )
+			remaining = deadline - now;
+
+		Internal::SharedMemory::Wait( signal, sequence, static_cast<int64_t>( remaining.count( ) ) );
+	}
+
+	waiting.store( 0, std::memory_order_relaxed );
+}
+
+static size_t RoundCapacity( size_t capacity )
+{
+	size_t rounded = 64;
+	while( rounded < capacity )
+		rounded <<= 1;
+
+	return rounded;
+}
+
+SharedChannel::SharedChannel( size_t capacity ) :
+	peer( nullptr ),
+	input( nullptr ),
+	output( nullptr ),
+	input_buffer( nullptr ),
+	output_buffer( nullptr ),
+	buffer_mask( RoundCapacity( capacity ) - 1 ),
+	cached_write_index( 0 ),
+	cached_read_index( 0 ),
+	peer_gone( false )
+{
+	memory = Internal::SharedMemory::Create( sizeof( SharedChannelHeader ) + 2 * ( buffer_mask + 1 ) );
+
+	// The memory starts zeroed, which is the initial state of the queues
+	SharedChannelHeader *header = new( memory->Address( ) ) SharedChannelHeader;
+	header->magic = channel_magic;
+	header->version = channel_version;
+	header->capacity = buffer_mask + 1;
+	header->processes[0].store( Internal::SharedMemory::GetProcessIdentifier( ), std::memory_order_release );
+	Attach( true );
+}
+
+SharedChannel::SharedChannel( const std::string &variable ) :
+	peer( nullptr ),
+	input( nullptr ),
+	output( nullptr ),
+	input_buffer( nullptr ),
+	output_buffer( nullptr ),
+	buffer_mask( 0 ),
+	cached_write_index( 0 ),
+	cached_read_index( 0 ),
+	peer_gone( false )
+{
+	const char *value = std::getenv( variable.c_str( ) );
+	uint64_t descriptor = 0;
+	if( value == nullptr || Number::Parse( value, value + std::strlen( value ), descriptor ) == nullptr )
+		throw std::system_error( EINVAL, std::system_category( ), "no shared channel was passed to this process" );
+
+	memory = Internal::SharedMemory::Open( static_cast<Descriptor>( descriptor ) );
+
+	const SharedChannelHeader *header = static_cast<const SharedChannelHeader *>( memory->Address( ) );
+	if( memory->Size( ) < sizeof( SharedChannelHeader ) || header->magic != channel_magic || header->version != channel_version ||
+		header->capacity == 0 || ( header->capacity & ( header->capacity - 1 ) ) != 0 ||
+		( memory->Size( ) - sizeof( SharedChannelHeader ) ) / 2 < header->capacity )
+		throw std::system_error( EINVAL, std::system_category( ), "invalid shared channel" );
+
+	buffer_mask = static_cast<size_t>( header->capacity - 1 );
+	SetPeer( Internal::SharedMemory::GetProcessIdentifier( ) );
+	Attach( false );
+}
+
+SharedChannel::~SharedChannel( )
+{
+	Close( );
+}
+
+void SharedChannel::Attach( bool parent )
+{
+	// The parent writes to the first queue and the child to the second one
+	SharedChannelHeader *header = static_cast<SharedChannelHeader *>( memory->Address( ) );
+	uint8_t *buffers = static_cast<uint8_t *>( memory->Address( ) ) + sizeof( SharedChannelHeader );
+	size_t outgoing = parent ? 0 : 1;
+	peer = &header->processes[1 - outgoing];
+	output = &header->rings[outgoing];
+	input = &header->rings[1 - outgoing];
+	output_buffer = buffers + outgoing * ( buffer_mask + 1 );
+	input_buffer = buffers + ( 1 - outgoing ) * ( buffer_mask + 1 );
+	cached_write_index = input->write_index.load( std::memory_order_acquire );
+	cached_read_index = output->read_index.load( std::memory_order_acquire );
+}
+
+bool SharedChannel::IsValid( ) const
+{
+	return !EndOfFile( );
+}
+
+bool SharedChannel::Seek( size_t )
+{
+	return false;
+}
+
+bool SharedChannel::Seek( int64_t, SeekMode )
+{
+	return false;
+}
+
+size_t SharedChannel::Tell( ) const
+{
+	return static_cast<size_t>( input->read_index.load( std::memory_order_acquire ) );
+}
+
+size_t SharedChannel::Size( ) const
+{
+	uint64_t read = input->read_index.load( std::memory_order_acquire );
+	return static_cast<size_t>( input->write_index.load( std::memory_order_acquire ) - read );
+}
+
+bool SharedChannel::EndOfFile( ) const
+{
+	return input->closed.load( std::memory_order_acquire ) != 0 && Size( ) == 0;
+}
+
+size_t SharedChannel::Read( void *data, size_t size )
+{
+	uint8_t *bytes = static_cast<uint8_t *>( data );
+	size_t total = 0;
+
+	// Two passes at most, when the data wraps around the end of the buffer
+	const void *readable = nullptr;
+	for( size_t available = 0; total < size && ( available = Peek( readable ) ) != 0; )
+	{
+		if( available > size - total )
+			available = size - total;
+
+		std::memcpy( bytes + total, readable, available );
+		Consume( available );
+		total += available;
+	}
+
+	return total;
+}
+
+size_t SharedChannel::Peek( const void *&data )
+{
+	uint64_t read = input->read_index.load( std::memory_order_relaxed );
+	if( cached_write_index == read )
+		cached_write_index = input->write_index.load( std::memory_order_acquire );
+
+	size_t available = static_cast<size_t>( cached_write_index - read );
+	size_t offset = static_cast<size_t>( read ) & buffer_mask;
+	size_t first = buffer_mask + 1 - offset;
+	data = input_buffer + offset;
+	return available < first ? available : first;
+}
+
+void SharedChannel::Consume( size_t size )
+{
+	if( size == 0 )
+		return;
+
+	input->read_index.store( input->read_index.load( std::memory_order_relaxed ) + size, std::memory_order_release );
+	Notify( input->space_signal, input->writer_waiting );
+}
+
+size_t SharedChannel::Write( const void *data, size_t size )
+{
+	if( output->closed.load( std::memory_order_relaxed ) != 0 )
+		return 0;
+
+	uint64_t write = output->write_index.load( std::memory_order_relaxed );
+	size_t space = buffer_mask + 1 - static_cast<size_t>( write - cached_read_index );
+	if( space < size )
+	{
+		cached_read_index = output->read_index.load( std::memory_order_acquire );
+		space = buffer_mask + 1 - static_cast<size_t>( write - cached_read_index );
+	}
+
+	if( size > space )
+		size = space;
+
+	if( size == 0 )
+		return 0;
+
+	size_t offset = static_cast<size_t>( write ) & buffer_mask;
+	size_t first = buffer_mask + 1 - offset;
+	if( first > size )
+		first = size;
+
+	std::memcpy( output_buffer + offset, data, first );
+	std::memcpy( output_buffer, static_cast<const uint8_t *>( data ) + first, size - first );
+	output->write_index.store( write + size, std::memory_order_release );
+	Notify( output->data_signal, output->reader_waiting );
+	return size;
+}
+
+bool SharedChannel::WaitForData( size_t size, int32_t timeout )
+{
+	if( size > buffer_mask + 1 )
+		size = buffer_mask + 1;
+
+	Wait( input->data_signal, input->reader_waiting, timeout, [this, size]( )
+	{
+		return Size( ) >= size || input->closed.load( std::memory_order_acquire ) != 0;
+	}, [this]( )
+	{
+		return IsPeerRunning( );
+	} );
+
+	return Size( ) >= size;
+}
+
+bool SharedChannel::WaitForSpace( size_t size, int32_t timeout )
+{
+	if( size > buffer_mask + 1 )
+		size = buffer_mask + 1;
+
+	auto space = [this]( )
+	{
+		uint64_t read = output->read_index.load( std::memory_order_acquire );
+		return buffer_mask + 1 - static_cast<size_t>( output->write_index.load( std::memory_order_relaxed ) - read );
+	};
+
+	Wait( output->space_signal, output->writer_waiting, timeout, [this, size, &space]( )
+	{
+		return space( ) >= size || output->closed.load( std::memory_order_acquire ) != 0;
+	}, [this]( )
+	{
+		return IsPeerRunning( );
+	} );
+
+	return !peer_gone && output->closed.load( std::memory_order_acquire ) == 0 && space( ) >= size;
+}
+
+void SharedChannel::Close( )
+{
+	output->closed.store( 1, std::memory_order_release );
+	Notify( output->data_signal, output->reader_waiting );
+	Notify( output->space_signal, output->writer_waiting );
+}
+
+size_t SharedChannel::Capacity( ) const
+{
+	return buffer_mask + 1;
+}
+
+SharedChannel::Descriptor SharedChannel::GetDescriptor( ) const
+{
+	return memory->GetDescriptor( );
+}
+
+void SharedChannel::SetPeer( uint32_t identifier ) const
+{
+	SharedChannelHeader *header = static_cast<SharedChannelHeader *>( memory->Address( ) );
+	header->processes[1].store( identifier, std::memory_order_release );
+}
+
+// A side that's gone never closes its queue, so that's done here and the
+// data it sent can still be read
+bool SharedChannel::IsPeerRunning( )
+{
+	uint32_t identifier = peer->load( std::memory_order_acquire );
+	if( peer_gone || ( identifier != 0 && !Internal::SharedMemory::IsRunning( identifier ) ) )
+	{
+		peer_gone = true;
+		input->closed.store( 1, std::memory_order_release );
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,128 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#pragma once
+
+#include <MultiLibrary/Common/NonCopyable.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace MultiLibrary
+{
+
+namespace Internal
+{
+
+/*!
+ \brief Memory mapped in several processes, passed around as a descriptor.
+ */
+class SharedMemory : public NonCopyable
+{
+public:
+	typedef SharedChannel::Descriptor Descriptor;
+
+	/*!
+	 \brief Create zeroed memory that isn't inherited unless mapped with
+	 ProcessBuilder.
+
+	 \param size Size in bytes.
+
+	 \return Mapped memory.
+	 */
+	static std::unique_ptr<SharedMemory> Create( size_t size );
+
+	/*!
+	 \brief Map memory created by another process.
+
+	 \param descriptor Descriptor inherited from that process.
+
+	 \return Mapped memory.
+	 */
+	static std::unique_ptr<SharedMemory> Open( Descriptor descriptor );
+
+	~SharedMemory( );
+
+	void *Address( ) const;
+	size_t Size( ) const;
+	Descriptor GetDescriptor( ) const;
+
+	/*!
+	 \brief Sleep while the signal holds a value, unless woken up by Wake
+	 from any process.
+
+	 \param signal Signal in the shared memory.
+	 \param value Value to sleep on.
+	 \param timeout Maximum time to wait, in nanoseconds, negative to wait
+	 forever.
+	 */
+	static void Wait( std::atomic<uint32_t> &signal, uint32_t value, int64_t timeout );
+
+	/*!
+	 \brief Wake up every process waiting on a signal.
+
+	 \param signal Signal in the shared memory.
+	 */
+	static void Wake( std::atomic<uint32_t> &signal );
+
+	/*!
+	 \brief Get the identifier of this process.
+
+	 \return Process identifier.
+	 */
+	static uint32_t GetProcessIdentifier( );
+
+	/*!
+	 \brief Tell if a process is still running, exited processes that weren't
+	 waited for yet aren't.
+
+	 \param identifier Process identifier.
+
+	 \return false if the process exited, true otherwise.
+	 */
+	static bool IsRunning( uint32_t identifier );
+
+private:
+	SharedMemory( Descriptor memory_descriptor, void *memory_address, size_t memory_size );
+
+	Descriptor descriptor;
+	void *address;
+	size_t size;
+};
+
+} // namespace Internal
+
+} // namespace MultiLibrary
@@ -34,18 +34,136 @@
  *************************************************************************/
 
 #include <MultiLibrary/Common/String.hpp>
+#include <MultiLibrary/Common/Checksum.hpp>
 #include <cstring>
 #include <iterator>
 
+#if defined __SSE2__ || defined _M_X64 || ( defined _M_IX86_FP && _M_IX86_FP >= 2 )
+
+	#define MULTILIBRARY_STRING_SSE2
+	#include <emmintrin.h>
+
+#endif
+
 namespace MultiLibrary
 {
 
+static void ConvertToWideString( const std::string &utf8_string, std::wstring &str )
+{
+	str.clear( );
+	UTF8::ToWideString( utf8_string.begin( ), utf8_string.end( ), std::back_inserter( str ) );
+}
+
+static void ConvertToUTF16( const std::string &utf8_string, std::u16string &str )
+{
+	str.resize( utf8_string.size( ) );
+	if( str.empty( ) )
+		return;
+
+	const char *data = utf8_string.data( );
+	char16_t *end = UTF8::ConvertToUTF16( data, data + utf8_string.size( ), &str[0] );
+	str.resize( static_cast<size_t>( end - str.data( ) ) );
+}
+
+static void ConvertToUTF32( const std::string &utf8_string, std::u32string &str )
+{
+	str.resize( utf8_string.size( ) );
+	if( str.empty( ) )
+		return;
+
+	const char *data = utf8_string.data( );
+	char32_t *end = UTF8::ConvertToUTF32( data, data + utf8_string.size( ), &str[0] );
+	str.resize( static_cast<size_t>( end - str.data( ) ) );
+}
+
+enum class CachedEncoding
+{
+	None,
+	WideString,
+	UTF16,
+	UTF32
+};
+
+class StringCache
+{
+public:
+	StringCache( ) :
+		length( unknown_length ),
+		encoding( CachedEncoding::None )
+	{ }
+
+	void Invalidate( )
+	{
+		length = unknown_length;
+		encoding = CachedEncoding::None;
+	}
+
+	size_t GetLength( const std::string &utf8_string )
+	{
+		if( length == unknown_length )
+			length = UTF8::Length( utf8_string.begin( ), utf8_string.end( ) );
+
+		return length;
+	}
+
+	const std::wstring &GetWideString( const std::string &utf8_string )
+	{
+		if( Select( CachedEncoding::WideString ) )
+			ConvertToWideString( utf8_string, wide_string );
+
+		return wide_string;
+	}
+
+	const std::u16string &GetUTF16( const std::string &utf8_string )
+	{
+		if( Select( CachedEncoding::UTF16 ) )
+			ConvertToUTF16( utf8_string, utf16_string );
+
+		return utf16_string;
+	}
+
+	const std::u32string &GetUTF32( const std::string &utf8_string )
+	{
+		if( Select( CachedEncoding::UTF32 ) )
+			ConvertToUTF32( utf8_string, utf32_string );
+
+		return utf32_string;
+	}
+
+	static const size_t unknown_length = static_cast<size_t>( -1 );
+
+	size_t length;
+
+private:
+	// Only the last conversion is kept around, returns true if it needs converting
+	bool Select( CachedEncoding new_encoding )
+	{
+		if( encoding == new_encoding )
+			return false;
+
+		if( encoding == CachedEncoding::WideString )
+			std::wstring( ).swap( wide_string );
+		else if( encoding == CachedEncoding::UTF16 )
+			std::u16string( ).swap( utf16_string );
+		else if( encoding == CachedEncoding::UTF32 )
+			std::u32string( ).swap( utf32_string );
+
+		encoding = new_encoding;
+		return true;
+	}
+
+	CachedEncoding encoding;
+	std::wstring wide_string;
+	std::u16string utf16_string;
+	std::u32string utf32_string;
+};
+
 String::String( )
 { }
 
 String::String( const char *str )
 {
-	UTF8::FromANSI( str, str + std::strlen( str ), std::back_inserter( utf8_string ) );
+	ANSICodec::GetDefault( ).ToUTF8( str, str + std::strlen( str ), utf8_string );
 }
 
 String::String( const wchar_t *str )
@@ -55,7 +173,7 @@ String::String( const wchar_t *str )
 
 String::String( const std::string &str )
 {
-	UTF8::FromANSI( str.begin( ), str.end( ), std::back_inserter( utf8_string ) );
+	ANSICodec::GetDefault( ).ToUTF8( str.data( ), str.data( ) + str.size( ), utf8_string );
 }
 
 String::String( const std::wstring &str )
@@ -63,23 +181,66 @@ String::String( const std::wstring &str )
 	UTF8::FromWideString( str.begin( ), str.end( ), std::back_inserter( utf8_string ) );
 }
 
+String::String( StringView str, const ANSICodec &codec )
+{
+	codec.ToUTF8( str.begin( ), str.end( ), utf8_string );
+}
+
+String::String( const String &str ) :
+	utf8_string( str.utf8_string )
+{
+	if( str.cache )
+	{
+		cache.reset( new StringCache );
+		cache->length = str.cache->length;
+	}
+}
+
+String::String( String &&str ) = default;
+
+String::~String( ) = default;
+
+String &String::operator=( const String &str )
+{
+	if( this != &str )
+	{
+		utf8_string = str.utf8_string;
+		SetCaching( static_cast<bool>( str.cache ) );
+		if( cache )
+		{
+			cache->Invalidate( );
+			cache->length = str.cache->length;
+		}
+	}
+
+	return *this;
+}
+
+String &String::operator=( String &&str ) = default;
+
 String &String::operator+=( const String &str )
 {
 	utf8_string += str.utf8_string;
+	if( cache )
+		cache->Invalidate( );
+
 	return *this;
 }
 
 std::string String::ToANSI( ) const
 {
 	std::string str;
-	UTF8::ToANSI( utf8_string.begin( ), utf8_string.end( ), std::back_inserter( str ) );
+	ToANSI( str );
 	return str;
 }
 
 std::wstring String::ToWideString( ) const
 {
+	if( cache )
+		return cache->GetWideString( utf8_string );
+
 	std::wstring str;
-	UTF8::ToWideString( utf8_string.begin( ), utf8_string.end( ), std::back_inserter( str ) );
+	ConvertToWideString( utf8_string, str );
 	return str;
 }
 
@@ -90,18 +251,92 @@ std::string String::ToUTF8( ) const
 
 std::u16string String::ToUTF16( ) const
 {
+	if( cache )
+		return cache->GetUTF16( utf8_string );
+
 	std::u16string str;
-	UTF8::ToUTF16( utf8_string.begin( ), utf8_string.end( ), std::back_inserter( str ) );
+	ConvertToUTF16( utf8_string, str );
 	return str;
 }
 
 std::u32string String::ToUTF32( ) const
 {
+	if( cache )
+		return cache->GetUTF32( utf8_string );
+
 	std::u32string str;
-	UTF8::ToUTF32( utf8_string.begin( ), utf8_string.end( ), std::back_inserter( str ) );
+	ConvertToUTF32( utf8_string, str );
+	return str;
+}
+
+std::string String::ToANSI( const ANSICodec &codec ) const
+{
+	std::string str;
+	ToANSI( str, codec );
 	return str;
 }
 
+void String::ToANSI( std::string &str ) const
+{
+	ToANSI( str, ANSICodec::GetDefault( ) );
+}
+
+void String::ToANSI( std::string &str, const ANSICodec &codec ) const
+{
+	str.clear( );
+	codec.FromUTF8( utf8_string.data( ), utf8_string.data( ) + utf8_string.size( ), str );
+}
+
+void String::ToWideString( std::wstring &str ) const
+{
+	if( cache )
+		str = cache->GetWideString( utf8_string );
+	else
+		ConvertToWideString( utf8_string, str );
+}
+
+void String::ToUTF16( std::u16string &str ) const
+{
+	if( cache )
+		str = cache->GetUTF16( utf8_string );
+	else
+		ConvertToUTF16( utf8_string, str );
+}
+
+void String::ToUTF32( std::u32string &str ) const
+{
+	if( cache )
+		str = cache->GetUTF32( utf8_string );
+	else
+		ConvertToUTF32( utf8_string, str );
+}
+
+StringView String::GetView( ) const
+{
+	return StringView( utf8_string );
+}
+
+size_t String::Length( ) const
+{
+	if( cache )
+		return cache->GetLength( utf8_string );
+
+	return UTF8::Length( utf8_string.begin( ), utf8_string.end( ) );
+}
+
+void String::SetCaching( bool enable )
+{
+	if( !enable )
+		cache.reset( );
+	else if( !cache )
+		cache.reset( new StringCache );
+}
+
+bool String::IsCaching( ) const
+{
+	return static_cast<bool>( cache );
+}
+
 String::operator std::string( ) const
 {
 	return ToANSI( );
@@ -156,4 +391,106 @@ bool String::WildcardCompare( const std::string &str, const std::string &wildcar
 	return wild == wildend;
 }
 
+static const uint64_t byte_ones = 0x0101010101010101ULL;
+
+// Sets the 0x20 bit of the bytes between 'A' and 'Z', eight at a time
+static inline uint64_t LowerWord( uint64_t word )
+{
+	uint64_t low_bits = word & ( 0x7F * byte_ones );
+	uint64_t above_z = low_bits + ( 0x7F - 'Z' ) * byte_ones;
+	uint64_t from_a = low_bits + ( 0x80 - 'A' ) * byte_ones;
+	uint64_t upper = ~word & ( from_a ^ above_z ) & ( 0x80 * byte_ones );
+	return word | ( upper >> 2 );
+}
+
+static inline unsigned char LowerByte( char c )
+{
+	return static_cast<unsigned char>( c >= 'A' && c <= 'Z' ? c | 0x20 : c );
+}
+
+void String::ToLowerASCII( const char *input, size_t size, char *output )
+{
+	size_t k = 0;
+
+#if defined MULTILIBRARY_STRING_SSE2
+
+	const __m128i before_a = _mm_set1_epi8( 'A' - 1 );
+	const __m128i after_z = _mm_set1_epi8( 'Z' + 1 );
+	const __m128i case_bit = _mm_set1_epi8( 0x20 );
+	for( ; k + 16 <= size; k += 16 )
+	{
+		__m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i *>( input + k ) );
+		__m128i upper = _mm_and_si128( _mm_cmpgt_epi8( chunk, before_a ), _mm_cmplt_epi8( chunk, after_z ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( output + k ), _mm_or_si128( chunk, _mm_and_si128( upper, case_bit ) ) );
+	}
+
+#endif
+
+	for( ; k + 8 <= size; k += 8 )
+	{
+		uint64_t word;
+		std::memcpy( &word, input + k, sizeof( word ) );
+		word = LowerWord( word );
+		std::memcpy( output + k, &word, sizeof( word ) );
+	}
+
+	for( ; k < size; ++k )
+		output[k] = static_cast<char>( LowerByte( input[k] ) );
+}
+
+int String::CompareCaseInsensitive( StringView left, StringView right )
+{
+	const char *left_data = left.Data( );
+	const char *right_data = right.Data( );
+	size_t size = left.Size( ) < right.Size( ) ? left.Size( ) : right.Size( );
+	size_t k = 0;
+	for( ; k + 8 <= size; k += 8 )
+	{
+		uint64_t left_word, right_word;
+		std::memcpy( &left_word, left_data + k, sizeof( left_word ) );
+		std::memcpy( &right_word, right_data + k, sizeof( right_word ) );
+		if( LowerWord( left_word ) != LowerWord( right_word ) )
+			break;
+	}
+
+	// Either the rest of the input or the word that differs
+	for( ; k < size; ++k )
+	{
+		unsigned char left_char = LowerByte( left_data[k] );
+		unsigned char right_char = LowerByte( right_data[k] );
+		if( left_char != right_char )
+			return left_char < right_char ? -1 : 1;
+	}
+
+	if( left.Size( ) != right.Size( ) )
+		return left.Size( ) < right.Size( ) ? -1 : 1;
+
+	return 0;
+}
+
+bool String::EqualsCaseInsensitive( StringView left, StringView right )
+{
+	return left.Size( ) == right.Size( ) && CompareCaseInsensitive( left, right ) == 0;
+}
+
+size_t String::HashCaseInsensitive( StringView str )
+{
+	char buffer[256];
+	if( str.Size( ) <= sizeof( buffer ) )
+	{
+		ToLowerASCII( str.Data( ), str.Size( ), buffer );
+		return static_cast<size_t>( Hash64::Compute( buffer, str.Size( ) ) );
+	}
+
+	Hash64 hash;
+	for( size_t offset = 0; offset < str.Size( ); offset += sizeof( buffer ) )
+	{
+		size_t size = str.Size( ) - offset < sizeof( buffer ) ? str.Size( ) - offset : sizeof( buffer );
+		ToLowerASCII( str.Data( ) + offset, size, buffer );
+		hash.Update( buffer, size );
+	}
+
+	return static_cast<size_t>( hash.Value( ) );
+}
+
 } // namespace MultiLibrary
@@ -0,0 +1,80 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/Transfer.hpp>
+
+namespace MultiLibrary
+{
+
+TransferEndpoint::TransferEndpoint( Type endpoint_type, Descriptor read, Descriptor write, InputStream *in, OutputStream *out, Stream *positioned ) :
+	type( endpoint_type ),
+	read_descriptor( read ),
+	write_descriptor( write ),
+	input( in ),
+	output( out ),
+	position( positioned )
+{ }
+
+TransferEndpoint::TransferEndpoint( InputStream &stream ) :
+	TransferEndpoint( Type::Stream, static_cast<Descriptor>( -1 ), static_cast<Descriptor>( -1 ), &stream, nullptr, nullptr )
+{ }
+
+TransferEndpoint::TransferEndpoint( OutputStream &stream ) :
+	TransferEndpoint( Type::Stream, static_cast<Descriptor>( -1 ), static_cast<Descriptor>( -1 ), nullptr, &stream, nullptr )
+{ }
+
+TransferEndpoint::TransferEndpoint( IOStream &stream ) :
+	TransferEndpoint( Type::Stream, static_cast<Descriptor>( -1 ), static_cast<Descriptor>( -1 ), &stream, &stream, nullptr )
+{ }
+
+TransferEndpoint TransferEndpoint::FromFile( Descriptor file, IOStream &stream )
+{
+	if( file == static_cast<Descriptor>( -1 ) )
+		return TransferEndpoint( stream );
+
+	return TransferEndpoint( Type::File, file, file, &stream, &stream, static_cast<InputStream *>( &stream ) );
+}
+
+TransferEndpoint TransferEndpoint::FromSocket( Descriptor socket )
+{
+	return TransferEndpoint( Type::Socket, socket, socket, nullptr, nullptr, nullptr );
+}
+
+TransferEndpoint::Type TransferEndpoint::GetType( ) const
+{
+	return type;
+}
+
+} // namespace MultiLibrary
@@ -0,0 +1,653 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/Unicode.hpp>
+#include <MultiLibrary/Common/CPUFeatures.hpp>
+#include <cstring>
+
+#if defined __SSE2__ || defined _M_X64 || ( defined _M_IX86_FP && _M_IX86_FP >= 2 )
+
+	#define MULTILIBRARY_UNICODE_SSE2
+	#include <emmintrin.h>
+
+#endif
+
+#if defined MULTILIBRARY_X86
+
+	#include <immintrin.h>
+
+#endif
+
+namespace MultiLibrary
+{
+
+static const uint32_t replacement_character = 0xFFFD;
+
+// Kernels convert the run of ASCII characters at the beginning of the input
+// and return its length, leaving everything else to the scalar code
+struct UnicodeKernels
+{
+	size_t ( *ascii_prefix )( const uint8_t *data, size_t size );
+	size_t ( *widen16 )( const uint8_t *data, size_t size, char16_t *out );
+	size_t ( *widen32 )( const uint8_t *data, size_t size, char32_t *out );
+	size_t ( *narrow16 )( const char16_t *data, size_t size, char *out );
+	size_t ( *narrow32 )( const char32_t *data, size_t size, char *out );
+};
+
+static size_t ASCIIPrefixScalar( const uint8_t *data, size_t size )
+{
+	size_t k = 0;
+	for( ; k + 8 <= size; k += 8 )
+	{
+		uint64_t word;
+		std::memcpy( &word, data + k, sizeof( word ) );
+		if( ( word & 0x8080808080808080ULL ) != 0 )
+			break;
+	}
+
+	while( k < size && data[k] < 0x80 )
+		++k;
+
+	return k;
+}
+
+static size_t WidenASCII16Scalar( const uint8_t *data, size_t size, char16_t *out )
+{
+	size_t k = 0;
+	for( ; k < size && data[k] < 0x80; ++k )
+		out[k] = data[k];
+
+	return k;
+}
+
+static size_t WidenASCII32Scalar( const uint8_t *data, size_t size, char32_t *out )
+{
+	size_t k = 0;
+	for( ; k < size && data[k] < 0x80; ++k )
+		out[k] = data[k];
+
+	return k;
+}
+
+static size_t NarrowASCII16Scalar( const char16_t *data, size_t size, char *out )
+{
+	size_t k = 0;
+	for( ; k < size && data[k] < 0x80; ++k )
+		out[k] = static_cast<char>( data[k] );
+
+	return k;
+}
+
+static size_t NarrowASCII32Scalar( const char32_t *data, size_t size, char *out )
+{
+	size_t k = 0;
+	for( ; k < size && data[k] < 0x80; ++k )
+		out[k] = static_cast<char>( data[k] );
+
+	return k;
+}
+
+#if defined MULTILIBRARY_UNICODE_SSE2 || defined MULTILIBRARY_X86
+
+static size_t CountTrailingZeros( uint32_t mask )
+{
+
+#if defined _MSC_VER
+
+	unsigned long index;
+	_BitScanForward( &index, mask );
+	return index;
+
+#else
+
+	return static_cast<size_t>( __builtin_ctz( mask ) );
+
+#endif
+
+}
+
+#endif
+
+#if defined MULTILIBRARY_UNICODE_SSE2
+
+static size_t ASCIIPrefixSSE2( const uint8_t *data, size_t size )
+{
+	size_t k = 0;
+	for( ; k + 16 <= size; k += 16 )
+	{
+		int mask = _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + k ) ) );
+		if( mask != 0 )
+			return k + CountTrailingZeros( static_cast<uint32_t>( mask ) );
+	}
+
+	return k + ASCIIPrefixScalar( data + k, size - k );
+}
+
+static size_t WidenASCII16SSE2( const uint8_t *data, size_t size, char16_t *out )
+{
+	const __m128i zero = _mm_setzero_si128( );
+	size_t k = 0;
+	for( ; k + 16 <= size; k += 16 )
+	{
+		__m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + k ) );
+		if( _mm_movemask_epi8( bytes ) != 0 )
+			break;
+
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + k ), _mm_unpacklo_epi8( bytes, zero ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + k + 8 ), _mm_unpackhi_epi8( bytes, zero ) );
+	}
+
+	return k + WidenASCII16Scalar( data + k, size - k, out + k );
+}
+
+static size_t WidenASCII32SSE2( const uint8_t *data, size_t size, char32_t *out )
+{
+	const __m128i zero = _mm_setzero_si128( );
+	size_t k = 0;
+	for( ; k + 16 <= size; k += 16 )
+	{
+		__m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + k ) );
+		if( _mm_movemask_epi8( bytes ) != 0 )
+			break;
+
+		__m128i low = _mm_unpacklo_epi8( bytes, zero );
+		__m128i high = _mm_unpackhi_epi8( bytes, zero );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + k ), _mm_unpacklo_epi16( low, zero ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + k + 4 ), _mm_unpackhi_epi16( low, zero ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + k + 8 ), _mm_unpacklo_epi16( high, zero ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + k + 12 ), _mm_unpackhi_epi16( high, zero ) );
+	}
+
+	return k + WidenASCII32Scalar( data + k, size - k, out + k );
+}
+
+static size_t NarrowASCII16SSE2( const char16_t *data, size_t size, char *out )
+{
+	const __m128i non_ascii = _mm_set1_epi16( static_cast<short>( 0xFF80 ) );
+	const __m128i zero = _mm_setzero_si128( );
+	size_t k = 0;
+	for( ; k + 16 <= size; k += 16 )
+	{
+		__m128i low = _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + k ) );
+		__m128i high = _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + k + 8 ) );
+		__m128i check = _mm_and_si128( _mm_or_si128( low, high ), non_ascii );
+		if( _mm_movemask_epi8( _mm_cmpeq_epi16( check, zero ) ) != 0xFFFF )
+			break;
+
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + k ), _mm_packus_epi16( low, high ) );
+	}
+
+	return k + NarrowASCII16Scalar( data + k, size - k, out + k );
+}
+
+static size_t NarrowASCII32SSE2( const char32_t *data, size_t size, char *out )
+{
+	const __m128i non_ascii = _mm_set1_epi32( static_cast<int>( 0xFFFFFF80 ) );
+	const __m128i zero = _mm_setzero_si128( );
+	size_t k = 0;
+	for( ; k + 8 <= size; k += 8 )
+	{
+		__m128i low = _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + k ) );
+		__m128i high = _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + k + 4 ) );
+		__m128i check = _mm_and_si128( _mm_or_si128( low, high ), non_ascii );
+		if( _mm_movemask_epi8( _mm_cmpeq_epi32( check, zero ) ) != 0xFFFF )
+			break;
+
+		__m128i words = _mm_packs_epi32( low, high );
+		_mm_storel_epi64( reinterpret_cast<__m128i *>( out + k ), _mm_packus_epi16( words, words ) );
+	}
+
+	return k + NarrowASCII32Scalar( data + k, size - k, out + k );
+}
+
+#endif
+
+#if defined MULTILIBRARY_X86
+
+MULTILIBRARY_TARGET( "avx2" ) static size_t ASCIIPrefixAVX2( const uint8_t *data, size_t size )
+{
+	size_t k = 0;
+	for( ; k + 32 <= size; k += 32 )
+	{
+		int mask = _mm256_movemask_epi8( _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + k ) ) );
+		if( mask != 0 )
+			return k + CountTrailingZeros( static_cast<uint32_t>( mask ) );
+	}
+
+	return k + ASCIIPrefixScalar( data + k, size - k );
+}
+
+MULTILIBRARY_TARGET( "avx2" ) static size_t WidenASCII16AVX2( const uint8_t *data, size_t size, char16_t *out )
+{
+	size_t k = 0;
+	for( ; k + 32 <= size; k += 32 )
+	{
+		__m256i bytes = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + k ) );
+		if( _mm256_movemask_epi8( bytes ) != 0 )
+			break;
+
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( out + k ), _mm256_cvtepu8_epi16( _mm256_castsi256_si128( bytes ) ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( out + k + 16 ), _mm256_cvtepu8_epi16( _mm256_extracti128_si256( bytes, 1 ) ) );
+	}
+
+	return k + WidenASCII16Scalar( data + k, size - k, out + k );
+}
+
+MULTILIBRARY_TARGET( "avx2" ) static size_t WidenASCII32AVX2( const uint8_t *data, size_t size, char32_t *out )
+{
+	size_t k = 0;
+	for( ; k + 32 <= size; k += 32 )
+	{
+		__m256i bytes = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + k ) );
+		if( _mm256_movemask_epi8( bytes ) != 0 )
+			break;
+
+		__m128i low = _mm256_castsi256_si128( bytes );
+		__m128i high = _mm256_extracti128_si256( bytes, 1 );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( out + k ), _mm256_cvtepu8_epi32( low ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( out + k + 8 ), _mm256_cvtepu8_epi32( _mm_srli_si128( low, 8 ) ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( out + k + 16 ), _mm256_cvtepu8_epi32( high ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( out + k + 24 ), _mm256_cvtepu8_epi32( _mm_srli_si128( high, 8 ) ) );
+	}
+
+	return k + WidenASCII32Scalar( data + k, size - k, out + k );
+}
+
+MULTILIBRARY_TARGET( "avx2" ) static size_t NarrowASCII16AVX2( const char16_t *data, size_t size, char *out )
+{
+	const __m256i non_ascii = _mm256_set1_epi16( static_cast<short>( 0xFF80 ) );
+	size_t k = 0;
+	for( ; k + 32 <= size; k += 32 )
+	{
+		__m256i low = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + k ) );
+		__m256i high = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + k + 16 ) );
+		if( !_mm256_testz_si256( _mm256_or_si256( low, high ), non_ascii ) )
+			break;
+
+		// Packing works per 128 bits lane, so the quadwords need reordering
+		__m256i packed = _mm256_permute4x64_epi64( _mm256_packus_epi16( low, high ), 0xD8 );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( out + k ), packed );
+	}
+
+	return k + NarrowASCII16Scalar( data + k, size - k, out + k );
+}
+
+#endif
+
+static UnicodeKernels SelectKernels( )
+{
+
+#if defined MULTILIBRARY_X86
+
+	// There's no AVX2 narrowing from 32 bits, the SSE2 one is used when the
+	// build targets SSE2 and the scalar one otherwise
+	if( Internal::GetCPUFeatures( ).avx2 )
+	{
+
+#if defined MULTILIBRARY_UNICODE_SSE2
+
+		UnicodeKernels kernels = { ASCIIPrefixAVX2, WidenASCII16AVX2, WidenASCII32AVX2, NarrowASCII16AVX2, NarrowASCII32SSE2 };
+
+#else
+
+		UnicodeKernels kernels = { ASCIIPrefixAVX2, WidenASCII16AVX2, WidenASCII32AVX2, NarrowASCII16AVX2, NarrowASCII32Scalar };
+
+#endif
+
+		return kernels;
+	}
+
+#endif
+
+#if defined MULTILIBRARY_UNICODE_SSE2
+
+	UnicodeKernels kernels = { ASCIIPrefixSSE2, WidenASCII16SSE2, WidenASCII32SSE2, NarrowASCII16SSE2, NarrowASCII32SSE2 };
+
+#else
+
+	UnicodeKernels kernels = { ASCIIPrefixScalar, WidenASCII16Scalar, WidenASCII32Scalar, NarrowASCII16Scalar, NarrowASCII32Scalar };
+
+#endif
+
+	return kernels;
+}
+
+static const UnicodeKernels &GetKernels( )
+{
+	static const UnicodeKernels kernels = SelectKernels( );
+	return kernels;
+}
+
+// UTF-8 DFA, bytes are mapped to classes which drive the state transitions:
+// 0 ASCII, 1 80..8F, 2 90..9F, 3 A0..BF, 4 never valid, 5 C2..DF, 6 E0,
+// 7 E1..EC and EE..EF, 8 ED, 9 F0, 10 F1..F3, 11 F4
+static const uint8_t utf8_classes[256] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+	4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+	5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+	6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 7,
+	9, 10, 10, 10, 11, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+};
+
+enum UTF8State : uint8_t
+{
+	Accept,
+	Reject,
+	Need1,
+	Need2,
+	Need3,
+	NeedE0,
+	NeedED,
+	NeedF0,
+	NeedF4
+};
+
+static const uint8_t utf8_transitions[9][12] =
+{
+	{ Accept, Reject, Reject, Reject, Reject, Need1, NeedE0, Need2, NeedED, NeedF0, Need3, NeedF4 },
+	{ Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject },
+	{ Reject, Accept, Accept, Accept, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject },
+	{ Reject, Need1, Need1, Need1, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject },
+	{ Reject, Need2, Need2, Need2, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject },
+	{ Reject, Reject, Reject, Need1, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject },
+	{ Reject, Need1, Need1, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject },
+	{ Reject, Reject, Need2, Need2, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject },
+	{ Reject, Need2, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject, Reject }
+};
+
+static const uint8_t utf8_lead_masks[12] = { 0x7F, 0, 0, 0, 0, 0x1F, 0x0F, 0x0F, 0x0F, 0x07, 0x07, 0x07 };
+
+// Decodes the sequence at data and returns its length, which for an invalid
+// sequence is the length of its maximal ill-formed part (at least 1)
+static size_t DecodeSequence( const uint8_t *data, const uint8_t *end, uint32_t &codepoint, bool &valid )
+{
+	uint8_t type = utf8_classes[data[0]];
+	uint8_t state = utf8_transitions[Accept][type];
+	size_t length = 1;
+	codepoint = data[0] & utf8_lead_masks[type];
+	while( state > Reject && data + length < end )
+	{
+		uint8_t next = utf8_transitions[state][utf8_classes[data[length]]];
+		if( next == Reject )
+			break;
+
+		codepoint = codepoint << 6 | ( data[length] & 0x3Fu );
+		state = next;
+		++length;
+	}
+
+	valid = state == Accept;
+	return length;
+}
+
+static char *EncodeUTF8( uint32_t codepoint, char *out )
+{
+	if( codepoint < 0x80 )
+	{
+		*out++ = static_cast<char>( codepoint );
+	}
+	else if( codepoint < 0x800 )
+	{
+		*out++ = static_cast<char>( 0xC0 | codepoint >> 6 );
+		*out++ = static_cast<char>( 0x80 | ( codepoint & 0x3F ) );
+	}
+	else if( codepoint < 0x10000 )
+	{
+		*out++ = static_cast<char>( 0xE0 | codepoint >> 12 );
+		*out++ = static_cast<char>( 0x80 | ( codepoint >> 6 & 0x3F ) );
+		*out++ = static_cast<char>( 0x80 | ( codepoint & 0x3F ) );
+	}
+	else
+	{
+		*out++ = static_cast<char>( 0xF0 | codepoint >> 18 );
+		*out++ = static_cast<char>( 0x80 | ( codepoint >> 12 & 0x3F ) );
+		*out++ = static_cast<char>( 0x80 | ( codepoint >> 6 & 0x3F ) );
+		*out++ = static_cast<char>( 0x80 | ( codepoint & 0x3F ) );
+	}
+
+	return out;
+}
+
+namespace UTF8
+{
+
+const char *SkipASCII( const char *begin, const char *end )
+{
+	return begin + GetKernels( ).ascii_prefix( reinterpret_cast<const uint8_t *>( begin ), static_cast<size_t>( end - begin ) );
+}
+
+bool Validate( const char *begin, const char *end )
+{
+	return FindInvalid( begin, end ) == end;
+}
+
+const char *FindInvalid( const char *begin, const char *end )
+{
+	const UnicodeKernels &kernels = GetKernels( );
+	const uint8_t *data = reinterpret_cast<const uint8_t *>( begin );
+	const uint8_t *data_end = reinterpret_cast<const uint8_t *>( end );
+	const uint8_t *sequence = data;
+	uint8_t state = Accept;
+	while( data < data_end )
+	{
+		if( state == Accept )
+		{
+			if( *data < 0x80 )
+			{
+				data += kernels.ascii_prefix( data, static_cast<size_t>( data_end - data ) );
+				continue;
+			}
+
+			sequence = data;
+		}
+
+		state = utf8_transitions[state][utf8_classes[*data]];
+		if( state == Reject )
+			return reinterpret_cast<const char *>( sequence );
+
+		++data;
+	}
+
+	return state == Accept ? end : reinterpret_cast<const char *>( sequence );
+}
+
+bool Sanitize( const char *begin, const char *end, std::string &output, ErrorPolicy policy, size_t *error_offset )
+{
+	const char *invalid = FindInvalid( begin, end );
+	if( invalid == end )
+	{
+		output.append( begin, end );
+		return true;
+	}
+
+	if( error_offset != nullptr )
+		*error_offset = static_cast<size_t>( invalid - begin );
+
+	if( policy == ErrorPolicy::Fail )
+		return false;
+
+	output.reserve( output.size( ) + static_cast<size_t>( end - begin ) + 2 );
+	while( invalid != end )
+	{
+		output.append( begin, invalid );
+		output.append( "\xEF\xBF\xBD", 3 );
+
+		uint32_t codepoint;
+		bool valid;
+		const uint8_t *data = reinterpret_cast<const uint8_t *>( invalid );
+		begin = invalid + DecodeSequence( data, reinterpret_cast<const uint8_t *>( end ), codepoint, valid );
+		invalid = FindInvalid( begin, end );
+	}
+
+	output.append( begin, end );
+	return false;
+}
+
+char16_t *ConvertToUTF16( const char *begin, const char *end, char16_t *out )
+{
+	const UnicodeKernels &kernels = GetKernels( );
+	const uint8_t *data = reinterpret_cast<const uint8_t *>( begin );
+	const uint8_t *data_end = reinterpret_cast<const uint8_t *>( end );
+	while( data < data_end )
+	{
+		if( *data < 0x80 )
+		{
+			size_t converted = kernels.widen16( data, static_cast<size_t>( data_end - data ), out );
+			data += converted;
+			out += converted;
+			continue;
+		}
+
+		uint32_t codepoint;
+		bool valid;
+		data += DecodeSequence( data, data_end, codepoint, valid );
+		if( !valid )
+			codepoint = replacement_character;
+
+		if( codepoint >= 0x10000 )
+		{
+			codepoint -= 0x10000;
+			*out++ = static_cast<char16_t>( 0xD800 + ( codepoint >> 10 ) );
+			*out++ = static_cast<char16_t>( 0xDC00 + ( codepoint & 0x3FF ) );
+		}
+		else
+		{
+			*out++ = static_cast<char16_t>( codepoint );
+		}
+	}
+
+	return out;
+}
+
+char32_t *ConvertToUTF32( const char *begin, const char *end, char32_t *out )
+{
+	const UnicodeKernels &kernels = GetKernels( );
+	const uint8_t *data = reinterpret_cast<const uint8_t *>( begin );
+	const uint8_t *data_end = reinterpret_cast<const uint8_t *>( end );
+	while( data < data_end )
+	{
+		if( *data < 0x80 )
+		{
+			size_t converted = kernels.widen32( data, static_cast<size_t>( data_end - data ), out );
+			data += converted;
+			out += converted;
+			continue;
+		}
+
+		uint32_t codepoint;
+		bool valid;
+		data += DecodeSequence( data, data_end, codepoint, valid );
+		if( !valid )
+			codepoint = replacement_character;
+
+		*out++ = static_cast<char32_t>( codepoint );
+	}
+
+	return out;
+}
+
+} // namespace UTF8
+
+namespace UTF16
+{
+
+char *ConvertToUTF8( const char16_t *begin, const char16_t *end, char *out )
+{
+	const UnicodeKernels &kernels = GetKernels( );
+	while( begin < end )
+	{
+		if( *begin < 0x80 )
+		{
+			size_t converted = kernels.narrow16( begin, static_cast<size_t>( end - begin ), out );
+			begin += converted;
+			out += converted;
+			continue;
+		}
+
+		uint32_t codepoint = *begin++;
+		if( codepoint >= 0xD800 && codepoint <= 0xDBFF && begin < end && *begin >= 0xDC00 && *begin <= 0xDFFF )
+			codepoint = 0x10000 + ( ( codepoint - 0xD800 ) << 10 ) + ( *begin++ - 0xDC00 );
+		else if( codepoint >= 0xD800 && codepoint <= 0xDFFF )
+			codepoint = replacement_character;
+
+		out = EncodeUTF8( codepoint, out );
+	}
+
+	return out;
+}
+
+} // namespace UTF16
+
+namespace UTF32
+{
+
+char *ConvertToUTF8( const char32_t *begin, const char32_t *end, char *out )
+{
+	const UnicodeKernels &kernels = GetKernels( );
+	while( begin < end )
+	{
+		if( *begin < 0x80 )
+		{
+			size_t converted = kernels.narrow32( begin, static_cast<size_t>( end - begin ), out );
+			begin += converted;
+			out += converted;
+			continue;
+		}
+
+		uint32_t codepoint = *begin++;
+		if( codepoint > 0x10FFFF || ( codepoint >= 0xD800 && codepoint <= 0xDFFF ) )
+			codepoint = replacement_character;
+
+		out = EncodeUTF8( codepoint, out );
+	}
+
+	return out;
+}
+
+} // namespace UTF32
+
+} // namespace MultiLibrary
@@ -34,6 +34,7 @@
  *************************************************************************/
 
 #include <MultiLibrary/Common/Windows/Pipe.hpp>
+#include <chrono>
 #include <stdexcept>
 #include <system_error>
 
@@ -55,7 +56,49 @@ Pipe::Handle::operator HANDLE( ) const
 	return handle;
 }
 
-Pipe::Pipe( Standard::Input in, Standard::Output out )
+typedef std::chrono::steady_clock Clock;
+
+// Anonymous pipes can't be waited on, so outside of Blocking mode they are
+// peeked until data shows up or the deadline passes; returns 0 on timeout or
+// error and sets closed when the other end is gone
+static size_t ReadUntil( HANDLE handle, void *data, size_t size, Pipe::Mode mode, Clock::time_point deadline, bool &closed )
+{
+	DWORD avail = static_cast<DWORD>( size );
+	if( mode != Pipe::Mode::Blocking )
+	{
+		for( ; ; )
+		{
+			if( PeekNamedPipe( handle, nullptr, 0, nullptr, &avail, nullptr ) == FALSE )
+			{
+				closed = GetLastError( ) == ERROR_BROKEN_PIPE;
+				return 0;
+			}
+
+			if( avail > 0 )
+				break;
+
+			if( mode == Pipe::Mode::NonBlocking || Clock::now( ) >= deadline )
+				return 0;
+
+			Sleep( 1 );
+		}
+	}
+
+	DWORD read = 0;
+	if( ReadFile( handle, data, avail < size ? avail : static_cast<DWORD>( size ), &read, nullptr ) == FALSE )
+	{
+		closed = GetLastError( ) == ERROR_BROKEN_PIPE;
+		return 0;
+	}
+
+	closed = read == 0;
+	return read;
+}
+
+Pipe::Pipe( Standard::Input in, Standard::Output out ) :
+	mode( Mode::Blocking ),
+	timeout( 0 ),
+	end_of_file( false )
 {
 	HANDLE cur_proc = GetCurrentProcess( );
 	HANDLE std_handle = nullptr;
@@ -124,7 +167,10 @@ Pipe::Pipe( Standard::Input in, Standard::Output out )
 	}
 }
 
-Pipe::Pipe( bool read_inheritable, bool write_inheritable )
+Pipe::Pipe( bool read_inheritable, bool write_inheritable ) :
+	mode( Mode::Blocking ),
+	timeout( 0 ),
+	end_of_file( false )
 {
 	SECURITY_ATTRIBUTES sa;
 	sa.nLength = static_cast<DWORD>( sizeof( SECURITY_ATTRIBUTES ) );
@@ -147,7 +193,10 @@ Pipe::Pipe( bool read_inheritable, bool write_inheritable )
 
 Pipe::Pipe( Pipe &&pipe ) noexcept :
 	read_handle( std::move( pipe.read_handle ) ),
-	write_handle( std::move( pipe.write_handle ) )
+	write_handle( std::move( pipe.write_handle ) ),
+	mode( pipe.mode ),
+	timeout( pipe.timeout ),
+	end_of_file( pipe.end_of_file )
 { }
 
 Pipe::~Pipe( )
@@ -188,21 +237,63 @@ size_t Pipe::Size( ) const
 
 bool Pipe::EndOfFile( ) const
 {
-	return static_cast<bool>( read_handle );
+	return end_of_file || !read_handle;
+}
+
+void Pipe::SetMode( Mode m, uint32_t t )
+{
+	mode = m;
+	timeout = t;
+}
+
+Pipe::Mode Pipe::GetMode( ) const
+{
+	return mode;
+}
+
+uint32_t Pipe::GetTimeout( ) const
+{
+	return timeout;
 }
 
 size_t Pipe::Read( void *data, size_t size )
 {
-	if( !read_handle )
+	if( !read_handle || size == 0 )
 		return 0;
 
-	DWORD avail = static_cast<DWORD>( Size( ) );
-	if( avail > 0 && ReadFile( *read_handle, data, avail < size ? avail : static_cast<DWORD>( size ), &avail, nullptr ) == FALSE )
+	bool closed = false;
+	size_t result = ReadUntil( *read_handle, data, size, mode, Clock::now( ) + std::chrono::milliseconds( timeout ), closed );
+	if( closed )
+		end_of_file = true;
+
+	return result;
+}
+
+size_t Pipe::ReadAll( void *data, size_t size )
+{
+	if( !read_handle )
 		return 0;
 
-	return avail;
+	Clock::time_point deadline = Clock::now( ) + std::chrono::milliseconds( timeout );
+	char *bytes = static_cast<char *>( data );
+	size_t total = 0;
+	bool closed = false;
+	while( total < size && !closed )
+	{
+		size_t result = ReadUntil( *read_handle, bytes + total, size - total, mode, deadline, closed );
+		if( result == 0 )
+			break;
+
+		total += result;
+	}
+
+	if( closed )
+		end_of_file = true;
+
+	return total;
 }
 
+// Writes to anonymous pipes always block until done, whatever the mode
 size_t Pipe::Write( const void *data, size_t size )
 {
 	if( !write_handle )
@@ -213,6 +304,22 @@ size_t Pipe::Write( const void *data, size_t size )
 	return written;
 }
 
+size_t Pipe::WriteAll( const void *data, size_t size )
+{
+	const char *bytes = static_cast<const char *>( data );
+	size_t total = 0;
+	while( total < size )
+	{
+		size_t result = Write( bytes + total, size - total );
+		if( result == 0 )
+			break;
+
+		total += result;
+	}
+
+	return total;
+}
+
 void Pipe::CloseRead( )
 {
 	read_handle.reset( );
@@ -33,52 +33,77 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *************************************************************************/
 
-#include <MultiLibrary/Common/Process.hpp>
+#include <MultiLibrary/Common/Windows/Process.hpp>
 #include <MultiLibrary/Common/Unicode.hpp>
 #include <MultiLibrary/Common/Windows/Pipe.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <algorithm>
 #include <system_error>
 #include <iterator>
+#include <vector>
 #include <windows.h>
+#include <psapi.h>
 
 namespace MultiLibrary
 {
 
-class Process::Handle
+Process::Handle::Handle( HANDLE proc ) :
+	handle( proc )
+{ }
+
+Process::Handle::~Handle( )
 {
-public:
-	Handle( HANDLE proc ) :
-		handle( proc )
-	{ }
+	if( handle != nullptr )
+		CloseHandle( handle );
+}
 
-	~Handle( )
-	{
-		if( handle != nullptr )
-			CloseHandle( handle );
-	}
+Process::Handle::operator HANDLE( ) const
+{
+	return handle;
+}
 
-	operator HANDLE( ) const
+// Handle for the standard stream of the process, the returned handle must be
+// closed by the caller if it's different from the pipe handle
+static HANDLE GetStandardHandle( ProcessBuilder::Redirection redirection, HANDLE pipe, DWORD standard, DWORD access )
+{
+	switch( redirection )
 	{
-		return handle;
-	}
+		case ProcessBuilder::Redirection::Inherit:
+			return GetStdHandle( standard );
+
+		case ProcessBuilder::Redirection::Null:
+		{
+			SECURITY_ATTRIBUTES sa;
+			sa.nLength = static_cast<DWORD>( sizeof( SECURITY_ATTRIBUTES ) );
+			sa.bInheritHandle = TRUE;
+			sa.lpSecurityDescriptor = nullptr;
+			return CreateFileW( L"NUL", access, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, nullptr );
+		}
 
-private:
-	HANDLE handle;
-};
+		default:
+			return pipe;
+	}
+}
 
 Process::Process( const std::string &path, const std::vector<std::string> &args ) :
+	Process( ProcessBuilder( path ).AddArguments( args ) )
+{ }
+
+Process::Process( const ProcessBuilder &builder ) :
 	exit_code( 0 ),
+	usage( ),
 	input_pipe( true, false ),
 	output_pipe( false, true ),
 	error_pipe( false, true )
 {
 	std::string cmdline;
-	cmdline.reserve( path.size( ) + 3 );
+	cmdline.reserve( builder.path.size( ) + 3 );
 	cmdline += '\"';
-	cmdline += path;
+	cmdline += builder.path;
 	cmdline += '\"';
 
-	std::vector<std::string>::const_iterator it, end = args.end( );
-	for( it = args.begin( ); it != end; ++it )
+	std::vector<std::string>::const_iterator it, end = builder.arguments.end( );
+	for( it = builder.arguments.begin( ); it != end; ++it )
 	{
 		cmdline += ' ';
 		cmdline += '\"';
@@ -89,20 +114,102 @@ Process::Process( const std::string &path, const std::vector<std::string> &args
 	std::wstring widecmdline;
 	UTF16::FromUTF8( cmdline.begin( ), cmdline.end( ), std::back_inserter( widecmdline ) );
 
-	STARTUPINFO startup;
+	// Block of NAME=value entries, each one and the block ending with a null
+	std::wstring environment;
+	for( const std::string &entry : builder.BuildEnvironment( ) )
+	{
+		UTF16::FromUTF8( entry.begin( ), entry.end( ), std::back_inserter( environment ) );
+		environment += L'\0';
+	}
+
+	environment += L'\0';
+
+	std::wstring directory;
+	UTF16::FromUTF8( builder.working_directory.begin( ), builder.working_directory.end( ), std::back_inserter( directory ) );
+
+	STARTUPINFOEX startup;
 	ZeroMemory( &startup, sizeof( startup ) );
-	startup.cb = sizeof( startup );
-	startup.dwFlags = STARTF_USESTDHANDLES;
-	startup.hStdInput = input_pipe.ReadHandle( );
-	startup.hStdOutput = output_pipe.WriteHandle( );
-	startup.hStdError = error_pipe.WriteHandle( );
+	startup.StartupInfo.cb = sizeof( startup );
+	startup.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+	startup.StartupInfo.hStdInput = GetStandardHandle( builder.input, input_pipe.ReadHandle( ), STD_INPUT_HANDLE, GENERIC_READ );
+	startup.StartupInfo.hStdOutput = GetStandardHandle( builder.output, output_pipe.WriteHandle( ), STD_OUTPUT_HANDLE, GENERIC_WRITE );
+	startup.StartupInfo.hStdError = GetStandardHandle( builder.error, error_pipe.WriteHandle( ), STD_ERROR_HANDLE, GENERIC_WRITE );
+
+	// Mapped handles are only inheritable while the process is created
+	std::vector<HANDLE> restored;
+	for( const std::pair<uintptr_t, uintptr_t> &mapping : builder.descriptors )
+	{
+		HANDLE handle = reinterpret_cast<HANDLE>( mapping.first );
+		DWORD flags = 0;
+		if( GetHandleInformation( handle, &flags ) != 0 && ( flags & HANDLE_FLAG_INHERIT ) == 0 && SetHandleInformation( handle, HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT ) != 0 )
+			restored.push_back( handle );
+	}
+
+	// Only the listed handles are inherited, instead of every inheritable
+	// handle of this process. The list can't hold duplicates or handles that
+	// aren't inheritable, like console handles.
+	std::vector<HANDLE> inherited;
+	std::vector<HANDLE> candidates = { startup.StartupInfo.hStdInput, startup.StartupInfo.hStdOutput, startup.StartupInfo.hStdError };
+	for( const std::pair<uintptr_t, uintptr_t> &mapping : builder.descriptors )
+		candidates.push_back( reinterpret_cast<HANDLE>( mapping.first ) );
+
+	for( HANDLE handle : candidates )
+	{
+		DWORD flags = 0;
+		if( handle != nullptr && handle != INVALID_HANDLE_VALUE && GetHandleInformation( handle, &flags ) != 0 && ( flags & HANDLE_FLAG_INHERIT ) != 0 &&
+			std::find( inherited.begin( ), inherited.end( ), handle ) == inherited.end( ) )
+			inherited.push_back( handle );
+	}
+
+	SIZE_T attributes_size = 0;
+	InitializeProcThreadAttributeList( nullptr, 1, 0, &attributes_size );
+	std::vector<uint8_t> attributes( attributes_size );
+	startup.lpAttributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>( attributes.data( ) );
+	BOOL initialized = InitializeProcThreadAttributeList( startup.lpAttributeList, 1, 0, &attributes_size );
+	BOOL created = initialized;
+	if( created != FALSE && !inherited.empty( ) )
+		created = UpdateProcThreadAttribute( startup.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, inherited.data( ), inherited.size( ) * sizeof( HANDLE ), nullptr, nullptr );
 
 	PROCESS_INFORMATION info;
-	if( CreateProcess( nullptr, &widecmdline[0], nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startup, &info ) == FALSE )
-		throw std::system_error( GetLastError( ), std::system_category( ), "failed to create process" );
+	if( created != FALSE )
+		created = CreateProcess( nullptr, &widecmdline[0], nullptr, nullptr, inherited.empty( ) ? FALSE : TRUE, CREATE_UNICODE_ENVIRONMENT | EXTENDED_STARTUPINFO_PRESENT, &environment[0], directory.empty( ) ? nullptr : directory.c_str( ), &startup.StartupInfo, &info );
+
+	DWORD error = GetLastError( );
+	if( initialized != FALSE )
+		DeleteProcThreadAttributeList( startup.lpAttributeList );
+
+	for( HANDLE handle : restored )
+		SetHandleInformation( handle, HANDLE_FLAG_INHERIT, 0 );
+
+	if( builder.input == ProcessBuilder::Redirection::Null )
+		CloseHandle( startup.StartupInfo.hStdInput );
+
+	if( builder.output == ProcessBuilder::Redirection::Null )
+		CloseHandle( startup.StartupInfo.hStdOutput );
+
+	if( builder.error == ProcessBuilder::Redirection::Null )
+		CloseHandle( startup.StartupInfo.hStdError );
+
+	if( created == FALSE )
+		throw std::system_error( error, std::system_category( ), "failed to create process" );
 
 	CloseHandle( info.hThread );
 	process.reset( new Handle( info.hProcess ) );
+	for( const SharedChannel *channel : builder.channels )
+		channel->SetPeer( static_cast<uint32_t>( info.dwProcessId ) );
+
+	// Only the process uses these ends
+	input_pipe.CloseRead( );
+	output_pipe.CloseWrite( );
+	error_pipe.CloseWrite( );
+	if( builder.input != ProcessBuilder::Redirection::Pipe )
+		input_pipe.CloseWrite( );
+
+	if( builder.output != ProcessBuilder::Redirection::Pipe )
+		output_pipe.CloseRead( );
+
+	if( builder.error != ProcessBuilder::Redirection::Pipe )
+		error_pipe.CloseRead( );
 }
 
 Process::~Process( )
@@ -130,6 +237,7 @@ bool Process::Close( )
 		DWORD code = 0;
 		GetExitCodeProcess( *process, &code );
 		exit_code = static_cast<int32_t>( code );
+		SampleUsage( );
 		process.reset( );
 		return true;
 	}
@@ -171,4 +279,45 @@ int32_t Process::ExitCode( ) const
 	return exit_code;
 }
 
+// FILETIME counts in units of 100 nanoseconds
+static uint64_t ToMicroseconds( const FILETIME &time )
+{
+	return ( ( static_cast<uint64_t>( time.dwHighDateTime ) << 32 ) | time.dwLowDateTime ) / 10;
+}
+
+bool Process::SampleUsage( )
+{
+	if( !process )
+		return false;
+
+	FILETIME creation, exit, kernel, user;
+	if( GetProcessTimes( *process, &creation, &exit, &kernel, &user ) == 0 )
+		return false;
+
+	usage.user_time = ToMicroseconds( user );
+	usage.system_time = ToMicroseconds( kernel );
+
+	// Windows counts soft and hard page faults together
+	PROCESS_MEMORY_COUNTERS memory;
+	if( K32GetProcessMemoryInfo( *process, &memory, sizeof( memory ) ) != 0 )
+	{
+		usage.max_resident_size = memory.PeakWorkingSetSize;
+		usage.minor_faults = memory.PageFaultCount;
+	}
+
+	IO_COUNTERS io;
+	if( GetProcessIoCounters( *process, &io ) != 0 )
+	{
+		usage.read_bytes = io.ReadTransferCount;
+		usage.written_bytes = io.WriteTransferCount;
+	}
+
+	return true;
+}
+
+const Process::Usage &Process::GetUsage( ) const
+{
+	return usage;
+}
+
 } // namespace MultiLibrary
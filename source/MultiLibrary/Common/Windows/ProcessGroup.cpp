@@ -0,0 +1,280 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ProcessGroup.hpp>
+#include <MultiLibrary/Common/Windows/Pipe.hpp>
+#include <MultiLibrary/Common/Windows/Process.hpp>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+namespace MultiLibrary
+{
+
+// Size of the chunks read from the process pipes
+static const size_t chunk_size = 64 * 1024;
+
+typedef std::chrono::steady_clock Clock;
+
+// Anonymous pipes can't be waited on, so the processes are polled
+class ProcessGroup::Reactor
+{
+public:
+	struct Entry;
+
+	struct Source
+	{
+		Entry *entry;
+		Event event;
+		HANDLE handle;
+	};
+
+	struct Entry
+	{
+		Process *process;
+		Callback callback;
+		Source sources[2];
+		bool removed;
+	};
+
+	Reactor( ) :
+		buffer( chunk_size )
+	{ }
+
+	bool Add( Process &process, const Callback &callback )
+	{
+		if( !process.process || Find( process ) != nullptr )
+			return false;
+
+		std::unique_ptr<Entry> entry( new Entry );
+		entry->process = &process;
+		entry->callback = callback;
+		entry->removed = false;
+		entry->sources[0] = { entry.get( ), Event::Output, process.output_pipe.read_handle ? static_cast<HANDLE>( *process.output_pipe.read_handle ) : nullptr };
+		entry->sources[1] = { entry.get( ), Event::Error, process.error_pipe.read_handle ? static_cast<HANDLE>( *process.error_pipe.read_handle ) : nullptr };
+		entries.push_back( std::move( entry ) );
+		return true;
+	}
+
+	bool Remove( Process &process )
+	{
+		Entry *entry = Find( process );
+		if( entry == nullptr )
+			return false;
+
+		entry->removed = true;
+		return true;
+	}
+
+	size_t Count( ) const
+	{
+		size_t count = 0;
+		for( const std::unique_ptr<Entry> &entry : entries )
+			if( !entry->removed )
+				++count;
+
+		return count;
+	}
+
+	size_t Wait( uint32_t timeout )
+	{
+		Clock::time_point deadline = Clock::now( ) + std::chrono::milliseconds( timeout );
+		size_t produced = 0;
+		while( true )
+		{
+			for( size_t k = 0; k < entries.size( ); ++k )
+			{
+				Entry &entry = *entries[k];
+				if( entry.removed )
+					continue;
+
+				if( WaitForSingleObject( *entry.process->process, 0 ) == WAIT_OBJECT_0 )
+				{
+					produced += Finish( entry );
+					continue;
+				}
+
+				for( Source &source : entry.sources )
+					if( !entry.removed && source.handle != nullptr )
+						produced += ReadChunk( source );
+			}
+
+			Purge( );
+			if( produced != 0 || entries.empty( ) || ( timeout != WAIT_FOREVER && Clock::now( ) >= deadline ) )
+				return produced;
+
+			Sleep( 1 );
+		}
+	}
+
+	bool Next( Notification &notification )
+	{
+		if( queue.empty( ) )
+			return false;
+
+		notification = std::move( queue.front( ) );
+		queue.pop_front( );
+		return true;
+	}
+
+	size_t Pending( ) const
+	{
+		return queue.size( );
+	}
+
+private:
+	Entry *Find( Process &process )
+	{
+		for( std::unique_ptr<Entry> &entry : entries )
+			if( entry->process == &process && !entry->removed )
+				return entry.get( );
+
+		return nullptr;
+	}
+
+	// Entries are only freed here, so callbacks can remove any of them
+	void Purge( )
+	{
+		size_t kept = 0;
+		for( size_t k = 0; k < entries.size( ); ++k )
+			if( !entries[k]->removed )
+				entries[kept++] = std::move( entries[k] );
+
+		entries.resize( kept );
+	}
+
+	void Deliver( Entry &entry, Event event, const uint8_t *data, size_t size, int32_t exit_code )
+	{
+		Notification *notification = &scratch;
+		if( !entry.callback )
+		{
+			queue.emplace_back( );
+			notification = &queue.back( );
+		}
+
+		notification->process = entry.process;
+		notification->event = event;
+		notification->data.assign( data, data + size );
+		notification->exit_code = exit_code;
+		if( entry.callback )
+		{
+			// The callback might remove the entry, it's only freed on Purge
+			Callback callback = entry.callback;
+			callback( *notification );
+		}
+	}
+
+	size_t ReadChunk( Source &source )
+	{
+		DWORD available = 0;
+		if( PeekNamedPipe( source.handle, nullptr, 0, nullptr, &available, nullptr ) == FALSE )
+		{
+			// The other end was closed, nothing else will come from it
+			source.handle = nullptr;
+			return 0;
+		}
+
+		DWORD read = 0;
+		if( available == 0 || ReadFile( source.handle, buffer.data( ), static_cast<DWORD>( std::min<size_t>( available, buffer.size( ) ) ), &read, nullptr ) == FALSE || read == 0 )
+			return 0;
+
+		Deliver( *source.entry, source.event, buffer.data( ), read, 0 );
+		return 1;
+	}
+
+	size_t Finish( Entry &entry )
+	{
+		size_t produced = 0;
+		for( Source &source : entry.sources )
+		{
+			size_t read = 0;
+			while( !entry.removed && source.handle != nullptr && ( read = ReadChunk( source ) ) != 0 )
+				produced += read;
+		}
+
+		if( entry.removed )
+			return produced;
+
+		Process &process = *entry.process;
+		entry.removed = true;
+		process.Close( );
+		Deliver( entry, Event::Exit, nullptr, 0, process.ExitCode( ) );
+		return produced + 1;
+	}
+
+	std::vector<std::unique_ptr<Entry>> entries;
+	std::deque<Notification> queue;
+	std::vector<uint8_t> buffer;
+	Notification scratch;
+};
+
+ProcessGroup::ProcessGroup( ) :
+	reactor( new Reactor( ) )
+{ }
+
+ProcessGroup::~ProcessGroup( )
+{ }
+
+bool ProcessGroup::Add( Process &process, const Callback &callback )
+{
+	return reactor->Add( process, callback );
+}
+
+bool ProcessGroup::Remove( Process &process )
+{
+	return reactor->Remove( process );
+}
+
+size_t ProcessGroup::Count( ) const
+{
+	return reactor->Count( );
+}
+
+size_t ProcessGroup::Wait( uint32_t timeout )
+{
+	return reactor->Wait( timeout );
+}
+
+bool ProcessGroup::Next( Notification &notification )
+{
+	return reactor->Next( notification );
+}
+
+size_t ProcessGroup::Pending( ) const
+{
+	return reactor->Pending( );
+}
+
+} // namespace MultiLibrary
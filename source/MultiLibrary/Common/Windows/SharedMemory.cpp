@@ -0,0 +1,152 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/SharedMemory.hpp>
+#include <atomic>
+#include <chrono>
+#include <system_error>
+#include <thread>
+#include <windows.h>
+
+namespace MultiLibrary
+{
+
+namespace Internal
+{
+
+// Longest sleep between checks of a signal, WaitOnAddress only works
+// between threads of the same process
+static const int64_t poll_interval = 200000;
+
+static void *Map( HANDLE mapping )
+{
+	void *address = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0 );
+	if( address == nullptr )
+	{
+		DWORD error = GetLastError( );
+		CloseHandle( mapping );
+		throw std::system_error( static_cast<int>( error ), std::system_category( ), "failed to map shared memory" );
+	}
+
+	return address;
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Create( size_t size )
+{
+	// Not inheritable until ProcessBuilder maps it
+	uint64_t size64 = size;
+	HANDLE mapping = CreateFileMappingW( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>( size64 >> 32 ), static_cast<DWORD>( size64 ), nullptr );
+	if( mapping == nullptr )
+		throw std::system_error( static_cast<int>( GetLastError( ) ), std::system_category( ), "failed to create shared memory" );
+
+	return std::unique_ptr<SharedMemory>( new SharedMemory( reinterpret_cast<Descriptor>( mapping ), Map( mapping ), size ) );
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open( Descriptor descriptor )
+{
+	HANDLE mapping = reinterpret_cast<HANDLE>( descriptor );
+	SetHandleInformation( mapping, HANDLE_FLAG_INHERIT, 0 );
+	void *address = Map( mapping );
+
+	// Views are rounded up to whole pages, the header tells the real size
+	MEMORY_BASIC_INFORMATION information;
+	if( VirtualQuery( address, &information, sizeof( information ) ) == 0 )
+	{
+		DWORD error = GetLastError( );
+		UnmapViewOfFile( address );
+		CloseHandle( mapping );
+		throw std::system_error( static_cast<int>( error ), std::system_category( ), "failed to open shared memory" );
+	}
+
+	return std::unique_ptr<SharedMemory>( new SharedMemory( descriptor, address, information.RegionSize ) );
+}
+
+SharedMemory::SharedMemory( Descriptor memory_descriptor, void *memory_address, size_t memory_size ) :
+	descriptor( memory_descriptor ),
+	address( memory_address ),
+	size( memory_size )
+{ }
+
+SharedMemory::~SharedMemory( )
+{
+	UnmapViewOfFile( address );
+	CloseHandle( reinterpret_cast<HANDLE>( descriptor ) );
+}
+
+void *SharedMemory::Address( ) const
+{
+	return address;
+}
+
+size_t SharedMemory::Size( ) const
+{
+	return size;
+}
+
+SharedMemory::Descriptor SharedMemory::GetDescriptor( ) const
+{
+	return descriptor;
+}
+
+void SharedMemory::Wait( std::atomic<uint32_t> &signal, uint32_t value, int64_t timeout )
+{
+	if( signal.load( std::memory_order_acquire ) != value )
+		return;
+
+	std::this_thread::sleep_for( std::chrono::nanoseconds( timeout >= 0 && timeout < poll_interval ? timeout : poll_interval ) );
+}
+
+void SharedMemory::Wake( std::atomic<uint32_t> & )
+{ }
+
+uint32_t SharedMemory::GetProcessIdentifier( )
+{
+	return static_cast<uint32_t>( GetCurrentProcessId( ) );
+}
+
+bool SharedMemory::IsRunning( uint32_t identifier )
+{
+	HANDLE process = OpenProcess( SYNCHRONIZE, FALSE, static_cast<DWORD>( identifier ) );
+	if( process == nullptr )
+		return GetLastError( ) != ERROR_INVALID_PARAMETER;
+
+	bool running = WaitForSingleObject( process, 0 ) == WAIT_TIMEOUT;
+	CloseHandle( process );
+	return running;
+}
+
+} // namespace Internal
+
+} // namespace MultiLibrary
@@ -0,0 +1,172 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/Transfer.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <MultiLibrary/Common/Windows/Pipe.hpp>
+#include <algorithm>
+
+namespace MultiLibrary
+{
+
+// Size of the buffer used when data has to go through user space
+static const size_t copy_buffer_size = 128 * 1024;
+
+// One end of a transfer, files being accessed at an explicit offset
+struct End
+{
+	HANDLE handle;
+	InputStream *input;
+	OutputStream *output;
+	bool is_file;
+	uint64_t offset;
+};
+
+static TransferEndpoint::Descriptor ToDescriptor( const std::unique_ptr<Pipe::Handle> &handle )
+{
+	if( !handle )
+		return static_cast<TransferEndpoint::Descriptor>( -1 );
+
+	return reinterpret_cast<TransferEndpoint::Descriptor>( static_cast<HANDLE>( *handle ) );
+}
+
+TransferEndpoint::TransferEndpoint( Pipe &pipe ) :
+	TransferEndpoint( Type::Pipe, ToDescriptor( pipe.read_handle ), ToDescriptor( pipe.write_handle ), &pipe, &pipe, nullptr )
+{ }
+
+static OVERLAPPED MakeOverlapped( uint64_t offset )
+{
+	OVERLAPPED overlapped = { };
+	overlapped.Offset = static_cast<DWORD>( offset );
+	overlapped.OffsetHigh = static_cast<DWORD>( offset >> 32 );
+	return overlapped;
+}
+
+static size_t ReadSome( End &end, void *data, size_t size )
+{
+	if( !end.is_file && end.input != nullptr )
+		return end.input->Read( data, size );
+
+	OVERLAPPED overlapped = MakeOverlapped( end.offset );
+	DWORD read = 0;
+	if( !ReadFile( end.handle, data, static_cast<DWORD>( size ), &read, end.is_file ? &overlapped : nullptr ) )
+		return 0;
+
+	end.offset += read;
+	return read;
+}
+
+static size_t WriteAll( End &end, const uint8_t *data, size_t size )
+{
+	size_t total = 0;
+	while( total < size )
+	{
+		size_t written = 0;
+		if( !end.is_file && end.output != nullptr )
+		{
+			written = end.output->Write( data + total, size - total );
+		}
+		else
+		{
+			OVERLAPPED overlapped = MakeOverlapped( end.offset );
+			DWORD result = 0;
+			if( !WriteFile( end.handle, data + total, static_cast<DWORD>( size - total ), &result, end.is_file ? &overlapped : nullptr ) )
+				break;
+
+			end.offset += result;
+			written = result;
+		}
+
+		if( written == 0 )
+			break;
+
+		total += written;
+	}
+
+	return total;
+}
+
+static End MakeEnd( TransferEndpoint::Descriptor descriptor, InputStream *input, OutputStream *output, Stream *position )
+{
+	End end = { reinterpret_cast<HANDLE>( descriptor ), input, output, position != nullptr, 0 };
+	if( position != nullptr )
+	{
+		// Seeking to the current position flushes whatever the stream buffered
+		end.offset = position->Tell( );
+		position->Seek( static_cast<size_t>( end.offset ) );
+	}
+
+	return end;
+}
+
+size_t Transfer( const TransferEndpoint &source, const TransferEndpoint &sink, size_t size )
+{
+	End from = MakeEnd( source.read_descriptor, source.input, nullptr, source.position );
+	End to = MakeEnd( sink.write_descriptor, nullptr, sink.output, sink.position );
+
+	BufferPool &pool = BufferPool::Default( );
+	BufferPool::Storage storage = pool.Acquire( copy_buffer_size );
+	storage->resize( copy_buffer_size );
+
+	size_t total = 0;
+	while( total < size )
+	{
+		size_t read = ReadSome( from, storage->data( ), std::min( size - total, copy_buffer_size ) );
+		if( read == 0 )
+			break;
+
+		size_t written = WriteAll( to, storage->data( ), read );
+		total += written;
+		if( written != read )
+			break;
+	}
+
+	pool.Release( std::move( storage ) );
+
+	if( from.is_file )
+		source.position->Seek( static_cast<size_t>( from.offset ) );
+
+	if( to.is_file )
+		sink.position->Seek( static_cast<size_t>( to.offset ) );
+
+	return total;
+}
+
+size_t Tee( Pipe &, Pipe &, size_t )
+{
+	return 0;
+}
+
+} // namespace MultiLibrary
@@ -35,14 +35,119 @@
 
 #include <MultiLibrary/Filesystem/File.hpp>
 #include <MultiLibrary/Filesystem/FileInternal.hpp>
+#include <MultiLibrary/Common/Number.hpp>
 #include <cassert>
 #include <cstring>
+#include <cstdio>
+#include <type_traits>
 #include <iostream>
 #include <fstream>
 
 namespace MultiLibrary
 {
 
+static bool IsSpace( char c )
+{
+	return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
+
+static bool IsDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
+
+static bool IsWordPrefix( const char *text, size_t size, const char *word )
+{
+	for( size_t k = 0; k < size; ++k, ++word )
+		if( *word == '\0' || ( text[k] | 0x20 ) != *word )
+			return false;
+
+	return true;
+}
+
+// Tells if a character can extend the number scanned so far, so nothing past
+// the number is consumed, like scanf, which reads a single byte ahead
+static bool ExtendsNumber( const char *text, size_t size, char c, bool floating )
+{
+	size_t sign = size != 0 && ( text[0] == '+' || text[0] == '-' ) ? 1 : 0;
+	if( size == 0 && ( c == '+' || c == '-' ) )
+		return true;
+
+	if( !floating )
+		return IsDigit( c );
+
+	// inf, infinity and nan
+	if( ( size > sign && !IsDigit( text[sign] ) && text[sign] != '.' ) || ( size == sign && !IsDigit( c ) && c != '.' ) )
+	{
+		char word[9];
+		std::memcpy( word, text + sign, size - sign );
+		word[size - sign] = c;
+		return IsWordPrefix( word, size - sign + 1, "infinity" ) || IsWordPrefix( word, size - sign + 1, "nan" );
+	}
+
+	bool digits = false, point = false, exponent = false;
+	for( size_t k = sign; k < size; ++k )
+	{
+		if( IsDigit( text[k] ) && !exponent )
+			digits = true;
+		else if( text[k] == '.' )
+			point = true;
+		else if( text[k] == 'e' || text[k] == 'E' )
+			exponent = true;
+	}
+
+	if( IsDigit( c ) )
+		return true;
+
+	if( c == '.' )
+		return !point && !exponent;
+
+	if( c == 'e' || c == 'E' )
+		return digits && !exponent;
+
+	return ( c == '+' || c == '-' ) && ( text[size - 1] == 'e' || text[size - 1] == 'E' );
+}
+
+// Skips whitespace like scanf did and parses the number that follows,
+// looking a single byte ahead so files that can't seek work too
+template<typename T>
+static bool ScanNumber( FileInternal &file, T &value )
+{
+	char c;
+	int32_t next;
+	while( ( next = file.Peek( ) ) != EOF && IsSpace( static_cast<char>( next ) ) )
+		file.Read( &c, 1 );
+
+	char buffer[256];
+	size_t size = 0;
+	bool floating = std::is_floating_point<T>::value;
+	while( size < sizeof( buffer ) && ( next = file.Peek( ) ) != EOF && ExtendsNumber( buffer, size, static_cast<char>( next ), floating ) )
+		file.Read( &buffer[size++], 1 );
+
+	if( size == sizeof( buffer ) )
+		return false;
+
+	return Number::Parse( buffer, buffer + size, value ) != nullptr;
+}
+
+template<typename Narrow, typename Wide>
+static bool ScanNarrowNumber( FileInternal &file, Narrow &value )
+{
+	Wide wide;
+	if( !ScanNumber( file, wide ) || static_cast<Wide>( static_cast<Narrow>( wide ) ) != wide )
+		return false;
+
+	value = static_cast<Narrow>( wide );
+	return true;
+}
+
+template<typename T>
+static void PrintNumber( File &file, T value )
+{
+	char buffer[Number::max_float_length];
+	file.Write( buffer, Number::Format( value, buffer ) );
+}
+
 File::File( const std::shared_ptr<FileInternal> &file ) :
 	file_internal( file )
 { }
@@ -128,6 +233,14 @@ bool File::Flush( )
 	return false;
 }
 
+TransferEndpoint File::GetTransferEndpoint( )
+{
+	if( file_internal )
+		return TransferEndpoint::FromFile( file_internal->GetDescriptor( ), *this );
+
+	return TransferEndpoint( static_cast<IOStream &>( *this ) );
+}
+
 bool File::Errored( ) const
 {
 	if( file_internal )
@@ -186,7 +299,7 @@ InputStream &File::operator>>( bool &data )
 InputStream &File::operator>>( int8_t &data )
 {
 	int8_t value;
-	if( file_internal && file_internal->Scan( "%hhi", &value ) == 1 )
+	if( file_internal && ScanNarrowNumber<int8_t, int32_t>( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -195,7 +308,7 @@ InputStream &File::operator>>( int8_t &data )
 InputStream &File::operator>>( uint8_t &data )
 {
 	uint8_t value;
-	if( file_internal && file_internal->Scan( "%hhu", &value ) == 1 )
+	if( file_internal && ScanNarrowNumber<uint8_t, uint32_t>( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -204,7 +317,7 @@ InputStream &File::operator>>( uint8_t &data )
 InputStream &File::operator>>( int16_t &data )
 {
 	int16_t value;
-	if( file_internal && file_internal->Scan( "%hi", &value ) == 1 )
+	if( file_internal && ScanNarrowNumber<int16_t, int32_t>( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -213,7 +326,7 @@ InputStream &File::operator>>( int16_t &data )
 InputStream &File::operator>>( uint16_t &data )
 {
 	uint16_t value;
-	if( file_internal && file_internal->Scan( "%hu", &value ) == 1 )
+	if( file_internal && ScanNarrowNumber<uint16_t, uint32_t>( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -222,7 +335,7 @@ InputStream &File::operator>>( uint16_t &data )
 InputStream &File::operator>>( int32_t &data )
 {
 	int32_t value;
-	if( file_internal && file_internal->Scan( "%i", &value ) == 1 )
+	if( file_internal && ScanNumber( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -231,7 +344,7 @@ InputStream &File::operator>>( int32_t &data )
 InputStream &File::operator>>( uint32_t &data )
 {
 	uint32_t value;
-	if( file_internal && file_internal->Scan( "%u", &value ) == 1 )
+	if( file_internal && ScanNumber( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -240,7 +353,7 @@ InputStream &File::operator>>( uint32_t &data )
 InputStream &File::operator>>( int64_t &data )
 {
 	int64_t value;
-	if( file_internal && file_internal->Scan( "%lli", &value ) == 1 )
+	if( file_internal && ScanNumber( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -249,7 +362,7 @@ InputStream &File::operator>>( int64_t &data )
 InputStream &File::operator>>( uint64_t &data )
 {
 	uint64_t value;
-	if( file_internal && file_internal->Scan( "%llu", &value ) == 1 )
+	if( file_internal && ScanNumber( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -258,7 +371,7 @@ InputStream &File::operator>>( uint64_t &data )
 InputStream &File::operator>>( float &data )
 {
 	float value;
-	if( file_internal && file_internal->Scan( "%f", &value ) == 1 )
+	if( file_internal && ScanNumber( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -267,7 +380,7 @@ InputStream &File::operator>>( float &data )
 InputStream &File::operator>>( double &data )
 {
 	double value;
-	if( file_internal && file_internal->Scan( "%lf", &value ) == 1 )
+	if( file_internal && ScanNumber( *file_internal, value ) )
 		data = value;
 
 	return *this;
@@ -358,7 +471,7 @@ OutputStream &File::operator<<( const bool &data )
 OutputStream &File::operator<<( const int8_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%hhi", data );
+		PrintNumber( *this, static_cast<int32_t>( data ) );
 
 	return *this;
 }
@@ -366,7 +479,7 @@ OutputStream &File::operator<<( const int8_t &data )
 OutputStream &File::operator<<( const uint8_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%hhu", data );
+		PrintNumber( *this, static_cast<uint32_t>( data ) );
 
 	return *this;
 }
@@ -374,7 +487,7 @@ OutputStream &File::operator<<( const uint8_t &data )
 OutputStream &File::operator<<( const int16_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%hi", data );
+		PrintNumber( *this, static_cast<int32_t>( data ) );
 
 	return *this;
 }
@@ -382,7 +495,7 @@ OutputStream &File::operator<<( const int16_t &data )
 OutputStream &File::operator<<( const uint16_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%hu", data );
+		PrintNumber( *this, static_cast<uint32_t>( data ) );
 
 	return *this;
 }
@@ -390,7 +503,7 @@ OutputStream &File::operator<<( const uint16_t &data )
 OutputStream &File::operator<<( const int32_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%i", data );
+		PrintNumber( *this, data );
 
 	return *this;
 }
@@ -398,7 +511,7 @@ OutputStream &File::operator<<( const int32_t &data )
 OutputStream &File::operator<<( const uint32_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%u", data );
+		PrintNumber( *this, data );
 
 	return *this;
 }
@@ -406,7 +519,7 @@ OutputStream &File::operator<<( const uint32_t &data )
 OutputStream &File::operator<<( const int64_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%lli", data );
+		PrintNumber( *this, data );
 
 	return *this;
 }
@@ -414,7 +527,7 @@ OutputStream &File::operator<<( const int64_t &data )
 OutputStream &File::operator<<( const uint64_t &data )
 {
 	if( file_internal )
-		file_internal->Print( "%llu", data );
+		PrintNumber( *this, data );
 
 	return *this;
 }
@@ -422,7 +535,7 @@ OutputStream &File::operator<<( const uint64_t &data )
 OutputStream &File::operator<<( const float &data )
 {
 	if( file_internal )
-		file_internal->Print( "%f", data );
+		PrintNumber( *this, data );
 
 	return *this;
 }
@@ -430,7 +543,7 @@ OutputStream &File::operator<<( const float &data )
 OutputStream &File::operator<<( const double &data )
 {
 	if( file_internal )
-		file_internal->Print( "%lf", data );
+		PrintNumber( *this, data );
 
 	return *this;
 }
@@ -37,6 +37,7 @@
 
 #include <MultiLibrary/Filesystem/Export.hpp>
 #include <MultiLibrary/Common/IOStream.hpp>
+#include <MultiLibrary/Common/Transfer.hpp>
 #include <string>
 
 namespace MultiLibrary
@@ -57,9 +58,10 @@ public:
 	virtual bool Flush( ) = 0;
 	virtual bool Errored( ) const = 0;
 	virtual bool EndOfFile( ) const = 0;
+	virtual TransferEndpoint::Descriptor GetDescriptor( ) const = 0;
 
 	virtual size_t Read( void *data, size_t size ) = 0;
-	virtual int32_t Scan( const char *format, ... ) = 0;
+	virtual int32_t Peek( ) = 0;
 	virtual size_t Write( const void *data, size_t size ) = 0;
 	virtual int32_t Print( const char *format, ... ) = 0;
 };
@@ -39,6 +39,12 @@
 #include <cstdarg>
 #include <sys/stat.h>
 
+#if defined _WIN32
+
+	#include <io.h>
+
+#endif
+
 namespace MultiLibrary
 {
 
@@ -148,6 +154,23 @@ bool FileSimple::EndOfFile( ) const
 	return feof( static_cast<FILE *>( file_pointer ) ) != 0;
 }
 
+TransferEndpoint::Descriptor FileSimple::GetDescriptor( ) const
+{
+	if( file_pointer == nullptr )
+		return static_cast<TransferEndpoint::Descriptor>( -1 );
+
+#if defined _WIN32
+
+	return static_cast<TransferEndpoint::Descriptor>( _get_osfhandle( _fileno( static_cast<FILE *>( file_pointer ) ) ) );
+
+#else
+
+	return fileno( static_cast<FILE *>( file_pointer ) );
+
+#endif
+
+}
+
 size_t FileSimple::Read( void *data, size_t size )
 {
 	assert( data != nullptr && size != 0 );
@@ -155,15 +178,14 @@ size_t FileSimple::Read( void *data, size_t size )
 	return fread( data, 1, size, static_cast<FILE *>( file_pointer ) );
 }
 
-int32_t FileSimple::Scan( const char *format, ... )
+int32_t FileSimple::Peek( )
 {
-	assert( format != nullptr );
+	FILE *file = static_cast<FILE *>( file_pointer );
+	int32_t c = fgetc( file );
+	if( c != EOF )
+		ungetc( c, file );
 
-	va_list args;
-	va_start( args, format );
-	int32_t num = vfscanf( static_cast<FILE *>( file_pointer ), format, args );
-	va_end( args );
-	return num;
+	return c;
 }
 
 size_t FileSimple::Write( const void *data, size_t size )
@@ -60,9 +60,10 @@ public:
 	bool Flush( );
 	bool Errored( ) const;
 	bool EndOfFile( ) const;
+	TransferEndpoint::Descriptor GetDescriptor( ) const;
 
 	size_t Read( void *data, size_t size );
-	int32_t Scan( const char *format, ... );
+	int32_t Peek( );
 	size_t Write( const void *data, size_t size );
 	int32_t Print( const char *format, ... );
 
@@ -36,7 +36,9 @@
 #include <MultiLibrary/Filesystem/Filesystem.hpp>
 #include <MultiLibrary/Filesystem/File.hpp>
 #include <MultiLibrary/Filesystem/FileSimple.hpp>
-#include <MultiLibrary/Common/String.hpp>
+#include <MultiLibrary/Common/GlobPattern.hpp>
+#include <algorithm>
+#include <iterator>
 #include <cstdlib>
 #include <cstdio>
 #include <sys/stat.h>
@@ -95,32 +97,53 @@ bool Filesystem::RemoveFile( const std::string &path )
 
 uint64_t Filesystem::Find( const std::string &find, std::vector<std::string> &files, std::vector<std::string> &folders )
 {
-	struct dirent **namelist;
-	int num = scandir( find.c_str( ), &namelist, NULL, alphasort );
-	if( num == -1 )
-		return 0;
-
-	std::string short_find = find;
-	if( short_find.back( ) == '/' )
-		short_find.erase( short_find.size( ) - 1 );
-
+	std::string directory = ".";
+	std::string pattern = find;
 	size_t pos = find.rfind( '/' );
 	if( pos != find.npos )
-		short_find = find.substr( pos + 1 );
-
-	for( std::vector<std::string>::iterator it = files.begin( ); it != files.end( ); ++it )
 	{
-		if( !String::WildcardCompare( *it, find ) )
-			it = files.erase( it );
+		directory = pos != 0 ? find.substr( 0, pos ) : "/";
+		pattern = find.substr( pos + 1 );
 	}
 
-	for( std::vector<std::string>::iterator it = folders.begin( ); it != folders.end( ); ++it )
+	if( pattern.empty( ) )
+		pattern = "*";
+
+	DIR *dir = opendir( directory.c_str( ) );
+	if( dir == NULL )
+		return 0;
+
+	std::vector<std::string> found_files;
+	std::vector<std::string> found_folders;
+	while( struct dirent *entry = readdir( dir ) )
 	{
-		if( !String::WildcardCompare( *it, find ) )
-			it = folders.erase( it );
+		std::string name = entry->d_name;
+		if( name == "." || name == ".." )
+			continue;
+
+		bool folder = entry->d_type == DT_DIR;
+		if( entry->d_type == DT_UNKNOWN )
+			folder = IsFolder( directory + "/" + name );
+
+		if( folder )
+			found_folders.push_back( name );
+		else
+			found_files.push_back( name );
 	}
 
-	return 0;
+	closedir( dir );
+
+	// The pattern is compiled once for every entry of the directory
+	GlobPattern glob( pattern );
+	glob.Filter( found_files );
+	glob.Filter( found_folders );
+
+	std::sort( found_files.begin( ), found_files.end( ) );
+	std::sort( found_folders.begin( ), found_folders.end( ) );
+
+	files.insert( files.end( ), std::make_move_iterator( found_files.begin( ) ), std::make_move_iterator( found_files.end( ) ) );
+	folders.insert( folders.end( ), std::make_move_iterator( found_folders.begin( ) ), std::make_move_iterator( found_folders.end( ) ) );
+	return found_files.size( ) + found_folders.size( );
 }
 
 bool Filesystem::IsFolder( const std::string &path )
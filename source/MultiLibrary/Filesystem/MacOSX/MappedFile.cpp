@@ -0,0 +1,115 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Filesystem/MappedFile.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace MultiLibrary
+{
+
+static int AdviceFromHint( MappedFile::AccessHint hint )
+{
+	switch( hint )
+	{
+	case MappedFile::AccessHint::Sequential:
+		return MADV_SEQUENTIAL;
+
+	case MappedFile::AccessHint::Random:
+		return MADV_RANDOM;
+
+	default:
+		return MADV_NORMAL;
+	}
+}
+
+bool MappedFile::Open( const std::string &path, AccessHint hint, bool populate )
+{
+	Close( );
+
+	int handle = open( path.c_str( ), O_RDONLY | O_CLOEXEC );
+	if( handle == -1 )
+		return false;
+
+	struct stat stats;
+	if( fstat( handle, &stats ) != 0 || !S_ISREG( stats.st_mode ) )
+	{
+		close( handle );
+		return false;
+	}
+
+	size_t size = static_cast<size_t>( stats.st_size );
+	if( size != 0 )
+	{
+		// The mapping stays valid after the descriptor is closed
+		void *data = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0 );
+		close( handle );
+		if( data == MAP_FAILED )
+			return false;
+
+		mapped_data.reset( static_cast<const uint8_t *>( data ), [size]( const uint8_t *mapping )
+		{
+			munmap( const_cast<uint8_t *>( mapping ), size );
+		} );
+	}
+	else
+	{
+		close( handle );
+	}
+
+	mapped_size = size;
+	end_of_file = size == 0;
+	file_path = path;
+	if( hint != AccessHint::Normal )
+		Advise( hint );
+
+	// No MAP_POPULATE here, ask for the pages to be read ahead instead
+	if( populate && mapped_data )
+		madvise( const_cast<uint8_t *>( mapped_data.get( ) ), mapped_size, MADV_WILLNEED );
+
+	return true;
+}
+
+bool MappedFile::Advise( AccessHint hint )
+{
+	if( !mapped_data )
+		return false;
+
+	return madvise( const_cast<uint8_t *>( mapped_data.get( ) ), mapped_size, AdviceFromHint( hint ) ) == 0;
+}
+
+} // namespace MultiLibrary
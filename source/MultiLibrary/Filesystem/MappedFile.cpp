@@ -0,0 +1,173 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Filesystem/MappedFile.hpp>
+#include <cassert>
+#include <cstring>
+
+namespace MultiLibrary
+{
+
+MappedFile::MappedFile( ) :
+	mapped_size( 0 ),
+	read_offset( 0 ),
+	end_of_file( true )
+{ }
+
+MappedFile::MappedFile( const std::string &path, AccessHint hint, bool populate ) :
+	mapped_size( 0 ),
+	read_offset( 0 ),
+	end_of_file( true )
+{
+	Open( path, hint, populate );
+}
+
+void MappedFile::Close( )
+{
+	mapped_data.reset( );
+	mapped_size = 0;
+	read_offset = 0;
+	end_of_file = true;
+	file_path.clear( );
+}
+
+bool MappedFile::IsValid( ) const
+{
+	return !file_path.empty( );
+}
+
+const std::string &MappedFile::GetPath( ) const
+{
+	return file_path;
+}
+
+size_t MappedFile::Tell( ) const
+{
+	return read_offset;
+}
+
+size_t MappedFile::Size( ) const
+{
+	return mapped_size;
+}
+
+bool MappedFile::Seek( size_t position )
+{
+	if( !IsValid( ) )
+		return false;
+
+	read_offset = position < mapped_size ? position : mapped_size;
+	end_of_file = read_offset >= mapped_size;
+	return true;
+}
+
+bool MappedFile::Seek( int64_t position, SeekMode mode )
+{
+	int64_t temp;
+	switch( mode )
+	{
+	case SeekMode::Set:
+		return Seek( static_cast<size_t>( position > 0 ? position : 0 ) );
+
+	case SeekMode::Cur:
+		temp = static_cast<int64_t>( Tell( ) ) + position;
+		return Seek( static_cast<size_t>( temp > 0 ? temp : 0 ) );
+
+	case SeekMode::End:
+		temp = static_cast<int64_t>( Size( ) ) + position;
+		return Seek( static_cast<size_t>( temp > 0 ? temp : 0 ) );
+
+	default:
+		return false;
+	}
+}
+
+bool MappedFile::EndOfFile( ) const
+{
+	return end_of_file;
+}
+
+const uint8_t *MappedFile::GetBuffer( ) const
+{
+	return mapped_data.get( );
+}
+
+ByteBufferView MappedFile::Slice( ) const
+{
+	return Slice( 0, mapped_size );
+}
+
+ByteBufferView MappedFile::Slice( size_t offset, size_t size ) const
+{
+	if( offset > mapped_size )
+		offset = mapped_size;
+
+	if( size > mapped_size - offset )
+		size = mapped_size - offset;
+
+	if( size == 0 )
+		return ByteBufferView( );
+
+	return ByteBufferView( std::shared_ptr<const uint8_t>( mapped_data, mapped_data.get( ) + offset ), size );
+}
+
+size_t MappedFile::Read( void *data, size_t size )
+{
+	assert( data != nullptr && size != 0 );
+
+	if( read_offset >= mapped_size )
+	{
+		end_of_file = true;
+		return 0;
+	}
+
+	size_t clamped = mapped_size - read_offset;
+	if( clamped > size )
+		clamped = size;
+
+	std::memcpy( data, mapped_data.get( ) + read_offset, clamped );
+	read_offset += clamped;
+	if( clamped < size )
+		end_of_file = true;
+
+	return clamped;
+}
+
+size_t MappedFile::Write( const void *, size_t )
+{
+	return 0;
+}
+
+} // namespace MultiLibrary
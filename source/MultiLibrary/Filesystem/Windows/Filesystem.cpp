@@ -37,6 +37,7 @@
 #include <MultiLibrary/Filesystem/File.hpp>
 #include <MultiLibrary/Filesystem/FileSimple.hpp>
 #include <MultiLibrary/Common/Unicode.hpp>
+#include <MultiLibrary/Common/GlobPattern.hpp>
 #include <cstdlib>
 #include <cstdio>
 #include <iterator>
@@ -115,6 +116,19 @@ static bool RemoveFolder( const std::wstring &widepath, bool recursive )
 	return _wrmdir( widepath.c_str( ) ) == 0;
 }
 
+// Lowercases a name with the rules of the system
+static std::string FoldCase( const std::string &name )
+{
+	std::wstring widename;
+	UTF16::FromUTF8( name.begin( ), name.end( ), std::back_inserter( widename ) );
+	if( !widename.empty( ) )
+		CharLowerBuffW( &widename[0], static_cast<DWORD>( widename.size( ) ) );
+
+	std::string folded;
+	UTF8::FromUTF16( widename.begin( ), widename.end( ), std::back_inserter( folded ) );
+	return folded;
+}
+
 }
 
 Filesystem::~Filesystem( )
@@ -174,12 +188,34 @@ bool Filesystem::RemoveFile( const std::string &path )
 
 uint64_t Filesystem::Find( const std::string &find, std::vector<std::string> &files, std::vector<std::string> &folders )
 {
+	// List the whole directory and match it ourselves, FindFirstFileEx
+	// doesn't know about character classes or **
+	std::string directory = ".";
+	std::string pattern = find;
+	size_t pos = find.find_last_of( "/\\" );
+	if( pos != find.npos )
+	{
+		directory = find.substr( 0, pos + 1 );
+		pattern = find.substr( pos + 1 );
+	}
+
+	if( pattern.empty( ) )
+		pattern = "*";
+
 	std::wstring widefind;
-	UTF16::FromUTF8( find.begin( ), find.end( ), std::back_inserter( widefind ) );
+	UTF16::FromUTF8( directory.begin( ), directory.end( ), std::back_inserter( widefind ) );
+	if( pos == find.npos )
+		widefind += L"/";
+
+	widefind += L"*";
 
 	std::vector<std::wstring> wfiles;
 	std::vector<std::wstring> wfolders;
-	uint64_t num_files = Internal::Find( widefind, wfiles, wfolders );
+	Internal::Find( widefind, wfiles, wfolders );
+
+	// Names are matched case insensitively, like FindFirstFileEx does
+	GlobPattern glob( Internal::FoldCase( pattern ) );
+	size_t first_file = files.size( ), first_folder = folders.size( );
 
 	files.reserve( wfiles.size( ) );
 	folders.reserve( wfolders.size( ) );
@@ -189,7 +225,8 @@ uint64_t Filesystem::Find( const std::string &find, std::vector<std::string> &fi
 		std::wstring &wfile = *it;
 		std::string file;
 		UTF8::FromUTF16( wfile.begin( ), wfile.end( ), std::back_inserter( file ) );
-		files.push_back( file );
+		if( glob.Match( Internal::FoldCase( file ) ) )
+			files.push_back( file );
 	}
 
 	for( std::vector<std::wstring>::iterator it = wfolders.begin( ); it != wfolders.end( ); ++it )
@@ -197,10 +234,11 @@ uint64_t Filesystem::Find( const std::string &find, std::vector<std::string> &fi
 		std::wstring &wfolder = *it;
 		std::string folder;
 		UTF8::FromUTF16( wfolder.begin( ), wfolder.end( ), std::back_inserter( folder ) );
-		folders.push_back( folder );
+		if( glob.Match( Internal::FoldCase( folder ) ) )
+			folders.push_back( folder );
 	}
 
-	return num_files;
+	return ( files.size( ) - first_file ) + ( folders.size( ) - first_folder );
 }
 
 bool Filesystem::IsFolder( const std::string &path )
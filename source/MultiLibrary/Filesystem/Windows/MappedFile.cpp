@@ -0,0 +1,104 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Filesystem/MappedFile.hpp>
+#include <MultiLibrary/Common/Unicode.hpp>
+#include <iterator>
+#include <windows.h>
+
+namespace MultiLibrary
+{
+
+bool MappedFile::Open( const std::string &path, AccessHint hint, bool )
+{
+	Close( );
+
+	std::wstring widepath;
+	UTF16::FromUTF8( path.begin( ), path.end( ), std::back_inserter( widepath ) );
+
+	DWORD flags = FILE_ATTRIBUTE_NORMAL;
+	if( hint == AccessHint::Sequential )
+		flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	else if( hint == AccessHint::Random )
+		flags |= FILE_FLAG_RANDOM_ACCESS;
+
+	HANDLE file = CreateFileW( widepath.c_str( ), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr );
+	if( file == INVALID_HANDLE_VALUE )
+		return false;
+
+	LARGE_INTEGER file_size;
+	if( GetFileSizeEx( file, &file_size ) == FALSE )
+	{
+		CloseHandle( file );
+		return false;
+	}
+
+	size_t size = static_cast<size_t>( file_size.QuadPart );
+	if( size != 0 )
+	{
+		HANDLE mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		CloseHandle( file );
+		if( mapping == nullptr )
+			return false;
+
+		// The view stays valid after the mapping handle is closed
+		void *data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		CloseHandle( mapping );
+		if( data == nullptr )
+			return false;
+
+		mapped_data.reset( static_cast<const uint8_t *>( data ), []( const uint8_t *view )
+		{
+			UnmapViewOfFile( view );
+		} );
+	}
+	else
+	{
+		CloseHandle( file );
+	}
+
+	mapped_size = size;
+	end_of_file = size == 0;
+	file_path = path;
+	return true;
+}
+
+bool MappedFile::Advise( AccessHint )
+{
+	// Access hints can only be given when opening files
+	return false;
+}
+
+} // namespace MultiLibrary
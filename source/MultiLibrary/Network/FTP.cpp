@@ -35,6 +35,8 @@
 
 #include <MultiLibrary/Network/FTP.hpp>
 #include <MultiLibrary/Common/NonCopyable.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <MultiLibrary/Common/ByteBuffer.hpp>
 #include <fstream>
 #include <sstream>
 #include <iterator>
@@ -42,6 +44,8 @@
 namespace MultiLibrary
 {
 
+static const size_t receive_chunk_size = 16384;
+
 class FTP::DataChannel : public NonCopyable
 {
 public:
@@ -109,14 +113,20 @@ public:
 		socket.Close( );
 	}
 
-	void Receive( std::vector<char> &data )
+	void Receive( ByteBuffer &data )
 	{
-		data.clear( );
-		char buffer[1024];
-		int32_t received;
-		while( !socket.Receive( buffer, sizeof( buffer ), 0, &received ) )
-			std::copy( buffer, buffer + received, std::back_inserter( data ) );
+		size_t size = 0;
+		int32_t received = 0;
+		for( ;; )
+		{
+			data.Resize( size + receive_chunk_size );
+			if( socket.Receive( data.GetBuffer( ) + size, static_cast<int32_t>( receive_chunk_size ), 0, &received ) || received <= 0 )
+				break;
+
+			size += static_cast<size_t>( received );
+		}
 
+		data.Resize( size );
 		socket.Close( );
 	}
 
@@ -245,7 +255,9 @@ FTP::ListingResponse FTP::GetDirectoryListing( const std::string &directory )
 		response = SendCommand( "NLST", directory );
 		if( response.IsOK( ) )
 		{
-			data.Receive( directoryData );
+			ByteBuffer received( BufferPool::Default( ), receive_chunk_size );
+			data.Receive( received );
+			directoryData.assign( received.GetBuffer( ), received.GetBuffer( ) + received.Size( ) );
 			response = GetResponse( );
 		}
 	}
@@ -289,7 +301,7 @@ FTP::Response FTP::Download(
 		response = SendCommand( "RETR", remoteFile );
 		if( response.IsOK( ) )
 		{
-			std::vector<char> fileData;
+			ByteBuffer fileData( BufferPool::Default( ), receive_chunk_size );
 			data.Receive( fileData );
 
 			response = GetResponse( );
@@ -308,8 +320,8 @@ FTP::Response FTP::Download(
 				if( !file )
 					return Response( Response::InvalidFile );
 
-				if( !fileData.empty( ) )
-					file.write( &fileData[0], static_cast<std::streamsize>( fileData.size( ) ) );
+				if( fileData.Size( ) != 0 )
+					file.write( reinterpret_cast<const char *>( fileData.GetBuffer( ) ), static_cast<std::streamsize>( fileData.Size( ) ) );
 			}
 		}
 	}
@@ -35,9 +35,12 @@
 
 #include <MultiLibrary/Network/HTTP.hpp>
 #include <MultiLibrary/Network/SocketTCP.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <MultiLibrary/Common/ByteBuffer.hpp>
+#include <MultiLibrary/Common/Number.hpp>
+#include <algorithm>
 #include <cctype>
-#include <sstream>
-#include <iterator>
+#include <cstring>
 
 namespace MultiLibrary
 {
@@ -82,34 +85,44 @@ bool HTTP::Request::HasField( const std::string &key ) const
 
 std::string HTTP::Request::BuildRequest( ) const
 {
-	std::ostringstream out;
+	std::string out;
 
 	switch( method )
 	{
 		default:
 		case Get:
-			out << "GET ";
+			out += "GET ";
 			break;
 
 		case Post:
-			out << "POST ";
+			out += "POST ";
 			break;
 
 		case Head:
-			out << "HEAD ";
+			out += "HEAD ";
 			break;
 	}
 
-	out << uri << " HTTP/" << majorVersion << "." << minorVersion << "\r\n";
+	char number[Number::max_integer_length];
+	out += uri;
+	out += " HTTP/";
+	out.append( number, Number::Format( majorVersion, number ) );
+	out += '.';
+	out.append( number, Number::Format( minorVersion, number ) );
+	out += "\r\n";
 
-	std::map<std::string, std::string>::const_iterator i;
+	FieldMap::const_iterator i;
 	for( i = fields.begin( ); i != fields.end( ); ++i )
 	{
-		out << i->first << ": " << i->second << "\r\n";
+		out += i->first;
+		out += ": ";
+		out += i->second;
+		out += "\r\n";
 	}
 
-	out << "\r\n" << body;
-	return out.str( );
+	out += "\r\n";
+	out += body;
+	return out;
 }
 
 HTTP::Response::Response( ) :
@@ -140,7 +153,7 @@ const std::string &HTTP::Response::GetBody( ) const
 
 const std::string &HTTP::Response::GetField( const std::string &key ) const
 {
-	std::map<std::string, std::string>::const_iterator it = fields.find( key );
+	FieldMap::const_iterator it = fields.find( key );
 	if( it != fields.end( ) )
 	{
 		return it->second;
@@ -154,24 +167,30 @@ const std::string &HTTP::Response::GetField( const std::string &key ) const
 
 void HTTP::Response::ParseResponse( const std::string &data )
 {
-	std::istringstream in( data );
-	std::string version;
-	if( in >> version )
+	const char *it = data.data( );
+	const char *end = it + data.size( );
+	while( it != end && std::isspace( static_cast<unsigned char>( *it ) ) )
+		++it;
+
+	uint32_t major = 0;
+	uint32_t minor = 0;
+	if( end - it < 6 || std::memcmp( it, "HTTP/", 5 ) != 0 || !std::isdigit( static_cast<unsigned char>( it[5] ) ) ||
+		( it = Number::Parse( it + 5, end, major ) ) == nullptr || it == end || *it != '.' ||
+		( it = Number::Parse( it + 1, end, minor ) ) == nullptr )
 	{
-		if( version.size( ) >= 8 && version[6] == '.' && version.substr( 0, 5 ) == "HTTP/" && std::isdigit( version[5] ) && std::isdigit( version[7] ) )
-		{
-			majorVersion = version[5] - '0';
-			minorVersion = version[7] - '0';
-		}
-		else
-		{
-			status = InvalidResponse;
-			return;
-		}
+		status = InvalidResponse;
+		return;
 	}
 
+	majorVersion = major;
+	minorVersion = minor;
+
+	while( it != end && ( *it == ' ' || *it == '\t' ) )
+		++it;
+
 	int32_t stat;
-	if( in >> stat )
+	it = Number::Parse( it, end, stat );
+	if( it != nullptr )
 	{
 		status = static_cast<Status>( stat );
 	}
@@ -181,26 +200,34 @@ void HTTP::Response::ParseResponse( const std::string &data )
 		return;
 	}
 
-	in.ignore( 10000, '\n' );
+	const char *line_end = std::find( it, end, '\n' );
+	it = line_end != end ? line_end + 1 : end;
 
-	std::string line;
-	while( std::getline( in, line ) && line.size( ) > 2 )
+	static const char separator[] = ": ";
+	for( ; ; )
 	{
-		std::string::size_type pos = line.find( ": " );
-		if( pos != std::string::npos )
+		line_end = std::find( it, end, '\n' );
+		const char *next = line_end != end ? line_end + 1 : end;
+		if( line_end - it <= 2 )
 		{
-			std::string field = line.substr( 0, pos );
-			std::string value = line.substr( pos + 2 );
+			it = next;
+			break;
+		}
 
-			if( !value.empty( ) && *value.rbegin( ) == '\r' )
-				value.erase( value.size( ) - 1 );
+		const char *pos = std::search( it, line_end, separator, separator + 2 );
+		if( pos != line_end )
+		{
+			const char *value_end = line_end;
+			if( *( value_end - 1 ) == '\r' && value_end - 1 >= pos + 2 )
+				--value_end;
 
-			fields[field] = value;
+			fields[std::string( it, pos )].assign( pos + 2, value_end );
 		}
+
+		it = next;
 	}
 
-	body.clear( );
-	std::copy( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>( ), std::back_inserter( body ) );
+	body.assign( it, end );
 }
 
 HTTP::HTTP( ) { }
@@ -251,9 +278,8 @@ HTTP::Response HTTP::SendRequest( const HTTP::Request &request, uint32_t timeout
 
 	if( !req.HasField( "Content-Length" ) )
 	{
-		std::ostringstream out;
-		out << req.body.size( );
-		req.SetField( "Content-Length", out.str( ) );
+		char length[Number::max_integer_length];
+		req.SetField( "Content-Length", std::string( length, Number::Format( static_cast<uint64_t>( req.body.size( ) ), length ) ) );
 	}
 
 	if( ( req.method == Request::Post ) && !req.HasField( "Content-Type" ) )
@@ -272,19 +298,24 @@ HTTP::Response HTTP::SendRequest( const HTTP::Request &request, uint32_t timeout
 		if( !reqString.empty( ) &&
 			!connection.Send( reqString.c_str( ), static_cast<int32_t>( reqString.size( ) ), 0 ) )
 		{
-			std::string received;
+			static const size_t chunk_size = 16384;
+
+			ByteBuffer received( BufferPool::Default( ), chunk_size );
+			size_t received_size = 0;
 			int32_t size = 0;
-			char buffer[1024];
-			while( !connection.Receive( buffer, sizeof( buffer ), 0, &size ) )
+			for( ;; )
 			{
-				received.append( buffer, buffer + size );
-				if( size < static_cast<int32_t>( sizeof( buffer ) ) )
-				{
+				received.Resize( received_size + chunk_size );
+				if( connection.Receive( received.GetBuffer( ) + received_size, static_cast<int32_t>( chunk_size ), 0, &size ) || size <= 0 )
+					break;
+
+				received_size += static_cast<size_t>( size );
+				if( size < static_cast<int32_t>( chunk_size ) )
 					break;
-				}
 			}
 
-			response.ParseResponse( received );
+			const char *data = reinterpret_cast<const char *>( received.GetBuffer( ) );
+			response.ParseResponse( std::string( data, data + received_size ) );
 		}
 
 		connection.Shutdown( 2 );
@@ -35,6 +35,7 @@
 
 #include <MultiLibrary/Network/Socket.hpp>
 #include <MultiLibrary/Common/ByteBuffer.hpp>
+#include <MultiLibrary/Common/ChainedBuffer.hpp>
 
 #if defined _WIN32
 
@@ -49,6 +50,7 @@
 	#include <cstring>
 	#include <errno.h>
 	#include <sys/socket.h>
+	#include <sys/uio.h>
 	#include <netdb.h>
 	#include <netinet/in.h>
 	#include <arpa/inet.h>
@@ -64,6 +66,9 @@
 namespace MultiLibrary
 {
 
+// Maximum amount of ChainedBuffer segments handed to a single scatter/gather call
+static const size_t max_segments = 64;
+
 #if defined _WIN32
 
 namespace Internal
@@ -233,6 +238,56 @@ SocketError Socket::Receive( ByteBuffer &buffer, int32_t flags )
 	return ret == SOCKET_ERROR ? GetSocketError( ) : 0;
 }
 
+SocketError Socket::Receive( ChainedBuffer &buffer, int32_t size, int32_t flags, int32_t *received_bytes )
+{
+	if( !IsValid( ) )
+		return ENOTSOCK;
+
+	ChainedBuffer::Segment segments[max_segments];
+	size_t count = buffer.PrepareSegments( static_cast<size_t>( size ), segments, max_segments );
+
+#if defined _WIN32
+
+	WSABUF buffers[max_segments];
+	for( size_t k = 0; k < count; ++k )
+	{
+		buffers[k].buf = reinterpret_cast<char *>( segments[k].data );
+		buffers[k].len = static_cast<ULONG>( segments[k].size );
+	}
+
+	DWORD received = 0;
+	DWORD recv_flags = static_cast<DWORD>( flags );
+	int32_t ret = WSARecv( socket_id, buffers, static_cast<DWORD>( count ), &received, &recv_flags, nullptr, nullptr );
+	if( ret != SOCKET_ERROR )
+		ret = static_cast<int32_t>( received );
+
+#else
+
+	iovec buffers[max_segments];
+	for( size_t k = 0; k < count; ++k )
+	{
+		buffers[k].iov_base = segments[k].data;
+		buffers[k].iov_len = segments[k].size;
+	}
+
+	msghdr message;
+	std::memset( &message, 0, sizeof( message ) );
+	message.msg_iov = buffers;
+	message.msg_iovlen = count;
+	int32_t ret = static_cast<int32_t>( recvmsg( socket_id, &message, flags ) );
+
+#endif
+
+	if( ret != SOCKET_ERROR )
+	{
+		buffer.Commit( static_cast<size_t>( ret ) );
+		if( received_bytes != nullptr )
+			*received_bytes = ret;
+	}
+
+	return ret == SOCKET_ERROR ? GetSocketError( ) : 0;
+}
+
 SocketError Socket::ReceiveFrom( void *buffer, int32_t size, int32_t flags, IPAddress &address, int32_t *received_bytes )
 {
 	if( !IsValid( ) )
@@ -322,6 +377,51 @@ SocketError Socket::Send( const ByteBuffer &buffer, int32_t flags, int32_t *sent
 	return ret == SOCKET_ERROR ? GetSocketError( ) : 0;
 }
 
+SocketError Socket::Send( const ChainedBuffer &buffer, int32_t flags, int32_t *sent_bytes )
+{
+	if( !IsValid( ) )
+		return ENOTSOCK;
+
+	ChainedBuffer::Segment segments[max_segments];
+	size_t count = buffer.GetSegments( segments, max_segments );
+
+#if defined _WIN32
+
+	WSABUF buffers[max_segments];
+	for( size_t k = 0; k < count; ++k )
+	{
+		buffers[k].buf = reinterpret_cast<char *>( segments[k].data );
+		buffers[k].len = static_cast<ULONG>( segments[k].size );
+	}
+
+	DWORD sent = 0;
+	int32_t ret = WSASend( socket_id, buffers, static_cast<DWORD>( count ), &sent, static_cast<DWORD>( flags ), nullptr, nullptr );
+	if( ret != SOCKET_ERROR )
+		ret = static_cast<int32_t>( sent );
+
+#else
+
+	iovec buffers[max_segments];
+	for( size_t k = 0; k < count; ++k )
+	{
+		buffers[k].iov_base = segments[k].data;
+		buffers[k].iov_len = segments[k].size;
+	}
+
+	msghdr message;
+	std::memset( &message, 0, sizeof( message ) );
+	message.msg_iov = buffers;
+	message.msg_iovlen = count;
+	int32_t ret = static_cast<int32_t>( sendmsg( socket_id, &message, flags ) );
+
+#endif
+
+	if( ret != SOCKET_ERROR && sent_bytes != nullptr )
+		*sent_bytes = ret;
+
+	return ret == SOCKET_ERROR ? GetSocketError( ) : 0;
+}
+
 SocketError Socket::SendTo( const void *buffer, int32_t size, int32_t flags, const IPAddress &address, int32_t *sent_bytes )
 {
 	if( !IsValid( ) )
@@ -73,6 +73,11 @@ bool SocketTCP::Open( )
 	return socket_id != INVALID_SOCKET;
 }
 
+TransferEndpoint SocketTCP::GetTransferEndpoint( ) const
+{
+	return TransferEndpoint::FromSocket( socket_id );
+}
+
 SocketType SocketTCP::Type( ) const
 {
 	return TCP;
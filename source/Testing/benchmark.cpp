@@ -0,0 +1,654 @@
+/*************************************************************************
+ * MultiLibrary - https://danielga.github.io/multilibrary/
+ * A C++ library that covers multiple low level systems.
+ *------------------------------------------------------------------------
+ * Copyright (c) 2014-2022, Daniel Almeida
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#include <MultiLibrary/Common/ByteBuffer.hpp>
+#include <MultiLibrary/Common/CompressingOutputStream.hpp>
+#include <MultiLibrary/Common/DecompressingInputStream.hpp>
+#include <MultiLibrary/Common/GlobPattern.hpp>
+#include <MultiLibrary/Common/Number.hpp>
+#include <MultiLibrary/Common/Pipe.hpp>
+#include <MultiLibrary/Common/Process.hpp>
+#include <MultiLibrary/Common/ProcessPool.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <MultiLibrary/Common/Stopwatch.hpp>
+#include <MultiLibrary/Common/String.hpp>
+#include <MultiLibrary/Common/Transfer.hpp>
+#include <MultiLibrary/Common/Unicode.hpp>
+
+#include <MultiLibrary/Filesystem/Filesystem.hpp>
+#include <MultiLibrary/Filesystem/File.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+#include <random>
+#include <iterator>
+#include <thread>
+
+#if !defined _WIN32
+
+	#include <unistd.h>
+	#include <sys/wait.h>
+
+#endif
+
+static const size_t payload_size = 64 * 1024 * 1024;
+
+static void Report( const std::string &name, size_t bytes, double milliseconds )
+{
+	std::cout << std::left << std::setw( 40 ) << name << std::right << std::fixed << std::setprecision( 1 )
+		<< std::setw( 10 ) << bytes / ( milliseconds / 1000.0 ) / ( 1024.0 * 1024.0 ) << " MB/s\n";
+}
+
+static void ReportLatency( const std::string &name, size_t operations, double milliseconds )
+{
+	std::cout << std::left << std::setw( 40 ) << name << std::right << std::fixed << std::setprecision( 1 )
+		<< std::setw( 10 ) << milliseconds * 1000.0 / operations << " us/op\n";
+}
+
+// Mix of repetitive text-like data and noise, roughly like real payloads
+static std::vector<uint8_t> MakePayload( size_t size )
+{
+	static const char words[] = "the quick brown fox jumps over the lazy dog while multilibrary streams data ";
+	std::mt19937 generator( 1337 );
+	std::vector<uint8_t> payload( size );
+	for( size_t k = 0; k < size; ++k )
+		payload[k] = ( k / 4096 ) % 4 == 3 ? static_cast<uint8_t>( generator( ) ) : static_cast<uint8_t>( words[( k * 7 + k / 97 ) % ( sizeof( words ) - 1 )] );
+
+	return payload;
+}
+
+static void BenchmarkCompression( )
+{
+	std::vector<uint8_t> payload = MakePayload( payload_size );
+	std::vector<uint8_t> output( payload_size );
+	ML::Stopwatch stopwatch;
+
+	{
+		ML::ByteBuffer buffer;
+		buffer.Reserve( payload_size );
+		stopwatch.Resume( );
+		buffer.Write( payload.data( ), payload.size( ) );
+		buffer.Seek( 0 );
+		buffer.Read( output.data( ), output.size( ) );
+		stopwatch.Pause( );
+		Report( "ByteBuffer copy in/out", payload_size, stopwatch.GetElapsedTime( ) );
+	}
+
+	ML::ByteBuffer compressed;
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	{
+		ML::CompressingOutputStream stream( compressed );
+		stream.Write( payload.data( ), payload.size( ) );
+		stream.Finish( );
+		stopwatch.Pause( );
+		Report( "CompressingOutputStream", payload_size, stopwatch.GetElapsedTime( ) );
+		std::cout << "  ratio " << std::setprecision( 3 ) << static_cast<double>( stream.CompressedSize( ) ) / payload_size << "\n";
+	}
+
+	compressed.Seek( 0 );
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	{
+		ML::DecompressingInputStream stream( compressed );
+		size_t read = stream.Read( output.data( ), output.size( ) );
+		stopwatch.Pause( );
+		Report( "DecompressingInputStream", read, stopwatch.GetElapsedTime( ) );
+		if( read != payload_size || output != payload )
+			std::cout << "  round trip mismatch\n";
+	}
+}
+
+// Mostly ASCII text with some Greek and emoji, like typical markup or JSON
+static std::string MakeText( size_t size )
+{
+	static const char *pieces[] = { "<p class=\"content\">", "the quick brown fox ", "κόσμε ", "\xF0\x9F\x98\x80 ", "jumps over the lazy dog</p>\n" };
+	std::mt19937 generator( 1337 );
+	std::string text;
+	text.reserve( size + 64 );
+	while( text.size( ) < size )
+		text += pieces[generator( ) % 5];
+
+	return text;
+}
+
+static void BenchmarkUnicode( )
+{
+	std::string text = MakeText( payload_size );
+	const char *begin = text.data( ), *end = text.data( ) + text.size( );
+	ML::Stopwatch stopwatch;
+
+	{
+		std::u16string output;
+		stopwatch.Resume( );
+		ML::UTF8::ToUTF16( begin, end, std::back_inserter( output ) );
+		stopwatch.Pause( );
+		Report( "UTF8::ToUTF16 (iterator)", text.size( ), stopwatch.GetElapsedTime( ) );
+	}
+
+	std::u16string utf16( text.size( ), u'\0' );
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	utf16.resize( ML::UTF8::ConvertToUTF16( begin, end, &utf16[0] ) - utf16.data( ) );
+	stopwatch.Pause( );
+	Report( "UTF8::ConvertToUTF16", text.size( ), stopwatch.GetElapsedTime( ) );
+
+	std::string utf8( utf16.size( ) * 3, '\0' );
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	utf8.resize( ML::UTF16::ConvertToUTF8( utf16.data( ), utf16.data( ) + utf16.size( ), &utf8[0] ) - utf8.data( ) );
+	stopwatch.Pause( );
+	Report( "UTF16::ConvertToUTF8", text.size( ), stopwatch.GetElapsedTime( ) );
+	if( utf8 != text )
+		std::cout << "  round trip mismatch\n";
+
+	uint32_t codepoint = 0, checksum = 0;
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( const char *it = begin; it != end; checksum += codepoint )
+		it = ML::UTF8::Decode( it, end, codepoint );
+	stopwatch.Pause( );
+	Report( "UTF8::Decode loop", text.size( ), stopwatch.GetElapsedTime( ) );
+
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	bool valid = ML::UTF8::Validate( begin, end );
+	stopwatch.Pause( );
+	Report( "UTF8::Validate", text.size( ), stopwatch.GetElapsedTime( ) );
+	if( !valid || checksum == 0 )
+		std::cout << "  validation mismatch\n";
+
+	const std::string path = "/home/user/projects/multilibrary/κόσμε/source/file.cpp";
+	const size_t conversions = 1000000;
+	for( int caching = 0; caching < 2; ++caching )
+	{
+		ML::String str = ML::String::FromUTF8( path.begin( ), path.end( ) );
+		str.SetCaching( caching != 0 );
+		std::wstring wide;
+		stopwatch.Reset( );
+		stopwatch.Resume( );
+		for( size_t k = 0; k < conversions; ++k )
+			str.ToWideString( wide );
+		stopwatch.Pause( );
+		Report( caching != 0 ? "String::ToWideString (cached)" : "String::ToWideString", path.size( ) * conversions, stopwatch.GetElapsedTime( ) );
+	}
+}
+
+static void BenchmarkGlob( )
+{
+	std::vector<std::string> names;
+	for( size_t k = 0; k < 100000; ++k )
+		names.push_back( "source/module" + std::to_string( k % 97 ) + "/file_" + std::to_string( k ) + ( k % 3 == 0 ? ".cpp" : ".hpp" ) );
+
+	size_t bytes = 0;
+	for( const std::string &name : names )
+		bytes += name.size( );
+
+	const std::string pattern = "source/*/*_*1*.cpp";
+	ML::Stopwatch stopwatch;
+	size_t wildcard_matches = 0, glob_matches = 0;
+
+	stopwatch.Resume( );
+	for( const std::string &name : names )
+		wildcard_matches += ML::String::WildcardCompare( name, pattern ) ? 1 : 0;
+	stopwatch.Pause( );
+	Report( "String::WildcardCompare", bytes, stopwatch.GetElapsedTime( ) );
+
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	ML::GlobPattern glob( pattern );
+	for( const std::string &name : names )
+		glob_matches += glob.Match( name ) ? 1 : 0;
+	stopwatch.Pause( );
+	Report( "GlobPattern::Match", bytes, stopwatch.GetElapsedTime( ) );
+	if( wildcard_matches != glob_matches )
+		std::cout << "  match count mismatch\n";
+}
+
+// Converts the same short string from several threads at once, where the
+// locale overloads contend on the global locale
+template<typename Function>
+static double RunThreads( size_t threads, const Function &function )
+{
+	ML::Stopwatch stopwatch;
+	std::vector<std::thread> workers;
+	stopwatch.Resume( );
+	for( size_t k = 0; k < threads; ++k )
+		workers.emplace_back( function );
+
+	for( std::thread &worker : workers )
+		worker.join( );
+
+	stopwatch.Pause( );
+	return stopwatch.GetElapsedTime( );
+}
+
+static void BenchmarkANSI( )
+{
+	const std::string text = "C:/Users/someone/Documents/report_2024_final (copy).docx";
+	const size_t conversions = 200000;
+	size_t hardware_threads = std::max<size_t>( std::thread::hardware_concurrency( ), 2 );
+	for( size_t threads = 1; threads <= hardware_threads; threads = threads == 1 ? hardware_threads : threads + 1 )
+	{
+		size_t bytes = text.size( ) * conversions * threads;
+		double locale_time = RunThreads( threads, [&text, conversions] ( )
+		{
+			std::string output;
+			for( size_t k = 0; k < conversions; ++k )
+			{
+				output.clear( );
+				ML::UTF8::FromANSI( text.begin( ), text.end( ), std::back_inserter( output ) );
+			}
+		} );
+		Report( "UTF8::FromANSI (std::locale) x" + std::to_string( threads ), bytes, locale_time );
+
+		double codec_time = RunThreads( threads, [&text, conversions] ( )
+		{
+			const ML::ANSICodec &codec = ML::ANSICodec::GetDefault( );
+			std::string output;
+			for( size_t k = 0; k < conversions; ++k )
+			{
+				output.clear( );
+				codec.ToUTF8( text.data( ), text.data( ) + text.size( ), output );
+			}
+		} );
+		Report( "ANSICodec::ToUTF8 x" + std::to_string( threads ), bytes, codec_time );
+	}
+}
+
+// Formats and parses the same values with the C library and Number, the
+// rate is measured over the amount of text produced
+static void BenchmarkNumbers( )
+{
+	const size_t count = 1000000;
+	std::mt19937_64 generator( 1337 );
+	std::uniform_real_distribution<double> distribution( -1e6, 1e6 );
+	std::vector<double> doubles( count );
+	std::vector<int64_t> integers( count );
+	for( size_t k = 0; k < count; ++k )
+	{
+		doubles[k] = distribution( generator );
+		integers[k] = static_cast<int64_t>( generator( ) ) >> ( k % 48 );
+	}
+
+	std::vector<char> text( count * ML::Number::max_float_length );
+	std::vector<size_t> lengths( count );
+	size_t bytes = 0;
+	ML::Stopwatch stopwatch;
+
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+		bytes += static_cast<size_t>( std::snprintf( &text[k * ML::Number::max_float_length], ML::Number::max_float_length, "%.17g", doubles[k] ) );
+	stopwatch.Pause( );
+	Report( "snprintf (double)", bytes, stopwatch.GetElapsedTime( ) );
+
+	bytes = 0;
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+		bytes += lengths[k] = ML::Number::Format( doubles[k], &text[k * ML::Number::max_float_length] );
+	stopwatch.Pause( );
+	Report( "Number::Format (double)", bytes, stopwatch.GetElapsedTime( ) );
+
+	for( size_t k = 0; k < count; ++k )
+		text[k * ML::Number::max_float_length + lengths[k]] = '\0';
+
+	std::vector<double> scanned_doubles( count );
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+		std::sscanf( &text[k * ML::Number::max_float_length], "%lf", &scanned_doubles[k] );
+	stopwatch.Pause( );
+	Report( "sscanf (double)", bytes, stopwatch.GetElapsedTime( ) );
+
+	double value = 0;
+	size_t mismatches = 0;
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+	{
+		const char *begin = &text[k * ML::Number::max_float_length];
+		if( ML::Number::Parse( begin, begin + lengths[k], value ) == nullptr || value != scanned_doubles[k] )
+			++mismatches;
+	}
+	stopwatch.Pause( );
+	Report( "Number::Parse (double)", bytes, stopwatch.GetElapsedTime( ) );
+
+	bytes = 0;
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+		bytes += static_cast<size_t>( std::snprintf( &text[k * ML::Number::max_float_length], ML::Number::max_float_length, "%lld", static_cast<long long>( integers[k] ) ) );
+	stopwatch.Pause( );
+	Report( "snprintf (int64_t)", bytes, stopwatch.GetElapsedTime( ) );
+
+	bytes = 0;
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+		bytes += lengths[k] = ML::Number::Format( integers[k], &text[k * ML::Number::max_float_length] );
+	stopwatch.Pause( );
+	Report( "Number::Format (int64_t)", bytes, stopwatch.GetElapsedTime( ) );
+
+	int64_t parsed = 0;
+
+	for( size_t k = 0; k < count; ++k )
+		text[k * ML::Number::max_float_length + lengths[k]] = '\0';
+
+	std::vector<long long> scanned_integers( count );
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+		std::sscanf( &text[k * ML::Number::max_float_length], "%lld", &scanned_integers[k] );
+	stopwatch.Pause( );
+	Report( "sscanf (int64_t)", bytes, stopwatch.GetElapsedTime( ) );
+
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < count; ++k )
+	{
+		const char *begin = &text[k * ML::Number::max_float_length];
+		if( ML::Number::Parse( begin, begin + lengths[k], parsed ) == nullptr || parsed != scanned_integers[k] )
+			++mismatches;
+	}
+	stopwatch.Pause( );
+	Report( "Number::Parse (int64_t)", bytes, stopwatch.GetElapsedTime( ) );
+	if( mismatches != 0 )
+		std::cout << "  parsed values mismatch\n";
+}
+
+// Header lookups with names in whatever case the peer used, either folded
+// into a copy first or compared in place
+static void BenchmarkCaseInsensitive( )
+{
+	static const char *const names[] = {
+		"Content-Type", "Content-Length", "Cache-Control", "Accept-Encoding", "User-Agent", "Host",
+		"Connection", "X-Forwarded-For", "Authorization", "If-None-Match", "Last-Modified", "Transfer-Encoding"
+	};
+	const size_t lookups = 2000000;
+	std::map<std::string, std::string> folded_headers;
+	std::map<std::string, std::string, ML::CaseInsensitiveLess> headers;
+	std::vector<std::string> queries;
+	for( const char *name : names )
+	{
+		std::string lower( name );
+		ML::String::ToLowerASCII( lower.data( ), lower.size( ), &lower[0] );
+		folded_headers[lower] = name;
+		headers[name] = name;
+
+		std::string upper( name );
+		std::transform( upper.begin( ), upper.end( ), upper.begin( ), ::toupper );
+		queries.push_back( upper );
+	}
+
+	size_t bytes = 0;
+	for( size_t k = 0; k < lookups; ++k )
+		bytes += queries[k % queries.size( )].size( );
+
+	size_t folded_hits = 0, hits = 0;
+	ML::Stopwatch stopwatch;
+	stopwatch.Resume( );
+	for( size_t k = 0; k < lookups; ++k )
+	{
+		std::string key = queries[k % queries.size( )];
+		std::transform( key.begin( ), key.end( ), key.begin( ), ::tolower );
+		folded_hits += folded_headers.count( key );
+	}
+	stopwatch.Pause( );
+	Report( "std::map (tolower copy)", bytes, stopwatch.GetElapsedTime( ) );
+
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	for( size_t k = 0; k < lookups; ++k )
+		hits += headers.count( queries[k % queries.size( )] );
+	stopwatch.Pause( );
+	Report( "std::map (CaseInsensitiveLess)", bytes, stopwatch.GetElapsedTime( ) );
+	if( folded_hits != hits || hits != lookups )
+		std::cout << "  lookup count mismatch\n";
+
+	std::string text = MakeText( payload_size / 4 );
+	std::vector<char> lowered( text.size( ) );
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	std::transform( text.begin( ), text.end( ), lowered.begin( ), ::tolower );
+	stopwatch.Pause( );
+	Report( "std::transform tolower", text.size( ), stopwatch.GetElapsedTime( ) );
+
+	stopwatch.Reset( );
+	stopwatch.Resume( );
+	ML::String::ToLowerASCII( text.data( ), text.size( ), lowered.data( ) );
+	stopwatch.Pause( );
+	Report( "String::ToLowerASCII", text.size( ), stopwatch.GetElapsedTime( ) );
+}
+
+static size_t CopyWithBuffer( ML::InputStream &source, ML::OutputStream &sink )
+{
+	std::vector<uint8_t> buffer( 128 * 1024 );
+	size_t total = 0, read = 0;
+	while( ( read = source.Read( buffer.data( ), buffer.size( ) ) ) != 0 )
+		total += sink.Write( buffer.data( ), read );
+
+	return total;
+}
+
+static void BenchmarkTransfer( )
+{
+	std::vector<uint8_t> payload = MakePayload( payload_size );
+	ML::Filesystem fs;
+	ML::File file = fs.Open( "transfer.bin", "wb" );
+	file.Write( payload.data( ), payload.size( ) );
+	file.Close( );
+
+	for( int32_t method = 0; method < 2; ++method )
+	{
+		ML::File source = fs.Open( "transfer.bin", "rb" );
+		ML::File copy = fs.Open( "transfer.copy", "wb" );
+		ML::Stopwatch stopwatch;
+		stopwatch.Resume( );
+		size_t copied = method == 0 ? CopyWithBuffer( source, copy ) : ML::Transfer( source.GetTransferEndpoint( ), copy.GetTransferEndpoint( ) );
+		copy.Flush( );
+		stopwatch.Pause( );
+		Report( method == 0 ? "File to file (Read/Write)" : "File to file (Transfer)", copied, stopwatch.GetElapsedTime( ) );
+	}
+
+	for( int32_t method = 0; method < 2; ++method )
+	{
+		ML::Pipe pipe( false, false );
+		ML::File copy = fs.Open( "transfer.copy", "wb" );
+		ML::Stopwatch stopwatch;
+		stopwatch.Resume( );
+		std::thread writer( [&pipe, &payload]( )
+		{
+			pipe.WriteAll( payload.data( ), payload.size( ) );
+			pipe.CloseWrite( );
+		} );
+
+		size_t copied = method == 0 ? CopyWithBuffer( pipe, copy ) : ML::Transfer( pipe, copy.GetTransferEndpoint( ) );
+		copy.Flush( );
+		writer.join( );
+		stopwatch.Pause( );
+		Report( method == 0 ? "Pipe to file (Read/Write)" : "Pipe to file (Transfer)", copied, stopwatch.GetElapsedTime( ) );
+	}
+
+	for( int32_t method = 0; method < 2; ++method )
+	{
+		ML::Pipe pipe( false, false );
+		ML::File source = fs.Open( "transfer.bin", "rb" );
+		std::vector<uint8_t> sink( 128 * 1024 );
+		ML::Stopwatch stopwatch;
+		stopwatch.Resume( );
+		std::thread reader( [&pipe, &sink]( )
+		{
+			while( pipe.Read( sink.data( ), sink.size( ) ) != 0 );
+		} );
+
+		size_t copied = method == 0 ? CopyWithBuffer( source, pipe ) : ML::Transfer( source.GetTransferEndpoint( ), pipe );
+		pipe.CloseWrite( );
+		reader.join( );
+		stopwatch.Pause( );
+		Report( method == 0 ? "File to pipe (Read/Write)" : "File to pipe (Transfer)", copied, stopwatch.GetElapsedTime( ) );
+	}
+
+	fs.RemoveFile( "transfer.bin" );
+	fs.RemoveFile( "transfer.copy" );
+}
+
+#if !defined _WIN32
+
+// What Process did before ProcessBuilder, fork copies the page tables of the
+// parent so it gets slower the more memory is mapped
+static void ForkAndWait( const char *path )
+{
+	pid_t pid = fork( );
+	if( pid == 0 )
+	{
+		char *argv[] = { const_cast<char *>( path ), nullptr };
+		execv( path, argv );
+		_exit( EXIT_FAILURE );
+	}
+
+	int status = 0;
+	waitpid( pid, &status, 0 );
+}
+
+#endif
+
+static void BenchmarkSpawn( )
+{
+
+#if defined _WIN32
+
+	const char *path = "C:\\Windows\\System32\\whoami.exe";
+
+#else
+
+	const char *path = "/bin/true";
+
+#endif
+
+	const size_t spawns = 200;
+	std::vector<uint8_t> ballast;
+	for( size_t mapped : { size_t( 0 ), payload_size * 8 } )
+	{
+		// Touched so the pages are really mapped
+		ballast.assign( mapped, 1 );
+		const std::string suffix = " (" + std::to_string( mapped / ( 1024 * 1024 ) ) + " MiB mapped)";
+		ML::Stopwatch stopwatch;
+
+#if !defined _WIN32
+
+		stopwatch.Resume( );
+		for( size_t k = 0; k < spawns; ++k )
+			ForkAndWait( path );
+		stopwatch.Pause( );
+		ReportLatency( "fork + execv" + suffix, spawns, stopwatch.GetElapsedTime( ) );
+		stopwatch.Reset( );
+
+#endif
+
+		ML::ProcessBuilder builder( path );
+		builder.SetOutput( ML::ProcessBuilder::Redirection::Null );
+		stopwatch.Resume( );
+		for( size_t k = 0; k < spawns; ++k )
+		{
+			ML::Process process( builder );
+			process.Close( );
+		}
+		stopwatch.Pause( );
+		ReportLatency( "ProcessBuilder" + suffix, spawns, stopwatch.GetElapsedTime( ) );
+	}
+}
+
+// Echoes the payload through Child.exe, over its pipes and over a shared channel
+static void BenchmarkChannel( )
+{
+	const size_t chunk_size = 1024 * 1024;
+	std::vector<uint8_t> payload = MakePayload( payload_size ), received( payload_size ), frame;
+	ML::Stopwatch stopwatch;
+
+	{
+		ML::Process process( ML::ProcessBuilder( "Child.exe" ).AddArgument( "--worker" ) );
+		stopwatch.Resume( );
+		for( size_t offset = 0; offset < payload_size; offset += chunk_size )
+		{
+			ML::ProcessPool::WriteFrame( process.Input( ), payload.data( ) + offset, chunk_size );
+			ML::ProcessPool::ReadFrame( process.Output( ), frame );
+		}
+		stopwatch.Pause( );
+		process.CloseInput( );
+		process.Close( );
+		Report( "Pipe echo", payload_size, stopwatch.GetElapsedTime( ) );
+		stopwatch.Reset( );
+	}
+
+	ML::SharedChannel channel( chunk_size );
+	ML::Process process( ML::ProcessBuilder( "Child.exe" ).AddArgument( "--channel" ).ShareChannel( channel, "CHILD_CHANNEL" ) );
+	stopwatch.Resume( );
+	size_t written = 0, read = 0;
+	while( read < payload_size )
+	{
+		if( written < payload_size )
+			written += channel.Write( payload.data( ) + written, payload_size - written );
+
+		size_t chunk = channel.Read( received.data( ) + read, payload_size - read );
+		read += chunk;
+		if( chunk == 0 && !channel.WaitForData( 1, 5000 ) )
+			break;
+	}
+	stopwatch.Pause( );
+	channel.Close( );
+	process.Close( );
+	Report( "SharedChannel echo", read, stopwatch.GetElapsedTime( ) );
+}
+
+int main( int, char ** )
+{
+	BenchmarkCompression( );
+	BenchmarkUnicode( );
+	BenchmarkGlob( );
+	BenchmarkANSI( );
+	BenchmarkNumbers( );
+	BenchmarkCaseInsensitive( );
+	BenchmarkTransfer( );
+	BenchmarkSpawn( );
+	BenchmarkChannel( );
+	return 0;
+}
@@ -34,14 +34,63 @@
  *************************************************************************/
 
 #include <MultiLibrary/Common/Pipe.hpp>
+#include <MultiLibrary/Common/ProcessPool.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
 #include <MultiLibrary/Filesystem/Filesystem.hpp>
 
 #include <string>
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 
-int main( int, const char ** )
+// Answers ProcessPool requests with their bytes reversed, crashing when asked to
+static int RunWorker( )
 {
 	ML::Pipe pipe( ML::Standard::Input::Normal, ML::Standard::Output::Normal );
+	std::vector<uint8_t> frame;
+	while( ML::ProcessPool::ReadFrame( pipe, frame ) )
+	{
+		if( std::string( frame.begin( ), frame.end( ) ) == "crash" )
+			std::abort( );
+
+		std::reverse( frame.begin( ), frame.end( ) );
+		if( !ML::ProcessPool::WriteFrame( pipe, frame.data( ), frame.size( ) ) )
+			return 1;
+	}
+
+	return 0;
+}
+
+// Sends back everything received through the shared channel, read in place
+static int RunChannel( )
+{
+	ML::SharedChannel channel( "CHILD_CHANNEL" );
+	while( channel.WaitForData( 1 ) )
+	{
+		const void *data = nullptr;
+		size_t size = channel.Peek( data );
+		size_t written = 0;
+		while( written < size && channel.WaitForSpace( 1 ) )
+			written += channel.Write( static_cast<const uint8_t *>( data ) + written, size - written );
+
+		if( written != size )
+			return 1;
+
+		channel.Consume( size );
+	}
+
+	return 0;
+}
+
+int main( int argc, const char **argv )
+{
+	if( argc > 1 && std::string( argv[1] ) == "--worker" )
+		return RunWorker( );
+
+	if( argc > 1 && std::string( argv[1] ) == "--channel" )
+		return RunChannel( );
+
+	ML::Pipe pipe( ML::Standard::Input::Normal, ML::Standard::Output::Normal );
 
 	std::string str1, str2, str3, str4;
 	int32_t num = 0;
@@ -34,10 +34,30 @@
  *************************************************************************/
 
 #include <MultiLibrary/Common/ByteBuffer.hpp>
+#include <MultiLibrary/Common/ByteBufferView.hpp>
+#include <MultiLibrary/Common/BufferPool.hpp>
+#include <MultiLibrary/Common/ChainedBuffer.hpp>
+#include <MultiLibrary/Common/BinaryWriter.hpp>
+#include <MultiLibrary/Common/BinaryReader.hpp>
+#include <MultiLibrary/Common/BufferedInputStream.hpp>
+#include <MultiLibrary/Common/BufferedOutputStream.hpp>
+#include <MultiLibrary/Common/CompressingOutputStream.hpp>
+#include <MultiLibrary/Common/DecompressingInputStream.hpp>
+#include <MultiLibrary/Common/HashingInputStream.hpp>
+#include <MultiLibrary/Common/HashingOutputStream.hpp>
+#include <MultiLibrary/Common/RingBuffer.hpp>
+#include <MultiLibrary/Common/GlobPattern.hpp>
+#include <MultiLibrary/Common/InternedString.hpp>
+#include <MultiLibrary/Common/Number.hpp>
 #include <MultiLibrary/Common/String.hpp>
 #include <MultiLibrary/Common/Unicode.hpp>
 #include <MultiLibrary/Common/Stopwatch.hpp>
+#include <MultiLibrary/Common/Pipe.hpp>
 #include <MultiLibrary/Common/Process.hpp>
+#include <MultiLibrary/Common/ProcessGroup.hpp>
+#include <MultiLibrary/Common/ProcessPool.hpp>
+#include <MultiLibrary/Common/SharedChannel.hpp>
+#include <MultiLibrary/Common/Transfer.hpp>
 
 #include <MultiLibrary/Common/Vector2.hpp>
 #include <MultiLibrary/Common/Vector3.hpp>
@@ -45,6 +65,7 @@
 
 #include <MultiLibrary/Filesystem/Filesystem.hpp>
 #include <MultiLibrary/Filesystem/File.hpp>
+#include <MultiLibrary/Filesystem/MappedFile.hpp>
 
 #include <MultiLibrary/Media/AudioDevice.hpp>
 #include <MultiLibrary/Media/SoundBuffer.hpp>
@@ -54,6 +75,7 @@
 
 #include <MultiLibrary/Network/HTTP.hpp>
 #include <MultiLibrary/Network/FTP.hpp>
+#include <MultiLibrary/Network/SocketTCP.hpp>
 
 #include <MultiLibrary/Window/Window.hpp>
 
@@ -63,7 +85,10 @@
 #include <iostream>
 #include <thread>
 #include <iterator>
+#include <limits>
+#include <map>
 #include <string>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -102,6 +127,216 @@ static void TestSockets( )
 		std::cout << "Not valid\n";
 }
 
+static void TestByteBuffer( )
+{
+	ML::ByteBuffer buffer;
+	buffer << "slice me" << static_cast<int32_t>( 1234 );
+
+	ML::ByteBufferView view = buffer.Slice( 6, buffer.Size( ) - 6 );
+	buffer.Clear( );
+
+	std::string str;
+	int32_t num = 0;
+	view >> str >> num;
+	if( str != "me" || num != 1234 || view.Slice( 0, 2 ).GetBuffer( ) != view.GetBuffer( ) )
+		throw std::runtime_error( "TestByteBuffer failed" );
+
+	ML::BufferPool pool;
+	for( int32_t k = 0; k < 10; ++k )
+	{
+		ML::ByteBuffer pooled( pool, 1024 );
+		pooled << k;
+	}
+
+	ML::BufferPool::Statistics stats = pool.GetStatistics( );
+	if( stats.misses != 1 || stats.hits != 9 )
+		throw std::runtime_error( "TestByteBuffer pool failed" );
+
+	ML::ByteBuffer original( reinterpret_cast<const uint8_t *>( "abc" ), 3 );
+	uint8_t *data = original.GetBuffer( );
+	ML::ByteBuffer copy( original );
+	ML::ByteBufferView copy_view = original.Slice( );
+	data[0] = 'x';
+	if( copy.GetBuffer( )[0] != 'a' || copy_view.GetBuffer( )[0] != 'a' || original.GetBuffer( )[0] != 'x' )
+		throw std::runtime_error( "TestByteBuffer copy-on-write failed" );
+
+	{
+		ML::ByteBuffer assigned( pool, 1024 );
+		assigned << static_cast<int32_t>( 1 );
+		assigned = copy;
+	}
+
+	// The loop released its storage 10 times, the assignment once more
+	stats = pool.GetStatistics( );
+	if( stats.releases != 11 )
+		throw std::runtime_error( "TestByteBuffer assignment failed" );
+
+	ML::ByteBuffer serialized;
+	{
+		const uint16_t values[] = { 1, 2, 0xBEEF };
+		ML::BinaryWriter writer( serialized, ML::Endianness::Big, 16 );
+		writer << static_cast<uint32_t>( 0x01020304 ) << std::string( "binary" );
+		writer.WriteZigZag( -300 ).WriteArray( values, 3 );
+	}
+
+	uint32_t magic = 0;
+	std::string name;
+	int64_t zigzag = 0;
+	uint16_t values[3] = { };
+	serialized.Seek( 0 );
+	ML::BinaryReader reader( serialized, ML::Endianness::Big, 16 );
+	reader >> magic >> name;
+	if( serialized.GetBuffer( )[0] != 0x01 || magic != 0x01020304 || name != "binary" ||
+		!reader.ReadZigZag( zigzag ) || zigzag != -300 || reader.ReadArray( values, 3 ) != 3 || values[2] != 0xBEEF || reader.Failed( ) )
+		throw std::runtime_error( "TestByteBuffer serialization failed" );
+}
+
+static std::string GatherSegments( const ML::ChainedBuffer &buffer )
+{
+	std::vector<ML::ChainedBuffer::Segment> segments( buffer.SegmentCount( ) );
+	segments.resize( buffer.GetSegments( segments.data( ), segments.size( ) ) );
+
+	std::string gathered;
+	for( const ML::ChainedBuffer::Segment &segment : segments )
+		gathered.append( reinterpret_cast<const char *>( segment.data ), segment.size );
+
+	return gathered;
+}
+
+static void TestChainedBuffer( )
+{
+	std::string text;
+	for( int32_t k = 0; k < 10; ++k )
+		text += "segment " + std::to_string( k ) + "\n";
+
+	ML::BufferPool pool;
+	{
+		ML::ChainedBuffer chained( 16, pool );
+		chained.Write( text.data( ), text.size( ) );
+		if( chained.Size( ) != text.size( ) || chained.SegmentCount( ) != ( text.size( ) + 15 ) / 16 || GatherSegments( chained ) != text )
+			throw std::runtime_error( "TestChainedBuffer write failed" );
+
+		// Consuming 20 bytes leaves the head in the middle of the second block
+		std::string rest( text.size( ) - 20, '\0' );
+		if( chained.Consume( 20 ) != 20 || chained.Read( &rest[0], rest.size( ) ) != rest.size( ) || rest != text.substr( 20 ) )
+			throw std::runtime_error( "TestChainedBuffer consume failed" );
+
+		ML::ChainedBuffer::Segment segments[8];
+		size_t count = chained.PrepareSegments( 40, segments, 8 );
+		size_t prepared = 0;
+		for( size_t k = 0; k < count; ++k )
+			for( size_t i = 0; i < segments[k].size; ++i, ++prepared )
+				segments[k].data[i] = static_cast<uint8_t>( 'a' + prepared % 26 );
+
+		chained.Commit( prepared );
+		std::string committed( 40, '\0' );
+		if( count < 2 || prepared != 40 || chained.Read( &committed[0], committed.size( ) ) != 40 || committed != "abcdefghijklmnopqrstuvwxyzabcdefghijklmn" )
+			throw std::runtime_error( "TestChainedBuffer commit failed" );
+
+		ML::ChainedBuffer moved( 16, pool );
+		moved.Write( text.data( ), text.size( ) );
+		moved = std::move( chained );
+		moved.Seek( 0 );
+		if( chained.Size( ) != 0 || GatherSegments( moved ) != text.substr( 20 ) + committed )
+			throw std::runtime_error( "TestChainedBuffer move failed" );
+	}
+
+	// Every block must have gone back to the pool, including the ones dropped by the move
+	ML::BufferPool::Statistics stats = pool.GetStatistics( );
+	if( stats.releases + stats.discards != stats.hits + stats.misses )
+		throw std::runtime_error( "TestChainedBuffer pool failed" );
+
+	const ML::IPAddress address( "127.0.0.1", 41237 );
+	ML::SocketTCP listener, client, server;
+	ML::IPAddress remote;
+	if( listener.Bind( address ) || listener.Listen( 1 ) || client.Connect( address ) || listener.Accept( server, remote ) )
+		throw std::runtime_error( "TestChainedBuffer connection failed" );
+
+	ML::ChainedBuffer outgoing( 16 ), incoming( 16 );
+	outgoing.Write( text.data( ), text.size( ) );
+	while( outgoing.Size( ) != 0 )
+	{
+		int32_t sent = 0;
+		if( client.Send( outgoing, 0, &sent ) || sent <= 0 )
+			throw std::runtime_error( "TestChainedBuffer send failed" );
+
+		outgoing.Consume( static_cast<size_t>( sent ) );
+	}
+
+	while( incoming.Size( ) < text.size( ) )
+	{
+		int32_t received = 0;
+		if( server.Receive( incoming, static_cast<int32_t>( text.size( ) - incoming.Size( ) ), 0, &received ) || received <= 0 )
+			throw std::runtime_error( "TestChainedBuffer receive failed" );
+	}
+
+	if( GatherSegments( incoming ) != text )
+		throw std::runtime_error( "TestChainedBuffer socket round-trip failed" );
+}
+
+static void TestCompression( )
+{
+	std::string text;
+	for( int32_t k = 0; k < 1000; ++k )
+		text += "compressible line " + std::to_string( k % 10 ) + "\n";
+
+	ML::ByteBuffer compressed;
+	{
+		ML::CompressingOutputStream output( compressed, 4096 );
+		output.Write( text.data( ), text.size( ) );
+		if( !output.Finish( ) || output.CompressedSize( ) >= text.size( ) / 4 )
+			throw std::runtime_error( "TestCompression failed" );
+	}
+
+	compressed.Seek( 0 );
+	ML::DecompressingInputStream input( compressed );
+	std::string decompressed( text.size( ), '\0' );
+	char extra = '\0';
+	if( input.Read( &decompressed[0], decompressed.size( ) ) != text.size( ) || decompressed != text || input.Read( &extra, 1 ) != 0 || !input.EndOfFile( ) )
+		throw std::runtime_error( "TestCompression failed" );
+}
+
+static void TestChecksum( )
+{
+	if( ML::CRC32C::Compute( "123456789", 9 ) != 0xE3069283 || ML::Hash64::Compute( "abc", 3 ) != 0x44BC2CF5AD770999 )
+		throw std::runtime_error( "TestChecksum failed" );
+
+	ML::ByteBuffer buffer;
+	ML::HashingOutputStream output( buffer );
+	for( int32_t k = 0; k < 1000; ++k )
+		output << k;
+
+	buffer.Seek( 0 );
+	ML::HashingInputStream input( buffer );
+	int32_t value = 0;
+	while( input.Read( &value, sizeof( value ) ) == sizeof( value ) );
+
+	if( input.GetCRC32C( ) != output.GetCRC32C( ) || input.GetHash64( ) != output.GetHash64( ) || input.GetSize( ) != 4000 ||
+		output.GetHash64( ) != ML::Hash64::Compute( static_cast<const ML::ByteBuffer &>( buffer ).GetBuffer( ), buffer.Size( ) ) )
+		throw std::runtime_error( "TestChecksum failed" );
+}
+
+static void TestRingBuffer( )
+{
+	ML::RingBuffer ring( 100 );
+	std::thread producer( [&ring]( )
+	{
+		for( int32_t k = 0; k < 100000; ++k )
+			if( ring.WaitForSpace( sizeof( k ) ) )
+				ring << k;
+
+		ring.Close( );
+	} );
+
+	int32_t expected = 0, value = 0;
+	while( ring.WaitForData( sizeof( value ) ) && ring.Read( &value, sizeof( value ) ) == sizeof( value ) && value == expected )
+		++expected;
+
+	producer.join( );
+	if( ring.Capacity( ) != 128 || expected != 100000 || !ring.EndOfFile( ) )
+		throw std::runtime_error( "TestRingBuffer failed" );
+}
+
 static void TestStrings( )
 {
 	std::string str = "κόσμε";
@@ -117,6 +352,63 @@ static void TestStrings( )
 
 	std::cout << str << " " << wstr.c_str( ) << " " << bstr.c_str( ) << "\n";
 
+	std::string mixed = std::string( 40, 'a' ) + str + "\xF0\x9F\x98\x80" + std::string( 40, 'b' );
+	std::u16string utf16( mixed.size( ), u'\0' );
+	utf16.resize( ML::UTF8::ConvertToUTF16( mixed.data( ), mixed.data( ) + mixed.size( ), &utf16[0] ) - utf16.data( ) );
+	std::string utf8( utf16.size( ) * 3, '\0' );
+	utf8.resize( ML::UTF16::ConvertToUTF8( utf16.data( ), utf16.data( ) + utf16.size( ), &utf8[0] ) - utf8.data( ) );
+	const char overlong[] = "abc\xC0\xAF";
+	if( utf8 != mixed || utf16.size( ) != 87 || !ML::UTF8::Validate( mixed.data( ), mixed.data( ) + mixed.size( ) ) || ML::UTF8::Validate( overlong, overlong + 5 ) || ML::UTF8::SkipASCII( mixed.data( ), mixed.data( ) + mixed.size( ) ) != mixed.data( ) + 40 )
+		throw std::runtime_error( "TestStrings transcoding failed" );
+
+	const char malformed[] = "ok\xE2\x82!\xED\xA0\x80";
+	std::string sanitized;
+	size_t error_offset = 0;
+	if( ML::UTF8::Sanitize( malformed, malformed + 8, sanitized, ML::UTF8::ErrorPolicy::Replace, &error_offset ) || error_offset != 2 || sanitized != "ok\xEF\xBF\xBD!\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD" )
+		throw std::runtime_error( "TestStrings sanitizing failed" );
+
+	ML::InternedString field( "Content-Length" ), same( std::string( "Content-Length" ) ), other( "Content-Type" );
+	if( field != same || field == other || field.GetHash( ) != same.GetHash( ) || field.GetView( ) != ML::StringView( "Content-Length" ) || !ML::InternedString( ).Empty( ) )
+		throw std::runtime_error( "TestStrings interning failed" );
+
+	ML::String title = ML::String::FromUTF8( str.begin( ), str.end( ) );
+	title.SetCaching( true );
+	std::u16string title16 = title.ToUTF16( );
+	title += ML::String( "!" );
+	if( title.Length( ) != 6 || title16.size( ) != 5 || title.ToUTF16( ).size( ) != 6 )
+		throw std::runtime_error( "TestStrings caching failed" );
+
+	const ML::ANSICodec &latin1 = ML::ANSICodec::Latin1( );
+	ML::String accented( "caf\xE9", latin1 );
+	if( accented.ToUTF8( ) != "caf\xC3\xA9" || accented.ToANSI( latin1 ) != "caf\xE9" || ML::String( "plain" ).ToANSI( ) != "plain" )
+		throw std::runtime_error( "TestStrings ANSI conversion failed" );
+
+	ML::GlobPattern glob( "src/**/[a-m]*.?pp" );
+	std::vector<std::string> names = { "src/main.cpp", "src/a/b/lib.hpp", "src/zed.cpp", "include/main.hpp", "src/main.c" };
+	if( !glob.Match( "src/x/y/file.cpp" ) || glob.Match( "src/x/y/file.c" ) || glob.Filter( names ) != 2 || names[1] != "src/a/b/lib.hpp" )
+		throw std::runtime_error( "TestStrings glob matching failed" );
+
+	char lowered[17];
+	ML::String::ToLowerASCII( "Content-Type: \xC3\x89" "A", 17, lowered );
+	std::map<std::string, int, ML::CaseInsensitiveLess> headers = { { "Content-Length", 1 }, { "content-type", 2 } };
+	if( std::string( lowered, 17 ) != "content-type: \xC3\x89" "a" || headers.find( "CONTENT-TYPE" ) == headers.end( ) || headers.count( ML::StringView( "content-length" ) ) != 1 ||
+		ML::String::CompareCaseInsensitive( "abc", "ABD" ) >= 0 || ML::String::HashCaseInsensitive( "X-Forwarded-For" ) != ML::String::HashCaseInsensitive( "x-forwarded-for" ) )
+		throw std::runtime_error( "TestStrings case insensitive comparison failed" );
+
+	char number[ML::Number::max_float_length];
+	std::string formatted( number, ML::Number::Format( 0.1, number ) );
+	formatted += ' ';
+	formatted.append( number, ML::Number::Format( -1.5e-300, number ) );
+	formatted += ' ';
+	formatted.append( number, ML::Number::Format( static_cast<int64_t>( -9007199254740993LL ), number ) );
+	double parsed_double = 0;
+	int32_t parsed_integer = 0;
+	const char numbers[] = "2.2250738585072011e-308 4294967296";
+	const char *parsed_end = ML::Number::Parse( numbers, numbers + 23, parsed_double );
+	if( formatted != "0.1 -1.5e-300 -9007199254740993" || parsed_end != numbers + 23 || parsed_double != 2.2250738585072011e-308 ||
+		ML::Number::Parse( numbers + 24, numbers + 34, parsed_integer ) != nullptr )
+		throw std::runtime_error( "TestStrings number conversion failed" );
+
 	std::string str2 = "this/is/a/filepath.xml";
 	std::string wild = "this/is/*";
 	if( ML::String::WildcardCompare( str2, wild ) )
@@ -127,8 +419,75 @@ static void TestFilesystem( )
 {
 	ML::Filesystem fs;
 	ML::File file1 = fs.Open( "file.pak", "wb" );
+	const uint32_t header = 0x4B415050;
+	file1.Write( &header, sizeof( header ) );
+	file1.Write( "mapped", 7 );
 	file1.Close( );
 
+	ML::File output = fs.Open( "numbers.txt", "wb" );
+	output << 0.3;
+	output << " ";
+	output << static_cast<int16_t>( -1234 );
+	output << " 2.5e+3x -inf;";
+	output.Close( );
+
+	ML::File input = fs.Open( "numbers.txt", "rb" );
+	double tenths = 0;
+	int16_t small = 0;
+	input >> tenths;
+	input >> small;
+	if( tenths != 0.3 || small != -1234 || input.Tell( ) != 9 )
+		throw std::runtime_error( "TestFilesystem text numbers failed" );
+
+	// Numbers are scanned without seeking, nothing after them is consumed
+	float thousands = 0, infinite = 0;
+	char after = 0, end = 0;
+	input >> thousands;
+	input >> after;
+	input >> infinite;
+	input >> end;
+	if( thousands != 2500.0f || after != 'x' || infinite != -std::numeric_limits<float>::infinity( ) || end != ';' )
+		throw std::runtime_error( "TestFilesystem text lookahead failed" );
+
+	input.Close( );
+	fs.RemoveFile( "numbers.txt" );
+
+	ML::MappedFile mapped( "file.pak", ML::MappedFile::AccessHint::Sequential );
+	uint32_t magic = 0;
+	std::string name;
+	ML::ByteBufferView view = mapped.Slice( 4, 6 );
+	mapped >> magic >> name;
+	if( !mapped.IsValid( ) || mapped.Size( ) != 11 || magic != header || name != "mapped" || view.GetBuffer( ) != mapped.GetBuffer( ) + 4 )
+		throw std::runtime_error( "TestFilesystem mapping failed" );
+
+	ML::File source = fs.Open( "file.pak", "rb" );
+	ML::File copy = fs.Open( "copy.pak", "wb" );
+	ML::Pipe pipe( false, false );
+	source.Seek( static_cast<size_t>( 4 ) );
+	size_t piped = ML::Transfer( source.GetTransferEndpoint( ), pipe );
+	pipe.CloseWrite( );
+	size_t copied = ML::Transfer( pipe, copy.GetTransferEndpoint( ) );
+	ML::ByteBuffer tail;
+	tail << "!";
+	tail.Seek( static_cast<size_t>( 0 ) );
+	copied += ML::Transfer( tail, copy.GetTransferEndpoint( ) );
+	if( piped != 7 || copied != 9 || source.Tell( ) != 11 || copy.Tell( ) != 9 )
+		throw std::runtime_error( "TestFilesystem transfer failed" );
+
+	ML::Pipe unread( false, false );
+	unread.CloseRead( );
+	source.Seek( static_cast<size_t>( 0 ) );
+	if( ML::Transfer( source.GetTransferEndpoint( ), unread ) != 0 )
+		throw std::runtime_error( "TestFilesystem closed sink failed" );
+
+	source.Close( );
+	copy.Close( );
+	fs.RemoveFile( "copy.pak" );
+
+	std::vector<std::string> files, folders;
+	if( fs.Find( "*.pak", files, folders ) != 1 || files.size( ) != 1 || files[0] != "file.pak" )
+		throw std::runtime_error( "TestFilesystem find failed" );
+
 	std::cout << ML::Filesystem::GetExecutablePath( ) << "\n";
 }
 
@@ -280,6 +639,46 @@ static void TestWindow( )
 	thread.join( );
 }
 
+static void TestPipe( )
+{
+	ML::Pipe pipe( false, false );
+	char buffer[16] = { 0 };
+	pipe.SetMode( ML::Pipe::Mode::NonBlocking );
+	if( pipe.Read( buffer, sizeof( buffer ) ) != 0 || pipe.WriteAll( "pipe", 4 ) != 4 )
+		throw std::runtime_error( "TestPipe non-blocking failed" );
+
+	pipe.SetMode( ML::Pipe::Mode::Deadline, 50 );
+	ML::Stopwatch stopwatch;
+	stopwatch.Resume( );
+	size_t received = pipe.ReadAll( buffer, sizeof( buffer ) );
+	stopwatch.Pause( );
+	if( received != 4 || std::string( buffer, 4 ) != "pipe" || stopwatch.GetElapsedTime( ) < 40 )
+		throw std::runtime_error( "TestPipe deadline failed" );
+
+	// Running out of time isn't the end of the pipe
+	if( pipe.Read( buffer, sizeof( buffer ) ) != 0 || pipe.EndOfFile( ) )
+		throw std::runtime_error( "TestPipe timeout failed" );
+
+	pipe.SetMode( ML::Pipe::Mode::Blocking );
+	std::thread writer( [&pipe]( )
+	{
+		std::this_thread::sleep_for( 20ms );
+		pipe.WriteAll( "late", 4 );
+		pipe.CloseWrite( );
+	} );
+
+	received = pipe.ReadAll( buffer, sizeof( buffer ) );
+	writer.join( );
+	if( received != 4 || std::string( buffer, 4 ) != "late" || !pipe.EndOfFile( ) )
+		throw std::runtime_error( "TestPipe blocking failed" );
+
+	ML::Pipe closed( false, false );
+	closed.SetMode( ML::Pipe::Mode::Deadline, 5000 );
+	closed.CloseWrite( );
+	if( closed.Read( buffer, sizeof( buffer ) ) != 0 || !closed.EndOfFile( ) )
+		throw std::runtime_error( "TestPipe end of file failed" );
+}
+
 static void TestProcess( )
 {
 	ML::Process process( "Child.exe" );
@@ -304,22 +703,238 @@ static void TestProcess( )
 		throw std::runtime_error( "TestProcess failed" );
 
 	std::cout << "Exit code: " << process.ExitCode( );
+
+	ML::Process quiet( ML::ProcessBuilder( "Child.exe" ).SetOutput( ML::ProcessBuilder::Redirection::Null ) );
+	ML::BufferedOutputStream quiet_input( quiet.Input( ) );
+	quiet_input << instr1 << instr2 << instr3 << instr4 << innum1 << inbool1;
+	quiet_input.Flush( );
+	quiet.CloseInput( );
+	if( !quiet.Close( ) || quiet.ExitCode( ) != 0 || quiet.Output( ).IsValid( ) )
+		throw std::runtime_error( "TestProcess redirection failed" );
+
+	if( quiet.GetUsage( ).max_resident_size == 0 )
+		throw std::runtime_error( "TestProcess usage failed" );
+}
+
+static void TestProcessBufferedInput( )
+{
+	ML::Process process( "Child.exe" );
+
+	ML::Pipe &input = process.Input( );
+	const std::string instr1 = "first", instr2 = "second", instr3 = "third", instr4 = "fourth";
+	const int32_t innum1 = 1234;
+	const bool inbool1 = true;
+	input << instr1 << instr2 << instr3 << instr4 << innum1 << inbool1;
+	process.CloseInput( );
+
+	// A small buffer makes the reads below refill it several times
+	ML::BufferedInputStream output( process.Output( ), 8 );
+	std::string outstr1, outstr2, outstr3, outstr4;
+	int32_t outnum1 = 0;
+	bool outbool1 = false;
+	if( !output.ReadUntil( outstr1, '\0' ) )
+		throw std::runtime_error( "TestProcessBufferedInput delimiter failed" );
+
+	output >> outstr2 >> outstr3 >> outstr4 >> outnum1 >> outbool1;
+	if( outstr1 != instr4 || outstr2 != instr3 || outstr3 != instr2 || outstr4 != instr1 || outnum1 != innum1 || outbool1 != inbool1 )
+		throw std::runtime_error( "TestProcessBufferedInput failed" );
+
+	if( !process.Close( ) || process.ExitCode( ) != 0 )
+		throw std::runtime_error( "TestProcessBufferedInput exit failed" );
+}
+
+static void TestProcessBufferedOutput( )
+{
+	ML::Process process( "Child.exe" );
+
+	ML::BufferedOutputStream input( process.Input( ) );
+	const std::string instr1 = "first", instr2 = "second", instr3 = "third", instr4 = "fourth";
+	const int32_t innum1 = 1234;
+	const bool inbool1 = true;
+	input << instr1 << instr2 << instr3 << instr4 << innum1 << inbool1;
+	if( input.Buffered( ) == 0 || !input.Flush( ) || input.Buffered( ) != 0 )
+		throw std::runtime_error( "TestProcessBufferedOutput flush failed" );
+
+	// All six writes must have reached the pipe in a single call
+	ML::BufferedOutputStream::Statistics stats = input.GetStatistics( );
+	if( stats.writes != 6 || stats.flushes != 1 )
+		throw std::runtime_error( "TestProcessBufferedOutput statistics failed" );
+
+	process.CloseInput( );
+
+	ML::Pipe &output = process.Output( );
+	std::string outstr1, outstr2, outstr3, outstr4;
+	int32_t outnum1 = 0;
+	bool outbool1 = false;
+	output >> outstr1 >> outstr2 >> outstr3 >> outstr4 >> outnum1 >> outbool1;
+	if( outstr1 != instr4 || outstr2 != instr3 || outstr3 != instr2 || outstr4 != instr1 || outnum1 != innum1 || outbool1 != inbool1 )
+		throw std::runtime_error( "TestProcessBufferedOutput failed" );
+
+	if( !process.Close( ) || process.ExitCode( ) != 0 )
+		throw std::runtime_error( "TestProcessBufferedOutput exit failed" );
+}
+
+static void TestProcessGroup( )
+{
+	std::vector<std::unique_ptr<ML::Process>> processes;
+	ML::ProcessGroup group;
+	size_t exits = 0, output = 0;
+	for( size_t k = 0; k < 4; ++k )
+	{
+		processes.emplace_back( new ML::Process( "Child.exe" ) );
+		ML::Process &process = *processes.back( );
+		ML::BufferedOutputStream input( process.Input( ) );
+		input << "one" << "two" << "three" << "four" << static_cast<int32_t>( k ) << true;
+		input.Flush( );
+		process.CloseInput( );
+
+		// Half of them go through the queue
+		if( k % 2 == 0 )
+			group.Add( process );
+		else
+			group.Add( process, [&exits, &output]( const ML::ProcessGroup::Notification &notification )
+			{
+				if( notification.event == ML::ProcessGroup::Event::Exit )
+					exits += notification.exit_code == 0 ? 1 : 0;
+				else
+					output += notification.data.size( );
+			} );
+	}
+
+	ML::ProcessGroup::Notification notification;
+	while( group.Count( ) != 0 )
+	{
+		group.Wait( 1000 );
+		while( group.Next( notification ) )
+		{
+			if( notification.event == ML::ProcessGroup::Event::Exit )
+				exits += notification.exit_code == 0 ? 1 : 0;
+			else
+				output += notification.data.size( );
+		}
+	}
+
+	if( exits != 4 || output == 0 )
+		throw std::runtime_error( "TestProcessGroup failed" );
+}
+
+static void TestProcessPool( )
+{
+	ML::ProcessPool pool( ML::ProcessBuilder( "Child.exe" ).AddArgument( "--worker" ), 2 );
+	const std::string requests[] = { "alpha", "beta", "crash", "gamma", "delta" };
+	size_t succeeded = 0, failed = 0;
+	for( const std::string &request : requests )
+	{
+		std::string expected( request.rbegin( ), request.rend( ) );
+		pool.Submit( request.data( ), request.size( ), [&succeeded, &failed, expected]( bool success, const std::vector<uint8_t> &response )
+		{
+			if( success && std::string( response.begin( ), response.end( ) ) == expected )
+				++succeeded;
+			else if( !success )
+				++failed;
+		} );
+	}
+
+	while( pool.Pending( ) != 0 )
+		pool.Wait( 1000 );
+
+	ML::ProcessPool::Statistics statistics = pool.GetStatistics( );
+	if( succeeded != 4 || failed != 1 || statistics.completed != 4 || statistics.restarts != 1 || statistics.workers != 2 || statistics.queued != 0 || statistics.usage.max_resident_size == 0 )
+		throw std::runtime_error( "TestProcessPool failed" );
+
+	// The response is bigger than the pipe buffer and is never read, the
+	// pool must still be able to go away
+	bool answered = false;
+	{
+		ML::ProcessPool abandoned( ML::ProcessBuilder( "Child.exe" ).AddArgument( "--worker" ), 1 );
+		std::vector<uint8_t> request( 1024 * 1024, 'x' );
+		abandoned.Submit( request.data( ), request.size( ), [&answered]( bool, const std::vector<uint8_t> & )
+		{
+			answered = true;
+		} );
+	}
+
+	if( answered )
+		throw std::runtime_error( "TestProcessPool destruction failed" );
+}
+
+static void TestSharedChannel( )
+{
+	ML::SharedChannel channel( 64 * 1024 );
+	ML::Process process( ML::ProcessBuilder( "Child.exe" ).AddArgument( "--channel" ).ShareChannel( channel, "CHILD_CHANNEL" ) );
+
+	// Several times the capacity, so both sides have to wait on each other
+	std::vector<uint8_t> sent( 1024 * 1024 ), received( sent.size( ) );
+	for( size_t k = 0; k < sent.size( ); ++k )
+		sent[k] = static_cast<uint8_t>( k * 7 );
+
+	size_t written = 0, read = 0;
+	while( read < received.size( ) )
+	{
+		if( written < sent.size( ) )
+		{
+			written += channel.Write( sent.data( ) + written, sent.size( ) - written );
+			if( written == sent.size( ) )
+				channel.Close( );
+		}
+
+		size_t chunk = channel.Read( received.data( ) + read, received.size( ) - read );
+		read += chunk;
+		if( chunk == 0 && !channel.WaitForData( 1, 5000 ) )
+			break;
+	}
+
+	if( read != sent.size( ) || received != sent || channel.WaitForData( 1, 5000 ) || !channel.EndOfFile( ) )
+		throw std::runtime_error( "TestSharedChannel failed" );
+
+	if( !process.Close( ) || process.ExitCode( ) != 0 )
+		throw std::runtime_error( "TestSharedChannel process failed" );
+
+	// Children that exit without closing the channel don't leave the parent
+	// waiting forever
+	ML::SharedChannel abandoned( 4096 );
+	ML::Process quitter( ML::ProcessBuilder( "Child.exe" ).AddArgument( "--worker" ).ShareChannel( abandoned, "CHILD_CHANNEL" ) );
+	quitter.CloseInput( );
+	if( abandoned.WaitForData( 1 ) || !abandoned.EndOfFile( ) )
+		throw std::runtime_error( "TestSharedChannel exit failed" );
 }
 
 int main( int, char ** )
 {
 	(void)&TestSockets;
+	(void)&TestByteBuffer;
+	(void)&TestChainedBuffer;
+	(void)&TestCompression;
+	(void)&TestChecksum;
+	(void)&TestRingBuffer;
 	(void)&TestStrings;
 	(void)&TestFilesystem;
 	(void)&TestAudio;
 	(void)&TestWindow;
+	(void)&TestPipe;
 	(void)&TestProcess;
+	(void)&TestProcessBufferedInput;
+	(void)&TestProcessBufferedOutput;
+	(void)&TestProcessGroup;
+	(void)&TestProcessPool;
+	(void)&TestSharedChannel;
 
 	TestSockets( );
+	TestByteBuffer( );
+	TestChainedBuffer( );
+	TestCompression( );
+	TestChecksum( );
+	TestRingBuffer( );
 	TestStrings( );
 	TestFilesystem( );
 	TestAudio( );
 	TestWindow( );
+	TestPipe( );
 	TestProcess( );
+	TestProcessBufferedInput( );
+	TestProcessBufferedOutput( );
+	TestProcessGroup( );
+	TestProcessPool( );
+	TestSharedChannel( );
 	return 0;
 }